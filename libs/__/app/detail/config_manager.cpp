@@ -43,6 +43,7 @@
 
 #include <boost/range/iterator_range_core.hpp>
 #include <boost/thread/futures/wait_for_all.hpp>
+#include <algorithm>
 #include <ranges>
 
 namespace sight::app::detail
@@ -606,14 +607,26 @@ service::base::sptr config_manager::create_service(const detail::service_config&
         core::thread::worker::sptr worker = core::thread::get_worker(_srv_config.m_worker);
         if(!worker)
         {
-            worker = core::thread::worker::make();
+            worker = core::thread::worker::make(_srv_config.m_worker_threads);
             worker->set_thread_name(_srv_config.m_worker);
 
             core::thread::add_worker(_srv_config.m_worker, worker);
             m_created_workers.push_back(worker);
         }
+        else
+        {
+            SIGHT_WARN_IF(
+                "Worker '" << _srv_config.m_worker << "' already exists with " << worker->thread_count()
+                << " thread(s), the 'worker_threads' attribute of service '" << _srv_config.m_uid
+                << "' is ignored.",
+                _srv_config.m_worker_threads != 0
+                && std::max<std::size_t>(_srv_config.m_worker_threads, 1) != worker->thread_count()
+            );
+        }
 
-        srv->set_worker(worker);
+        // A multi-threaded worker is shared through a strand, so the tasks of this service are still serialized
+        const auto strand = worker->create_strand();
+        srv->set_worker(strand ? strand : worker);
     }
 
     const std::string err_msg_tail = " when creating service '" + _srv_config.m_uid + "'.";
@@ -286,6 +286,13 @@ app::detail::service_config config::parse_service(
     // Worker key
     srvconfig.m_worker = _srv_elem.get<std::string>("<xmlattr>.worker", "");
 
+    // Worker threads
+    srvconfig.m_worker_threads = _srv_elem.get<std::size_t>("<xmlattr>.worker_threads", 0);
+    SIGHT_ASSERT(
+        std::string(_err_msg_head) + "Attribute \"worker_threads\" requires a \"worker\" attribute" + err_msg_tail,
+        srvconfig.m_worker_threads == 0 || !srvconfig.m_worker.empty()
+    );
+
     // Get service configuration
     if(!config.empty())
     {
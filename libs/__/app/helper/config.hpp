@@ -92,6 +92,9 @@ struct service_config
     /// Service worker
     std::string m_worker;
 
+    /// Number of threads of the service worker if it is created by this service, 0 or 1 for a single thread
+    std::size_t m_worker_threads {0};
+
     /// list of required objects information (inputs, inouts and outputs), indexed by key name and index
     std::map<std::pair<std::string, std::optional<std::size_t> >, object_serviceconfig> m_objects;
 
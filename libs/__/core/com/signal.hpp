@@ -29,10 +29,13 @@
 #include <core/com/slot_connection.hpp>
 #include <core/mt/types.hpp>
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace sight::core::com
 {
@@ -67,7 +70,11 @@ struct SIGHT_CORE_CLASS_API signal<R(A ...)>: signal_base
     using slot_sptr     = std::shared_ptr<slot_run_type>;
 
     using pair_type        = std::pair<bool, std::weak_ptr<slot_run_type> >;
-    using slot_container_t = std::list<pair_type*>;
+    using emission_state_t = std::shared_ptr<slot_connection_base::emission_state>;
+    using slot_container_t = std::list<std::pair<pair_type*, emission_state_t> >;
+
+    /// Unblocked slots, as seen by the emissions
+    using slot_snapshot_t = std::vector<std::pair<std::weak_ptr<slot_run_type>, emission_state_t> >;
 
     using connection_map_type = std::map<std::weak_ptr<slot_base>, std::weak_ptr<slot_connection_base>,
                                          std::owner_less<std::weak_ptr<slot_base> > >;
@@ -90,17 +97,27 @@ struct SIGHT_CORE_CLASS_API signal<R(A ...)>: signal_base
 
     /**
      * @brief Disconnects the given slot.
+     *
+     * Returns once the emissions running the slot in other threads are done.
      * @throws BadSlot If given slot is not found in current connections.
      */
     void disconnect(SPTR(slot_base) _slot) override;
 
-    /// Disconnects all slots.
+    /// Disconnects all slots, once the emissions running them in other threads are done.
     void disconnect_all();
 
-    /// Requests execution of slots with given arguments.
+    /**
+     * @brief Requests execution of slots with given arguments.
+     *
+     * Emissions do not lock the connections, they run the slots connected and unblocked when they start.
+     */
     void emit(A ... _a) const;
 
-    /// Requests asynchronous execution of slots with given arguments.
+    /**
+     * @brief Requests asynchronous execution of slots with given arguments.
+     *
+     * The slots are posted with slot_run::async_run_detached(), so an emission does not allocate memory by itself.
+     */
     void async_emit(A ... _a) const;
 
     /// Returns number of connected slots.
@@ -132,12 +149,19 @@ struct SIGHT_CORE_CLASS_API signal<R(A ...)>: signal_base
         template<typename FROM_F>
         connection connect(SPTR(slot_base) _slot);
 
+        /// *NOT THREAD SAFE* Rebuilds the slots seen by the emissions, must be called when m_slots changes.
+        void update_snapshot_no_lock();
+
         /// Connected slots.
         slot_container_t m_slots;
 
         /// Container of current connections.
         connection_map_type m_connections;
 
+        /// Copy of m_slots read by the emissions, replaced as a whole when the connections change. Accessed with
+        /// std::atomic_load_explicit() and std::atomic_store_explicit() only.
+        std::shared_ptr<const slot_snapshot_t> m_snapshot;
+
         mutable core::mt::read_write_mutex m_connections_mutex;
 
     private:
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -52,24 +52,34 @@ connection signal<R(A ...)>::connect(slot_base::sptr _slot)
 template<typename R, typename ... A>
 void signal<R(A ...)>::disconnect(slot_base::sptr _slot)
 {
-    core::mt::read_to_write_lock lock(m_connections_mutex);
+    emission_state_t state;
+    {
+        core::mt::read_to_write_lock lock(m_connections_mutex);
 
-    auto iter = m_connections.find(_slot);
+        auto iter = m_connections.find(_slot);
 
-    if(iter != m_connections.end())
-    {
-        slot_connection_base::sptr connection(iter->second.lock());
-        SIGHT_ASSERT("Connection has been previously destroyed", connection);
-        if(connection)
+        if(iter != m_connections.end())
+        {
+            slot_connection_base::sptr connection(iter->second.lock());
+            SIGHT_ASSERT("Connection has been previously destroyed", connection);
+            if(connection)
+            {
+                core::mt::upgrade_to_write_lock write_lock(lock);
+                state = connection->m_emission_state;
+                connection->disconnect_weak_lock();
+                // m_connections.erase(slot.get()); // done in connection->disconnect
+            }
+        }
+        else
         {
-            core::mt::upgrade_to_write_lock write_lock(lock);
-            connection->disconnect_weak_lock();
-            // m_connections.erase(slot.get()); // done in connection->disconnect
+            SIGHT_THROW_EXCEPTION(core::com::exception::bad_slot("No such slot connected"));
         }
     }
-    else
+
+    // Emissions do not lock the connections, so they are waited for once the slot can not be run anymore
+    if(state)
     {
-        SIGHT_THROW_EXCEPTION(core::com::exception::bad_slot("No such slot connected"));
+        state->wait_for_emissions();
     }
 }
 
@@ -78,19 +88,29 @@ void signal<R(A ...)>::disconnect(slot_base::sptr _slot)
 template<typename R, typename ... A>
 void signal<R(A ...)>::disconnect_all()
 {
-    core::mt::write_lock lock(m_connections_mutex);
-
-    connection_map_type connections = m_connections;
-
-    for(const auto& conn : connections)
+    std::vector<emission_state_t> states;
     {
-        slot_connection_base::sptr connection(conn.second.lock());
+        core::mt::write_lock lock(m_connections_mutex);
 
-        if(connection)
+        connection_map_type connections = m_connections;
+        states.reserve(connections.size());
+
+        for(const auto& conn : connections)
         {
-            connection->disconnect_weak_lock();
+            slot_connection_base::sptr connection(conn.second.lock());
+
+            if(connection)
+            {
+                states.push_back(connection->m_emission_state);
+                connection->disconnect_weak_lock();
+            }
         }
     }
+
+    for(const auto& state : states)
+    {
+        state->wait_for_emissions();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -98,14 +118,21 @@ void signal<R(A ...)>::disconnect_all()
 template<typename R, typename ... A>
 void signal<R(A ...)>::emit(A ... _a) const
 {
-    core::mt::read_lock lock(m_connections_mutex);
-    typename slot_container_t::const_iterator iter;
-    auto end = m_slots.end();
-    for(iter = m_slots.begin() ; iter != end ; ++iter)
+    const std::shared_ptr<const slot_snapshot_t> slots = std::atomic_load_explicit(
+        &m_snapshot,
+        std::memory_order_acquire
+    );
+
+    if(slots)
     {
-        if((*iter)->first)
+        for(const auto& [weak_slot, state] : *slots)
         {
-            (*iter)->second.lock()->run(_a ...);
+            // The guard is declared first so that it outlives the slot, a disconnection waits for both
+            const slot_connection_base::emission_guard guard(*state);
+            if(auto slot = weak_slot.lock(); slot && guard.connected())
+            {
+                slot->run(_a ...);
+            }
         }
     }
 }
@@ -115,22 +142,21 @@ void signal<R(A ...)>::emit(A ... _a) const
 template<typename R, typename ... A>
 void signal<R(A ...)>::async_emit(A ... _a) const
 {
-    // We hold the slots alive in case they are destroyed during the emission
-    // If we don't do this, we could end up with a deadlock on m_connectionsMutex
-    // because of the automatic disconnection from this signal
-    // With this vector, we ensure the potential destruction occurs outside the scope of the mutex
-    std::vector<SPTR(slot_run_type)> keep_slots_alive;
+    // The snapshot is read without locking m_connections_mutex, the slots are kept alive by each iteration. If a
+    // slot is destroyed meanwhile, its automatic disconnection can then not deadlock on this signal.
+    const std::shared_ptr<const slot_snapshot_t> slots = std::atomic_load_explicit(
+        &m_snapshot,
+        std::memory_order_acquire
+    );
+
+    if(slots)
     {
-        core::mt::read_lock lock(m_connections_mutex);
-        typename slot_container_t::const_iterator iter;
-        auto end = m_slots.end();
-        for(iter = m_slots.begin() ; iter != end ; ++iter)
+        for(const auto& [weak_slot, state] : *slots)
         {
-            if((*iter)->first)
+            const slot_connection_base::emission_guard guard(*state);
+            if(auto slot = weak_slot.lock(); slot && guard.connected())
             {
-                auto slot = (*iter)->second.lock();
-                keep_slots_alive.push_back(slot);
-                slot->async_run(_a ...);
+                slot->async_run_detached(_a ...);
             }
         }
     }
@@ -138,6 +164,29 @@ void signal<R(A ...)>::async_emit(A ... _a) const
 
 //-----------------------------------------------------------------------------
 
+template<typename R, typename ... A>
+void signal<R(A ...)>::update_snapshot_no_lock()
+{
+    auto slots = std::make_shared<slot_snapshot_t>();
+    slots->reserve(m_slots.size());
+
+    for(const auto& [pair, state] : m_slots)
+    {
+        if(pair->first)
+        {
+            slots->emplace_back(pair->second, state);
+        }
+    }
+
+    std::atomic_store_explicit(
+        &m_snapshot,
+        std::shared_ptr<const slot_snapshot_t>(std::move(slots)),
+        std::memory_order_release
+    );
+}
+
+//-----------------------------------------------------------------------------
+
 template<typename R, typename ... A>
 template<typename FROM_F>
 connection signal<R(A ...)>::connect(slot_base::sptr _slot)
@@ -216,6 +216,9 @@ struct SIGHT_CORE_CLASS_API slot_base : virtual core::base_object
         template<typename F>
         friend struct signal;
 
+        template<typename F>
+        friend struct slot_run;
+
         template<typename T, typename R>
         friend struct util::weak_call;
 
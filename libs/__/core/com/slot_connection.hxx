@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -73,7 +73,8 @@ template<typename ... A>
 inline void slot_connection<void(A ...)>::connect_no_lock()
 {
     signal_sptr_type sig(m_signal);
-    sig->m_slots.push_back(&m_pair);
+    sig->m_slots.emplace_back(&m_pair, m_emission_state);
+    sig->update_snapshot_no_lock();
 }
 
 //-----------------------------------------------------------------------------
@@ -81,7 +82,11 @@ inline void slot_connection<void(A ...)>::connect_no_lock()
 template<typename ... A>
 inline void slot_connection<void(A ...)>::disconnect_signal_no_lock(const signal_sptr_type& _sig)
 {
-    _sig->m_slots.remove(&m_pair);
+    _sig->m_slots.remove_if([this](const auto& _slot){return _slot.first == &m_pair;});
+    _sig->update_snapshot_no_lock();
+
+    // Emissions which already loaded the previous snapshot skip the slot from now on
+    m_emission_state->connected = false;
     _sig->m_connections.erase(m_connected_slot);
 }
 
@@ -108,27 +113,32 @@ inline void slot_connection<void(A ...)>::disconnect_slot_no_lock(const slot_bas
 template<typename ... A>
 inline void slot_connection<void(A ...)>::disconnect()
 {
-    core::mt::write_lock lock(m_mutex);
+    {
+        core::mt::write_lock lock(m_mutex);
 
-    signal_sptr_type sig(m_signal.lock());
-    slot_base::sptr slot(m_connected_slot.lock());
+        signal_sptr_type sig(m_signal.lock());
+        slot_base::sptr slot(m_connected_slot.lock());
 
-    if(sig)
-    {
-        core::mt::write_lock lock_connection(sig->m_connections_mutex);
-        this->disconnect_signal_no_lock(sig);
-    }
+        if(sig)
+        {
+            core::mt::write_lock lock_connection(sig->m_connections_mutex);
+            this->disconnect_signal_no_lock(sig);
+        }
 
-    m_slot_wrapper.reset();
+        m_slot_wrapper.reset();
 
-    if(slot)
-    {
-        core::mt::write_lock lock_connection(slot->m_connections_mutex);
-        this->disconnect_slot_no_lock(slot);
+        if(slot)
+        {
+            core::mt::write_lock lock_connection(slot->m_connections_mutex);
+            this->disconnect_slot_no_lock(slot);
+        }
+
+        m_signal.reset();
+        m_connected_slot.reset();
     }
 
-    m_signal.reset();
-    m_connected_slot.reset();
+    // Emissions do not lock the connections, so they are waited for once the slot can not be run anymore
+    m_emission_state->wait_for_emissions();
 }
 
 //-----------------------------------------------------------------------------
@@ -181,8 +191,9 @@ inline slot_connection_base::blocker_sptr_type slot_connection<void(A ...)>::get
 
             // signal has to be locked : signal got a pointer on m_pair
             signal_sptr_type sig(m_signal);
-            core::mt::read_lock lock_connection(sig->m_connections_mutex);
+            core::mt::write_lock lock_connection(sig->m_connections_mutex);
             m_pair.first = false;
+            sig->update_snapshot_no_lock();
         }
     }
 
@@ -197,8 +208,9 @@ inline void slot_connection<void(A ...)>::unblock()
     core::mt::write_lock lock(m_mutex);
     // signal has to be locked : signal got a pointer on m_pair
     signal_sptr_type sig(m_signal);
-    core::mt::read_lock connection_lock(sig->m_connections_mutex);
+    core::mt::write_lock connection_lock(sig->m_connections_mutex);
     m_pair.first = true;
+    sig->update_snapshot_no_lock();
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/com/slot_connection_base.hpp"
+
+namespace sight::core::com
+{
+
+namespace
+{
+
+/// Innermost emission run by the current thread
+thread_local const slot_connection_base::emission_guard* g_current_emission = nullptr;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+void slot_connection_base::emission_state::wait_for_emissions() const
+{
+    // Emissions of the slot run by this thread can not be waited for
+    std::size_t own = 0;
+    for(const auto* emission = g_current_emission ; emission != nullptr ; emission = emission->m_previous)
+    {
+        if(&emission->m_state == this)
+        {
+            ++own;
+        }
+    }
+
+    for(std::size_t running = in_flight.load() ; running > own ; running = in_flight.load())
+    {
+        in_flight.wait(running);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+slot_connection_base::emission_guard::emission_guard(emission_state& _state) :
+    m_state(_state),
+    m_previous(g_current_emission)
+{
+    ++m_state.in_flight;
+    g_current_emission = this;
+}
+
+//-----------------------------------------------------------------------------
+
+slot_connection_base::emission_guard::~emission_guard()
+{
+    g_current_emission = m_previous;
+
+    // A disconnection may be waiting for this emission
+    --m_state.in_flight;
+    if(!m_state.connected.load())
+    {
+        m_state.in_flight.notify_all();
+    }
+}
+
+} // namespace sight::core::com
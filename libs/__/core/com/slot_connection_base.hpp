@@ -26,6 +26,9 @@
 
 #include <core/base_object.hpp>
 
+#include <atomic>
+#include <cstddef>
+
 namespace sight::core::com
 {
 
@@ -47,6 +50,54 @@ struct SIGHT_CORE_CLASS_API slot_connection_base : core::base_object
     using blocker_wptr_type = std::weak_ptr<void>;
     /**  @} */
 
+    /**
+     * @brief State of a connection shared with the emissions of its signal.
+     *
+     * Emissions do not lock the connections of the signal, so a disconnection waits for the emissions which are
+     * running the slot, through this state.
+     */
+    struct emission_state
+    {
+        /// Number of emissions running the slot
+        std::atomic_size_t in_flight {0};
+
+        /// Cleared on disconnection, so that the emissions which have not started the slot yet skip it
+        std::atomic_bool connected {true};
+
+        /// Waits for the emissions which are running the slot, once disconnected. The ones run by the calling thread
+        /// are not waited for, as a slot may disconnect itself.
+        SIGHT_CORE_API void wait_for_emissions() const;
+    };
+
+    /// Marks an emission of a slot as running, as long as it lives
+    class emission_guard final
+    {
+    public:
+
+        emission_guard(const emission_guard&)            = delete;
+        emission_guard(emission_guard&&)                 = delete;
+        emission_guard& operator=(const emission_guard&) = delete;
+        emission_guard& operator=(emission_guard&&)      = delete;
+
+        SIGHT_CORE_API explicit emission_guard(emission_state& _state);
+        SIGHT_CORE_API ~emission_guard();
+
+        /// Returns false if the connection has been disconnected before the emission started, the slot must be skipped
+        [[nodiscard]] bool connected() const
+        {
+            return m_state.connected.load();
+        }
+
+    private:
+
+        friend struct emission_state;
+
+        emission_state& m_state;
+
+        /// Enclosing emission of the same thread, if any
+        const emission_guard* const m_previous;
+    };
+
     slot_connection_base()
     = default;
 
@@ -76,6 +127,9 @@ struct SIGHT_CORE_CLASS_API slot_connection_base : core::base_object
 
         /// *NOT THREAD SAFE* Connect the related Signal and Slot together.
         virtual void connect_no_lock() = 0;
+
+        /// State shared with the emissions
+        const std::shared_ptr<emission_state> m_emission_state {std::make_shared<emission_state>()};
 };
 
 } // namespace sight::core::com
@@ -90,6 +90,18 @@ struct SIGHT_CORE_CLASS_API slot_run<void(A ...)>: slot_base
      */
     virtual slot_base::void_shared_future_type async_run(A ... _args) const;
 
+    /**
+     * @brief Run the Slot with the given parameters asynchronously, without any way to wait for the result.
+     * The execution of this slot will occur on it's own worker.
+     *
+     * Unlike async_run(), this does not allocate memory for the call itself, the task is built in a recycled node.
+     * Exceptions thrown by the slot are ignored, like they are when the future returned by async_run() is discarded.
+     * @pre Slot's worker must be set.
+     *
+     * @throws NoWorker if slot has no worker set.
+     */
+    virtual void async_run_detached(A ... _args) const;
+
     protected:
 
         template<typename R, typename WEAKCALL>
@@ -101,6 +113,12 @@ struct SIGHT_CORE_CLASS_API slot_run<void(A ...)>: slot_base
          * @return a void() function.
          */
         virtual std::function<void()> bind_run(A ... _args) const;
+
+        /// Task posted by async_run_detached(), recycled once run
+        struct detached_task;
+
+        /// Runs a task posted by async_run_detached() and recycles it
+        static void run_detached(detached_task* _task);
 };
 
 } // namespace sight::core::com
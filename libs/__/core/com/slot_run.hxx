@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2019 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -28,6 +28,7 @@
 
 #include "core/com/exception/no_worker.hpp"
 #include "core/com/slot_base.hxx"
+#include "core/com/util/node_pool.hpp"
 #include "core/com/util/weak_call.hpp"
 
 #include <core/mt/types.hpp>
@@ -35,6 +36,9 @@
 #include <core/thread/worker.hpp>
 
 #include <future>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 
 namespace sight::core::com
 {
@@ -108,6 +112,102 @@ inline slot_base::void_shared_future_type slot_run<void(A ...)>::async_run(A ...
 
 //-----------------------------------------------------------------------------
 
+template<typename ... A>
+struct slot_run<void(A ...)>::detached_task
+{
+    /// Slot called, or source slot if this one is a wrapper. The call is skipped if it has been destroyed.
+    std::weak_ptr<const slot_base> callee;
+
+    /// Keeps a wrapper alive until the call, the signal may have been disconnected meanwhile
+    std::shared_ptr<const slot_base> wrapper;
+
+    /// Worker of the slot when the task was posted, the call is skipped if it has changed
+    std::weak_ptr<core::thread::worker> worker;
+
+    const slot_run<void(A ...)>* slot {nullptr};
+    std::optional<std::tuple<std::decay_t<A>...> > args;
+
+    detached_task* next {nullptr};
+};
+
+//-----------------------------------------------------------------------------
+
+template<typename ... A>
+inline void slot_run<void(A ...)>::async_run_detached(A ... _args) const
+{
+    using pool_t = core::com::util::node_pool<detached_task>;
+
+    core::mt::read_lock lock(this->m_worker_mutex);
+
+    if(!this->m_worker)
+    {
+        SIGHT_THROW_EXCEPTION(core::com::exception::no_worker("Slot has no worker set."));
+    }
+
+    detached_task* task = pool_t::acquire();
+    task->slot   = this;
+    task->worker = this->m_worker;
+    task->args.emplace(std::move(_args)...);
+
+    if(const auto& source_slot = this->m_source_slot.lock(); source_slot)
+    {
+        task->callee  = source_slot;
+        task->wrapper = std::dynamic_pointer_cast<const slot_base>(this->shared_from_this());
+    }
+    else
+    {
+        task->callee = std::dynamic_pointer_cast<const slot_base>(this->shared_from_this());
+    }
+
+    // Only a pointer is captured, so that the std::function does not allocate
+    this->m_worker->post([task]{run_detached(task);});
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename ... A>
+inline void slot_run<void(A ...)>::run_detached(detached_task* _task)
+{
+    using pool_t = core::com::util::node_pool<detached_task>;
+
+    const auto callee  = _task->callee.lock();
+    const auto wrapper = std::move(_task->wrapper);
+    const auto worker  = _task->worker.lock();
+    const auto* slot   = _task->slot;
+    auto args          = std::move(*_task->args);
+
+    _task->callee.reset();
+    _task->wrapper.reset();
+    _task->worker.reset();
+    _task->slot = nullptr;
+    _task->args.reset();
+    pool_t::release(_task);
+
+    if(!callee)
+    {
+        return;
+    }
+
+    core::mt::read_lock lock(callee->m_worker_mutex);
+
+    if(worker && callee->m_worker != worker)
+    {
+        // Worker changed since the task has been posted
+        return;
+    }
+
+    try
+    {
+        std::apply([slot](auto&& ... _a){slot->run(std::forward<decltype(_a)>(_a)...);}, std::move(args));
+    }
+    catch(...)
+    {
+        // Ignored, as it would be in the discarded future of async_run()
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 // Copied from core::thread::worker because of issues with gcc 4.2 and template
 // keyword
 template<typename ... A>
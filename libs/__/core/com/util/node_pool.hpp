@@ -0,0 +1,94 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+namespace sight::core::com::util
+{
+
+/**
+ * @brief Pool of nodes recycled between asynchronous calls, to avoid a heap allocation on each call.
+ *
+ * NODE must be default constructible and have a `NODE* next` member, used to chain the free nodes. Nodes are shared
+ * by all the callers of a given NODE type, and at most MAX_FREE free nodes are kept.
+ * @note This class is thread-safe.
+ */
+template<typename NODE, std::size_t MAX_FREE = 1024>
+class node_pool
+{
+public:
+
+    /// Returns a free node, allocated only if the pool is empty
+    static NODE* acquire()
+    {
+        node_pool& pool = instance();
+        {
+            std::lock_guard lock(pool.m_mutex);
+            if(NODE* node = pool.m_free; node != nullptr)
+            {
+                pool.m_free = node->next;
+                --pool.m_nb_free;
+                node->next = nullptr;
+                return node;
+            }
+        }
+
+        return new NODE();
+    }
+
+    /// Gives back a node, it must have been reset by the caller
+    static void release(NODE* _node)
+    {
+        node_pool& pool = instance();
+        {
+            std::lock_guard lock(pool.m_mutex);
+            if(pool.m_nb_free < MAX_FREE)
+            {
+                _node->next = pool.m_free;
+                pool.m_free = _node;
+                ++pool.m_nb_free;
+                return;
+            }
+        }
+
+        delete _node;
+    }
+
+private:
+
+    //------------------------------------------------------------------------------
+
+    static node_pool& instance()
+    {
+        // Never destroyed, since nodes may be released by worker threads during the static destruction
+        static auto* const s_POOL = new node_pool();
+        return *s_POOL;
+    }
+
+    std::mutex m_mutex;
+    NODE* m_free {nullptr};
+    std::size_t m_nb_free {0};
+};
+
+} // namespace sight::core::com::util
@@ -43,6 +43,12 @@ public:
     SIGHT_CORE_API virtual void reallocate(buffer_t& _buffer, size_type _size) = 0;
     SIGHT_CORE_API virtual void destroy(buffer_t& _buffer)                     = 0;
 
+    /// Returns false if the buffer manager must not dump the buffers of this policy
+    [[nodiscard]] virtual bool is_dumpable() const
+    {
+        return true;
+    }
+
     SIGHT_CORE_API virtual ~buffer_allocation_policy()
     = default;
 };
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2015 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -22,6 +22,9 @@
 
 #include "core/memory/buffer_info.hpp"
 
+#include "core/memory/compressed_buffer.hpp"
+#include "core/memory/mapped_file.hpp"
+
 namespace sight::core::memory
 {
 
@@ -43,6 +46,10 @@ void buffer_info::clear()
     last_access = core::logic_stamp();
     buffer_policy.reset();
     istream_factory.reset();
+    mapping.reset();
+    compressed.reset();
+    prefetch.reset();
+    prefetched = false;
 }
 
 } // namespace sight::core::memory
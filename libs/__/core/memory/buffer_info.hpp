@@ -32,16 +32,45 @@
 #include <core/logic_stamp.hpp>
 #include <core/macros.hpp>
 
+#include <atomic>
 #include <filesystem>
 
 namespace sight::core::memory
 {
 
+class compressed_buffer;
+class mapped_file;
+struct buffer_prefetch;
+
 struct SIGHT_CORE_CLASS_API buffer_info
 {
     using size_t       = std::size_t;
     using counter_type = std::weak_ptr<void>;
 
+    /**
+     * @brief Lock counter shared between the buffer_manager and the buffer_object.
+     *
+     * It allows to lock a resident buffer from any thread without going through the buffer_manager worker. The
+     * highest bit is set when this fast path is disabled, i.e. when the buffer is not loaded or when the dump policy
+     * needs to be notified of locks. The remaining bits hold the number of locks taken on the fast path.
+     */
+    struct resident_lock
+    {
+        static constexpr std::uint64_t DISABLED = std::uint64_t(1) << 63;
+
+        //------------------------------------------------------------------------------
+
+        std::int64_t count() const
+        {
+            return static_cast<std::int64_t>(state.load(std::memory_order_acquire) & ~DISABLED);
+        }
+
+        std::atomic<std::uint64_t> state {DISABLED};
+
+        /// Set when a lock is taken on the fast path, the last access of the buffer is then updated by the worker
+        std::atomic<bool> accessed {false};
+    };
+
     SIGHT_CORE_API buffer_info();
 
     SIGHT_CORE_API void clear();
@@ -49,7 +78,7 @@ struct SIGHT_CORE_CLASS_API buffer_info
 
     std::int64_t lock_count() const
     {
-        return lock_counter.use_count();
+        return lock_counter.use_count() + (fast_lock ? fast_lock->count() : 0);
     }
 
     size_t size {0};
@@ -66,6 +95,21 @@ struct SIGHT_CORE_CLASS_API buffer_info
     core::memory::buffer_allocation_policy::sptr buffer_policy;
 
     SPTR(core::memory::stream::in::factory) istream_factory;
+
+    /// Mapping of the dumped file when the buffer has been restored by mapping it, the buffer points into it
+    SPTR(core::memory::mapped_file) mapping;
+
+    /// Content of the buffer when it has been dumped in the compressed tier, see buffer_manager
+    SPTR(core::memory::compressed_buffer) compressed;
+
+    /// Restore started ahead of the next lock, see buffer_manager::prefetch_buffer()
+    SPTR(core::memory::buffer_prefetch) prefetch;
+
+    /// true if the buffer has been restored ahead and has not been locked since
+    bool prefetched {false};
+
+    /// Shared with the buffer_object, kept across clear() since it is bound to the buffer pointer
+    SPTR(resident_lock) fast_lock {std::make_shared<resident_lock>()};
 };
 
 } // namespace sight::core::memory
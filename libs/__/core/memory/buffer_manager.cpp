@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -22,17 +22,22 @@
 
 #include "core/memory/buffer_manager.hpp"
 
+#include "core/memory/compressed_buffer.hpp"
+#include "core/memory/mapped_file.hpp"
 #include "core/memory/policy/never_dump.hpp"
 #include "core/memory/stream/in/buffer.hpp"
+#include "core/memory/stream/in/compressed.hpp"
 #include "core/memory/stream/in/raw.hpp"
 
 #include <core/com/signal.hxx>
 #include <core/lazy_instantiator.hpp>
 #include <core/os/temp_path.hpp>
+#include <core/spy_log.hpp>
 #include <core/thread/worker.hpp>
 #include <core/tools/system.hpp>
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -43,6 +48,26 @@
 namespace sight::core::memory
 {
 
+/// zstd level used by the compressed tier, favors speed since dumps and restores are on the critical path
+static constexpr int COMPRESSED_TIER_LEVEL = 1;
+
+/// Data read ahead by buffer_manager::prefetch_buffer()
+struct buffer_prefetch
+{
+    SPTR(core::memory::stream::in::factory) istream_factory;
+    buffer_info::size_t size {0};
+    core::memory::buffer_allocation_policy::sptr buffer_policy;
+
+    /// Read data, owned by the prefetch until it is installed or released
+    buffer_manager::buffer_t buffer {nullptr};
+
+    /// Set by the prefetch thread once the read is over
+    std::promise<void> done;
+    std::shared_future<void> read {done.get_future()};
+};
+
+//-----------------------------------------------------------------------------
+
 SPTR(void) get_lock(const buffer_manager::sptr& _manager, buffer_manager::const_buffer_ptr_t _buffer_ptr)
 {
     return _manager->lock_buffer(_buffer_ptr).get();
@@ -68,23 +93,33 @@ buffer_manager::buffer_manager() :
 
 buffer_manager::~buffer_manager()
 {
+    if(m_prefetch_worker)
+    {
+        m_prefetch_worker->stop();
+    }
+
     m_worker->stop();
     // TODO restore dumped buffers
 }
 
 //-----------------------------------------------------------------------------
 
-std::shared_future<void> buffer_manager::register_buffer(buffer_manager::buffer_ptr_t _buffer_ptr)
+std::shared_future<SPTR(buffer_info::resident_lock)> buffer_manager::register_buffer(
+    buffer_manager::buffer_ptr_t _buffer_ptr
+)
 {
-    return m_worker->post_task<void>([this, _buffer_ptr](auto&& ...){register_buffer_impl(_buffer_ptr);});
+    return m_worker->post_task<SPTR(buffer_info::resident_lock)>(
+        [this, _buffer_ptr](auto&& ...){return register_buffer_impl(_buffer_ptr);});
 }
 
 //------------------------------------------------------------------------------
 
-void buffer_manager::register_buffer_impl(buffer_manager::buffer_ptr_t _buffer_ptr)
+SPTR(buffer_info::resident_lock) buffer_manager::register_buffer_impl(buffer_manager::buffer_ptr_t _buffer_ptr)
 {
-    m_buffer_infos.insert(buffer_info_map_t::value_type(_buffer_ptr, buffer_info()));
+    buffer_info& info = m_buffer_infos.insert(buffer_info_map_t::value_type(_buffer_ptr, buffer_info())).first->second;
+    this->update_resident_lock(info, _buffer_ptr);
     m_updated_sig->async_emit();
+    return info.fast_lock;
 }
 
 //-----------------------------------------------------------------------------
@@ -101,9 +136,14 @@ void buffer_manager::unregister_buffer_impl(buffer_manager::buffer_ptr_t _buffer
     SIGHT_ASSERT(
         "There are still " << m_buffer_infos[_buffer_ptr].lock_count() << " locks on this BufferObject ("
         << this << ")",
-        m_buffer_infos[_buffer_ptr].lock_counter.expired()
+        m_buffer_infos[_buffer_ptr].lock_count() == 0
     );
 
+    // The buffer_object may still hold the counter, make sure it can not be used anymore
+    m_buffer_infos[_buffer_ptr].fast_lock->state.fetch_or(
+        buffer_info::resident_lock::DISABLED,
+        std::memory_order_acq_rel
+    );
     m_buffer_infos.erase(_buffer_ptr);
     m_updated_sig->async_emit();
 }
@@ -160,6 +200,7 @@ void buffer_manager::allocate_buffer_impl(
     info.last_access.modified();
     info.size          = _size;
     info.buffer_policy = _policy;
+    this->update_resident_lock(info, _buffer_ptr);
     m_updated_sig->async_emit();
 }
 
@@ -212,6 +253,7 @@ void buffer_manager::set_buffer_impl(
             _size,
             [capture0 = this->get_sptr(), _buffer_ptr](auto&& ...){return get_lock(capture0, _buffer_ptr);});
     info.user_stream_factory = false;
+    this->update_resident_lock(info, _buffer_ptr);
     m_updated_sig->async_emit();
 }
 
@@ -240,7 +282,16 @@ void buffer_manager::reallocate_buffer_impl(buffer_manager::buffer_ptr_t _buffer
 
     try
     {
-        if(info.loaded)
+        if(info.mapping)
+        {
+            // A mapped buffer can not be resized in place, move it to a buffer owned by the allocation policy
+            buffer_t buffer = nullptr;
+            info.buffer_policy->allocate(buffer, _new_size);
+            std::memcpy(buffer, *_buffer_ptr, std::min(info.size, _new_size));
+            info.mapping.reset();
+            *_buffer_ptr = buffer;
+        }
+        else if(info.loaded)
         {
             info.buffer_policy->reallocate(*_buffer_ptr, _new_size);
         }
@@ -263,6 +314,7 @@ void buffer_manager::reallocate_buffer_impl(buffer_manager::buffer_ptr_t _buffer
 
     info.last_access.modified();
     info.size = _new_size;
+    this->update_resident_lock(info, _buffer_ptr);
 
     m_updated_sig->async_emit();
 }
@@ -282,10 +334,20 @@ void buffer_manager::destroy_buffer_impl(buffer_manager::buffer_ptr_t _buffer_pt
     SIGHT_ASSERT("Buffer must be allocated or dumped", (*_buffer_ptr != nullptr) || !info.loaded);
 
     m_dump_policy->destroy_request(info, _buffer_ptr);
-    info.buffer_policy->destroy(*_buffer_ptr);
+
+    if(info.mapping)
+    {
+        info.mapping.reset();
+        *_buffer_ptr = nullptr;
+    }
+    else
+    {
+        info.buffer_policy->destroy(*_buffer_ptr);
+    }
 
     info.clear();
     info.last_access.modified();
+    this->update_resident_lock(info, _buffer_ptr);
     m_updated_sig->async_emit();
 }
 
@@ -310,11 +372,28 @@ void buffer_manager::swap_buffer_impl(buffer_manager::buffer_ptr_t _buf_a, buffe
     std::swap(info_a.size, info_b.size);
     std::swap(info_a.loaded, info_b.loaded);
     std::swap(info_a.fs_file, info_b.fs_file);
+    std::swap(info_a.file_format, info_b.file_format);
+    std::swap(info_a.mapping, info_b.mapping);
+    std::swap(info_a.compressed, info_b.compressed);
+    std::swap(info_a.prefetch, info_b.prefetch);
+    std::swap(info_a.prefetched, info_b.prefetched);
     std::swap(info_a.buffer_policy, info_b.buffer_policy);
     std::swap(info_a.istream_factory, info_b.istream_factory);
     std::swap(info_a.user_stream_factory, info_b.user_stream_factory);
     info_a.last_access.modified();
     info_b.last_access.modified();
+    this->update_resident_lock(info_a, _buf_a);
+    this->update_resident_lock(info_b, _buf_b);
+
+    // Entries of the compressed tier are bound to the buffer pointers
+    for(auto* const buffer_ptr : {_buf_a, _buf_b})
+    {
+        const buffer_info& info = m_buffer_infos[buffer_ptr];
+        if(info.compressed)
+        {
+            m_compressed_queue.emplace_back(buffer_ptr, info.compressed);
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -373,6 +452,14 @@ SPTR(void) buffer_manager::lock_buffer_impl(buffer_manager::const_buffer_ptr_t _
 
     m_dump_policy->lock_request(info, _buffer_ptr);
 
+    if(info.prefetched)
+    {
+        // First lock since the buffer has been prefetched, it is resident thanks to the prefetch
+        info.prefetched = false;
+        ++m_stats.restore_hits;
+        this->update_resident_lock(info, _buffer_ptr);
+    }
+
     SPTR(void) counter = info.lock_counter.lock();
     if(!counter)
     {
@@ -380,6 +467,8 @@ SPTR(void) buffer_manager::lock_buffer_impl(buffer_manager::const_buffer_ptr_t _
         info.lock_counter = counter;
     }
 
+    buffer_manager::record_resident_access(info);
+    info.last_access.modified();
     m_last_access.modified();
 
     m_updated_sig->async_emit();
@@ -389,6 +478,131 @@ SPTR(void) buffer_manager::lock_buffer_impl(buffer_manager::const_buffer_ptr_t _
 
 //-----------------------------------------------------------------------------
 
+struct resident_unlock
+{
+    resident_unlock(
+        buffer_manager::sptr _manager,
+        buffer_manager::const_buffer_ptr_t _buffer_ptr,
+        SPTR(buffer_info::resident_lock) _lock
+    ) :
+        m_manager(std::move(_manager)),
+        m_buffer_ptr(_buffer_ptr),
+        m_lock(std::move(_lock))
+    {
+    }
+
+    ~resident_unlock()
+    {
+        const std::uint64_t previous = m_lock->state.fetch_sub(1, std::memory_order_release);
+
+        // The fast path has been disabled while the buffer was locked, the dump policy has then been notified of the
+        // locks held as a single one, so it is notified of its release with the last of them
+        if(previous == (buffer_info::resident_lock::DISABLED | 1))
+        {
+            m_manager->unlock_buffer(m_buffer_ptr);
+        }
+    }
+
+    buffer_manager::sptr m_manager;
+    buffer_manager::const_buffer_ptr_t m_buffer_ptr;
+    SPTR(buffer_info::resident_lock) m_lock;
+};
+
+//------------------------------------------------------------------------------
+
+SPTR(void) buffer_manager::try_lock_resident(
+    buffer_manager::const_buffer_ptr_t _buffer_ptr,
+    const SPTR(buffer_info::resident_lock)& _lock
+)
+{
+    if(!_lock)
+    {
+        return nullptr;
+    }
+
+    std::uint64_t current = _lock->state.load(std::memory_order_relaxed);
+    do
+    {
+        if((current & buffer_info::resident_lock::DISABLED) != 0)
+        {
+            return nullptr;
+        }
+    }
+    while(!_lock->state.compare_exchange_weak(
+              current,
+              current + 1,
+              std::memory_order_acquire,
+              std::memory_order_relaxed
+    ));
+
+    // The access is recorded by the worker, avoid writing the flag at each lock
+    if(!_lock->accessed.load(std::memory_order_relaxed))
+    {
+        _lock->accessed.store(true, std::memory_order_relaxed);
+    }
+
+    return std::make_shared<resident_unlock>(this->get_sptr(), _buffer_ptr, _lock);
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager::update_resident_lock(buffer_info& _info, buffer_manager::const_buffer_ptr_t _buffer_ptr) const
+{
+    // Prefetched buffers go through the worker on their first lock so that hits are counted
+    if(_info.loaded && !_info.prefetched && !m_dump_policy->needs_lock_notification())
+    {
+        // If locks taken before the fast path was disabled are still held, it is enabled again by the release of the
+        // last of them, once the dump policy has been notified
+        std::uint64_t expected = buffer_info::resident_lock::DISABLED;
+        _info.fast_lock->state.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+    }
+    else
+    {
+        const std::uint64_t previous =
+            _info.fast_lock->state.fetch_or(buffer_info::resident_lock::DISABLED, std::memory_order_acq_rel);
+
+        // The dump policy did not see the locks held on the fast path, it is notified of them as a single lock
+        if(previous != 0 && (previous & buffer_info::resident_lock::DISABLED) == 0)
+        {
+            m_dump_policy->lock_request(_info, _buffer_ptr);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool buffer_manager::acquire_resident_lock(buffer_info& _info)
+{
+    // Once disabled, no lock can be taken anymore on the fast path, so it is only disabled if no lock is held
+    std::uint64_t current = _info.fast_lock->state.load(std::memory_order_acquire);
+    while((current & ~buffer_info::resident_lock::DISABLED) == 0)
+    {
+        if(_info.fast_lock->state.compare_exchange_weak(
+               current,
+               buffer_info::resident_lock::DISABLED,
+               std::memory_order_acq_rel,
+               std::memory_order_acquire
+        ))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager::record_resident_access(buffer_info& _info)
+{
+    if(_info.fast_lock->accessed.exchange(false, std::memory_order_relaxed))
+    {
+        _info.last_access.modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 std::shared_future<bool> buffer_manager::unlock_buffer(buffer_manager::const_buffer_ptr_t _buffer_ptr)
 {
     return m_worker->post_task<bool>([this, _buffer_ptr](auto&& ...){return unlock_buffer_impl(_buffer_ptr);});
@@ -401,6 +615,10 @@ bool buffer_manager::unlock_buffer_impl(buffer_manager::const_buffer_ptr_t _buff
     buffer_info& info = m_buffer_infos[_buffer_ptr];
     m_dump_policy->unlock_request(info, _buffer_ptr);
 
+    // This may be the release of the last lock taken on the fast path before it was disabled
+    buffer_manager::record_resident_access(info);
+    this->update_resident_lock(info, _buffer_ptr);
+
     m_updated_sig->async_emit();
     return true;
 }
@@ -426,30 +644,76 @@ bool buffer_manager::dump_buffer_impl(buffer_manager::const_buffer_ptr_t _buffer
 
 bool buffer_manager::dump_buffer(buffer_info& _info, buffer_manager::buffer_ptr_t _buffer_ptr)
 {
-    if(!_info.loaded || _info.lock_count() > 0 || _info.size == 0)
+    if(!_info.loaded || _info.lock_count() > 0 || _info.size == 0
+       || (_info.buffer_policy && !_info.buffer_policy->is_dumpable()))
     {
         return false;
     }
 
-    const std::filesystem::path& dumped_file = core::os::temp_file::unique_path();
+    if(!buffer_manager::acquire_resident_lock(_info))
+    {
+        // The buffer has been locked on the fast path in the meantime
+        return false;
+    }
 
     _info.lock_counter.reset();
 
-    if(sight::core::memory::buffer_manager::write_buffer_impl(*_buffer_ptr, _info.size, dumped_file))
+    bool dumped = false;
+
+    if(_info.mapping)
+    {
+        // The buffer already lives in its file, which is kept up to date by the system
+        _info.fs_file = _info.mapping->file();
+        _info.mapping.reset();
+        *_buffer_ptr = nullptr;
+        dumped       = true;
+    }
+    else if(m_compressed_capacity > 0 && this->compress_buffer(_info, _buffer_ptr))
     {
-        _info.fs_file             = core::memory::file_holder(dumped_file, true);
-        _info.file_format         = core::memory::raw;
-        _info.istream_factory     = std::make_shared<core::memory::stream::in::raw>(_info.fs_file);
-        _info.user_stream_factory = false;
         _info.buffer_policy->destroy(*_buffer_ptr);
         *_buffer_ptr = nullptr;
-        _info.loaded = false;
+        dumped       = true;
+    }
+    else
+    {
+        const std::filesystem::path& dumped_file = core::os::temp_file::unique_path();
+
+        if(sight::core::memory::buffer_manager::write_buffer_impl(*_buffer_ptr, _info.size, dumped_file))
+        {
+            _info.fs_file = core::memory::file_holder(dumped_file, true);
+            _info.buffer_policy->destroy(*_buffer_ptr);
+            *_buffer_ptr      = nullptr;
+            dumped            = true;
+            m_stats.dumped_bytes += _info.size;
+        }
+    }
+
+    if(dumped)
+    {
+        if(_info.compressed)
+        {
+            _info.file_format     = core::memory::other;
+            _info.istream_factory = std::make_shared<core::memory::stream::in::compressed>(_info.compressed);
+        }
+        else
+        {
+            _info.file_format = m_dump_backend == buffer_manager::mapped_backend
+                                ? core::memory::mapped
+                                : core::memory::raw;
+            _info.istream_factory = std::make_shared<core::memory::stream::in::raw>(_info.fs_file);
+        }
+
+        _info.user_stream_factory = false;
+        _info.loaded              = false;
+        _info.prefetched          = false;
 
         m_dump_policy->dump_success(_info, _buffer_ptr);
 
         m_updated_sig->async_emit();
     }
 
+    this->update_resident_lock(_info, _buffer_ptr);
+
     return !_info.loaded;
 }
 
@@ -481,43 +745,84 @@ bool buffer_manager::restore_buffer(
     _alloc_size = ((_alloc_size) != 0U ? _alloc_size : _info.size);
     if(!_info.loaded)
     {
-        if(*_buffer_ptr == nullptr)
+        const auto start = std::chrono::steady_clock::now();
+
+        bool not_failed = false;
+
+        if(_info.prefetch)
+        {
+            // A prefetch can only be used if the buffer keeps its size, otherwise it is released when its read ends
+            if(_alloc_size == _info.size && *_buffer_ptr == nullptr)
+            {
+                not_failed = this->install_prefetch(_info, _buffer_ptr);
+            }
+            else
+            {
+                _info.prefetch.reset();
+            }
+        }
+
+        if(not_failed)
+        {
+            ++m_stats.restore_hits;
+        }
+        else if(_info.compressed && *_buffer_ptr == nullptr && _alloc_size == _info.size)
         {
             _info.buffer_policy->allocate(*_buffer_ptr, _alloc_size);
+
+            try
+            {
+                _info.compressed->decompress(*_buffer_ptr);
+            }
+            catch(...)
+            {
+                _info.buffer_policy->destroy(*_buffer_ptr);
+                throw;
+            }
+
+            ++m_stats.compressed_hits;
+            not_failed = true;
         }
         else
         {
-            _info.buffer_policy->reallocate(*_buffer_ptr, _alloc_size);
+            ++m_stats.restore_misses;
+
+            // A mapped restore is only possible if the buffer keeps its size
+            not_failed = _info.file_format == core::memory::mapped
+                         && *_buffer_ptr == nullptr
+                         && _alloc_size == _info.size
+                         && buffer_manager::map_buffer(_info, _buffer_ptr);
         }
 
-        char* char_buf  = static_cast<char*>(*_buffer_ptr);
-        size_t size     = std::min(_alloc_size, _info.size);
-        bool not_failed = false;
+        if(!not_failed)
         {
+            if(*_buffer_ptr == nullptr)
+            {
+                _info.buffer_policy->allocate(*_buffer_ptr, _alloc_size);
+            }
+            else
+            {
+                _info.buffer_policy->reallocate(*_buffer_ptr, _alloc_size);
+            }
+
+            char* char_buf = static_cast<char*>(*_buffer_ptr);
+            size_t size    = std::min(_alloc_size, _info.size);
+
             SPTR(std::istream) stream = (*_info.istream_factory)();
             std::istream& is = *stream;
             const auto read  = static_cast<size_t>(is.read(char_buf, static_cast<std::streamsize>(size)).gcount());
 
             SIGHT_THROW_IF(" Bad file size, expected: " << size << ", was: " << read, size - read != 0);
-            not_failed = !is.fail();
+            not_failed              = !is.fail();
+            m_stats.restored_bytes += read;
         }
 
         if(not_failed)
         {
-            _info.loaded = true;
-            _info.fs_file.clear();
-            _info.last_access.modified();
-
-            m_dump_policy->restore_success(_info, _buffer_ptr);
-
-            _info.file_format     = core::memory::other;
-            _info.istream_factory =
-                std::make_shared<core::memory::stream::in::buffer>(
-                    *_buffer_ptr,
-                    _alloc_size,
-                    [capture0 = this->get_sptr(), _buffer_ptr](auto&& ...){return get_lock(capture0, _buffer_ptr);});
-            _info.user_stream_factory = false;
-            m_updated_sig->async_emit();
+            this->finish_restore(_info, _buffer_ptr, _alloc_size);
+            m_stats.restore_time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start
+            );
             return true;
         }
     }
@@ -527,6 +832,307 @@ bool buffer_manager::restore_buffer(
 
 //-----------------------------------------------------------------------------
 
+void buffer_manager::finish_restore(
+    buffer_info& _info,
+    buffer_manager::buffer_ptr_t _buffer_ptr,
+    buffer_manager::size_t _size
+)
+{
+    _info.loaded = true;
+    _info.fs_file.clear();
+    _info.compressed.reset();
+    _info.last_access.modified();
+
+    m_dump_policy->restore_success(_info, _buffer_ptr);
+
+    _info.file_format     = core::memory::other;
+    _info.istream_factory =
+        std::make_shared<core::memory::stream::in::buffer>(
+            *_buffer_ptr,
+            _size,
+            [capture0 = this->get_sptr(), _buffer_ptr](auto&& ...){return get_lock(capture0, _buffer_ptr);});
+    _info.user_stream_factory = false;
+    this->update_resident_lock(_info, _buffer_ptr);
+    m_updated_sig->async_emit();
+}
+
+//-----------------------------------------------------------------------------
+
+std::shared_future<bool> buffer_manager::prefetch_buffer(buffer_manager::const_buffer_ptr_t _buffer_ptr)
+{
+    return m_worker->post_task<bool>([this, _buffer_ptr](auto&& ...){return prefetch_buffer_impl(_buffer_ptr);});
+}
+
+//------------------------------------------------------------------------------
+
+bool buffer_manager::prefetch_buffer_impl(buffer_manager::const_buffer_ptr_t _buffer_ptr)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto* casted_buffer = const_cast<buffer_manager::buffer_ptr_t>(_buffer_ptr);
+    auto iter_info      = m_buffer_infos.find(casted_buffer);
+
+    if(iter_info == m_buffer_infos.end())
+    {
+        return false;
+    }
+
+    buffer_info& info = iter_info->second;
+
+    if(info.loaded
+       || info.prefetch
+       || info.size == 0
+       || !info.istream_factory
+       || info.file_format == core::memory::mapped
+       || info.compressed
+       || !m_dump_policy->prefetch_request(info, casted_buffer))
+    {
+        return false;
+    }
+
+    if(!m_prefetch_worker)
+    {
+        m_prefetch_worker = core::thread::worker::make();
+    }
+
+    auto prefetch = std::make_shared<buffer_prefetch>();
+    prefetch->istream_factory = info.istream_factory;
+    prefetch->size            = info.size;
+    prefetch->buffer_policy   = info.buffer_policy;
+
+    info.prefetch = prefetch;
+
+    m_prefetch_worker->post(
+        [manager = this->get_sptr(), casted_buffer, prefetch]
+        {
+            try
+            {
+                prefetch->buffer_policy->allocate(prefetch->buffer, prefetch->size);
+
+                SPTR(std::istream) stream = (*prefetch->istream_factory)();
+                std::istream& is = *stream;
+                const auto read  = static_cast<size_t>(
+                    is.read(static_cast<char*>(prefetch->buffer), static_cast<std::streamsize>(prefetch->size))
+                    .gcount()
+                );
+
+                SIGHT_THROW_IF(
+                    " Bad file size, expected: " << prefetch->size << ", was: " << read,
+                    prefetch->size != read || is.fail()
+                );
+
+                prefetch->done.set_value();
+            }
+            catch(...)
+            {
+                prefetch->buffer_policy->destroy(prefetch->buffer);
+                prefetch->done.set_exception(std::current_exception());
+            }
+
+            // The completion is posted in any case so that the data is installed or released
+            manager->m_worker->post(
+                [manager, casted_buffer, prefetch]
+                {
+                    manager->complete_prefetch(casted_buffer, prefetch);
+                });
+        });
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+buffer_manager::buffer_t buffer_manager::take_prefetch(buffer_prefetch& _prefetch)
+{
+    try
+    {
+        _prefetch.read.get();
+    }
+    catch(const std::exception& e)
+    {
+        SIGHT_WARN("Unable to prefetch a buffer: " << e.what());
+        return nullptr;
+    }
+
+    m_stats.restored_bytes += _prefetch.size;
+
+    buffer_t buffer = _prefetch.buffer;
+    _prefetch.buffer = nullptr;
+    return buffer;
+}
+
+//------------------------------------------------------------------------------
+
+bool buffer_manager::install_prefetch(buffer_info& _info, buffer_manager::buffer_ptr_t _buffer_ptr)
+{
+    const SPTR(buffer_prefetch) prefetch = std::move(_info.prefetch);
+    _info.prefetch.reset();
+
+    buffer_t buffer = this->take_prefetch(*prefetch);
+
+    if(buffer == nullptr)
+    {
+        return false;
+    }
+
+    // The buffer may have been changed since the prefetch started
+    if(_info.loaded
+       || *_buffer_ptr != nullptr
+       || _info.istream_factory != prefetch->istream_factory
+       || _info.size != prefetch->size)
+    {
+        prefetch->buffer_policy->destroy(buffer);
+        return false;
+    }
+
+    *_buffer_ptr = buffer;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager::complete_prefetch(buffer_manager::buffer_ptr_t _buffer_ptr, const SPTR(buffer_prefetch)& _prefetch)
+{
+    auto iter_info = m_buffer_infos.find(_buffer_ptr);
+
+    if(iter_info != m_buffer_infos.end() && iter_info->second.prefetch == _prefetch)
+    {
+        buffer_info& info = iter_info->second;
+        if(this->install_prefetch(info, _buffer_ptr))
+        {
+            info.prefetched = true;
+            this->finish_restore(info, _buffer_ptr, info.size);
+        }
+    }
+    else
+    {
+        // The prefetch has already been consumed by a lock, or the buffer has been destroyed or resized meanwhile
+        buffer_t buffer = nullptr;
+        if(_prefetch->buffer != nullptr)
+        {
+            buffer = this->take_prefetch(*_prefetch);
+        }
+
+        if(buffer != nullptr)
+        {
+            _prefetch->buffer_policy->destroy(buffer);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+bool buffer_manager::map_buffer(buffer_info& _info, buffer_manager::buffer_ptr_t _buffer_ptr)
+{
+    try
+    {
+        _info.mapping = std::make_shared<core::memory::mapped_file>(_info.fs_file, _info.size);
+    }
+    catch(const std::exception& e)
+    {
+        SIGHT_WARN("Unable to map the dumped buffer, it will be read in full: " << e.what());
+        return false;
+    }
+
+    *_buffer_ptr = _info.mapping->data();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool buffer_manager::compress_buffer(buffer_info& _info, buffer_manager::buffer_ptr_t _buffer_ptr)
+{
+    // Buffers that are not at least halved are not worth the memory they would take in the tier
+    const size_t max_size = std::min(_info.size / 2, m_compressed_capacity);
+
+    std::unique_ptr<core::memory::compressed_buffer> compressed;
+    try
+    {
+        compressed = core::memory::compressed_buffer::compress(
+            *_buffer_ptr,
+            _info.size,
+            max_size,
+            COMPRESSED_TIER_LEVEL
+        );
+    }
+    catch(const std::exception& e)
+    {
+        SIGHT_WARN("Unable to compress the dumped buffer, it will be written to disk: " << e.what());
+        return false;
+    }
+
+    if(!compressed)
+    {
+        return false;
+    }
+
+    const size_t compressed_size = compressed->compressed_size();
+    this->spill_compressed(compressed_size);
+
+    // The usage is decreased when the last reference is released, which may happen in a stream on another thread
+    *m_compressed_size += compressed_size;
+    _info.compressed    = SPTR(core::memory::compressed_buffer)(
+        compressed.release(),
+        [usage = m_compressed_size](core::memory::compressed_buffer* _compressed)
+        {
+            *usage -= _compressed->compressed_size();
+            delete _compressed;
+        });
+
+    m_compressed_queue.emplace_back(_buffer_ptr, _info.compressed);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void buffer_manager::spill_compressed(buffer_manager::size_t _size)
+{
+    while(!m_compressed_queue.empty() && *m_compressed_size + _size > m_compressed_capacity)
+    {
+        const auto [buffer_ptr, weak_compressed] = m_compressed_queue.front();
+        m_compressed_queue.pop_front();
+
+        const SPTR(core::memory::compressed_buffer) compressed = weak_compressed.lock();
+        auto iter_info                                         = m_buffer_infos.find(buffer_ptr);
+
+        // The buffer left the tier since it has been compressed
+        if(!compressed || iter_info == m_buffer_infos.end() || iter_info->second.compressed != compressed)
+        {
+            continue;
+        }
+
+        buffer_info& info = iter_info->second;
+
+        const std::filesystem::path& dumped_file = core::os::temp_file::unique_path();
+        {
+            std::ofstream fs(dumped_file, std::ios::binary | std::ios::trunc);
+            SIGHT_THROW_IF("Memory management : Unable to open " << dumped_file, !fs.good());
+
+            SPTR(std::istream) stream = (*info.istream_factory)();
+            fs << stream->rdbuf();
+            fs.close();
+            SIGHT_THROW_IF("Memory management : Unable to write " << dumped_file, fs.bad());
+        }
+
+        info.fs_file     = core::memory::file_holder(dumped_file, true);
+        info.file_format = m_dump_backend == buffer_manager::mapped_backend
+                           ? core::memory::mapped
+                           : core::memory::raw;
+        info.istream_factory = std::make_shared<core::memory::stream::in::raw>(info.fs_file);
+        info.compressed.reset();
+
+        ++m_stats.compressed_spills;
+        m_stats.dumped_bytes += info.size;
+    }
+
+    // Drop the entries of the buffers restored in the meantime, the queue would otherwise grow with each dump
+    if(m_compressed_queue.size() > 2 * m_buffer_infos.size())
+    {
+        std::erase_if(m_compressed_queue, [](const auto& _entry){return _entry.second.expired();});
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 std::shared_future<bool> buffer_manager::write_buffer(
     buffer_manager::const_buffer_t _buffer,
     size_t _size,
@@ -639,6 +1245,27 @@ std::string buffer_manager::to_string_impl() const
 void buffer_manager::set_dump_policy(const core::memory::policy::base::sptr& _policy)
 {
     m_dump_policy = _policy;
+
+    // Locks of resident buffers may bypass the worker only if the new policy does not need to be notified
+    const auto update_resident_locks =
+        [this](auto&& ...)
+        {
+            for(auto& item : m_buffer_infos)
+            {
+                this->update_resident_lock(item.second, item.first);
+            }
+        };
+
+    // The worker can not wait for a task it would run itself
+    if(core::thread::get_current_thread_id() == m_worker->get_thread_id())
+    {
+        update_resident_locks();
+    }
+    else
+    {
+        m_worker->post_task<void>(update_resident_locks).wait();
+    }
+
     _policy->refresh();
 }
 
@@ -660,6 +1287,13 @@ std::shared_future<buffer_manager::buffer_info_map_t> buffer_manager::get_buffer
 
 buffer_manager::buffer_info_map_t buffer_manager::get_buffer_infos_impl() const
 {
+    // Locks taken on the fast path are only recorded by the worker, before the infos are read by the dump policies
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    for(auto& item : const_cast<buffer_info_map_t&>(m_buffer_infos))
+    {
+        buffer_manager::record_resident_access(item.second);
+    }
+
     return m_buffer_infos;
 }
 
@@ -668,7 +1302,17 @@ buffer_manager::buffer_info_map_t buffer_manager::get_buffer_infos_impl() const
 std::shared_future<buffer_manager::buffer_stats> buffer_manager::get_buffer_stats() const
 {
     return m_worker->post_task<buffer_manager::buffer_stats>(
-        [this](auto&& ...){return buffer_manager::compute_buffer_stats(m_buffer_infos);});
+        [this](auto&& ...)
+        {
+            buffer_stats stats = m_stats;
+            const buffer_stats sizes = buffer_manager::compute_buffer_stats(m_buffer_infos);
+            stats.total_dumped        = sizes.total_dumped;
+            stats.total_managed       = sizes.total_managed;
+            stats.total_compressed    = sizes.total_compressed;
+            stats.compressed_size     = sizes.compressed_size;
+            stats.compressed_capacity = m_compressed_capacity;
+            return stats;
+        });
 }
 
 //------------------------------------------------------------------------------
@@ -684,6 +1328,12 @@ buffer_manager::buffer_stats buffer_manager::compute_buffer_stats(const buffer_i
             stats.total_dumped += info.size;
         }
 
+        if(info.compressed)
+        {
+            stats.total_compressed += info.size;
+            stats.compressed_size  += info.compressed->compressed_size();
+        }
+
         stats.total_managed += info.size;
     }
 
@@ -698,13 +1348,14 @@ std::shared_future<void> buffer_manager::set_istream_factory(
     size_t _size,
     core::memory::file_holder _fs_file,
     core::memory::file_format_type _format,
-    const core::memory::buffer_allocation_policy::sptr& _policy
+    const core::memory::buffer_allocation_policy::sptr& _policy,
+    std::optional<loading_mode_type> _loading_mode
 )
 {
     return m_worker->post_task<void>(
-        [this, _buffer_ptr, _factory, _size, _fs_file, _format, _policy](auto&& ...)
+        [this, _buffer_ptr, _factory, _size, _fs_file, _format, _policy, _loading_mode](auto&& ...)
         {
-            set_istream_factory_impl(_buffer_ptr, _factory, _size, _fs_file, _format, _policy);
+            set_istream_factory_impl(_buffer_ptr, _factory, _size, _fs_file, _format, _policy, _loading_mode);
         });
 }
 
@@ -716,7 +1367,8 @@ void buffer_manager::set_istream_factory_impl(
     size_t _size,
     core::memory::file_holder _fs_file,
     core::memory::file_format_type _format,
-    const core::memory::buffer_allocation_policy::sptr& _policy
+    const core::memory::buffer_allocation_policy::sptr& _policy,
+    std::optional<loading_mode_type> _loading_mode
 )
 {
     auto iter_info = m_buffer_infos.find(_buffer_ptr);
@@ -734,10 +1386,11 @@ void buffer_manager::set_istream_factory_impl(
     info.file_format         = _format;
     info.buffer_policy       = _policy;
     info.loaded              = false;
+    this->update_resident_lock(info, _buffer_ptr);
 
     m_dump_policy->dump_success(info, _buffer_ptr);
 
-    switch(m_loading_mode)
+    switch(_loading_mode.value_or(m_loading_mode))
     {
         case buffer_manager::direct:
             this->restore_buffer(_buffer_ptr);
@@ -798,4 +1451,38 @@ void buffer_manager::set_loading_mode(loading_mode_type _mode)
     m_loading_mode = _mode;
 }
 
+//------------------------------------------------------------------------------
+
+buffer_manager::dump_backend_type buffer_manager::get_dump_backend() const
+{
+    return m_dump_backend;
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager::set_dump_backend(dump_backend_type _backend)
+{
+    m_dump_backend = _backend;
+}
+
+//------------------------------------------------------------------------------
+
+buffer_manager::size_t buffer_manager::get_compressed_tier_capacity() const
+{
+    return m_worker->post_task<size_t>([this](auto&& ...){return m_compressed_capacity;}).get();
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager::set_compressed_tier_capacity(size_t _capacity)
+{
+    m_worker->post_task<void>(
+        [this, _capacity](auto&& ...)
+        {
+            m_compressed_capacity = _capacity;
+            this->spill_compressed(0);
+            m_updated_sig->async_emit();
+        }).get();
+}
+
 } //namespace sight::core::memory
@@ -32,8 +32,13 @@
 #include <core/com/signal.hpp>
 #include <core/mt/types.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <future>
+#include <optional>
 
 namespace sight::core::thread
 {
@@ -105,10 +110,41 @@ public:
         lazy
     };
 
+    /// How dumped buffers are stored and restored
+    enum dump_backend_type
+    {
+        /// Dumped buffers are read back in full when they are restored
+        stream_backend,
+        /// Dumped buffers are restored by mapping their file in memory, pages are only loaded when accessed
+        mapped_backend
+    };
+
     struct buffer_stats
     {
         size_t total_dumped;
         size_t total_managed;
+
+        /// Number of restores served by a prefetch, see prefetch_buffer()
+        std::uint64_t restore_hits {0};
+        /// Number of restores that had to read the buffer synchronously
+        std::uint64_t restore_misses {0};
+        /// Cumulated time spent by callers waiting for restores
+        std::chrono::nanoseconds restore_time {0};
+        /// Number of bytes written to dump files
+        std::uint64_t dumped_bytes {0};
+        /// Number of bytes read back from dump files or user streams, prefetches included
+        std::uint64_t restored_bytes {0};
+
+        /// Uncompressed size of the buffers held by the compressed tier
+        size_t total_compressed {0};
+        /// Memory used by the compressed tier
+        size_t compressed_size {0};
+        /// Maximum memory used by the compressed tier, 0 if it is disabled
+        size_t compressed_capacity {0};
+        /// Number of restores served by the compressed tier
+        std::uint64_t compressed_hits {0};
+        /// Number of buffers moved from the compressed tier to disk to make room for newer ones
+        std::uint64_t compressed_spills {0};
     };
 
     struct stream_info
@@ -127,8 +163,12 @@ public:
      * @brief Hook called when a new BufferObject is created
      *
      * @param _buffer_ptr BufferObject's buffer pointer.
+     *
+     * @return the lock counter to give to try_lock_resident() for this buffer
      */
-    SIGHT_CORE_API virtual std::shared_future<void> register_buffer(buffer_ptr_t _buffer_ptr);
+    SIGHT_CORE_API virtual std::shared_future<SPTR(buffer_info::resident_lock)> register_buffer(
+        buffer_ptr_t _buffer_ptr
+    );
 
     /**
      * @brief Hook called when a BufferObject is destroyed
@@ -197,6 +237,23 @@ public:
      */
     SIGHT_CORE_API virtual std::shared_future<SPTR(void)> lock_buffer(const_buffer_ptr_t _buffer_ptr);
 
+    /**
+     * @brief Locks a resident buffer without going through the worker
+     *
+     * This succeeds only if the buffer is loaded and if the dump policy does not need to be notified of locks, which
+     * is the case of never_dump. Otherwise lock_buffer() must be used.
+     *
+     * @param _buffer_ptr BufferObject's buffer pointer
+     * @param _lock lock counter returned by register_buffer()
+     *
+     * @return the lock counter, or nullptr if the fast path is not available for this buffer
+     * @note This method is thread-safe and lock-free.
+     */
+    SIGHT_CORE_API SPTR(void) try_lock_resident(
+        const_buffer_ptr_t _buffer_ptr,
+        const SPTR(buffer_info::resident_lock)& _lock
+    );
+
     /**
      * @brief Hook called when a BufferObject lock is released
      *
@@ -224,6 +281,20 @@ public:
     SIGHT_CORE_API std::shared_future<bool> restore_buffer(const_buffer_ptr_t _buffer_ptr);
     /**  @} */
 
+    /**
+     * @brief Starts restoring a dumped buffer ahead of its next lock
+     *
+     * The buffer is read on a dedicated thread, so that the worker of the buffer manager is not blocked. A lock
+     * requested meanwhile waits for this read instead of restoring the buffer again. The dump policy may refuse the
+     * prefetch, see policy::base::prefetch_request(). Buffers dumped with mapped_backend or held by the compressed tier
+     * are never prefetched since their restore is already fast.
+     *
+     * @param _buffer_ptr Buffer to prefetch
+     *
+     * @return true if a prefetch has been started
+     */
+    SIGHT_CORE_API std::shared_future<bool> prefetch_buffer(const_buffer_ptr_t _buffer_ptr);
+
     /**
      * @brief Write/read a buffer
      *
@@ -291,12 +362,37 @@ public:
         size_t _size,
         core::memory::file_holder _fs_file,
         core::memory::file_format_type _format,
-        const core::memory::buffer_allocation_policy::sptr& _policy
+        const core::memory::buffer_allocation_policy::sptr& _policy,
+        std::optional<loading_mode_type> _loading_mode = std::nullopt
     );
 
     SIGHT_CORE_API loading_mode_type get_loading_mode() const;
     SIGHT_CORE_API void set_loading_mode(loading_mode_type _mode);
 
+    /**
+     * @brief Returns/sets the backend used for the next dumps
+     *
+     * With mapped_backend, a restore only maps the dumped file, and a buffer restored this way is dumped again by
+     * simply releasing its mapping.
+     * @{ */
+    SIGHT_CORE_API dump_backend_type get_dump_backend() const;
+    SIGHT_CORE_API void set_dump_backend(dump_backend_type _backend);
+    /**  @} */
+
+    /**
+     * @brief Returns/sets the memory available for the compressed tier
+     *
+     * When the capacity is not null, dumped buffers are first compressed in memory with zstd. Only buffers that are
+     * at least halved by the compression are kept in this tier, the others are written to disk. When the tier is
+     * full, its oldest buffers are moved to disk. Restoring a buffer of this tier only requires to decompress it,
+     * which is usually much faster than reading it back from disk.
+     *
+     * The tier is disabled by default. Reducing the capacity moves buffers to disk until the tier fits.
+     * @{ */
+    SIGHT_CORE_API size_t get_compressed_tier_capacity() const;
+    SIGHT_CORE_API void set_compressed_tier_capacity(size_t _capacity);
+    /**  @} */
+
     /**
      * @brief Returns the current BufferManager instance
      * @note This method is thread-safe.
@@ -315,7 +411,7 @@ protected:
     /**
      * @brief BufferManager'a Implementation
      * @{ */
-    virtual void register_buffer_impl(buffer_ptr_t _buffer_ptr);
+    virtual SPTR(buffer_info::resident_lock) register_buffer_impl(buffer_ptr_t _buffer_ptr);
     virtual void unregister_buffer_impl(buffer_ptr_t _buffer_ptr);
     virtual void allocate_buffer_impl(
         buffer_ptr_t _buffer_ptr,
@@ -336,6 +432,7 @@ protected:
     virtual std::string to_string_impl() const;
     bool dump_buffer_impl(const_buffer_ptr_t _buffer);
     bool restore_buffer_impl(const_buffer_ptr_t _buffer);
+    bool prefetch_buffer_impl(const_buffer_ptr_t _buffer_ptr);
     static bool write_buffer_impl(const_buffer_t _buffer, size_t _size, const std::filesystem::path& _path);
     static bool read_buffer_impl(buffer_t _buffer, size_t _size, const std::filesystem::path& _path);
     buffer_info_map_t get_buffer_infos_impl() const;
@@ -346,7 +443,8 @@ protected:
         size_t _size,
         core::memory::file_holder _fs_file,
         core::memory::file_format_type _format,
-        const core::memory::buffer_allocation_policy::sptr& _policy
+        const core::memory::buffer_allocation_policy::sptr& _policy,
+        std::optional<loading_mode_type> _loading_mode
     );
     /**  @} */
 
@@ -359,6 +457,67 @@ protected:
     SIGHT_CORE_API bool restore_buffer(buffer_info& _info, buffer_ptr_t _buffer_ptr, size_t _size = 0);
     /**  @} */
 
+    /**
+     * @brief Enables or disables the lock fast path of a buffer, according to its state and to the dump policy
+     *
+     * When it is disabled while locks are held on the fast path, the dump policy is notified of them as a single lock,
+     * released with the last of them.
+     */
+    void update_resident_lock(buffer_info& _info, const_buffer_ptr_t _buffer_ptr) const;
+
+    /**
+     * @brief Disables the lock fast path of a buffer before dumping it, if no lock is held on it
+     *
+     * @return true if no lock is held on the fast path, meaning the buffer can be safely dumped
+     */
+    static bool acquire_resident_lock(buffer_info& _info);
+
+    /// Updates the last access of a buffer if it has been locked on the fast path since the previous call
+    static void record_resident_access(buffer_info& _info);
+
+    /**
+     * @brief Restores a buffer dumped with mapped_backend by mapping its file
+     *
+     * @return false if the file can not be mapped, the buffer must then be read through its stream
+     */
+    static bool map_buffer(buffer_info& _info, buffer_ptr_t _buffer_ptr);
+
+    /**
+     * @brief Compresses a buffer in the compressed tier, moving older buffers to disk if needed
+     *
+     * @return false if the buffer is not compressible enough or does not fit in the tier
+     */
+    bool compress_buffer(buffer_info& _info, buffer_ptr_t _buffer_ptr);
+
+    /**
+     * @brief Moves the oldest buffers of the compressed tier to disk until _size bytes are available
+     */
+    void spill_compressed(size_t _size);
+
+    /**
+     * @brief Ends a restore: marks the buffer as loaded and notifies the dump policy
+     */
+    void finish_restore(buffer_info& _info, buffer_ptr_t _buffer_ptr, size_t _size);
+
+    /**
+     * @brief Waits for the prefetch of a buffer and installs its data
+     *
+     * The prefetch is consumed in any case, its data is released if it can not be used anymore.
+     *
+     * @return true if the buffer has been restored
+     */
+    bool install_prefetch(buffer_info& _info, buffer_ptr_t _buffer_ptr);
+
+    /**
+     * @brief Called on the worker when a prefetch read is over, installs it if no lock did it before
+     */
+    void complete_prefetch(buffer_ptr_t _buffer_ptr, const SPTR(buffer_prefetch)& _prefetch);
+
+    /**
+     * @brief Waits for a prefetch read and returns its data, or nullptr if the read failed
+     */
+    buffer_t take_prefetch(buffer_prefetch& _prefetch);
+
     SPTR(updated_signal_t) m_updated_sig;
 
     core::logic_stamp m_last_access;
@@ -368,8 +527,25 @@ protected:
 
     loading_mode_type m_loading_mode {buffer_manager::direct};
 
+    dump_backend_type m_dump_backend {buffer_manager::stream_backend};
+
+    /// Restore and dump counters, the sizes of the managed buffers are computed on demand
+    buffer_stats m_stats {0, 0};
+
     SPTR(core::thread::worker) m_worker;
 
+    /// Maximum memory used by the compressed tier, 0 if it is disabled
+    size_t m_compressed_capacity {0};
+
+    /// Memory used by the compressed tier, updated when a compressed buffer is released
+    SPTR(std::atomic<size_t>) m_compressed_size {std::make_shared<std::atomic<size_t> >(0)};
+
+    /// Buffers of the compressed tier, oldest first. Entries of buffers that left the tier are skipped.
+    std::deque<std::pair<buffer_ptr_t, std::weak_ptr<core::memory::compressed_buffer> > > m_compressed_queue;
+
+    /// Reads prefetched buffers, created on the first prefetch
+    SPTR(core::thread::worker) m_prefetch_worker;
+
     /// Mutex to protect concurrent access in BufferManager
     mutable core::mt::read_write_mutex m_mutex;
 };
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -30,7 +30,7 @@ buffer_object::buffer_object(bool _auto_delete) :
     m_alloc_policy(std::make_shared<core::memory::buffer_no_alloc_policy>()),
     m_auto_delete(_auto_delete)
 {
-    m_buffer_manager->register_buffer(&m_buffer).get();
+    m_resident_lock = m_buffer_manager->register_buffer(&m_buffer).get();
 }
 
 //------------------------------------------------------------------------------
@@ -129,12 +129,21 @@ void buffer_object::set_istream_factory(
     size_t _size,
     const std::filesystem::path& _source_file,
     core::memory::file_format_type _format,
-    const core::memory::buffer_allocation_policy::sptr& _policy
+    const core::memory::buffer_allocation_policy::sptr& _policy,
+    std::optional<buffer_manager::loading_mode_type> _loading_mode
 )
 {
     m_size         = _size;
     m_alloc_policy = _policy;
-    m_buffer_manager->set_istream_factory(&m_buffer, _factory, _size, _source_file, _format, _policy).get();
+    m_buffer_manager->set_istream_factory(
+        &m_buffer,
+        _factory,
+        _size,
+        _source_file,
+        _format,
+        _policy,
+        _loading_mode
+    ).get();
 }
 
 //------------------------------------------------------------------------------
@@ -127,7 +127,13 @@ public:
 
             if(!m_count)
             {
-                m_count      = _bo->m_buffer_manager->lock_buffer(&(_bo->m_buffer)).get();
+                // Resident buffers can be locked without any round trip to the buffer manager worker
+                m_count = _bo->m_buffer_manager->try_lock_resident(&(_bo->m_buffer), _bo->m_resident_lock);
+                if(!m_count)
+                {
+                    m_count = _bo->m_buffer_manager->lock_buffer(&(_bo->m_buffer)).get();
+                }
+
                 _bo->m_count = m_count;
             }
         }
@@ -311,6 +317,7 @@ public:
      * @param _source_file Filesystem path of the source file, if applicable
      * @param _format file format (RAW,RAWZ,OTHER), if sourceFile is provided
      * @param _policy Buffer allocation policy
+     * @param _loading_mode loading mode of this buffer, the one of the buffer manager if not set
      */
     SIGHT_CORE_API void set_istream_factory(
         const SPTR(core::memory::stream::in::factory)& _factory,
@@ -318,7 +325,8 @@ public:
         const std::filesystem::path& _source_file                   = "",
         core::memory::file_format_type _format                      = core::memory::other,
         const core::memory::buffer_allocation_policy::sptr& _policy = std::make_shared<core::memory::
-                                                                                       buffer_malloc_policy>()
+                                                                                       buffer_malloc_policy>(),
+        std::optional<buffer_manager::loading_mode_type> _loading_mode = std::nullopt
     );
 
     /// Equality comparison operators
@@ -340,6 +348,9 @@ protected:
 
     core::memory::buffer_manager::sptr m_buffer_manager;
 
+    /// Lock counter used to lock the buffer without going through the buffer manager worker when it is resident
+    SPTR(buffer_info::resident_lock) m_resident_lock;
+
     core::memory::buffer_allocation_policy::sptr m_alloc_policy;
 
     bool m_auto_delete {false};
@@ -0,0 +1,92 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/memory/compressed_buffer.hpp"
+
+#include <core/exceptionmacros.hpp>
+
+#include <zstd.h>
+
+namespace sight::core::memory
+{
+
+//------------------------------------------------------------------------------
+
+compressed_buffer::compressed_buffer(std::vector<char>&& _data, std::size_t _size) :
+    m_data(std::move(_data)),
+    m_size(_size)
+{
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr<compressed_buffer> compressed_buffer::compress(
+    const void* _data,
+    std::size_t _size,
+    std::size_t _max_size,
+    int _level
+)
+{
+    const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    SIGHT_THROW_IF("Unable to create a zstd context.", !context);
+
+    ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel, _level);
+    ZSTD_CCtx_setPledgedSrcSize(context.get(), _size);
+
+    // Compress by chunks, so that incompressible buffers are detected without allocating their whole size
+    const std::size_t chunk_size = ZSTD_CStreamOutSize();
+    std::vector<char> data;
+    ZSTD_inBuffer input {_data, _size, 0};
+    std::size_t remaining = 0;
+
+    do
+    {
+        const std::size_t position = data.size();
+        data.resize(position + chunk_size);
+
+        ZSTD_outBuffer output {data.data() + position, chunk_size, 0};
+        remaining = ZSTD_compressStream2(context.get(), &output, &input, ZSTD_e_end);
+        SIGHT_THROW_IF("zstd compression failed: " << ZSTD_getErrorName(remaining), ZSTD_isError(remaining) != 0U);
+
+        data.resize(position + output.pos);
+
+        if(data.size() > _max_size)
+        {
+            return nullptr;
+        }
+    }
+    while(remaining != 0);
+
+    data.shrink_to_fit();
+
+    return std::unique_ptr<compressed_buffer>(new compressed_buffer(std::move(data), _size));
+}
+
+//------------------------------------------------------------------------------
+
+void compressed_buffer::decompress(void* _data) const
+{
+    const std::size_t result = ZSTD_decompress(_data, m_size, m_data.data(), m_data.size());
+    SIGHT_THROW_IF("zstd decompression failed: " << ZSTD_getErrorName(result), ZSTD_isError(result) != 0U);
+    SIGHT_THROW_IF("Bad decompressed size, expected: " << m_size << ", was: " << result, result != m_size);
+}
+
+} // namespace sight::core::memory
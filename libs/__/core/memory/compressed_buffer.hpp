@@ -0,0 +1,100 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/core/config.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sight::core::memory
+{
+
+/**
+ * @brief Content of a buffer compressed with zstd and held in memory.
+ *
+ * It is used by the compressed tier of the buffer_manager, which keeps dumped buffers in memory as long as they fit.
+ */
+class SIGHT_CORE_CLASS_API compressed_buffer
+{
+public:
+
+    /**
+     * @brief Compresses a buffer.
+     *
+     * @param _data buffer to compress
+     * @param _size size of the buffer
+     * @param _max_size compressed size beyond which the compression is abandoned
+     * @param _level zstd compression level
+     *
+     * @return nullptr if the compressed data would be larger than _max_size
+     * @throw core::exception if zstd fails
+     */
+    SIGHT_CORE_API static std::unique_ptr<compressed_buffer> compress(
+        const void* _data,
+        std::size_t _size,
+        std::size_t _max_size,
+        int _level
+    );
+
+    /**
+     * @brief Decompresses the whole buffer.
+     *
+     * @param _data destination, at least size() bytes long
+     * @throw core::exception if the data is corrupted
+     */
+    SIGHT_CORE_API void decompress(void* _data) const;
+
+    //------------------------------------------------------------------------------
+
+    /// Returns the size of the uncompressed buffer
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_size;
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Returns the size of the compressed data
+    [[nodiscard]] std::size_t compressed_size() const
+    {
+        return m_data.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Returns the compressed data, a single zstd frame
+    [[nodiscard]] const std::vector<char>& data() const
+    {
+        return m_data;
+    }
+
+private:
+
+    compressed_buffer(std::vector<char>&& _data, std::size_t _size);
+
+    std::vector<char> m_data;
+    std::size_t m_size {0};
+};
+
+} // namespace sight::core::memory
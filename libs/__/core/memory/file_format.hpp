@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -27,9 +27,11 @@ namespace sight::core::memory
 
 enum file_format_type
 {
-    other = 0,
-    raw   = 1,
-    rawz  = 1 << 2
+    other  = 0,
+    raw    = 1,
+    rawz   = 1 << 2,
+    /// raw file restored by mapping it in memory
+    mapped = 1 << 3
 };
 
 } // namespace sight::core::memory
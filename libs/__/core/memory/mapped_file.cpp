@@ -0,0 +1,108 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/memory/mapped_file.hpp"
+
+#include <core/exceptionmacros.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <utility>
+
+namespace sight::core::memory
+{
+
+//------------------------------------------------------------------------------
+
+mapped_file::mapped_file(core::memory::file_holder _file, std::size_t _size) :
+    m_file(std::move(_file)),
+    m_size(_size)
+{
+    const std::filesystem::path path = m_file;
+
+    SIGHT_THROW_IF("Unable to map an empty buffer from " << path.string(), m_size == 0);
+    SIGHT_THROW_IF(
+        path.string() << " is smaller than the buffer to map (" << m_size << " bytes).",
+        std::filesystem::file_size(path) < m_size
+    );
+
+#ifdef _WIN32
+    m_file_handle = CreateFileW(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    SIGHT_THROW_IF("Unable to open " << path.string(), m_file_handle == INVALID_HANDLE_VALUE);
+
+    m_mapping_handle = CreateFileMappingW(m_file_handle, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if(m_mapping_handle == nullptr)
+    {
+        CloseHandle(m_file_handle);
+        SIGHT_THROW("Unable to create a mapping of " << path.string());
+    }
+
+    m_data = MapViewOfFile(m_mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, m_size);
+    if(m_data == nullptr)
+    {
+        CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+        SIGHT_THROW("Unable to map " << path.string());
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDWR);
+    SIGHT_THROW_IF("Unable to open " << path.string(), fd < 0);
+
+    void* data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // The mapping keeps its own reference on the file
+    ::close(fd);
+
+    SIGHT_THROW_IF("Unable to map " << path.string(), data == MAP_FAILED);
+    m_data = data;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+mapped_file::~mapped_file()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping_handle);
+    CloseHandle(m_file_handle);
+#else
+    ::munmap(m_data, m_size);
+#endif
+}
+
+} // namespace sight::core::memory
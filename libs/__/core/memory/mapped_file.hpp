@@ -0,0 +1,89 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/core/config.hpp>
+
+#include "core/memory/file_holder.hpp"
+
+#include <cstddef>
+
+namespace sight::core::memory
+{
+
+/**
+ * @brief Maps a dumped buffer file in memory.
+ *
+ * The mapping is shared with the file: pages are only read when they are accessed, and modified pages are written
+ * back to the file by the operating system, so that the file is always up to date when the mapping is released.
+ * The file is kept alive as long as the mapping exists.
+ */
+class SIGHT_CORE_CLASS_API mapped_file
+{
+public:
+
+    /**
+     * @brief Maps the first _size bytes of the given file.
+     * @throw core::exception if the file can not be opened or mapped
+     */
+    SIGHT_CORE_API mapped_file(core::memory::file_holder _file, std::size_t _size);
+    SIGHT_CORE_API ~mapped_file();
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file(mapped_file&&)                 = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file& operator=(mapped_file&&)      = delete;
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] void* data() const
+    {
+        return m_data;
+    }
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_size;
+    }
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] const core::memory::file_holder& file() const
+    {
+        return m_file;
+    }
+
+private:
+
+    core::memory::file_holder m_file;
+    std::size_t m_size {0};
+    void* m_data {nullptr};
+
+#ifdef _WIN32
+    void* m_file_handle {nullptr};
+    void* m_mapping_handle {nullptr};
+#endif
+};
+
+} // namespace sight::core::memory
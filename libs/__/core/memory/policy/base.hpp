@@ -71,6 +71,32 @@ public:
 
     virtual void refresh() = 0;
 
+    /**
+     * @brief Returns true if the policy needs lock_request() and unlock_request() to be called on each lock.
+     *
+     * Policies that do not need them allow the buffer_manager to lock resident buffers without going through its
+     * worker.
+     */
+    virtual bool needs_lock_notification() const
+    {
+        return true;
+    }
+
+    /**
+     * @brief Called before a dumped buffer is restored ahead of its next lock, see buffer_manager::prefetch_buffer().
+     *
+     * The restore itself is notified through restore_success() once the buffer is installed.
+     *
+     * @return false to refuse the prefetch, for instance if the buffer would not fit in the memory budget
+     */
+    virtual bool prefetch_request(
+        buffer_info& /*_info*/,
+        core::memory::buffer_manager::const_buffer_ptr_t /*_buffer*/
+    )
+    {
+        return true;
+    }
+
     virtual bool set_param(const std::string& _name, const std::string& _value) = 0;
     virtual std::string get_param(const std::string& _name, bool* _ok           = nullptr) const = 0;
     virtual const param_names_type& get_param_names() const                     = 0;
@@ -91,6 +91,13 @@ public:
 
     //------------------------------------------------------------------------------
 
+    bool needs_lock_notification() const override
+    {
+        return false;
+    }
+
+    //------------------------------------------------------------------------------
+
     bool set_param(const std::string& _name, const std::string& _value) override
     {
         SIGHT_NOT_USED(_name);
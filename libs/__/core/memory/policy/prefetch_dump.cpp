@@ -0,0 +1,195 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/memory/policy/prefetch_dump.hpp"
+
+#include "core/memory/policy/registry/macros.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+namespace sight::core::memory::policy
+{
+
+SIGHT_REGISTER_MEMORY_POLICY(core::memory::policy::prefetch_dump);
+
+//------------------------------------------------------------------------------
+
+void prefetch_dump::allocation_request(
+    buffer_info& _info,
+    core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+    buffer_info::size_t _size
+)
+{
+    barrier_dump::allocation_request(_info, _buffer, _size);
+
+    if(m_last_created != nullptr && m_last_created != _buffer)
+    {
+        this->record(m_last_created, _buffer, false);
+    }
+
+    m_last_created = _buffer;
+}
+
+//------------------------------------------------------------------------------
+
+void prefetch_dump::set_request(
+    buffer_info& _info,
+    core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+    buffer_info::size_t _size
+)
+{
+    barrier_dump::set_request(_info, _buffer, _size);
+
+    if(m_last_created != nullptr && m_last_created != _buffer)
+    {
+        this->record(m_last_created, _buffer, false);
+    }
+
+    m_last_created = _buffer;
+}
+
+//------------------------------------------------------------------------------
+
+void prefetch_dump::destroy_request(buffer_info& _info, core::memory::buffer_manager::const_buffer_ptr_t _buffer)
+{
+    barrier_dump::destroy_request(_info, _buffer);
+
+    m_successors.erase(_buffer);
+    std::erase_if(m_successors, [_buffer](const auto& _item){return _item.second.buffer == _buffer;});
+
+    if(m_last_created == _buffer)
+    {
+        m_last_created = nullptr;
+    }
+
+    if(m_last_locked == _buffer)
+    {
+        m_last_locked = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void prefetch_dump::lock_request(buffer_info& _info, core::memory::buffer_manager::const_buffer_ptr_t _buffer)
+{
+    barrier_dump::lock_request(_info, _buffer);
+
+    if(m_last_locked == _buffer)
+    {
+        return;
+    }
+
+    if(m_last_locked != nullptr)
+    {
+        this->record(m_last_locked, _buffer, true);
+    }
+
+    m_last_locked = _buffer;
+
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+
+    // Follow the chain of successors, this is called on the buffer manager worker so prefetches start immediately
+    auto current = _buffer;
+    for(std::size_t i = 0 ; i < m_depth ; ++i)
+    {
+        const auto iter = m_successors.find(current);
+        if(iter == m_successors.end() || iter->second.buffer == _buffer)
+        {
+            break;
+        }
+
+        current = iter->second.buffer;
+        manager->prefetch_buffer(current);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool prefetch_dump::prefetch_request(buffer_info& _info, core::memory::buffer_manager::const_buffer_ptr_t /*buffer*/)
+{
+    return this->get_total_alive() + _info.size <= m_barrier;
+}
+
+//------------------------------------------------------------------------------
+
+void prefetch_dump::record(
+    core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+    core::memory::buffer_manager::const_buffer_ptr_t _next,
+    bool _learnt
+)
+{
+    successor& next = m_successors[_buffer];
+    if(_learnt || !next.learnt)
+    {
+        next.buffer = _next;
+        next.learnt = _learnt;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool prefetch_dump::set_param(const std::string& _name, const std::string& _value)
+{
+    if(_name == "depth")
+    {
+        try
+        {
+            m_depth = boost::lexical_cast<std::size_t>(_value);
+            return true;
+        }
+        catch(const boost::bad_lexical_cast&)
+        {
+            SIGHT_ERROR("Bad value for " << _name << " : " << _value);
+            return false;
+        }
+    }
+
+    return barrier_dump::set_param(_name, _value);
+}
+
+//------------------------------------------------------------------------------
+
+const core::memory::policy::base::param_names_type& prefetch_dump::get_param_names() const
+{
+    static const core::memory::policy::base::param_names_type s_PARAMS = {{"barrier"}, {"depth"}};
+    return s_PARAMS;
+}
+
+//------------------------------------------------------------------------------
+
+std::string prefetch_dump::get_param(const std::string& _name, bool* _ok) const
+{
+    if(_name == "depth")
+    {
+        if(_ok != nullptr)
+        {
+            *_ok = true;
+        }
+
+        return std::to_string(m_depth);
+    }
+
+    return barrier_dump::get_param(_name, _ok);
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace sight::core::memory::policy
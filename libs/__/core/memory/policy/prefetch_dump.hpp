@@ -0,0 +1,123 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/core/config.hpp>
+
+#include "core/memory/policy/barrier_dump.hpp"
+
+#include <map>
+
+namespace sight::core::memory::policy
+{
+
+/**
+ * @brief Barrier dump policy that restores buffers ahead of their use
+ *
+ * Buffers are dumped like with barrier_dump. In addition, the policy learns the order in which buffers are locked:
+ * when a buffer is locked, the buffers that were locked after it the last time are prefetched, so that they are
+ * already resident when they are locked in turn. Until a buffer has been followed by another lock, the buffer
+ * created right after it is used instead, which matches series loaded and then browsed in order.
+ *
+ * Prefetches are refused if they would cross the barrier.
+ *
+ * Parameters:
+ * - barrier: memory usage barrier, see barrier_dump
+ * - depth: number of buffers restored ahead of a lock, 1 by default
+ */
+class SIGHT_CORE_CLASS_API prefetch_dump : public core::memory::policy::barrier_dump
+{
+public:
+
+    SIGHT_DECLARE_CLASS(prefetch_dump, core::memory::policy::barrier_dump);
+
+    prefetch_dump() = default;
+
+    SIGHT_CORE_API void allocation_request(
+        buffer_info& _info,
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+        buffer_info::size_t _size
+    ) override;
+
+    SIGHT_CORE_API void set_request(
+        buffer_info& _info,
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+        buffer_info::size_t _size
+    ) override;
+
+    SIGHT_CORE_API void destroy_request(
+        buffer_info& _info,
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer
+    ) override;
+
+    SIGHT_CORE_API void lock_request(
+        buffer_info& _info,
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer
+    ) override;
+
+    SIGHT_CORE_API bool prefetch_request(
+        buffer_info& _info,
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer
+    ) override;
+
+    //------------------------------------------------------------------------------
+
+    void set_depth(std::size_t _depth)
+    {
+        m_depth = _depth;
+    }
+
+    //------------------------------------------------------------------------------
+
+    std::size_t get_depth() const
+    {
+        return m_depth;
+    }
+
+    SIGHT_CORE_API std::string get_param(const std::string& _name, bool* _ok = nullptr) const override;
+    SIGHT_CORE_API bool set_param(const std::string& _name, const std::string& _value) override;
+    SIGHT_CORE_API const core::memory::policy::base::param_names_type& get_param_names() const override;
+
+protected:
+
+    /// Records that _next follows _buffer, learnt orders replace the creation order
+    SIGHT_CORE_API void record(
+        core::memory::buffer_manager::const_buffer_ptr_t _buffer,
+        core::memory::buffer_manager::const_buffer_ptr_t _next,
+        bool _learnt
+    );
+
+    struct successor
+    {
+        core::memory::buffer_manager::const_buffer_ptr_t buffer {nullptr};
+        bool learnt {false};
+    };
+
+    std::map<core::memory::buffer_manager::const_buffer_ptr_t, successor> m_successors;
+
+    core::memory::buffer_manager::const_buffer_ptr_t m_last_created {nullptr};
+    core::memory::buffer_manager::const_buffer_ptr_t m_last_locked {nullptr};
+
+    std::size_t m_depth {1};
+};
+
+} // namespace sight::core::memory::policy
@@ -0,0 +1,88 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/memory/stream/in/compressed.hpp"
+
+#include "core/memory/compressed_buffer.hpp"
+
+#include <core/exceptionmacros.hpp>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <zstd.h>
+
+namespace sight::core::memory::stream::in
+{
+
+/// Boost iostreams source decompressing a zstd frame by chunks
+class zstd_source : public boost::iostreams::source
+{
+public:
+
+    zstd_source(SPTR(const compressed_buffer) _buffer) :
+        m_buffer(std::move(_buffer)),
+        m_context(ZSTD_createDCtx(), &ZSTD_freeDCtx),
+        m_input {m_buffer->data().data(), m_buffer->data().size(), 0}
+    {
+        SIGHT_THROW_IF("Unable to create a zstd context.", !m_context);
+    }
+
+    //------------------------------------------------------------------------------
+
+    std::streamsize read(char* _s, std::streamsize _n)
+    {
+        if(m_finished)
+        {
+            return -1;
+        }
+
+        ZSTD_outBuffer output {_s, static_cast<std::size_t>(_n), 0};
+
+        while(output.pos == 0 && !m_finished)
+        {
+            SIGHT_THROW_IF("Truncated compressed buffer.", m_input.pos == m_input.size);
+
+            const std::size_t result = ZSTD_decompressStream(m_context.get(), &output, &m_input);
+            SIGHT_THROW_IF("zstd decompression failed: " << ZSTD_getErrorName(result), ZSTD_isError(result) != 0U);
+
+            m_finished = result == 0;
+        }
+
+        return output.pos == 0 ? -1 : static_cast<std::streamsize>(output.pos);
+    }
+
+private:
+
+    SPTR(const compressed_buffer) m_buffer;
+    std::shared_ptr<ZSTD_DCtx> m_context;
+    ZSTD_inBuffer m_input;
+    bool m_finished {false};
+};
+
+//------------------------------------------------------------------------------
+
+SPTR(std::istream) compressed::get()
+{
+    return std::make_shared<boost::iostreams::stream<zstd_source> >(zstd_source(m_buffer));
+}
+
+} // namespace sight::core::memory::stream::in
@@ -0,0 +1,59 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/core/config.hpp>
+
+#include "core/memory/stream/in/factory.hpp"
+
+#include <core/macros.hpp>
+
+#include <utility>
+
+namespace sight::core::memory
+{
+
+class compressed_buffer;
+
+} // namespace sight::core::memory
+
+namespace sight::core::memory::stream::in
+{
+
+/// Provides a stream decompressing a buffer held by the compressed tier of the buffer_manager.
+class SIGHT_CORE_CLASS_API compressed : public factory
+{
+public:
+
+    compressed(SPTR(const compressed_buffer) _buffer) :
+        m_buffer(std::move(_buffer))
+    {
+    }
+
+protected:
+
+    SIGHT_CORE_API SPTR(std::istream) get() override;
+
+    SPTR(const compressed_buffer) m_buffer;
+};
+
+} // namespace sight::core::memory::stream::in
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -24,6 +24,10 @@
 
 #include "core/memory/tools/memory_monitor_tools.hpp"
 
+#include "core/memory/buffer_manager.hpp"
+
+#include <core/spy_log.hpp>
+
 #ifdef _WIN32
 #define MEMORYTOOLIMPL win32memory_monitor_tools // NOLINT(cppcoreguidelines-macro-usage): It's a class name
 #include "core/memory/tools/win32memory_monitor_tools.hpp"
@@ -68,6 +72,40 @@ void memory_monitor_tools::print_system_memory_information()
 void memory_monitor_tools::print_memory_information()
 {
     MEMORYTOOLIMPL::print_memory_information();
+    print_compressed_tier_information();
+}
+
+//-----------------------------------------------------------------------------
+
+memory_monitor_tools::compressed_tier_info memory_monitor_tools::get_compressed_tier_info()
+{
+    compressed_tier_info info;
+
+    if(const auto manager = core::memory::buffer_manager::get(); manager)
+    {
+        const auto stats = manager->get_buffer_stats().get();
+        info.capacity = stats.compressed_capacity;
+        info.used     = stats.compressed_size;
+        info.stored   = stats.total_compressed;
+        info.hits     = stats.compressed_hits;
+        info.spills   = stats.compressed_spills;
+    }
+
+    return info;
+}
+
+//-----------------------------------------------------------------------------
+
+void memory_monitor_tools::print_compressed_tier_information()
+{
+    [[maybe_unused]] const compressed_tier_info info = get_compressed_tier_info();
+    [[maybe_unused]] const std::uint64_t o_to_kmo = 1024LL * 1024;
+
+    SIGHT_INFO("Compressed tier capacity: " << info.capacity / o_to_kmo << " Mo");
+    SIGHT_INFO("Compressed tier used:     " << info.used / o_to_kmo << " Mo");
+    SIGHT_INFO("Compressed tier stored:   " << info.stored / o_to_kmo << " Mo");
+    SIGHT_INFO("Compressed tier hits:     " << info.hits);
+    SIGHT_INFO("Compressed tier spills:   " << info.spills);
 }
 
 //-----------------------------------------------------------------------------
@@ -33,6 +33,21 @@ class SIGHT_CORE_CLASS_API memory_monitor_tools
 {
 public:
 
+    /// State of the compressed tier of the buffer_manager, sizes are in bytes
+    struct compressed_tier_info
+    {
+        /// Maximum memory used by the tier, 0 if it is disabled
+        std::uint64_t capacity {0};
+        /// Memory currently used by the tier
+        std::uint64_t used {0};
+        /// Uncompressed size of the buffers held by the tier
+        std::uint64_t stored {0};
+        /// Number of restores served by the tier
+        std::uint64_t hits {0};
+        /// Number of buffers moved from the tier to disk
+        std::uint64_t spills {0};
+    };
+
     SIGHT_CORE_API memory_monitor_tools();
 
     SIGHT_CORE_API ~memory_monitor_tools() = default;
@@ -45,6 +60,10 @@ public:
 
     SIGHT_CORE_API static void print_memory_information();
 
+    SIGHT_CORE_API static compressed_tier_info get_compressed_tier_info();
+
+    SIGHT_CORE_API static void print_compressed_tier_information();
+
     SIGHT_CORE_API static std::uint64_t get_total_system_memory();
 
     SIGHT_CORE_API static std::uint64_t get_used_system_memory();
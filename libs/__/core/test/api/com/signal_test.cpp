@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -29,12 +29,18 @@
 #include <core/com/signal.hxx>
 #include <core/com/slot.hpp>
 #include <core/com/slot.hxx>
+#include <core/spy_log.hpp>
 #include <core/thread/worker.hpp>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
 #include <string>
 #include <thread>
+#include <vector>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::core::com::ut::signal_test);
@@ -667,4 +673,196 @@ void signal_test::async_emit_test()
     worker->stop();
 }
 
+//-----------------------------------------------------------------------------
+
+void signal_test::async_run_detached_test()
+{
+    using signature = void (int);
+
+    core::thread::worker::sptr worker       = core::thread::worker::make();
+    core::thread::worker::sptr other_worker = core::thread::worker::make();
+
+    std::atomic_int count {0};
+    auto sig = std::make_shared<core::com::signal<signature> >();
+
+    // Holds the worker until the gate is opened, so that the emissions are pending
+    const auto block =
+        [](const core::thread::worker::sptr& _worker)
+        {
+            auto gate = std::make_shared<std::promise<void> >();
+            _worker->post([future = gate->get_future().share()]{future.wait();});
+            return gate;
+        };
+
+    // A destroyed slot is skipped
+    {
+        auto slot = core::com::new_slot([&count](int _value){count += _value;});
+        slot->set_worker(worker);
+        sig->connect(slot);
+
+        auto gate = block(worker);
+        sig->async_emit(1);
+        sig->disconnect(slot);
+        slot.reset();
+        gate->set_value();
+
+        worker->post_task<void>([]{}).wait();
+        CPPUNIT_ASSERT_EQUAL(0, count.load());
+    }
+
+    // A slot is skipped if its worker changed since the emission
+    {
+        auto slot = core::com::new_slot([&count](int _value){count += _value;});
+        slot->set_worker(worker);
+        sig->connect(slot);
+
+        auto gate = block(worker);
+        sig->async_emit(1);
+        slot->set_worker(other_worker);
+        gate->set_value();
+
+        worker->post_task<void>([]{}).wait();
+        CPPUNIT_ASSERT_EQUAL(0, count.load());
+
+        // The next emissions are run by the new worker
+        sig->async_emit(2);
+        other_worker->post_task<void>([]{}).wait();
+        CPPUNIT_ASSERT_EQUAL(2, count.load());
+
+        sig->disconnect(slot);
+    }
+
+    worker->stop();
+    other_worker->stop();
+}
+
+//------------------------------------------------------------------------------
+
+void signal_test::disconnect_during_emit_test()
+{
+    using signature = void ();
+
+    std::promise<void> started;
+    std::atomic_bool running {false};
+    std::atomic_bool done {false};
+
+    auto slot = core::com::new_slot(
+        [&]
+        {
+            running = true;
+            started.set_value();
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            running = false;
+            done    = true;
+        });
+    auto sig = std::make_shared<core::com::signal<signature> >();
+    auto connection = sig->connect(slot);
+
+    std::thread emitter([&sig]{sig->emit();});
+    started.get_future().wait();
+
+    // The disconnection returns once the slot is done
+    connection.disconnect();
+    const bool running_after_disconnect = running.load();
+    const bool done_after_disconnect    = done.load();
+    emitter.join();
+
+    CPPUNIT_ASSERT(!running_after_disconnect);
+    CPPUNIT_ASSERT(done_after_disconnect);
+
+    // A slot may disconnect itself while it runs
+    std::atomic_int count {0};
+    core::com::connection self_connection;
+    auto self_slot = core::com::new_slot(
+        [&]
+        {
+            ++count;
+            self_connection.disconnect();
+        });
+    self_connection = sig->connect(self_slot);
+    sig->emit();
+    sig->emit();
+    CPPUNIT_ASSERT_EQUAL(1, count.load());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), sig->num_connections());
+}
+
+//------------------------------------------------------------------------------
+
+void signal_test::benchmark_async_emit()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    using signature = void (int);
+
+    constexpr int nb_emissions = 20000;
+
+    core::thread::worker::sptr worker = core::thread::worker::make();
+
+    const auto run =
+        [&](std::size_t _nb_slots)
+        {
+            std::atomic<int> count {0};
+
+            core::com::signal<signature>::sptr sig = std::make_shared<core::com::signal<signature> >();
+            std::vector<core::com::slot<signature>::sptr> slots;
+            for(std::size_t i = 0 ; i < _nb_slots ; ++i)
+            {
+                auto slot = core::com::new_slot([&count](int _value){count += _value;});
+                slot->set_worker(worker);
+                sig->connect(slot);
+                slots.push_back(slot);
+            }
+
+            const auto expected = static_cast<int>(_nb_slots) * nb_emissions;
+
+            const auto measure =
+                [&](const auto& _emit)
+                {
+                    count = 0;
+                    const auto start = std::chrono::steady_clock::now();
+                    for(int i = 0 ; i < nb_emissions ; ++i)
+                    {
+                        _emit();
+                    }
+
+                    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+                    while(count < expected && std::chrono::steady_clock::now() < deadline)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    CPPUNIT_ASSERT_EQUAL(expected, count.load());
+                    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                           / nb_emissions;
+                };
+
+            // Former dispatch path: one future per slot and per emission
+            const double with_future = measure(
+                [&]
+                {
+                    for(const auto& slot : slots)
+                    {
+                        slot->async_run(1);
+                    }
+                });
+
+            const double detached = measure([&]{sig->async_emit(1);});
+
+            SIGHT_INFO(
+                "async_emit - " << _nb_slots << " slot(s): " << detached << " us/emission, "
+                << with_future << " us/emission with futures"
+            );
+        };
+
+    run(1);
+    run(8);
+    run(64);
+
+    worker->stop();
+}
+
 } // namespace sight::core::com::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -39,6 +39,9 @@ CPPUNIT_TEST(block_test);
 CPPUNIT_TEST(argument_loss_test);
 CPPUNIT_TEST(async_emit_test);
 CPPUNIT_TEST(async_argument_loss_test);
+CPPUNIT_TEST(async_run_detached_test);
+CPPUNIT_TEST(disconnect_during_emit_test);
+CPPUNIT_TEST(benchmark_async_emit);
 
 CPPUNIT_TEST_SUITE_END();
 
@@ -56,6 +59,9 @@ public:
     static void argument_loss_test();
     static void async_emit_test();
     static void async_argument_loss_test();
+    static void async_run_detached_test();
+    static void disconnect_during_emit_test();
+    static void benchmark_async_emit();
 };
 
 } // namespace sight::core::com::ut
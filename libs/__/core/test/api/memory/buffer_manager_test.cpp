@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -24,15 +24,27 @@
 
 #include <core/memory/buffer_manager.hpp>
 #include <core/memory/buffer_object.hpp>
+#include <core/memory/mapped_file.hpp>
 #include <core/memory/policy/always_dump.hpp>
 #include <core/memory/policy/barrier_dump.hpp>
 #include <core/memory/policy/base.hpp>
 #include <core/memory/policy/never_dump.hpp>
+#include <core/memory/policy/prefetch_dump.hpp>
 #include <core/memory/policy/valve_dump.hpp>
+#include <core/memory/tools/memory_monitor_tools.hpp>
+
+#include <core/spy_log.hpp>
 
 #include <utest/wait.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <thread>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::core::memory::ut::buffer_manager_test);
@@ -281,6 +293,194 @@ void buffer_manager_test::dump_restore_test()
 
 //------------------------------------------------------------------------------
 
+void buffer_manager_test::mapped_dump_restore_test()
+{
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+    manager->set_dump_backend(core::memory::buffer_manager::mapped_backend);
+
+    constexpr std::size_t size = 3 * 4096 + 7;
+    core::memory::buffer_object::sptr bo = std::make_shared<core::memory::buffer_object>();
+    bo->allocate(size);
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+        auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+        std::iota(buffer, buffer + size, std::uint8_t(0));
+    }
+
+    const auto info = [&]{return manager->get_buffer_infos().get().at(bo->get_buffer_pointer());};
+
+    CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!info().loaded);
+    CPPUNIT_ASSERT_EQUAL(core::memory::mapped, info().file_format);
+    const std::filesystem::path dumped_file = info().fs_file;
+    CPPUNIT_ASSERT_EQUAL(std::uintmax_t(size), std::filesystem::file_size(dumped_file));
+
+    // The restore maps the dumped file instead of copying it
+    CPPUNIT_ASSERT(manager->restore_buffer(bo->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(info().loaded);
+    CPPUNIT_ASSERT(info().mapping);
+    CPPUNIT_ASSERT_EQUAL(size, info().mapping->size());
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+        auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+        CPPUNIT_ASSERT(buffer == info().mapping->data());
+        for(std::size_t i = 0 ; i < size ; ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL(std::uint8_t(i), buffer[i]);
+        }
+
+        buffer[size - 1] = 42;
+    }
+
+    // Dumping a mapped buffer only releases the mapping, the modifications are kept in the same file
+    CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!info().loaded);
+    CPPUNIT_ASSERT(!info().mapping);
+    CPPUNIT_ASSERT(dumped_file == std::filesystem::path(info().fs_file));
+    {
+        std::ifstream fs(dumped_file, std::ios::binary);
+        fs.seekg(static_cast<std::streamoff>(size - 1));
+        CPPUNIT_ASSERT_EQUAL(42, fs.get());
+    }
+
+    // A lock restores the buffer, and a reallocation moves it back to memory owned by the allocation policy
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(42), static_cast<std::uint8_t*>(bo->lock().buffer())[size - 1]);
+    CPPUNIT_ASSERT(info().mapping);
+    bo->reallocate(2 * size);
+    CPPUNIT_ASSERT(!info().mapping);
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+        auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(1), buffer[1]);
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(42), buffer[size - 1]);
+    }
+
+    // Once restored, the dumped file is removed
+    CPPUNIT_ASSERT(!std::filesystem::exists(dumped_file));
+
+    // Destroying a mapped buffer releases the mapping and its file
+    CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+    const std::filesystem::path second_file = info().fs_file;
+    CPPUNIT_ASSERT(manager->restore_buffer(bo->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(info().mapping);
+    bo->destroy();
+    CPPUNIT_ASSERT(!std::filesystem::exists(second_file));
+
+    const core::memory::buffer_manager::size_t zero = 0;
+    CPPUNIT_ASSERT_EQUAL(zero, manager->get_buffer_stats().get().total_managed);
+
+    manager->set_dump_backend(core::memory::buffer_manager::stream_backend);
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::compressed_tier_test()
+{
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+    manager->set_compressed_tier_capacity(std::size_t(64) * 1024);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64) * 1024, manager->get_compressed_tier_capacity());
+
+    const auto initial_stats = manager->get_buffer_stats().get();
+
+    constexpr std::size_t size = std::size_t(32) * 1024;
+
+    // Looks like a label map, which compresses very well
+    core::memory::buffer_object::sptr mask = std::make_shared<core::memory::buffer_object>();
+    mask->allocate(size);
+    {
+        core::memory::buffer_object::lock_t lock(mask->lock());
+        auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+        for(std::size_t i = 0 ; i < size ; ++i)
+        {
+            buffer[i] = std::uint8_t(i / 1000);
+        }
+    }
+
+    // Random data can not be compressed
+    core::memory::buffer_object::sptr noise = std::make_shared<core::memory::buffer_object>();
+    noise->allocate(size);
+    {
+        core::memory::buffer_object::lock_t lock(noise->lock());
+        auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+        std::mt19937 generator(42);
+        std::generate(buffer, buffer + size, [&]{return std::uint8_t(generator());});
+    }
+
+    const auto info = [&](const core::memory::buffer_object::sptr& _bo)
+                      {
+                          return manager->get_buffer_infos().get().at(_bo->get_buffer_pointer());
+                      };
+
+    const auto check_mask = [&]
+                            {
+                                core::memory::buffer_object::lock_t lock(mask->lock());
+                                const auto* buffer = static_cast<const std::uint8_t*>(lock.buffer());
+                                for(std::size_t i = 0 ; i < size ; ++i)
+                                {
+                                    CPPUNIT_ASSERT_EQUAL(std::uint8_t(i / 1000), buffer[i]);
+                                }
+                            };
+
+    // The mask is kept in memory, compressed
+    CPPUNIT_ASSERT(manager->dump_buffer(mask->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!info(mask).loaded);
+    CPPUNIT_ASSERT(info(mask).compressed);
+    CPPUNIT_ASSERT(std::filesystem::path(info(mask).fs_file).empty());
+
+    auto stats = manager->get_buffer_stats().get();
+    CPPUNIT_ASSERT_EQUAL(size, stats.total_compressed);
+    CPPUNIT_ASSERT(stats.compressed_size > 0 && stats.compressed_size <= size / 2);
+
+    // The stream of a compressed buffer provides the uncompressed data
+    {
+        const auto stream_info = manager->get_stream_info(mask->get_buffer_pointer()).get();
+        std::vector<char> data(size);
+        stream_info.stream->read(data.data(), static_cast<std::streamsize>(size));
+        CPPUNIT_ASSERT_EQUAL(std::streamsize(size), stream_info.stream->gcount());
+        CPPUNIT_ASSERT_EQUAL(char((size - 1) / 1000), data[size - 1]);
+    }
+
+    // The noise goes to disk
+    CPPUNIT_ASSERT(manager->dump_buffer(noise->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!info(noise).compressed);
+    CPPUNIT_ASSERT_EQUAL(core::memory::raw, info(noise).file_format);
+    CPPUNIT_ASSERT(std::filesystem::exists(std::filesystem::path(info(noise).fs_file)));
+
+    // A lock decompresses the mask
+    check_mask();
+    CPPUNIT_ASSERT(!info(mask).compressed);
+
+    stats = manager->get_buffer_stats().get();
+    CPPUNIT_ASSERT_EQUAL(initial_stats.compressed_hits + 1, stats.compressed_hits);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), stats.compressed_size);
+
+    // Reducing the capacity moves the buffers of the tier to disk
+    CPPUNIT_ASSERT(manager->dump_buffer(mask->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(info(mask).compressed);
+    manager->set_compressed_tier_capacity(0);
+    CPPUNIT_ASSERT(!info(mask).compressed);
+    CPPUNIT_ASSERT(!info(mask).loaded);
+    CPPUNIT_ASSERT_EQUAL(core::memory::raw, info(mask).file_format);
+    CPPUNIT_ASSERT_EQUAL(
+        std::uintmax_t(size),
+        std::filesystem::file_size(std::filesystem::path(info(mask).fs_file))
+    );
+    check_mask();
+
+    // The state of the tier is reported by the memory tools
+    const auto tier = core::memory::tools::memory_monitor_tools::get_compressed_tier_info();
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), tier.capacity);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), tier.used);
+    CPPUNIT_ASSERT_EQUAL(initial_stats.compressed_hits + 1, tier.hits);
+    CPPUNIT_ASSERT_EQUAL(initial_stats.compressed_spills + 1, tier.spills);
+
+    SIGHT_TEST_WAIT(mask->lock_count() == 0);
+    mask->destroy();
+    noise->destroy();
+}
+
+//------------------------------------------------------------------------------
+
 class dummy_memory_monitor_tools
 {
 public:
@@ -525,4 +725,383 @@ void buffer_manager_test::dump_policy_test()
     }
 }
 
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::resident_lock_test()
+{
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+
+    core::memory::buffer_object::sptr bo = std::make_shared<core::memory::buffer_object>();
+    bo->allocate(sizeof(char));
+
+    // A resident buffer is locked without the worker, so the lock count is immediately up to date
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+        *static_cast<char*>(lock.buffer()) = '!';
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::int64_t>(1), bo->lock_count());
+        CPPUNIT_ASSERT_EQUAL(
+            static_cast<std::int64_t>(1),
+            manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).lock_count()
+        );
+
+        // A buffer locked on the fast path can not be dumped
+        CPPUNIT_ASSERT(!manager->dump_buffer(bo->get_buffer_pointer()).get());
+        CPPUNIT_ASSERT(manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::int64_t>(0), bo->lock_count());
+    CPPUNIT_ASSERT_EQUAL(
+        static_cast<std::int64_t>(0),
+        manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).lock_count()
+    );
+
+    // Once unlocked, the buffer can be dumped, and the next lock restores it through the worker
+    CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+    CPPUNIT_ASSERT_EQUAL('!', *static_cast<char*>(bo->lock().buffer()));
+    CPPUNIT_ASSERT(manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+
+    // A policy that needs to be notified of locks disables the fast path
+    manager->set_dump_policy(std::make_shared<core::memory::policy::always_dump>());
+    CPPUNIT_ASSERT(!manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+    CPPUNIT_ASSERT_EQUAL('!', *static_cast<char*>(bo->lock().buffer()));
+    SIGHT_TEST_WAIT(!manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+    CPPUNIT_ASSERT(!manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).loaded);
+
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+    bo->destroy();
+}
+
+//------------------------------------------------------------------------------
+
+/// Policy that never dumps but counts the lock notifications
+class lock_counting_policy final : public core::memory::policy::never_dump
+{
+public:
+
+    //------------------------------------------------------------------------------
+
+    void lock_request(buffer_info& /*_info*/, core::memory::buffer_manager::const_buffer_ptr_t /*_buffer*/) override
+    {
+        ++m_locks;
+    }
+
+    //------------------------------------------------------------------------------
+
+    void unlock_request(buffer_info& /*_info*/, core::memory::buffer_manager::const_buffer_ptr_t /*_buffer*/) override
+    {
+        ++m_unlocks;
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool needs_lock_notification() const override
+    {
+        return true;
+    }
+
+    std::atomic_int m_locks {0};
+    std::atomic_int m_unlocks {0};
+};
+
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::resident_lock_policy_change_test()
+{
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+
+    core::memory::buffer_object::sptr bo = std::make_shared<core::memory::buffer_object>();
+    bo->allocate(sizeof(char));
+
+    const auto last_access =
+        [&]
+        {
+            return manager->get_buffer_infos().get().at(bo->get_buffer_pointer()).last_access.get_logic_stamp();
+        };
+
+    // Locks on the fast path update the last access of the buffer
+    const auto before = last_access();
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+    }
+    CPPUNIT_ASSERT(last_access() > before);
+
+    // The policy set while locks are held on the fast path sees them as a single lock, released with the last of them
+    auto policy = std::make_shared<lock_counting_policy>();
+    {
+        core::memory::buffer_object::lock_t first(bo->lock());
+        core::memory::buffer_object::lock_t second(bo->lock());
+
+        manager->set_dump_policy(policy);
+        CPPUNIT_ASSERT_EQUAL(1, policy->m_locks.load());
+        CPPUNIT_ASSERT_EQUAL(0, policy->m_unlocks.load());
+
+        first.reset();
+        CPPUNIT_ASSERT_EQUAL(std::int64_t(1), bo->lock_count());
+        CPPUNIT_ASSERT_EQUAL(0, policy->m_unlocks.load());
+    }
+    SIGHT_TEST_WAIT(policy->m_unlocks == 1);
+    CPPUNIT_ASSERT_EQUAL(1, policy->m_unlocks.load());
+
+    // From now on, every lock is notified
+    {
+        core::memory::buffer_object::lock_t lock(bo->lock());
+    }
+    SIGHT_TEST_WAIT(policy->m_unlocks == 2);
+    CPPUNIT_ASSERT_EQUAL(2, policy->m_locks.load());
+    CPPUNIT_ASSERT_EQUAL(2, policy->m_unlocks.load());
+
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+    SIGHT_TEST_WAIT(bo->lock_count() == 0);
+    bo->destroy();
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::prefetch_test()
+{
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+
+    auto prefetch = std::make_shared<core::memory::policy::prefetch_dump>();
+    const core::memory::policy::base::param_names_type& params = prefetch->get_param_names();
+    CPPUNIT_ASSERT(params.size() == 2 && params[0] == "barrier" && params[1] == "depth");
+    CPPUNIT_ASSERT(!prefetch->set_param("depth", "nope"));
+    CPPUNIT_ASSERT(prefetch->set_param("depth", "1"));
+    CPPUNIT_ASSERT(prefetch->set_param("barrier", "1GB"));
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), prefetch->get_param("depth"));
+    manager->set_dump_policy(prefetch);
+
+    constexpr std::size_t size = 1024;
+    std::vector<core::memory::buffer_object::sptr> buffers;
+    for(std::uint8_t i = 0 ; i < 3 ; ++i)
+    {
+        buffers.push_back(std::make_shared<core::memory::buffer_object>());
+        buffers.back()->allocate(size);
+        std::fill_n(static_cast<std::uint8_t*>(buffers.back()->lock().buffer()), size, i);
+    }
+
+    const auto info = [&](std::size_t _index)
+                      {
+                          return manager->get_buffer_infos().get().at(buffers[_index]->get_buffer_pointer());
+                      };
+
+    for(const auto& bo : buffers)
+    {
+        SIGHT_TEST_WAIT(bo->lock_count() == 0);
+        CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+    }
+
+    const core::memory::buffer_manager::buffer_stats before = manager->get_buffer_stats().get();
+
+    // Locking the first buffer restores the buffer created after it ahead of its own lock
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(0), *static_cast<std::uint8_t*>(buffers[0]->lock().buffer()));
+    SIGHT_TEST_WAIT(info(1).loaded);
+    CPPUNIT_ASSERT(info(1).loaded);
+    CPPUNIT_ASSERT(info(1).prefetched);
+    CPPUNIT_ASSERT(!info(2).loaded);
+
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(1), static_cast<std::uint8_t*>(buffers[1]->lock().buffer())[size - 1]);
+    CPPUNIT_ASSERT(!info(1).prefetched);
+
+    // The lock of the second buffer started the prefetch of the third one, which may still be in progress
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(2), static_cast<std::uint8_t*>(buffers[2]->lock().buffer())[size - 1]);
+
+    // Resident buffers are not prefetched
+    CPPUNIT_ASSERT(!manager->prefetch_buffer(buffers[0]->get_buffer_pointer()).get());
+
+    // An explicit prefetch is started only once
+    SIGHT_TEST_WAIT(buffers[0]->lock_count() == 0);
+    CPPUNIT_ASSERT(manager->dump_buffer(buffers[0]->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(manager->prefetch_buffer(buffers[0]->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(!manager->prefetch_buffer(buffers[0]->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(0), static_cast<std::uint8_t*>(buffers[0]->lock().buffer())[size - 1]);
+
+    const core::memory::buffer_manager::buffer_stats after = manager->get_buffer_stats().get();
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(3), after.restore_hits - before.restore_hits);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(1), after.restore_misses - before.restore_misses);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(4 * size), after.restored_bytes - before.restored_bytes);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(size), after.dumped_bytes - before.dumped_bytes);
+    CPPUNIT_ASSERT(after.restore_time > before.restore_time);
+
+    // The data of a buffer destroyed while being prefetched is released
+    SIGHT_TEST_WAIT(buffers[1]->lock_count() == 0);
+    CPPUNIT_ASSERT(manager->dump_buffer(buffers[1]->get_buffer_pointer()).get());
+    CPPUNIT_ASSERT(manager->prefetch_buffer(buffers[1]->get_buffer_pointer()).get());
+    buffers[1]->destroy();
+    buffers.erase(buffers.begin() + 1);
+
+    for(const auto& bo : buffers)
+    {
+        SIGHT_TEST_WAIT(bo->lock_count() == 0);
+        bo->destroy();
+    }
+
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::benchmark_lock()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+
+    const auto run =
+        [](const std::string& _label, std::size_t _nb_threads)
+        {
+            constexpr std::size_t nb_buffers    = 16;
+            constexpr std::size_t nb_iterations = 20000;
+
+            std::vector<core::memory::buffer_object::sptr> buffers;
+            for(std::size_t i = 0 ; i < nb_buffers ; ++i)
+            {
+                buffers.push_back(std::make_shared<core::memory::buffer_object>());
+                buffers.back()->allocate(sizeof(std::uint64_t));
+                *static_cast<std::uint64_t*>(buffers.back()->lock().buffer()) = 0;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+
+            // Each thread works mostly on its own buffer so that every lock is a first lock, which is the case that
+            // involves the buffer manager, but buffers are shared as soon as there are more threads than buffers
+            std::vector<std::thread> threads;
+            std::atomic_size_t failures {0};
+            for(std::size_t t = 0 ; t < _nb_threads ; ++t)
+            {
+                threads.emplace_back(
+                    [&buffers, &failures, t]
+                    {
+                        const auto& bo = buffers[t % nb_buffers];
+                        for(std::size_t i = 0 ; i < nb_iterations ; ++i)
+                        {
+                            core::memory::buffer_object::lock_t lock(bo->lock());
+                            if(lock.buffer() == nullptr)
+                            {
+                                ++failures;
+                            }
+                        }
+                    });
+            }
+
+            for(auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            CPPUNIT_ASSERT_EQUAL(std::size_t(0), failures.load());
+
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            SIGHT_INFO(
+                "lock/unlock - " << _label << " - " << _nb_threads << " thread(s): "
+                << static_cast<double>(_nb_threads * nb_iterations) / elapsed << " ops/s"
+            );
+
+            for(const auto& bo : buffers)
+            {
+                SIGHT_TEST_WAIT(bo->lock_count() == 0);
+                bo->destroy();
+            }
+        };
+
+    // Fast path: resident buffers are locked with atomics only
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+    for(const std::size_t nb_threads : {1, 4, 16})
+    {
+        run("resident", nb_threads);
+    }
+
+    // Slow path: a policy that needs lock notifications forces every lock through the worker
+    auto barrier = std::make_shared<core::memory::policy::barrier_dump>();
+    CPPUNIT_ASSERT(barrier->set_param("barrier", "1GB"));
+    manager->set_dump_policy(barrier);
+    for(const std::size_t nb_threads : {1, 4, 16})
+    {
+        run("worker", nb_threads);
+    }
+
+    manager->set_dump_policy(std::make_shared<core::memory::policy::never_dump>());
+}
+
+
+//------------------------------------------------------------------------------
+
+void buffer_manager_test::benchmark_restore()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    core::memory::buffer_manager::sptr manager = core::memory::buffer_manager::get();
+
+    constexpr std::size_t size          = std::size_t(64) * 1024 * 1024;
+    constexpr std::size_t page          = 4096;
+    constexpr std::size_t nb_iterations = 4;
+
+    const auto run =
+        [&](const std::string& _label, std::size_t _accessed_size)
+        {
+            core::memory::buffer_object::sptr bo = std::make_shared<core::memory::buffer_object>();
+            bo->allocate(size);
+            {
+                core::memory::buffer_object::lock_t lock(bo->lock());
+                auto* buffer = static_cast<std::uint8_t*>(lock.buffer());
+                std::fill(buffer, buffer + size, std::uint8_t(1));
+            }
+
+            double elapsed = 0.;
+            for(std::size_t i = 0 ; i < nb_iterations ; ++i)
+            {
+                CPPUNIT_ASSERT(manager->dump_buffer(bo->get_buffer_pointer()).get());
+
+                const auto start = std::chrono::steady_clock::now();
+
+                // Touch one byte per page of the accessed slice
+                std::size_t sum = 0;
+                {
+                    core::memory::buffer_object::lock_t lock(bo->lock());
+                    const auto* buffer = static_cast<const std::uint8_t*>(lock.buffer());
+                    for(std::size_t offset = 0 ; offset < _accessed_size ; offset += page)
+                    {
+                        sum += buffer[offset];
+                    }
+                }
+
+                elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                CPPUNIT_ASSERT_EQUAL(_accessed_size / page, sum);
+            }
+
+            SIGHT_INFO(
+                "restore - " << _label << " - " << _accessed_size * 100 / size << "% accessed: "
+                << elapsed * 1000. / static_cast<double>(nb_iterations) << " ms"
+            );
+
+            SIGHT_TEST_WAIT(bo->lock_count() == 0);
+            bo->destroy();
+        };
+
+    manager->set_dump_backend(core::memory::buffer_manager::stream_backend);
+    run("stream", size / 64);
+    run("stream", size);
+
+    manager->set_dump_backend(core::memory::buffer_manager::mapped_backend);
+    run("mapped", size / 64);
+    run("mapped", size);
+
+    manager->set_dump_backend(core::memory::buffer_manager::stream_backend);
+
+    manager->set_compressed_tier_capacity(size);
+    run("compressed", size / 64);
+    run("compressed", size);
+    manager->set_compressed_tier_capacity(0);
+}
+
 } // namespace sight::core::memory::ut
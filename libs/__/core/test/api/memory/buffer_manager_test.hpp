@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -34,7 +34,14 @@ CPPUNIT_TEST(allocate_test);
 CPPUNIT_TEST(memory_info_test);
 CPPUNIT_TEST(swap_test);
 CPPUNIT_TEST(dump_restore_test);
+CPPUNIT_TEST(mapped_dump_restore_test);
+CPPUNIT_TEST(compressed_tier_test);
 CPPUNIT_TEST(dump_policy_test);
+CPPUNIT_TEST(resident_lock_test);
+CPPUNIT_TEST(resident_lock_policy_change_test);
+CPPUNIT_TEST(prefetch_test);
+CPPUNIT_TEST(benchmark_lock);
+CPPUNIT_TEST(benchmark_restore);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,7 +54,14 @@ public:
     static void memory_info_test();
     static void swap_test();
     static void dump_restore_test();
+    static void mapped_dump_restore_test();
+    static void compressed_tier_test();
     static void dump_policy_test();
+    static void resident_lock_test();
+    static void resident_lock_policy_change_test();
+    static void prefetch_test();
+    static void benchmark_lock();
+    static void benchmark_restore();
 };
 
 } // namespace sight::core::memory::ut
@@ -0,0 +1,271 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "pool_test.hpp"
+
+#include <core/thread/pool.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(sight::core::thread::ut::pool_test);
+
+namespace sight::core::thread::ut
+{
+
+//------------------------------------------------------------------------------
+
+void pool_test::setUp()
+{
+    // Set up context before running a test.
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::tearDown()
+{
+    // Clean up after the test run.
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::parallel_for_test()
+{
+    constexpr std::ptrdiff_t size = 100003;
+    std::vector<int> values(size, 0);
+
+    // Every index is processed exactly once
+    core::thread::parallel_for(
+        0,
+        size,
+        [&values](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            for(std::ptrdiff_t i = _begin ; i < _end ; ++i)
+            {
+                ++values[static_cast<std::size_t>(i)];
+            }
+        });
+    CPPUNIT_ASSERT(std::all_of(values.begin(), values.end(), [](int _v){return _v == 1;}));
+
+    // Chunk indices are contiguous and bounded by the requested number of chunks
+    std::mutex mutex;
+    std::set<std::size_t> chunks;
+    core::thread::parallel_for(
+        10,
+        20,
+        [&](std::ptrdiff_t _begin, std::ptrdiff_t _end, std::size_t _chunk)
+        {
+            CPPUNIT_ASSERT(_begin >= 10 && _end <= 20 && _begin < _end);
+            std::lock_guard lock(mutex);
+            chunks.insert(_chunk);
+        },
+        4
+    );
+    CPPUNIT_ASSERT_EQUAL(std::set<std::size_t>({0, 1, 2, 3}), chunks);
+
+    // Empty ranges are not processed
+    bool called = false;
+    core::thread::parallel_for(5, 5, [&called](std::ptrdiff_t, std::ptrdiff_t){called = true;});
+    CPPUNIT_ASSERT(!called);
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::parallel_reduce_test()
+{
+    constexpr std::ptrdiff_t size = 1000000;
+    std::vector<std::uint64_t> values(size);
+    std::iota(values.begin(), values.end(), 0);
+
+    const std::uint64_t sum = core::thread::parallel_reduce(
+        0,
+        size,
+        std::uint64_t(0),
+        [&values](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            return std::accumulate(values.begin() + _begin, values.begin() + _end, std::uint64_t(0));
+        },
+        [](std::uint64_t _a, std::uint64_t _b){return _a + _b;});
+
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(size) * (size - 1) / 2, sum);
+
+    // Results are combined in the order of the chunks
+    const std::string concatenation = core::thread::parallel_reduce(
+        0,
+        10,
+        std::string(),
+        [](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            std::string result;
+            for(std::ptrdiff_t i = _begin ; i < _end ; ++i)
+            {
+                result += std::to_string(i);
+            }
+
+            return result;
+        },
+        [](const std::string& _a, const std::string& _b){return _a + _b;});
+    CPPUNIT_ASSERT_EQUAL(std::string("0123456789"), concatenation);
+
+    // Boolean partial results are written concurrently by the chunks
+    const bool all_in_range = core::thread::parallel_reduce(
+        0,
+        size,
+        true,
+        [&values](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            return std::all_of(
+                values.begin() + _begin,
+                values.begin() + _end,
+                [](std::uint64_t _v){return _v < std::uint64_t(size);});
+        },
+        [](bool _a, bool _b){return _a && _b;},
+        64);
+    CPPUNIT_ASSERT(all_in_range);
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::task_group_test()
+{
+    {
+        std::atomic_int count {0};
+        core::thread::task_group group;
+        for(int i = 0 ; i < 100 ; ++i)
+        {
+            group.run([&count]{++count;});
+        }
+
+        group.wait();
+        CPPUNIT_ASSERT_EQUAL(100, count.load());
+    }
+
+    // The first exception is rethrown by wait(), other tasks still run
+    {
+        std::atomic_int count {0};
+        core::thread::task_group group;
+        group.run([]{throw std::runtime_error("task failure");});
+        for(int i = 0 ; i < 10 ; ++i)
+        {
+            group.run([&count]{++count;});
+        }
+
+        CPPUNIT_ASSERT_THROW(group.wait(), std::runtime_error);
+        CPPUNIT_ASSERT_EQUAL(10, count.load());
+
+        // The exception is only reported once
+        CPPUNIT_ASSERT_NO_THROW(group.wait());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::nested_test()
+{
+    // Nested loops wait for their inner loops while running pending tasks, so they can not exhaust the pool threads
+    core::thread::pool pool(2);
+    std::atomic_int count {0};
+    core::thread::parallel_for(
+        0,
+        16,
+        [&](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            for(std::ptrdiff_t i = _begin ; i < _end ; ++i)
+            {
+                core::thread::parallel_for(
+                    0,
+                    100,
+                    [&count](std::ptrdiff_t _inner_begin, std::ptrdiff_t _inner_end)
+                    {
+                        count += static_cast<int>(_inner_end - _inner_begin);
+                    },
+                    0,
+                    pool
+                );
+            }
+        },
+        0,
+        pool
+    );
+
+    CPPUNIT_ASSERT_EQUAL(1600, count.load());
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::concurrency_test()
+{
+    core::thread::pool pool(3);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), pool.concurrency());
+
+    std::atomic_int count {0};
+    core::thread::task_group group(pool);
+    for(int i = 0 ; i < 1000 ; ++i)
+    {
+        group.run([&count]{++count;});
+    }
+
+    // Pending tasks are run when the concurrency changes
+    pool.set_concurrency(1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), pool.concurrency());
+    group.wait();
+    CPPUNIT_ASSERT_EQUAL(1000, count.load());
+
+    pool.set_concurrency(0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(std::max(std::thread::hardware_concurrency(), 1U)), pool.concurrency());
+}
+
+//------------------------------------------------------------------------------
+
+void pool_test::foreign_wait_test()
+{
+    // A thread outside the pool waits for its group without running any task of the pool
+    core::thread::pool pool(1);
+    const auto caller = std::this_thread::get_id();
+    std::atomic_int count {0};
+    std::atomic_int run_by_caller {0};
+    core::thread::task_group group(pool);
+    for(int i = 0 ; i < 64 ; ++i)
+    {
+        group.run(
+            [&]
+            {
+                if(std::this_thread::get_id() == caller)
+                {
+                    ++run_by_caller;
+                }
+
+                ++count;
+            });
+    }
+
+    CPPUNIT_ASSERT(!pool.run_pending_task());
+    group.wait();
+    CPPUNIT_ASSERT_EQUAL(64, count.load());
+    CPPUNIT_ASSERT_EQUAL(0, run_by_caller.load());
+}
+
+} // namespace sight::core::thread::ut
@@ -32,6 +32,7 @@
 #include <exception>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::core::thread::ut::worker_test);
@@ -412,4 +413,168 @@ void worker_test::thread_name_test()
 
 //-----------------------------------------------------------------------------
 
+void worker_test::multi_thread_test()
+{
+    static constexpr int s_NB_THREADS = 4;
+
+    // A single-threaded worker is already serial
+    {
+        auto worker = core::thread::worker::make(1);
+        CPPUNIT_ASSERT(worker->create_strand() == nullptr);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), worker->thread_count());
+        worker->stop();
+    }
+
+    auto worker = core::thread::worker::make(s_NB_THREADS);
+    CPPUNIT_ASSERT(worker->get_thread_id() != core::thread::get_current_thread_id());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(s_NB_THREADS), worker->thread_count());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), worker->create_strand()->thread_count());
+
+    // Each task waits for all the others, which can only succeed if they all run at the same time
+    std::atomic_int running {0};
+    std::atomic_int succeeded {0};
+    std::atomic_bool thread_check_ok {true};
+    for(int i = 0 ; i < s_NB_THREADS ; ++i)
+    {
+        worker->post(
+            [&, worker]
+            {
+                thread_check_ok = thread_check_ok.load()
+                                  && worker->get_thread_id() == core::thread::get_current_thread_id();
+                ++running;
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while(running.load() < s_NB_THREADS && std::chrono::steady_clock::now() < deadline)
+                {
+                    std::this_thread::yield();
+                }
+
+                if(running.load() == s_NB_THREADS)
+                {
+                    ++succeeded;
+                }
+            });
+    }
+
+    worker->stop();
+    CPPUNIT_ASSERT_EQUAL(s_NB_THREADS, succeeded.load());
+    CPPUNIT_ASSERT(thread_check_ok.load());
+}
+
+//-----------------------------------------------------------------------------
+
+void worker_test::strand_test()
+{
+    static constexpr int s_NB_TASKS = 200;
+
+    auto worker = core::thread::worker::make(4);
+
+    auto strand1 = worker->create_strand();
+    auto strand2 = worker->create_strand();
+    CPPUNIT_ASSERT(strand1 != nullptr);
+    CPPUNIT_ASSERT(strand2 != nullptr);
+    CPPUNIT_ASSERT(strand1->get_thread_id() != core::thread::get_current_thread_id());
+
+    struct strand_state
+    {
+        std::vector<int> order;
+        std::atomic_bool busy {false};
+        std::atomic_bool check_ok {true};
+    };
+
+    strand_state state1;
+    strand_state state2;
+
+    const auto post = [](const core::thread::worker::sptr& _strand, strand_state& _state, int _i)
+                      {
+                          _strand->post(
+                              [&_state, _strand, _i]
+                              {
+                                  // No other task of the same strand may run at the same time
+                                  const bool was_busy = _state.busy.exchange(true);
+                                  _state.check_ok = _state.check_ok.load() && !was_busy
+                                                    && _strand->get_thread_id()
+                                                    == core::thread::get_current_thread_id();
+                                  _state.order.push_back(_i);
+                                  std::this_thread::yield();
+                                  _state.busy = false;
+                              });
+                      };
+
+    for(int i = 0 ; i < s_NB_TASKS ; ++i)
+    {
+        post(strand1, state1, i);
+        post(strand2, state2, i);
+    }
+
+    // post_task() called from the strand itself is executed immediately
+    auto nested = strand1->post_task<bool>(
+        [strand1]
+        {
+            return strand1->post_task<bool>([]{return true;}).wait_for(std::chrono::seconds(0))
+                   == std::future_status::ready;
+        });
+    CPPUNIT_ASSERT(nested.get());
+
+    strand1->stop();
+    strand2->stop();
+
+    for(const auto* state : {&state1, &state2})
+    {
+        CPPUNIT_ASSERT(state->check_ok.load());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(s_NB_TASKS), state->order.size());
+        for(int i = 0 ; i < s_NB_TASKS ; ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL(i, state->order[std::size_t(i)]);
+        }
+    }
+
+    strand1.reset();
+    strand2.reset();
+    worker->stop();
+}
+
+//-----------------------------------------------------------------------------
+
+void worker_test::strand_timer_test()
+{
+    auto worker = core::thread::worker::make(4);
+    auto strand = worker->create_strand();
+
+    std::atomic_bool busy {false};
+    std::atomic_bool check_ok {true};
+    std::atomic_int ticks {0};
+
+    const auto serial_task = [&, strand]
+                             {
+                                 const bool was_busy = busy.exchange(true);
+                                 check_ok = check_ok.load() && !was_busy
+                                            && strand->get_thread_id() == core::thread::get_current_thread_id();
+                                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                 busy = false;
+                             };
+
+    core::thread::timer::sptr timer = strand->create_timer();
+    timer->set_function([&]{serial_task(); ++ticks;});
+    timer->set_duration(std::chrono::milliseconds(5));
+    timer->start();
+
+    for(int i = 0 ; i < 100 ; ++i)
+    {
+        strand->post(serial_task);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    timer->stop();
+    strand->stop();
+
+    CPPUNIT_ASSERT(check_ok.load());
+    CPPUNIT_ASSERT_GREATER(0, ticks.load());
+
+    timer.reset();
+    strand.reset();
+    worker->stop();
+}
+
+//-----------------------------------------------------------------------------
+
 } // namespace sight::core::thread::ut
@@ -34,6 +34,9 @@ CPPUNIT_TEST(basic_test);
 CPPUNIT_TEST(timer_test);
 CPPUNIT_TEST(registry_test);
 CPPUNIT_TEST(thread_name_test);
+CPPUNIT_TEST(multi_thread_test);
+CPPUNIT_TEST(strand_test);
+CPPUNIT_TEST(strand_timer_test);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -46,6 +49,9 @@ public:
     static void timer_test();
     static void registry_test();
     static void thread_name_test();
+    static void multi_thread_test();
+    static void strand_test();
+    static void strand_timer_test();
 };
 
 } // namespace sight::core::thread::ut
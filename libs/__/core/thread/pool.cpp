@@ -0,0 +1,332 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "core/thread/pool.hpp"
+
+#include "core/thread/worker.hpp"
+
+#include <core/spy_log.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace sight::core::thread
+{
+
+namespace
+{
+
+/// Pool and queue owned by the current thread, if it belongs to a pool
+thread_local pool* g_current_pool        = nullptr;
+thread_local std::size_t g_current_queue = 0;
+
+//------------------------------------------------------------------------------
+
+std::size_t resolve_concurrency(std::size_t _concurrency)
+{
+    return _concurrency != 0 ? _concurrency : std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+//------------------------------------------------------------------------------
+
+void execute(const pool::task_t& _task)
+{
+    try
+    {
+        _task();
+    }
+    catch(const std::exception& e)
+    {
+        SIGHT_ERROR("Exception caught in a thread pool task: " << e.what());
+    }
+    catch(...)
+    {
+        SIGHT_ERROR("Unknown exception caught in a thread pool task.");
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+pool::pool(std::size_t _concurrency)
+{
+    // Queues are never reallocated, so that posting is safe while the concurrency changes. Queues without thread
+    // are emptied by the other threads.
+    const std::size_t nb_queues = std::max<std::size_t>(resolve_concurrency(_concurrency), resolve_concurrency(0));
+    for(std::size_t i = 0 ; i < nb_queues ; ++i)
+    {
+        m_queues.push_back(std::make_unique<queue>());
+    }
+
+    this->start(resolve_concurrency(_concurrency));
+}
+
+//------------------------------------------------------------------------------
+
+pool::~pool()
+{
+    this->stop();
+}
+
+//------------------------------------------------------------------------------
+
+pool& pool::get()
+{
+    static pool s_pool;
+    return s_pool;
+}
+
+//------------------------------------------------------------------------------
+
+void pool::set_concurrency(std::size_t _concurrency)
+{
+    SIGHT_ASSERT("The concurrency of a pool can not be changed from one of its tasks.", g_current_pool != this);
+    std::lock_guard lock(m_config_mutex);
+
+    const std::size_t concurrency = resolve_concurrency(_concurrency);
+    if(concurrency != m_threads.size())
+    {
+        this->stop();
+        this->start(concurrency);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::size_t pool::concurrency() const
+{
+    return m_concurrency.load();
+}
+
+//------------------------------------------------------------------------------
+
+void pool::post(task_t _task)
+{
+    // Tasks posted from a thread of the pool stay on this thread, others are spread over all queues
+    const std::size_t index = g_current_pool == this
+                              ? g_current_queue
+                              : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    // Counted before being queued, so that a thread can not take it before and make the counter underflow
+    ++m_pending;
+    {
+        std::lock_guard lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(_task));
+    }
+
+    {
+        // Prevents the notification from being lost between the check and the wait of a sleeping thread
+        std::lock_guard lock(m_sleep_mutex);
+    }
+    m_wake_up.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+bool pool::run_pending_task()
+{
+    // Other threads must not run unrelated tasks
+    task_t task;
+    if(g_current_pool != this || !this->pop(g_current_queue, task))
+    {
+        return false;
+    }
+
+    execute(task);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void pool::start(std::size_t _concurrency)
+{
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stop = false;
+    }
+
+    m_concurrency = _concurrency;
+    for(std::size_t i = 0 ; i < _concurrency ; ++i)
+    {
+        m_threads.emplace_back([this, i]{this->run(i % m_queues.size());});
+        core::thread::set_thread_name("pool_" + std::to_string(i), m_threads.back().native_handle());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void pool::stop()
+{
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wake_up.notify_all();
+
+    for(auto& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    m_threads.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void pool::run(std::size_t _index)
+{
+    g_current_pool  = this;
+    g_current_queue = _index;
+
+    task_t task;
+    while(true)
+    {
+        if(this->pop(_index, task))
+        {
+            execute(task);
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake_up.wait(lock, [this]{return m_stop || m_pending.load() > 0;});
+
+        // Remaining tasks are run before stopping
+        if(m_stop && m_pending.load() == 0)
+        {
+            break;
+        }
+    }
+
+    g_current_pool = nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+bool pool::pop(std::size_t _index, task_t& _task)
+{
+    if(m_pending.load() == 0)
+    {
+        return false;
+    }
+
+    // Own tasks are taken from the back, as they are the most likely to be hot in the cache, and stolen tasks are
+    // taken from the front, as they are the largest ones with recursive splitting
+    {
+        auto& own = *m_queues[_index];
+        std::lock_guard lock(own.mutex);
+        if(!own.tasks.empty())
+        {
+            _task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --m_pending;
+            return true;
+        }
+    }
+
+    for(std::size_t i = 1 ; i < m_queues.size() ; ++i)
+    {
+        auto& other = *m_queues[(_index + i) % m_queues.size()];
+        std::lock_guard lock(other.mutex);
+        if(!other.tasks.empty())
+        {
+            _task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            --m_pending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+task_group::task_group(pool& _pool) :
+    m_pool(_pool)
+{
+}
+
+//------------------------------------------------------------------------------
+
+task_group::~task_group()
+{
+    try
+    {
+        this->wait();
+    }
+    catch(...)
+    {
+        // Exceptions are only reported by an explicit call to wait()
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void task_group::wait()
+{
+    if(g_current_pool == &m_pool)
+    {
+        while(m_running.load() != 0)
+        {
+            // Helping the pool is what allows tasks to wait for nested groups without exhausting the threads
+            if(!m_pool.run_pending_task())
+            {
+                std::unique_lock lock(m_mutex);
+                m_done.wait_for(lock, std::chrono::milliseconds(1), [this]{return m_running.load() == 0;});
+            }
+        }
+    }
+    else
+    {
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [this]{return m_running.load() == 0;});
+    }
+
+    std::exception_ptr exception;
+    {
+        // Also ensures that finish() has released the group before it can be destroyed
+        std::lock_guard lock(m_mutex);
+        std::swap(exception, m_exception);
+    }
+
+    if(exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void task_group::finish(std::exception_ptr _exception)
+{
+    std::lock_guard lock(m_mutex);
+    if(_exception && !m_exception)
+    {
+        m_exception = _exception;
+    }
+
+    --m_running;
+    m_done.notify_all();
+}
+
+} // namespace sight::core::thread
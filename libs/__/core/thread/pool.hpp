@@ -0,0 +1,206 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/core/config.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sight::core::thread
+{
+
+/**
+ * @brief Pool of threads dedicated to data-parallel computations.
+ *
+ * Each thread of the pool owns a queue of tasks. It runs its own tasks first and steals the tasks of the other
+ * threads when its queue is empty. A thread of the pool waiting for a task_group helps the pool by running pending
+ * tasks, so parallel loops can be nested without deadlocks. Other threads simply wait.
+ *
+ * A process-wide pool is available through get(). It should be preferred to spawning threads, so that all
+ * services share the same threads and do not oversubscribe the cores. Its concurrency can be configured with the
+ * `thread_pool_size` parameter of `sight::module::app` in the application profile.
+ */
+class SIGHT_CORE_CLASS_API pool
+{
+public:
+
+    using task_t = std::function<void ()>;
+
+    /**
+     * @brief Constructs a pool and starts its threads.
+     *
+     * @param _concurrency number of threads, 0 means std::thread::hardware_concurrency()
+     */
+    SIGHT_CORE_API explicit pool(std::size_t _concurrency = 0);
+
+    /// Runs the remaining tasks and joins the threads
+    SIGHT_CORE_API ~pool();
+
+    pool(const pool&)            = delete;
+    pool(pool&&)                 = delete;
+    pool& operator=(const pool&) = delete;
+    pool& operator=(pool&&)      = delete;
+
+    /// Returns the process-wide pool
+    SIGHT_CORE_API static pool& get();
+
+    /**
+     * @brief Changes the number of threads of the pool.
+     *
+     * The pending tasks are run before the threads are restarted. This must not be called from a task of the pool.
+     * @param _concurrency number of threads, 0 means std::thread::hardware_concurrency()
+     */
+    SIGHT_CORE_API void set_concurrency(std::size_t _concurrency);
+
+    /// Returns the number of threads of the pool
+    SIGHT_CORE_API std::size_t concurrency() const;
+
+    /// Requests the execution of a task and returns immediately
+    SIGHT_CORE_API void post(task_t _task);
+
+    /**
+     * @brief Runs one pending task on the calling thread, if it is a thread of the pool.
+     *
+     * @return false if there was no task to run, or if the calling thread does not belong to the pool
+     */
+    SIGHT_CORE_API bool run_pending_task();
+
+private:
+
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    void start(std::size_t _concurrency);
+    void stop();
+    void run(std::size_t _index);
+    bool pop(std::size_t _index, task_t& _task);
+
+    std::vector<std::unique_ptr<queue> > m_queues;
+    std::vector<std::thread> m_threads;
+
+    /// Number of tasks posted but not yet started
+    std::atomic<std::size_t> m_pending {0};
+    std::atomic<std::size_t> m_next {0};
+    std::atomic<std::size_t> m_concurrency {0};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake_up;
+    bool m_stop {false};
+
+    /// Serializes set_concurrency() calls
+    mutable std::mutex m_config_mutex;
+};
+
+/**
+ * @brief Group of tasks run on a pool, that can be waited for as a whole.
+ *
+ * The first exception thrown by a task is rethrown by wait().
+ */
+class SIGHT_CORE_CLASS_API task_group
+{
+public:
+
+    SIGHT_CORE_API explicit task_group(pool& _pool = pool::get());
+
+    /// Waits for the tasks, any exception is discarded
+    SIGHT_CORE_API ~task_group();
+
+    task_group(const task_group&)            = delete;
+    task_group(task_group&&)                 = delete;
+    task_group& operator=(const task_group&) = delete;
+    task_group& operator=(task_group&&)      = delete;
+
+    /// Requests the execution of a callable in the group
+    template<typename CALLABLE>
+    void run(CALLABLE&& _f);
+
+    /// Waits for all tasks of the group, running pending tasks of the pool meanwhile if called from one of its threads
+    SIGHT_CORE_API void wait();
+
+private:
+
+    void finish(std::exception_ptr _exception);
+
+    pool& m_pool;
+    std::atomic<std::size_t> m_running {0};
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+    std::exception_ptr m_exception;
+};
+
+/**
+ * @brief Splits a range into chunks and processes them in parallel on a pool.
+ *
+ * @param _begin first index of the range
+ * @param _end index past the end of the range
+ * @param _func callable invoked as `_func(chunk_begin, chunk_end)` or `_func(chunk_begin, chunk_end, chunk_index)`
+ * @param _nb_chunks number of chunks, 0 lets the pool choose according to its concurrency
+ * @param _pool pool running the chunks
+ */
+template<typename CALLABLE>
+void parallel_for(
+    std::ptrdiff_t _begin,
+    std::ptrdiff_t _end,
+    CALLABLE _func,
+    std::size_t _nb_chunks = 0,
+    pool& _pool            = pool::get()
+);
+
+/**
+ * @brief Splits a range into chunks, processes them in parallel on a pool and combines their results.
+ *
+ * The results are combined in the order of the chunks, so that the result is deterministic.
+ *
+ * @param _begin first index of the range
+ * @param _end index past the end of the range
+ * @param _identity initial value of the result
+ * @param _func callable invoked as `_func(chunk_begin, chunk_end)`, returning the result of the chunk
+ * @param _reduce callable invoked as `_reduce(T, T)`, combining two results
+ * @param _nb_chunks number of chunks, 0 lets the pool choose according to its concurrency
+ * @param _pool pool running the chunks
+ */
+template<typename T, typename CALLABLE, typename REDUCE>
+T parallel_reduce(
+    std::ptrdiff_t _begin,
+    std::ptrdiff_t _end,
+    T _identity,
+    CALLABLE _func,
+    REDUCE _reduce,
+    std::size_t _nb_chunks = 0,
+    pool& _pool            = pool::get()
+);
+
+} // namespace sight::core::thread
+
+#include "core/thread/pool.hxx"
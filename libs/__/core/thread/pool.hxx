@@ -0,0 +1,165 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+
+namespace sight::core::thread
+{
+
+//------------------------------------------------------------------------------
+
+template<typename CALLABLE>
+void task_group::run(CALLABLE&& _f)
+{
+    ++m_running;
+    m_pool.post(
+        [this, f = std::forward<CALLABLE>(_f)]() mutable
+        {
+            std::exception_ptr exception;
+            try
+            {
+                f();
+            }
+            catch(...)
+            {
+                exception = std::current_exception();
+            }
+
+            this->finish(exception);
+        });
+}
+
+namespace detail
+{
+
+//------------------------------------------------------------------------------
+
+inline std::size_t chunk_count(std::ptrdiff_t _size, std::size_t _nb_chunks, const pool& _pool)
+{
+    // A few chunks per thread balance the load when all chunks do not have the same cost
+    const std::size_t nb_chunks = _nb_chunks != 0 ? _nb_chunks : 4 * std::max<std::size_t>(_pool.concurrency(), 1);
+    return std::min(nb_chunks, static_cast<std::size_t>(_size));
+}
+
+//------------------------------------------------------------------------------
+
+template<typename CALLABLE>
+void call_chunk(CALLABLE& _func, std::ptrdiff_t _begin, std::ptrdiff_t _end, std::size_t _index)
+{
+    if constexpr(std::is_invocable_v<CALLABLE&, std::ptrdiff_t, std::ptrdiff_t, std::size_t>)
+    {
+        _func(_begin, _end, _index);
+    }
+    else
+    {
+        _func(_begin, _end);
+    }
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+
+template<typename CALLABLE>
+void parallel_for(
+    std::ptrdiff_t _begin,
+    std::ptrdiff_t _end,
+    CALLABLE _func,
+    std::size_t _nb_chunks,
+    pool& _pool
+)
+{
+    const std::ptrdiff_t size = _end - _begin;
+    if(size <= 0)
+    {
+        return;
+    }
+
+    const auto nb_chunks = static_cast<std::ptrdiff_t>(detail::chunk_count(size, _nb_chunks, _pool));
+    const auto bound     = [&](std::ptrdiff_t _index){return _begin + (size * _index) / nb_chunks;};
+
+    if(nb_chunks == 1)
+    {
+        detail::call_chunk(_func, _begin, _end, 0);
+        return;
+    }
+
+    task_group group(_pool);
+    for(std::ptrdiff_t i = 1 ; i < nb_chunks ; ++i)
+    {
+        group.run(
+            [&_func, chunk_begin = bound(i), chunk_end = bound(i + 1), i]
+            {
+                detail::call_chunk(_func, chunk_begin, chunk_end, static_cast<std::size_t>(i));
+            });
+    }
+
+    // The calling thread processes the first chunk itself instead of waiting idle
+    detail::call_chunk(_func, _begin, bound(1), 0);
+    group.wait();
+}
+
+//------------------------------------------------------------------------------
+
+template<typename T, typename CALLABLE, typename REDUCE>
+T parallel_reduce(
+    std::ptrdiff_t _begin,
+    std::ptrdiff_t _end,
+    T _identity,
+    CALLABLE _func,
+    REDUCE _reduce,
+    std::size_t _nb_chunks,
+    pool& _pool
+)
+{
+    const std::ptrdiff_t size = _end - _begin;
+    if(size <= 0)
+    {
+        return _identity;
+    }
+
+    // Each chunk writes its own object: a std::vector<bool> would pack the partial results in shared words
+    std::vector<std::optional<T> > results(detail::chunk_count(size, _nb_chunks, _pool));
+    parallel_for(
+        _begin,
+        _end,
+        [&_func, &results](std::ptrdiff_t _chunk_begin, std::ptrdiff_t _chunk_end, std::size_t _index)
+        {
+            results[_index].emplace(_func(_chunk_begin, _chunk_end));
+        },
+        results.size(),
+        _pool
+    );
+
+    T result = std::move(_identity);
+    for(auto& chunk_result : results)
+    {
+        result = _reduce(std::move(result), std::move(*chunk_result));
+    }
+
+    return result;
+}
+
+} // namespace sight::core::thread
@@ -173,10 +173,34 @@ public:
      */
     SIGHT_CORE_API virtual void process_tasks() = 0;
 
+    /**
+     * @brief Returns a serial view of this worker, if it runs its tasks concurrently.
+     *
+     * Tasks posted to the returned worker are executed one at a time and in posting order (strand semantics), but
+     * may run on any thread of this worker. Several strands created on the same worker run in parallel. This is
+     * how services share a multi-threaded worker while keeping their slots serialized.
+     *
+     * @return a new strand worker, or nullptr if this worker is already serial
+     */
+    SIGHT_CORE_API virtual SPTR(worker) create_strand();
+
+    /// Returns the number of threads running the tasks of this worker, 1 for a serial worker
+    [[nodiscard]] SIGHT_CORE_API virtual std::size_t thread_count() const;
+
     /// Creates and returns a new instance of Worker default implementation
     /// (boost::Asio).
     SIGHT_CORE_API static SPTR(worker) make();
 
+    /**
+     * @brief Creates and returns a new instance of Worker backed by several threads (boost::Asio).
+     *
+     * Tasks posted directly to this worker may run concurrently, use create_strand() to get a serial executor.
+     * With _nb_threads <= 1, this is equivalent to make().
+     *
+     * @param _nb_threads number of threads running the worker loop
+     */
+    SIGHT_CORE_API static SPTR(worker) make(std::size_t _nb_threads);
+
 protected:
 
     /// Copy constructor forbidden
@@ -28,9 +28,12 @@
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/placeholders.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/bind.hpp>
 
+#include <algorithm>
 #include <thread>
+#include <utility>
 
 namespace sight::core::thread
 {
@@ -98,6 +101,123 @@ private:
 
 //------------------------------------------------------------------------------
 
+/**
+ * @brief Private implementation of core::thread::worker using boost::asio, with one io_service run by several threads.
+ *
+ * Tasks posted directly to this worker are executed concurrently. Serial executors sharing these threads are obtained
+ * with create_strand().
+ */
+class worker_asio_pool : public core::thread::worker,
+                         public std::enable_shared_from_this<worker_asio_pool>
+{
+public:
+
+    using ioservice_type = boost::asio::io_service;
+    using work_type      = boost::asio::io_service::work;
+    using work_ptr_type  = std::shared_ptr<work_type>;
+    using thread_type    = std::thread;
+
+    explicit worker_asio_pool(std::size_t _nb_threads);
+
+    ~worker_asio_pool() override;
+
+    void stop() override;
+
+    void post(task_t _handler) override;
+
+    /// Returns the calling thread id if it belongs to this worker, a default id otherwise.
+    [[nodiscard]] thread_id_t get_thread_id() const override;
+
+    void set_thread_name(const std::string& _thread_name) const override;
+
+    SPTR(core::thread::timer) create_timer() override;
+
+    void process_tasks() override;
+
+    void process_tasks(period_t _maxtime) override;
+
+    SPTR(core::thread::worker) create_strand() override;
+
+    [[nodiscard]] std::size_t thread_count() const override;
+
+    /// Returns the io_service shared by all threads and strands of this worker.
+    ioservice_type& io_service()
+    {
+        return *m_io_service;
+    }
+
+private:
+
+    /// Class provides functionality to manipulate asynchronous tasks.
+    SPTR(ioservice_type) m_io_service;
+
+    /// Class to inform the io_service when it has work to do.
+    work_ptr_type m_work;
+
+    /// Threads created and managed by the worker.
+    std::vector<thread_type> m_threads;
+
+    /// Ids of m_threads, never modified after construction.
+    std::vector<thread_id_t> m_thread_ids;
+
+    /// Native handles of m_threads, never modified after construction.
+    std::vector<thread_type::native_handle_type> m_native_handles;
+
+    /// Fulfilled with the total number of handlers executed when all threads are joined.
+    std::promise<exit_return_type> m_exit_promise;
+
+    /// To avoid race conditions when calling stop()
+    std::recursive_mutex m_stop_mutex;
+};
+
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Private serial view of a worker_asio_pool, using a boost::asio strand.
+ *
+ * Tasks are executed one at a time and in posting order on any thread of the pool.
+ */
+class worker_asio_strand : public core::thread::worker
+{
+public:
+
+    using strand_type = boost::asio::io_service::strand;
+
+    explicit worker_asio_strand(std::shared_ptr<worker_asio_pool> _pool);
+
+    ~worker_asio_strand() override = default;
+
+    /// Waits for the tasks already posted to this strand. The threads are owned by the pool and keep running.
+    void stop() override;
+
+    void post(task_t _handler) override;
+
+    /// Returns the calling thread id if it is currently running a task of this strand, a default id otherwise.
+    [[nodiscard]] thread_id_t get_thread_id() const override;
+
+    /// Does nothing, threads are shared with other strands and are named by the pool.
+    void set_thread_name(const std::string& _thread_name) const override;
+
+    /// Creates a timer whose callbacks are serialized with the tasks of this strand.
+    SPTR(core::thread::timer) create_timer() override;
+
+    void process_tasks() override;
+
+    void process_tasks(period_t _maxtime) override;
+
+    future_t get_future() override;
+
+private:
+
+    /// The pool running the tasks, kept alive as long as the strand.
+    std::shared_ptr<worker_asio_pool> m_pool;
+
+    /// Strand serializing the tasks.
+    std::shared_ptr<strand_type> m_strand;
+};
+
+//------------------------------------------------------------------------------
+
 /**
  * @brief Private Timer implementation using boost::asio.
  */
@@ -113,6 +233,11 @@ public:
      */
     explicit timer_asio(boost::asio::io_service& _io_srv);
 
+    /**
+     * @brief Constructs a TimerAsio from given io_service, its callbacks being dispatched through the given strand.
+     */
+    timer_asio(boost::asio::io_service& _io_srv, std::shared_ptr<boost::asio::io_service::strand> _strand);
+
     ~timer_asio() override;
 
     /// Starts or restarts the timer.
@@ -163,6 +288,9 @@ private:
     /// Timer object.
     boost::asio::deadline_timer m_timer;
 
+    /// Optional strand serializing the callbacks with other tasks.
+    std::shared_ptr<boost::asio::io_service::strand> m_strand;
+
     /// Time to wait until timer's expiration.
     time_duration_t m_duration;
 
@@ -232,7 +360,7 @@ SPTR(core::thread::timer) worker_asio::create_timer()
 
 void worker_asio::post(task_t _handler)
 {
-    m_io_service->post(_handler);
+    m_io_service->post(std::move(_handler));
 }
 
 //------------------------------------------------------------------------------
@@ -269,12 +397,230 @@ void worker_asio::process_tasks(period_t _maxtime)
     }
 }
 
+// ---------- WorkerAsioPool private implementation ----------
+
+worker_asio_pool::worker_asio_pool(std::size_t _nb_threads) :
+    m_io_service(std::make_shared<ioservice_type>()),
+    m_work(std::make_shared<work_type>(*m_io_service))
+{
+    SIGHT_ASSERT("A multi-threaded worker needs at least one thread", _nb_threads > 0);
+
+    m_threads.reserve(_nb_threads);
+    m_thread_ids.reserve(_nb_threads);
+    m_native_handles.reserve(_nb_threads);
+    for(std::size_t i = 0 ; i < _nb_threads ; ++i)
+    {
+        m_threads.emplace_back([io_service = m_io_service]{worker_thread(io_service);});
+        m_thread_ids.push_back(m_threads.back().get_id());
+        m_native_handles.push_back(m_threads.back().native_handle());
+    }
+
+    m_future = m_exit_promise.get_future();
+}
+
+//------------------------------------------------------------------------------
+
+worker_asio_pool::~worker_asio_pool()
+{
+    std::unique_lock<std::recursive_mutex> lock(m_stop_mutex);
+
+    SIGHT_ASSERT(
+        "Worker must be properly stopped. Try to call stop() from the caller thread before.",
+        std::ranges::none_of(m_threads, [](const auto& _t){return _t.joinable();})
+    );
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_pool::stop()
+{
+    // stop() is also called in the destructor, so we need to put a critical section here
+    std::unique_lock<std::recursive_mutex> lock(m_stop_mutex);
+
+    SIGHT_ASSERT("Thread is not joinable", !m_threads.empty() && m_threads.front().joinable());
+    SIGHT_ASSERT(
+        "Can not destroy a thread while running it. Try to call stop() from the caller thread before.",
+        this->get_thread_id() != core::thread::get_current_thread_id()
+    );
+
+    m_work.reset();
+    for(auto& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    m_exit_promise.set_value(exit_return_type());
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(core::thread::timer) worker_asio_pool::create_timer()
+{
+    return std::make_shared<timer_asio>(*m_io_service);
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_pool::post(task_t _handler)
+{
+    m_io_service->post(std::move(_handler));
+}
+
+//------------------------------------------------------------------------------
+
+thread_id_t worker_asio_pool::get_thread_id() const
+{
+    const auto current = core::thread::get_current_thread_id();
+    return std::ranges::find(m_thread_ids, current) != m_thread_ids.end() ? current : thread_id_t();
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_pool::set_thread_name(const std::string& _thread_name) const
+{
+    for(const auto& handle : m_native_handles)
+    {
+        core::thread::set_thread_name(_thread_name, handle);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_pool::process_tasks()
+{
+    m_io_service->poll();
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_pool::process_tasks(period_t _maxtime)
+{
+    core::time_stamp time_stamp;
+    time_stamp.set_life_period(_maxtime);
+    time_stamp.modified();
+    while(time_stamp.period_expired())
+    {
+        m_io_service->poll_one();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(core::thread::worker) worker_asio_pool::create_strand()
+{
+    return std::make_shared<worker_asio_strand>(this->shared_from_this());
+}
+
+//------------------------------------------------------------------------------
+
+std::size_t worker_asio_pool::thread_count() const
+{
+    return m_thread_ids.size();
+}
+
+// ---------- WorkerAsioStrand private implementation ----------
+
+worker_asio_strand::worker_asio_strand(std::shared_ptr<worker_asio_pool> _pool) :
+    m_pool(std::move(_pool)),
+    m_strand(std::make_shared<strand_type>(m_pool->io_service()))
+{
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_strand::stop()
+{
+    if(m_strand->running_in_this_thread())
+    {
+        return;
+    }
+
+    // Tasks of a strand are executed in order, so once this one is processed, all the previous ones are too
+    std::promise<void> flushed;
+    m_strand->post([&flushed]{flushed.set_value();});
+    flushed.get_future().wait();
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_strand::post(task_t _handler)
+{
+    m_strand->post(std::move(_handler));
+}
+
+//------------------------------------------------------------------------------
+
+thread_id_t worker_asio_strand::get_thread_id() const
+{
+    return m_strand->running_in_this_thread() ? core::thread::get_current_thread_id() : thread_id_t();
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_strand::set_thread_name(const std::string& /*_thread_name*/) const
+{
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(core::thread::timer) worker_asio_strand::create_timer()
+{
+    return std::make_shared<timer_asio>(m_pool->io_service(), m_strand);
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_strand::process_tasks()
+{
+    m_pool->process_tasks();
+}
+
+//------------------------------------------------------------------------------
+
+void worker_asio_strand::process_tasks(period_t _maxtime)
+{
+    m_pool->process_tasks(_maxtime);
+}
+
+//------------------------------------------------------------------------------
+
+worker::future_t worker_asio_strand::get_future()
+{
+    return m_pool->get_future();
+}
+
 // ---------- Worker ----------
 SPTR(worker) worker::make()
 {
     return std::make_shared<worker_asio>();
 }
 
+//------------------------------------------------------------------------------
+
+SPTR(worker) worker::make(std::size_t _nb_threads)
+{
+    if(_nb_threads <= 1)
+    {
+        return std::make_shared<worker_asio>();
+    }
+
+    return std::make_shared<worker_asio_pool>(_nb_threads);
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(worker) worker::create_strand()
+{
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+std::size_t worker::thread_count() const
+{
+    return 1;
+}
+
 // ---------- Timer private implementation ----------
 
 timer_asio::timer_asio(boost::asio::io_service& _io_srv) :
@@ -283,6 +629,16 @@ timer_asio::timer_asio(boost::asio::io_service& _io_srv) :
 {
 }
 
+timer_asio::timer_asio(
+    boost::asio::io_service& _io_srv,
+    std::shared_ptr<boost::asio::io_service::strand> _strand
+) :
+    m_timer(_io_srv),
+    m_strand(std::move(_strand)),
+    m_duration(std::chrono::seconds(1))
+{
+}
+
 timer_asio::~timer_asio()
 = default;
 
@@ -363,7 +719,15 @@ void timer_asio::rearm_no_lock(time_duration_t _duration)
         boost::posix_time::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(_duration).count());
     m_timer.expires_from_now(d);
     // NOLINTNEXTLINE(modernize-avoid-bind)
-    m_timer.async_wait(boost::bind(timer_callback::call, boost::asio::placeholders::error, this->get_sptr()));
+    auto callback = boost::bind(timer_callback::call, boost::asio::placeholders::error, this->get_sptr());
+    if(m_strand)
+    {
+        m_timer.async_wait(m_strand->wrap(callback));
+    }
+    else
+    {
+        m_timer.async_wait(callback);
+    }
 }
 
 //------------------------------------------------------------------------------
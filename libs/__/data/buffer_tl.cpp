@@ -53,6 +53,33 @@ void buffer_tl::alloc_pool_size(std::size_t _size)
 
     SIGHT_ASSERT("Allocation size must be greater than 0", _size > 0);
     m_pool = std::make_shared<pool_t>(_size);
+
+    // The slots of the ring no longer match the buffers, the producer enables it again if needed
+    std::atomic_store(&m_ring, timeline::ring::sptr());
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_tl::init_ring(std::size_t _capacity)
+{
+    SIGHT_THROW_IF("The pool must be allocated before the ring.", !m_pool);
+    std::atomic_store(&m_ring, std::make_shared<timeline::ring>(_capacity, m_pool->get_requested_size()));
+}
+
+//------------------------------------------------------------------------------
+
+timeline::ring::writer buffer_tl::begin_push()
+{
+    const timeline::ring::sptr ring = std::atomic_load(&m_ring);
+    return ring ? ring->begin_push() : timeline::ring::writer {};
+}
+
+//------------------------------------------------------------------------------
+
+void buffer_tl::publish(timeline::ring::writer& _writer, core::clock::type _timestamp, std::uint64_t _mask)
+{
+    _writer.publish(_timestamp, _mask);
+    m_newer_push_time = core::clock::get_time_in_milli_sec();
 }
 
 //------------------------------------------------------------------------------
@@ -69,7 +96,12 @@ void buffer_tl::push_object(const SPTR(data::timeline::object)& _obj)
     }
 
     SPTR(data::timeline::buffer) src_obj = std::dynamic_pointer_cast<data::timeline::buffer>(_obj);
-    m_timeline.insert(timeline_t::value_type(_obj->get_timestamp(), src_obj));
+    const auto inserted                  = m_timeline.insert(timeline_t::value_type(_obj->get_timestamp(), src_obj));
+
+    if(inserted.second && std::next(inserted.first) == m_timeline.end())
+    {
+        m_newer_push_time = core::clock::get_time_in_milli_sec();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -218,7 +250,12 @@ core::clock::type buffer_tl::get_newer_timestamp() const
 {
     core::clock::type result = 0;
 
-    if(!m_timeline.empty())
+    if(const timeline::ring::sptr ring = std::atomic_load(&m_ring); ring)
+    {
+        const timeline::ring::view newest = ring->get_newest();
+        result = newest ? newest.timestamp() : 0.;
+    }
+    else if(!m_timeline.empty())
     {
         result = m_timeline.rbegin()->first;
     }
@@ -232,6 +269,11 @@ void buffer_tl::clear_timeline()
 {
     m_timeline.clear();
 
+    if(const timeline::ring::sptr ring = std::atomic_load(&m_ring); ring)
+    {
+        ring->clear();
+    }
+
     auto sig = this->signal<timeline::signals::cleared_t>(timeline::signals::CLEARED);
     sig->async_emit();
 }
@@ -26,17 +26,26 @@
 
 #include "data/timeline/base.hpp"
 #include "data/timeline/buffer.hpp"
+#include "data/timeline/ring.hpp"
 
 #include <boost/array.hpp>
 #include <boost/pool/pool.hpp>
 #include <boost/pool/poolfwd.hpp>
 
+#include <atomic>
+#include <mutex>
+
 namespace sight::data
 {
 
 /**
  * @brief   This class defines a timeline of buffers. It implements basic features of the Timeline interface such as
  *          pushing or retrieving objects. Allocation must be done by inherited classes.
+ *
+ * The timeline may also hold a timeline::ring, enabled with init_ring(). The producer then writes the buffers in
+ * place into the ring with begin_push() and publish(), and the consumers read them in place with get_ring(), none of
+ * them locking the timeline. It suits streams with several consumers that only need the newest or the closest
+ * buffers, such as videos. The buffers of the ring are not in the map of the timeline.
  */
 class SIGHT_DATA_CLASS_API buffer_tl : public timeline::base
 {
@@ -47,7 +56,44 @@ public:
     using timestamp_t   = core::clock::type;
     using timeline_t    = std::map<timestamp_t, std::shared_ptr<timeline::buffer> >;
     using buffer_pair_t = std::pair<timestamp_t, std::shared_ptr<timeline::buffer> >;
-    using pool_t        = boost::pool<>;
+
+    /**
+     * @brief Pool of the buffers of the timeline.
+     *
+     * Buffers are allocated under the lock of the timeline, but they are released by their last owner, which may be a
+     * consumer holding them without the lock. The pool is thus locked by itself.
+     */
+    class pool_t : private boost::pool<>
+    {
+    public:
+
+        explicit pool_t(std::size_t _requested_size) :
+            boost::pool<>(_requested_size)
+        {
+        }
+
+        //------------------------------------------------------------------------------
+
+        void* malloc()
+        {
+            std::lock_guard lock(m_mutex);
+            return boost::pool<>::malloc();
+        }
+
+        //------------------------------------------------------------------------------
+
+        void free(void* _chunk)
+        {
+            std::lock_guard lock(m_mutex);
+            boost::pool<>::free(_chunk);
+        }
+
+        using boost::pool<>::get_requested_size;
+
+    private:
+
+        std::mutex m_mutex;
+    };
 
     SIGHT_DATA_API buffer_tl();
     SIGHT_DATA_API ~buffer_tl() override;
@@ -87,9 +133,18 @@ public:
     /// Return the last object in the timeline
     SIGHT_DATA_API CSPTR(timeline::object) get_newer_object() const;
 
-    /// Return the last timestamp in the timeline
+    /// Return the last timestamp in the timeline, or in its ring if it is enabled
     SIGHT_DATA_API core::clock::type get_newer_timestamp() const;
 
+    /**
+     * @brief Return when the last object of the timeline was pushed, with core::clock::get_time_in_milli_sec().
+     * @return 0 if no object was pushed as the last one of the timeline
+     */
+    [[nodiscard]] core::clock::type get_newer_push_time() const
+    {
+        return m_newer_push_time;
+    }
+
     /// Change the maximum size of the timeline
     void set_maximum_size(std::size_t _maximum_size)
     {
@@ -105,6 +160,35 @@ public:
         return m_pool != nullptr;
     }
 
+    /**
+     * @brief Enables the lock-free ring of this timeline, with slots of the size of the buffers of the pool.
+     *
+     * The ring is disabled when the pool is reallocated, and it is cleared with the timeline.
+     * @pre The pool must be allocated.
+     * @param _capacity number of slots, it must be greater than the number of buffers read at the same time
+     */
+    SIGHT_DATA_API void init_ring(std::size_t _capacity);
+
+    /**
+     * @brief Returns the lock-free ring of this timeline, or nullptr if it is not enabled.
+     * @note The ring is published atomically and is itself thread-safe, the timeline does not need to be locked.
+     */
+    [[nodiscard]] timeline::ring::sptr get_ring() const
+    {
+        return std::atomic_load(&m_ring);
+    }
+
+    /**
+     * @brief Claims a slot of the ring, for the producer to write the next buffer in place.
+     *
+     * The timeline does not need to be locked. There must be a single producer, which no longer calls push_object().
+     * @return an empty writer if the ring is not enabled or if all its slots are borrowed
+     */
+    SIGHT_DATA_API timeline::ring::writer begin_push();
+
+    /// Makes a slot claimed with begin_push() visible to the consumers, the timeline does not need to be locked
+    SIGHT_DATA_API void publish(timeline::ring::writer& _writer, core::clock::type _timestamp, std::uint64_t _mask = 1);
+
     /// Equality comparison operators
     /// @{
     SIGHT_DATA_API bool operator==(const buffer_tl& _other) const noexcept;
@@ -124,6 +208,13 @@ protected:
 
     /// maximum size
     std::size_t m_maximum_size;
+
+    /// Lock-free ring, see init_ring(), it is replaced while consumers may read it without locking the timeline, so
+    /// it is only accessed with std::atomic_load() and std::atomic_store()
+    timeline::ring::sptr m_ring;
+
+    /// Time when the last object was pushed, see get_newer_push_time(), it can be read without locking the timeline
+    std::atomic<core::clock::type> m_newer_push_time {0.};
 }; // class buffer_tl
 
 } // namespace sight::data
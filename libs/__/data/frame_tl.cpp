@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -23,8 +23,10 @@
 #include "data/frame_tl.hpp"
 
 #include <core/base.hpp>
+#include <core/memory/buffer_allocation_policy.hpp>
 
 #include <data/exception.hpp>
+#include <data/image.hpp>
 #include <data/registry/macros.hpp>
 
 SIGHT_REGISTER_DATA(sight::data::frame_tl);
@@ -32,6 +34,56 @@ SIGHT_REGISTER_DATA(sight::data::frame_tl);
 namespace sight::data
 {
 
+namespace
+{
+
+/// Allocation policy of an image viewing a timeline buffer: it only keeps the buffer alive.
+class view_policy final : public core::memory::buffer_allocation_policy
+{
+public:
+
+    explicit view_policy(CSPTR(timeline::buffer) _buffer) :
+        m_buffer(std::move(_buffer))
+    {
+    }
+
+    //------------------------------------------------------------------------------
+
+    void allocate(buffer_t& /*_buffer*/, size_type /*_size*/) override
+    {
+        SIGHT_THROW_EXCEPTION_MSG(core::memory::exception::memory, "A timeline buffer view can not be allocated.");
+    }
+
+    //------------------------------------------------------------------------------
+
+    void reallocate(buffer_t& /*_buffer*/, size_type /*_size*/) override
+    {
+        SIGHT_THROW_EXCEPTION_MSG(core::memory::exception::memory, "A timeline buffer view can not be reallocated.");
+    }
+
+    //------------------------------------------------------------------------------
+
+    void destroy(buffer_t& _buffer) override
+    {
+        _buffer = nullptr;
+        m_buffer.reset();
+    }
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] bool is_dumpable() const override
+    {
+        // Once dumped, the memory could not be allocated again to restore the image
+        return false;
+    }
+
+private:
+
+    CSPTR(timeline::buffer) m_buffer;
+};
+
+} // namespace
+
 //------------------------------------------------------------------------------
 
 frame_tl::frame_tl()
@@ -126,6 +178,53 @@ void frame_tl::init_pool_size(unsigned int /*maxElementNum*/)
 
 //------------------------------------------------------------------------------
 
+enum data::image::pixel_format frame_tl::to_image_format(enum pixel_format _format)
+{
+    switch(_format)
+    {
+        case pixel_format::gray_scale:
+            return data::image::gray_scale;
+
+        case pixel_format::rgb:
+            return data::image::rgb;
+
+        case pixel_format::bgr:
+            return data::image::bgr;
+
+        case pixel_format::rgba:
+            return data::image::rgba;
+
+        case pixel_format::bgra:
+            return data::image::bgra;
+
+        default:
+            return data::image::undefined;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void frame_tl::view(data::image& _image, const CSPTR(buffer_t)& _buffer, unsigned int _element) const
+{
+    SIGHT_ASSERT("Buffer is null", _buffer);
+
+    const enum data::image::pixel_format format = to_image_format(m_pixel_format);
+    SIGHT_THROW_EXCEPTION_IF(exception("Frame timeline pixel format undefined"), format == data::image::undefined);
+
+    // The image only reads the buffer, the const_cast is needed by the buffer_object API
+    auto* const element = const_cast<std::uint8_t*>(&_buffer->get_element(_element)); // NOLINT
+    _image.set_buffer(
+        element,
+        false,
+        m_type,
+        {m_width, m_height, 0},
+        format,
+        std::make_shared<view_policy>(_buffer)
+    );
+}
+
+//------------------------------------------------------------------------------
+
 bool frame_tl::operator==(const frame_tl& _other) const noexcept
 {
     if(m_width != _other.m_width
@@ -25,6 +25,7 @@
 #include "data/factory/new.hpp"
 #include "data/generic_tl.hpp"
 #include "data/generic_tl.hxx"
+#include "data/image.hpp"
 #include "data/timeline/generic_object.hpp"
 #include "data/timeline/generic_object.hxx"
 
@@ -102,6 +103,23 @@ public:
     /// Set the frame pixel format
     void set_pixel_format(enum pixel_format _format);
 
+    /// Returns the image pixel format matching a frame pixel format, image::undefined if there is none
+    SIGHT_DATA_API static enum image::pixel_format to_image_format(enum pixel_format _format);
+
+    /**
+     * @brief Makes an image point to an element of a buffer of this timeline, without copying it.
+     *
+     * The image holds a reference on the buffer, so the pool slot is only given back to the timeline once the image
+     * points to another buffer or is destroyed. The image does not own the memory, it must thus be considered as
+     * read-only and can not be resized. The buffer manager does not dump it either, since it could not be restored.
+     *
+     * @param _image image to set
+     * @param _buffer buffer of this timeline
+     * @param _element index of the element in the buffer
+     * @throw data::exception if the pixel format of the timeline is undefined
+     */
+    SIGHT_DATA_API void view(data::image& _image, const CSPTR(buffer_t)& _buffer, unsigned int _element = 0) const;
+
     /// Equality comparison operators
     /// @{
     SIGHT_DATA_API bool operator==(const frame_tl& _other) const noexcept;
@@ -22,12 +22,23 @@
 
 #include "frame_tl_test.hpp"
 
+#include <core/memory/buffer_manager.hpp>
+#include <core/spy_log.hpp>
+
 #include <data/frame_tl.hpp>
+#include <data/image.hpp>
 #include <data/timeline/buffer.hpp>
+#include <data/timeline/ring.hpp>
 
 #include <utest/exception.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <vector>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::data::ut::frame_tl_test);
@@ -173,8 +184,15 @@ void frame_tl_test::push_test()
     std::uint8_t* buffer_data2 = data2->add_element(0);
     std::memset(buffer_data2, 2, (10LL * 20 * 3));
 
-    timeline->push_object(data1);
+    CPPUNIT_ASSERT_EQUAL(0., timeline->get_newer_push_time());
+    const core::clock::type before_push = core::clock::get_time_in_milli_sec();
     timeline->push_object(data2);
+    const core::clock::type push_time = timeline->get_newer_push_time();
+    CPPUNIT_ASSERT(push_time >= before_push);
+
+    // An older object does not change the time of the newest one
+    timeline->push_object(data1);
+    CPPUNIT_ASSERT_EQUAL(push_time, timeline->get_newer_push_time());
 
     CSPTR(data::timeline::object) data_pushed1 = timeline->get_object(time1);
     CPPUNIT_ASSERT(data1 == data_pushed1);
@@ -300,4 +318,383 @@ void frame_tl_test::equality_test()
 
 //------------------------------------------------------------------------------
 
+void frame_tl_test::ring_test()
+{
+    constexpr std::size_t frame_size = 10LL * 20 * 3;
+
+    data::frame_tl::sptr timeline = std::make_shared<data::frame_tl>();
+    CPPUNIT_ASSERT_THROW(timeline->init_ring(3), core::exception);
+
+    timeline->init_pool_size(10, 20, core::type::UINT8, data::frame_tl::pixel_format::rgb);
+    CPPUNIT_ASSERT(!timeline->get_ring());
+    timeline->init_ring(3);
+
+    const data::timeline::ring::sptr ring = timeline->get_ring();
+    CPPUNIT_ASSERT(ring);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), ring->capacity());
+    CPPUNIT_ASSERT_EQUAL(frame_size, ring->slot_size());
+    CPPUNIT_ASSERT(!ring->get_newest());
+
+    const auto push =
+        [&](core::clock::type _timestamp, std::uint8_t _value)
+        {
+            data::timeline::ring::writer writer = ring->begin_push();
+            CPPUNIT_ASSERT(writer);
+            std::fill(writer.data(), writer.data() + frame_size, _value);
+            writer.publish(_timestamp);
+        };
+
+    push(10., 1);
+    push(20., 2);
+
+    {
+        const data::timeline::ring::view newest = ring->get_newest();
+        CPPUNIT_ASSERT(newest);
+        CPPUNIT_ASSERT_EQUAL(20., newest.timestamp());
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(2), newest.data()[frame_size - 1]);
+
+        CPPUNIT_ASSERT_EQUAL(10., ring->get_closest(14.).timestamp());
+        CPPUNIT_ASSERT_EQUAL(20., ring->get_closest(16.).timestamp());
+        CPPUNIT_ASSERT_EQUAL(10., ring->get_closest(19., data::timeline::past).timestamp());
+        CPPUNIT_ASSERT_EQUAL(20., ring->get_closest(11., data::timeline::future).timestamp());
+        CPPUNIT_ASSERT(!ring->get_closest(21., data::timeline::future));
+        CPPUNIT_ASSERT(!ring->get_closest(9., data::timeline::past));
+
+        // The borrowed frame is not overwritten, the producer skips it
+        push(30., 3);
+        push(40., 4);
+        push(50., 5);
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(2), newest.data()[0]);
+        CPPUNIT_ASSERT_EQUAL(50., ring->get_newest().timestamp());
+        CPPUNIT_ASSERT_EQUAL(20., ring->get_closest(20.).timestamp());
+
+        // All slots but one are borrowed, the producer fails once they are all taken
+        const data::timeline::ring::view second = ring->get_closest(40.);
+        const data::timeline::ring::view third  = ring->get_newest();
+        CPPUNIT_ASSERT(!ring->begin_push());
+    }
+
+    // An aborted push empties its slot
+    {
+        data::timeline::ring::writer writer = ring->begin_push();
+        CPPUNIT_ASSERT(writer);
+    }
+    CPPUNIT_ASSERT_EQUAL(50., ring->get_newest().timestamp());
+
+    // Clearing the timeline clears the ring
+    timeline->clear_timeline();
+    CPPUNIT_ASSERT(!ring->get_newest());
+    push(60., 6);
+    CPPUNIT_ASSERT_EQUAL(60., ring->get_newest().timestamp());
+
+    // The producer writes in place through the timeline, which gives the newest timestamp of the ring
+    {
+        data::timeline::ring::writer writer = timeline->begin_push();
+        CPPUNIT_ASSERT(writer);
+        std::fill(writer.data(), writer.data() + frame_size, std::uint8_t(7));
+        timeline->publish(writer, 70.);
+
+        const data::timeline::ring::view newest = ring->get_newest();
+        CPPUNIT_ASSERT_EQUAL(70., newest.timestamp());
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(7), newest.data()[frame_size - 1]);
+        CPPUNIT_ASSERT_EQUAL(70., timeline->get_newer_timestamp());
+        CPPUNIT_ASSERT(timeline->get_newer_push_time() > 0.);
+    }
+
+    // Reallocating the pool disables the ring, the views already borrowed remain valid
+    {
+        const data::timeline::ring::view newest = ring->get_newest();
+        timeline->init_pool_size(4, 4, core::type::UINT8, data::frame_tl::pixel_format::gray_scale);
+        CPPUNIT_ASSERT(!timeline->get_ring());
+        CPPUNIT_ASSERT(!timeline->begin_push());
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(7), newest.data()[frame_size - 1]);
+    }
+
+    timeline->init_ring(2);
+    CPPUNIT_ASSERT(timeline->get_ring() != ring);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(16), timeline->get_ring()->slot_size());
+}
+
+//------------------------------------------------------------------------------
+
+void frame_tl_test::concurrent_release_test()
+{
+    constexpr std::size_t nb_frames    = 2000;
+    constexpr std::size_t nb_consumers = 4;
+
+    auto timeline = std::make_shared<data::frame_tl>();
+    timeline->init_pool_size(16, 16, core::type::UINT8, data::frame_tl::pixel_format::rgba);
+    timeline->set_maximum_size(2);
+
+    // Consumers keep the buffers beyond the lock of the timeline, the last owner releases them into the pool
+    std::atomic<bool> done {false};
+    std::atomic<std::size_t> nb_invalid {0};
+    std::vector<std::thread> consumers;
+    for(std::size_t i = 0 ; i < nb_consumers ; ++i)
+    {
+        consumers.emplace_back(
+            [&]
+            {
+                while(!done)
+                {
+                    CSPTR(data::frame_tl::buffer_t) buffer;
+                    {
+                        core::mt::read_lock lock(timeline->get_mutex());
+                        buffer = std::dynamic_pointer_cast<const data::frame_tl::buffer_t>(
+                            timeline->get_newer_object()
+                        );
+                    }
+
+                    if(buffer && buffer->get_element(0) != static_cast<std::uint8_t>(buffer->get_timestamp()))
+                    {
+                        ++nb_invalid;
+                    }
+                }
+            });
+    }
+
+    for(std::size_t i = 0 ; i < nb_frames ; ++i)
+    {
+        core::mt::write_lock lock(timeline->get_mutex());
+        SPTR(data::frame_tl::buffer_t) buffer = timeline->create_buffer(static_cast<core::clock::type>(i));
+        std::fill_n(buffer->add_element(0), 16 * 16 * 4, static_cast<std::uint8_t>(i));
+        timeline->push_object(buffer);
+    }
+
+    done = true;
+    for(auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), nb_invalid.load());
+}
+
+//------------------------------------------------------------------------------
+
+void frame_tl_test::benchmark_ring()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    constexpr std::size_t width        = 640;
+    constexpr std::size_t height       = 480;
+    constexpr std::size_t frame_size   = width * height * 4;
+    constexpr std::size_t nb_frames    = 500;
+    constexpr std::size_t nb_consumers = 4;
+
+    // Consumers read one byte per cache line, and check that the frame is not torn
+    const auto consume =
+        [](const std::uint8_t* _frame)
+        {
+            std::size_t sum = 0;
+            for(std::size_t i = 0 ; i < frame_size ; i += 64)
+            {
+                sum += _frame[i];
+            }
+
+            return _frame[0] == _frame[frame_size - 1] && sum >= _frame[0];
+        };
+
+    const auto run =
+        [&](const std::string& _label, const auto& _produce, const auto& _read)
+        {
+            std::atomic<bool> done {false};
+            std::atomic<std::size_t> nb_reads {0};
+            std::atomic<std::size_t> nb_torn {0};
+
+            // Failures are counted, they are asserted in this thread
+            std::vector<std::thread> consumers;
+            for(std::size_t i = 0 ; i < nb_consumers ; ++i)
+            {
+                consumers.emplace_back(
+                    [&]
+                    {
+                        while(!done)
+                        {
+                            if(const auto frame = _read(); frame.has_value())
+                            {
+                                ++nb_reads;
+                                nb_torn += *frame ? 0 : 1;
+                            }
+                        }
+                    });
+            }
+
+            std::size_t nb_skipped = 0;
+            const auto start       = std::chrono::steady_clock::now();
+            for(std::size_t i = 0 ; i < nb_frames ; ++i)
+            {
+                nb_skipped += _produce(static_cast<core::clock::type>(i), static_cast<std::uint8_t>(i)) ? 0 : 1;
+            }
+
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            done = true;
+            for(auto& consumer : consumers)
+            {
+                consumer.join();
+            }
+
+            // The timeline holds more slots than there are consumers, so no frame is skipped
+            CPPUNIT_ASSERT_EQUAL(std::size_t(0), nb_skipped);
+            CPPUNIT_ASSERT_EQUAL(std::size_t(0), nb_torn.load());
+
+            SIGHT_INFO(
+                "timeline - " << _label << ": " << static_cast<double>(nb_frames - nb_skipped) / elapsed
+                << " frames/s pushed, " << static_cast<double>(nb_reads) / elapsed << " frames/s read by "
+                << nb_consumers << " consumers"
+            );
+        };
+
+    const auto push =
+        [&](const data::frame_tl::sptr& _timeline, core::clock::type _timestamp, std::uint8_t _value)
+        {
+            SPTR(data::frame_tl::buffer_t) buffer;
+            {
+                core::mt::write_lock lock(_timeline->get_mutex());
+                buffer = _timeline->create_buffer(_timestamp);
+            }
+
+            std::uint8_t* frame = buffer->add_element(0);
+            std::fill(frame, frame + frame_size, _value);
+
+            core::mt::write_lock lock(_timeline->get_mutex());
+            _timeline->push_object(buffer);
+            return true;
+        };
+
+    // Map-based timeline, locked like data::mt::locked_ptr does
+    {
+        data::frame_tl::sptr timeline = std::make_shared<data::frame_tl>();
+        timeline->init_pool_size(width, height, core::type::UINT8, data::frame_tl::pixel_format::rgba);
+        timeline->set_maximum_size(10);
+
+        run(
+            "map",
+            [&](core::clock::type _timestamp, std::uint8_t _value){return push(timeline, _timestamp, _value);},
+            [&]() -> std::optional<bool>
+            {
+                core::mt::read_lock lock(timeline->get_mutex());
+                const auto buffer = std::dynamic_pointer_cast<const data::frame_tl::buffer_t>(
+                    timeline->get_newer_object()
+                );
+                return buffer ? std::make_optional(consume(&buffer->get_element(0))) : std::nullopt;
+            });
+    }
+
+    // Same timeline, written and read in place through its ring without any lock
+    {
+        data::frame_tl::sptr timeline = std::make_shared<data::frame_tl>();
+        timeline->init_pool_size(width, height, core::type::UINT8, data::frame_tl::pixel_format::rgba);
+        timeline->init_ring(10);
+        const data::timeline::ring::sptr ring = timeline->get_ring();
+
+        run(
+            "ring",
+            [&](core::clock::type _timestamp, std::uint8_t _value)
+            {
+                data::timeline::ring::writer writer = timeline->begin_push();
+                if(!writer)
+                {
+                    return false;
+                }
+
+                std::fill(writer.data(), writer.data() + frame_size, _value);
+                timeline->publish(writer, _timestamp);
+                return true;
+            },
+            [&]() -> std::optional<bool>
+            {
+                const data::timeline::ring::view view = ring->get_newest();
+                return view ? std::make_optional(consume(view.data())) : std::nullopt;
+            });
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void frame_tl_test::view_test()
+{
+    auto timeline = std::make_shared<frame_tl>();
+    timeline->init_pool_size(4, 3, core::type::UINT8, frame_tl::pixel_format::rgba, 2);
+
+    {
+        SPTR(frame_tl::buffer_t) buffer = timeline->create_buffer(1);
+        std::fill_n(buffer->add_element(0), 4 * 3 * 4, std::uint8_t(1));
+        std::fill_n(buffer->add_element(1), 4 * 3 * 4, std::uint8_t(2));
+        timeline->push_object(buffer);
+    }
+
+    std::weak_ptr<const frame_tl::buffer_t> weak_buffer = timeline->get_closest_buffer(1);
+
+    auto image = std::make_shared<data::image>();
+    timeline->view(*image, timeline->get_closest_buffer(1), 1);
+
+    CPPUNIT_ASSERT_EQUAL(data::image::rgba, image->pixel_format());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), image->num_components());
+    CPPUNIT_ASSERT(core::type::UINT8 == image->type());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), image->size()[0]);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), image->size()[1]);
+
+    {
+        const auto dump_lock = image->dump_lock();
+        CPPUNIT_ASSERT_EQUAL(
+            static_cast<const void*>(&timeline->get_closest_buffer(1)->get_element(1)),
+            static_cast<const void*>(image->buffer())
+        );
+        CPPUNIT_ASSERT(
+            std::all_of(
+                image->cbegin<std::uint8_t>(),
+                image->cend<std::uint8_t>(),
+                [](std::uint8_t _x){return _x == 2;})
+        );
+    }
+
+    // The image can not be resized since it does not own the memory
+    CPPUNIT_ASSERT_THROW(image->resize({8, 8, 0}, core::type::UINT8, data::image::rgba), data::exception);
+
+    // The image is not dumped, its memory could not be allocated again to restore it
+    {
+        const auto manager        = core::memory::buffer_manager::get();
+        const auto buffer_pointer = image->get_buffer_object()->get_buffer_pointer();
+        CPPUNIT_ASSERT(!manager->dump_buffer(buffer_pointer).get());
+        CPPUNIT_ASSERT(manager->get_buffer_infos().get().at(buffer_pointer).loaded);
+    }
+
+    // The image keeps the buffer alive once it is removed from the timeline...
+    timeline->clear_timeline();
+    CPPUNIT_ASSERT(!weak_buffer.expired());
+
+    // ... until it points to another buffer
+    image->set_buffer(nullptr, true, core::type::UINT8, {4, 3, 0}, data::image::rgba);
+    CPPUNIT_ASSERT(weak_buffer.expired());
+
+    // ... or is destroyed
+    {
+        SPTR(frame_tl::buffer_t) buffer = timeline->create_buffer(2);
+        buffer->add_element(0);
+        timeline->push_object(buffer);
+    }
+    weak_buffer = timeline->get_closest_buffer(2);
+    timeline->view(*image, timeline->get_closest_buffer(2));
+    timeline->clear_timeline();
+    CPPUNIT_ASSERT(!weak_buffer.expired());
+    image.reset();
+    CPPUNIT_ASSERT(weak_buffer.expired());
+
+    // A timeline without pixel format can not be viewed
+    auto undefined = std::make_shared<frame_tl>();
+    undefined->init_pool_size(4, 3, core::type::UINT8, frame_tl::pixel_format::undefined);
+    SPTR(frame_tl::buffer_t) buffer = undefined->create_buffer(3);
+    buffer->add_element(0);
+    auto other = std::make_shared<data::image>();
+    CPPUNIT_ASSERT_THROW(undefined->view(*other, buffer), data::exception);
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::data::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -36,6 +36,10 @@ public:
     CPPUNIT_TEST(push_test);
     CPPUNIT_TEST(copy_test);
     CPPUNIT_TEST(equality_test);
+    CPPUNIT_TEST(ring_test);
+    CPPUNIT_TEST(concurrent_release_test);
+    CPPUNIT_TEST(benchmark_ring);
+    CPPUNIT_TEST(view_test);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -48,6 +52,10 @@ public:
     static void push_test();
     static void copy_test();
     static void equality_test();
+    static void ring_test();
+    static void concurrent_release_test();
+    static void benchmark_ring();
+    static void view_test();
 };
 
 } // namespace sight::data::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -22,26 +22,32 @@
 
 #pragma once
 
+#include <core/thread/pool.hpp>
+
 #include <algorithm>
 #include <cstddef>
 #include <limits>
-#include <thread>
-#include <vector>
 
 namespace sight::data::thread
 {
 
+/**
+ * @brief Splits a region into as many chunks as threads and processes them in parallel.
+ *
+ * The chunks are run on the process-wide core::thread::pool, so no thread is created on each call.
+ */
 class region_threader
 {
 public:
 
     region_threader() :
-        m_nb_thread((std::thread::hardware_concurrency() > 1) ? std::thread::hardware_concurrency() : 1)
+        m_nb_thread(std::max<std::size_t>(core::thread::pool::get().concurrency(), 1))
     {
     }
 
     region_threader(std::size_t _nb_thread, bool _capped = true) :
-        m_nb_thread(std::min(_capped ? std::thread::hardware_concurrency() : std::numeric_limits<std::size_t>::max(),
+        m_nb_thread(std::min(_capped ? std::max<std::size_t>(core::thread::pool::get().concurrency(), 1)
+                                     : std::numeric_limits<std::size_t>::max(),
                              (_nb_thread > 1) ? _nb_thread : 1))
     {
     }
@@ -51,32 +57,17 @@ public:
     template<typename T>
     void operator()(T _func, const std::ptrdiff_t _data_size)
     {
-        std::vector<std::thread> threads;
-
-        const std::ptrdiff_t step = (_data_size / static_cast<std::ptrdiff_t>(m_nb_thread)) + 1;
-
         if(m_nb_thread > 1)
         {
-            std::ptrdiff_t region_begin = 0;
-            std::size_t thread_id       = 0;
-            for( ; region_begin < _data_size ; region_begin += step, ++thread_id)
-            {
-                threads.push_back(
-                    std::thread(
-                        _func,
-                        region_begin,
-                        std::min(_data_size, region_begin + step),
-                        thread_id
-                    )
-                );
-            }
-
-            for(auto& thread : threads)
-            {
-                thread.join();
-            }
-
-            threads.clear();
+            core::thread::parallel_for(
+                0,
+                _data_size,
+                [&_func](std::ptrdiff_t _region_begin, std::ptrdiff_t _region_end, std::size_t _thread_id)
+                {
+                    _func(_region_begin, _region_end, _thread_id);
+                },
+                m_nb_thread
+            );
         }
         else
         {
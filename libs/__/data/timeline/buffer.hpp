@@ -59,6 +59,12 @@ public:
         return m_size;
     }
 
+    /// Returns the raw data, size() bytes long
+    [[nodiscard]] const std::uint8_t* data() const
+    {
+        return m_buffer;
+    }
+
     /// Equality comparison operators
     /// @{
     SIGHT_DATA_API bool operator==(const buffer& _other) const noexcept;
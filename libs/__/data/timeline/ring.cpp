@@ -0,0 +1,347 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "data/timeline/ring.hpp"
+
+#include <core/exceptionmacros.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace sight::data::timeline
+{
+
+/// Cache line size, slots are aligned on it so that readers of a slot do not slow down the producer of another one
+static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/// Number of times a read selects a slot again when the producer overwrote it before it was pinned
+static constexpr std::size_t MAX_READ_ATTEMPTS = 4;
+
+struct alignas(CACHE_LINE_SIZE) ring::slot
+{
+    /// 0 if empty, 2 * generation - 1 while written, 2 * generation once published
+    std::atomic<std::uint64_t> sequence {0};
+
+    /// Number of views borrowing the slot, the only state changed by readers
+    mutable std::atomic<std::uint32_t> pins {0};
+
+    std::atomic<core::clock::type> timestamp {0.};
+    std::atomic<std::uint64_t> mask {0};
+};
+
+//------------------------------------------------------------------------------
+
+ring::ring(std::size_t _capacity, std::size_t _slot_size) :
+    m_capacity(_capacity),
+    m_slot_size(_slot_size),
+    m_stride((_slot_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE),
+    m_slots(std::make_unique<slot[]>(_capacity)),
+    m_data(std::make_unique<std::uint8_t[]>(m_stride * _capacity))
+{
+    SIGHT_THROW_IF("The capacity of a ring must be greater than 0.", _capacity == 0);
+    SIGHT_THROW_IF("The slot size of a ring must be greater than 0.", _slot_size == 0);
+}
+
+//------------------------------------------------------------------------------
+
+ring::~ring() = default;
+
+//------------------------------------------------------------------------------
+
+ring::writer ring::begin_push()
+{
+    const std::uint64_t generation = m_generation.load(std::memory_order_relaxed) + 1;
+
+    for(std::size_t i = 0 ; i < m_capacity ; ++i)
+    {
+        const std::size_t index = m_next;
+        m_next = (m_next + 1) % m_capacity;
+
+        slot& current = m_slots[index];
+        if(current.pins.load(std::memory_order_seq_cst) != 0)
+        {
+            continue;
+        }
+
+        // Mark the slot as written, then check again that no reader pinned it meanwhile. A reader pins the slot
+        // before checking its sequence, so either it sees this sequence and gives up, or it is seen here.
+        const std::uint64_t previous = current.sequence.load(std::memory_order_relaxed);
+        current.sequence.store(2 * generation - 1, std::memory_order_seq_cst);
+
+        if(current.pins.load(std::memory_order_seq_cst) != 0)
+        {
+            current.sequence.store(previous, std::memory_order_seq_cst);
+            continue;
+        }
+
+        m_generation.store(generation, std::memory_order_release);
+
+        writer result;
+        result.m_ring     = this->shared_from_this();
+        result.m_index    = index;
+        result.m_sequence = 2 * generation;
+        result.m_data     = m_data.get() + index * m_stride;
+        return result;
+    }
+
+    return {};
+}
+
+//------------------------------------------------------------------------------
+
+std::uint64_t ring::read_slot(std::size_t _index, core::clock::type& _timestamp) const
+{
+    const slot& current = m_slots[_index];
+
+    const std::uint64_t sequence = current.sequence.load(std::memory_order_acquire);
+    if(sequence == 0 || (sequence % 2) != 0 || sequence / 2 <= m_floor.load(std::memory_order_acquire))
+    {
+        return 0;
+    }
+
+    _timestamp = current.timestamp.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return current.sequence.load(std::memory_order_relaxed) == sequence ? sequence : 0;
+}
+
+//------------------------------------------------------------------------------
+
+ring::view ring::borrow(std::size_t _index, std::uint64_t _sequence) const
+{
+    const slot& current = m_slots[_index];
+
+    current.pins.fetch_add(1, std::memory_order_seq_cst);
+
+    if(current.sequence.load(std::memory_order_seq_cst) != _sequence)
+    {
+        current.pins.fetch_sub(1, std::memory_order_release);
+        return {};
+    }
+
+    view result;
+    result.m_ring      = this->shared_from_this();
+    result.m_index     = _index;
+    result.m_data      = m_data.get() + _index * m_stride;
+    result.m_timestamp = current.timestamp.load(std::memory_order_relaxed);
+    result.m_mask      = current.mask.load(std::memory_order_relaxed);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+ring::view ring::get_newest() const
+{
+    for(std::size_t attempt = 0 ; attempt < MAX_READ_ATTEMPTS ; ++attempt)
+    {
+        std::size_t best_index      = 0;
+        std::uint64_t best_sequence = 0;
+
+        for(std::size_t i = 0 ; i < m_capacity ; ++i)
+        {
+            core::clock::type timestamp = 0.;
+            const std::uint64_t sequence = this->read_slot(i, timestamp);
+            if(sequence > best_sequence)
+            {
+                best_index    = i;
+                best_sequence = sequence;
+            }
+        }
+
+        if(best_sequence == 0)
+        {
+            return {};
+        }
+
+        if(view result = this->borrow(best_index, best_sequence); result)
+        {
+            return result;
+        }
+    }
+
+    return {};
+}
+
+//------------------------------------------------------------------------------
+
+ring::view ring::get_closest(core::clock::type _timestamp, direction_t _direction) const
+{
+    for(std::size_t attempt = 0 ; attempt < MAX_READ_ATTEMPTS ; ++attempt)
+    {
+        std::size_t best_index      = 0;
+        std::uint64_t best_sequence = 0;
+        core::clock::type best_distance = std::numeric_limits<core::clock::type>::max();
+
+        for(std::size_t i = 0 ; i < m_capacity ; ++i)
+        {
+            core::clock::type timestamp = 0.;
+            const std::uint64_t sequence = this->read_slot(i, timestamp);
+            if(sequence == 0
+               || (_direction == past && timestamp > _timestamp)
+               || (_direction == future && timestamp < _timestamp))
+            {
+                continue;
+            }
+
+            // On equal distances, the most recent slot is kept
+            const core::clock::type distance = std::abs(timestamp - _timestamp);
+            if(distance < best_distance || (distance == best_distance && sequence > best_sequence))
+            {
+                best_index    = i;
+                best_sequence = sequence;
+                best_distance = distance;
+            }
+        }
+
+        if(best_sequence == 0)
+        {
+            return {};
+        }
+
+        if(view result = this->borrow(best_index, best_sequence); result)
+        {
+            return result;
+        }
+    }
+
+    return {};
+}
+
+//------------------------------------------------------------------------------
+
+void ring::clear()
+{
+    m_floor.store(m_generation.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+
+ring::view::view(view&& _other) noexcept :
+    m_ring(std::move(_other.m_ring)),
+    m_index(_other.m_index),
+    m_data(_other.m_data),
+    m_timestamp(_other.m_timestamp),
+    m_mask(_other.m_mask)
+{
+    _other.m_data = nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+ring::view& ring::view::operator=(view&& _other) noexcept
+{
+    if(this != &_other)
+    {
+        this->release();
+        m_ring        = std::move(_other.m_ring);
+        m_index       = _other.m_index;
+        m_data        = _other.m_data;
+        m_timestamp   = _other.m_timestamp;
+        m_mask        = _other.m_mask;
+        _other.m_data = nullptr;
+    }
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+ring::view::~view()
+{
+    this->release();
+}
+
+//------------------------------------------------------------------------------
+
+void ring::view::release()
+{
+    if(m_data != nullptr)
+    {
+        m_ring->m_slots[m_index].pins.fetch_sub(1, std::memory_order_release);
+        m_data = nullptr;
+        m_ring.reset();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+ring::writer::writer(writer&& _other) noexcept :
+    m_ring(std::move(_other.m_ring)),
+    m_index(_other.m_index),
+    m_sequence(_other.m_sequence),
+    m_data(_other.m_data)
+{
+    _other.m_data = nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+ring::writer& ring::writer::operator=(writer&& _other) noexcept
+{
+    if(this != &_other)
+    {
+        this->abort();
+        m_ring        = std::move(_other.m_ring);
+        m_index       = _other.m_index;
+        m_sequence    = _other.m_sequence;
+        m_data        = _other.m_data;
+        _other.m_data = nullptr;
+    }
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+ring::writer::~writer()
+{
+    this->abort();
+}
+
+//------------------------------------------------------------------------------
+
+void ring::writer::publish(core::clock::type _timestamp, std::uint64_t _mask)
+{
+    SIGHT_THROW_IF("The slot has already been published.", m_data == nullptr);
+
+    slot& current = m_ring->m_slots[m_index];
+    current.timestamp.store(_timestamp, std::memory_order_relaxed);
+    current.mask.store(_mask, std::memory_order_relaxed);
+    current.sequence.store(m_sequence, std::memory_order_release);
+
+    m_data = nullptr;
+    m_ring.reset();
+}
+
+//------------------------------------------------------------------------------
+
+void ring::writer::abort()
+{
+    if(m_data != nullptr)
+    {
+        // The content is partially written, the slot is emptied
+        m_ring->m_slots[m_index].sequence.store(0, std::memory_order_release);
+        m_data = nullptr;
+        m_ring.reset();
+    }
+}
+
+} // namespace sight::data::timeline
@@ -0,0 +1,240 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/data/config.hpp>
+
+#include "data/timeline/base.hpp"
+
+#include <core/clock.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sight::data::timeline
+{
+
+/**
+ * @brief Fixed-capacity ring of timestamped buffers, written by a single producer and read by many consumers.
+ *
+ * Each slot holds a sequence number: 0 when the slot is empty, odd while the producer writes it, and even once it
+ * is published. Readers never lock: they select a slot from the published sequences and timestamps, then borrow it
+ * by pinning it. The producer never overwrites a pinned slot, it takes the next free one instead. The data of a view
+ * thus stays valid until the view is released, without any copy.
+ *
+ * A read is retried when the producer overwrites the selected slot before it is pinned, which requires the whole
+ * ring to be written in between. Reads are wait-free: they give up after a few attempts and return an empty view, so
+ * a reader can not be starved by a producer that is faster than it.
+ *
+ * @note Only one thread may call begin_push() and clear() at a time. The capacity must be greater than the number
+ * of views held at the same time, otherwise begin_push() fails.
+ */
+class SIGHT_DATA_CLASS_API ring : public std::enable_shared_from_this<ring>
+{
+public:
+
+    using sptr  = std::shared_ptr<ring>;
+    using csptr = std::shared_ptr<const ring>;
+
+    /// Published slot borrowed by a reader, the slot can not be overwritten until the view is destroyed
+    class SIGHT_DATA_CLASS_API view
+    {
+    public:
+
+        view() = default;
+        SIGHT_DATA_API view(view&& _other) noexcept;
+        SIGHT_DATA_API view& operator=(view&& _other) noexcept;
+        SIGHT_DATA_API ~view();
+
+        view(const view&)            = delete;
+        view& operator=(const view&) = delete;
+
+        /// Returns false if no slot matched the request
+        explicit operator bool() const
+        {
+            return m_data != nullptr;
+        }
+
+        /// Returns the timestamp given when the slot was published
+        [[nodiscard]] core::clock::type timestamp() const
+        {
+            return m_timestamp;
+        }
+
+        /// Returns the mask given when the slot was published, for instance the present elements of a generic_tl
+        [[nodiscard]] std::uint64_t mask() const
+        {
+            return m_mask;
+        }
+
+        /// Returns the data of the slot, ring::slot_size() bytes long
+        [[nodiscard]] const std::uint8_t* data() const
+        {
+            return m_data;
+        }
+
+        //------------------------------------------------------------------------------
+
+        template<typename T>
+        [[nodiscard]] const T* as() const
+        {
+            return reinterpret_cast<const T*>(m_data);
+        }
+
+    private:
+
+        friend class ring;
+
+        void release();
+
+        csptr m_ring;
+        std::size_t m_index {0};
+        const std::uint8_t* m_data {nullptr};
+        core::clock::type m_timestamp {0.};
+        std::uint64_t m_mask {0};
+    };
+
+    /// Slot claimed by the producer, it is visible to readers once published, or emptied if the writer is destroyed
+    class SIGHT_DATA_CLASS_API writer
+    {
+    public:
+
+        writer() = default;
+        SIGHT_DATA_API writer(writer&& _other) noexcept;
+        SIGHT_DATA_API writer& operator=(writer&& _other) noexcept;
+        SIGHT_DATA_API ~writer();
+
+        writer(const writer&)            = delete;
+        writer& operator=(const writer&) = delete;
+
+        /// Returns false if no slot could be claimed
+        explicit operator bool() const
+        {
+            return m_data != nullptr;
+        }
+
+        /// Returns the data of the slot, ring::slot_size() bytes long
+        [[nodiscard]] std::uint8_t* data() const
+        {
+            return m_data;
+        }
+
+        //------------------------------------------------------------------------------
+
+        template<typename T>
+        [[nodiscard]] T* as() const
+        {
+            return reinterpret_cast<T*>(m_data);
+        }
+
+        /// Makes the slot visible to readers
+        SIGHT_DATA_API void publish(core::clock::type _timestamp, std::uint64_t _mask = 1);
+
+    private:
+
+        friend class ring;
+
+        void abort();
+
+        sptr m_ring;
+        std::size_t m_index {0};
+        std::uint64_t m_sequence {0};
+        std::uint8_t* m_data {nullptr};
+    };
+
+    /**
+     * @brief Constructor
+     * @param _capacity number of slots
+     * @param _slot_size size of the data of each slot in bytes
+     */
+    SIGHT_DATA_API ring(std::size_t _capacity, std::size_t _slot_size);
+    SIGHT_DATA_API ~ring();
+
+    ring(const ring&)            = delete;
+    ring& operator=(const ring&) = delete;
+
+    /// Returns the number of slots
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    /// Returns the size of the data of each slot in bytes
+    [[nodiscard]] std::size_t slot_size() const
+    {
+        return m_slot_size;
+    }
+
+    /**
+     * @brief Claims the oldest slot that is not borrowed, for the producer to write it.
+     * @return an empty writer if all slots are borrowed
+     */
+    SIGHT_DATA_API writer begin_push();
+
+    /// Returns the last published slot, or an empty view if the ring is empty or if the producer overwrote it on each
+    /// attempt to borrow it
+    SIGHT_DATA_API view get_newest() const;
+
+    /**
+     * @brief Returns the slot with the closest timestamp, or an empty view if there is none in the given direction.
+     *
+     * An empty view is also returned if the producer overwrote the selected slot on each attempt to borrow it.
+     * @param _timestamp timestamp used to find the closest slot
+     * @param _direction direction to find the closest slot (PAST, FUTURE, BOTH)
+     */
+    SIGHT_DATA_API view get_closest(core::clock::type _timestamp, direction_t _direction = both) const;
+
+    /// Empties the ring, the views already borrowed remain valid
+    SIGHT_DATA_API void clear();
+
+private:
+
+    struct slot;
+
+    /// Pins a slot if it still holds the given sequence
+    view borrow(std::size_t _index, std::uint64_t _sequence) const;
+
+    /// Returns the published sequence of a slot and reads its timestamp, or 0 if the slot can not be read
+    std::uint64_t read_slot(std::size_t _index, core::clock::type& _timestamp) const;
+
+    std::size_t m_capacity;
+    std::size_t m_slot_size;
+
+    /// Distance between the data of two slots, rounded to avoid sharing cache lines
+    std::size_t m_stride;
+
+    std::unique_ptr<slot[]> m_slots;
+    std::unique_ptr<std::uint8_t[]> m_data;
+
+    /// Generation of the last claimed slot, written by the producer and read by clear()
+    std::atomic<std::uint64_t> m_generation {0};
+
+    /// Next slot to claim, only accessed by the producer
+    std::size_t m_next {0};
+
+    /// Slots published up to this generation have been cleared
+    std::atomic<std::uint64_t> m_floor {0};
+};
+
+} // namespace sight::data::timeline
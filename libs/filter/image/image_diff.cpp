@@ -22,29 +22,95 @@
 
 #include "image_diff.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace sight::filter::image
 {
 
+namespace
+{
+
+/// Uniform runs shorter than this are converted to per pixel values when a different value is added, instead of
+/// starting a new run
+constexpr std::uint32_t MIN_UNIFORM_RUN = 8;
+
+/// The two highest bits of a count are the uniform flags
+constexpr std::uint32_t MAX_RUN     = (1U << 30) - 1;
+constexpr std::uint32_t UNIFORM_OLD = 1U << 30;
+constexpr std::uint32_t UNIFORM_NEW = 1U << 31;
+
+/// Lowest bit of a run, set if the run has several pixels
+constexpr std::uint64_t SEVERAL_PIXELS = 1;
+
+/// Interval between the runs whose position is kept
+constexpr std::size_t POSITION_INTERVAL = 64;
+
+//------------------------------------------------------------------------------
+
+/// Add the value of a new pixel to the values of the last run
+void append_value(
+    std::vector<std::uint8_t>& _values,
+    bool& _uniform,
+    bool _same,
+    std::size_t _offset,
+    std::size_t _count,
+    const data::image::buffer_t* _value,
+    std::size_t _size
+)
+{
+    if(_uniform)
+    {
+        if(_same)
+        {
+            return;
+        }
+
+        // Convert the uniform value, at the end of the values, to per pixel values
+        _values.resize(_offset + _count * _size);
+        for(std::size_t i = 1 ; i < _count ; ++i)
+        {
+            std::memcpy(_values.data() + _offset + i * _size, _values.data() + _offset, _size);
+        }
+
+        _uniform = false;
+    }
+
+    _values.insert(_values.end(), _value, _value + _size);
+}
+
+} // namespace
+
 //-----------------------------------------------------------------------------
 
 image_diff::image_diff(const std::size_t _image_element_size, const std::size_t _reserved_elements) :
-    m_img_elt_size(_image_element_size),
-    m_elt_size(_image_element_size * 2 + sizeof(data::image::index_t))
+    m_img_elt_size(_image_element_size)
 {
-    m_buffer.reserve(_reserved_elements);
+    m_storage.m_old_values.reserve(_reserved_elements * _image_element_size);
+    m_storage.m_new_values.reserve(_reserved_elements * _image_element_size);
 }
 
 //------------------------------------------------------------------------------
 
 void image_diff::add_diff(const image_diff& _diff)
 {
-    SIGHT_ASSERT("Diff elements must be the same size.", m_elt_size == _diff.m_elt_size);
+    SIGHT_ASSERT("Diff elements must be the same size.", m_img_elt_size == _diff.m_img_elt_size);
+
+    this->decompress();
+
+    const storage_t decompressed = _diff.m_compressed ? _diff.decompressed() : storage_t {};
+    const storage_t& other       = _diff.m_compressed ? decompressed : _diff.m_storage;
 
-    const std::size_t old_size = this->size();
-    const std::size_t new_size = old_size + _diff.size();
+    // Runs do not hold any offset, they can be appended as they are
+    const std::size_t first_run = m_storage.m_runs.size();
+    m_storage.m_runs.insert(m_storage.m_runs.end(), other.m_runs.begin(), other.m_runs.end());
+    m_storage.m_counts.insert(m_storage.m_counts.end(), other.m_counts.begin(), other.m_counts.end());
+    m_storage.m_old_values.insert(m_storage.m_old_values.end(), other.m_old_values.begin(), other.m_old_values.end());
+    m_storage.m_new_values.insert(m_storage.m_new_values.end(), other.m_new_values.begin(), other.m_new_values.end());
 
-    m_buffer.reserve(new_size);
-    std::copy(_diff.m_buffer.begin(), _diff.m_buffer.end(), std::back_inserter(m_buffer));
+    m_num_elements += _diff.m_num_elements;
+
+    this->index_runs(first_run);
 }
 
 //-----------------------------------------------------------------------------
@@ -55,41 +121,353 @@ void image_diff::add_diff(
     const data::image::buffer_t* _new_value
 )
 {
-    const std::size_t old_size = m_buffer.size();
+    this->decompress();
 
-    // Double the size of the buffer to prevent systematic reallocation when building a diff
-    if(old_size + m_elt_size > m_buffer.capacity())
+    if(!m_storage.m_runs.empty())
     {
-        const std::size_t new_size = std::max(m_elt_size, old_size) * 2;
-        m_buffer.reserve(new_size);
+        run_t run = this->last_run();
+
+        if(_index == run.m_index + run.m_count && run.m_count < MAX_RUN)
+        {
+            // The values of the last run are at the end of the storage
+            const std::size_t old_offset = m_storage.m_old_values.size()
+                                           - (run.m_uniform_old ? 1 : run.m_count) * m_img_elt_size;
+            const std::size_t new_offset = m_storage.m_new_values.size()
+                                           - (run.m_uniform_new ? 1 : run.m_count) * m_img_elt_size;
+
+            const auto* old_value = m_storage.m_old_values.data() + old_offset;
+            const auto* new_value = m_storage.m_new_values.data() + new_offset;
+
+            const bool same_old = run.m_uniform_old && std::equal(_old_value, _old_value + m_img_elt_size, old_value);
+            const bool same_new = run.m_uniform_new && std::equal(_new_value, _new_value + m_img_elt_size, new_value);
+
+            // Long uniform runs are kept, a new run is started instead
+            const bool split = (run.m_uniform_old && !same_old && run.m_count >= MIN_UNIFORM_RUN)
+                               || (run.m_uniform_new && !same_new && run.m_count >= MIN_UNIFORM_RUN);
+
+            if(!split)
+            {
+                append_value(
+                    m_storage.m_old_values,
+                    run.m_uniform_old,
+                    same_old,
+                    old_offset,
+                    run.m_count,
+                    _old_value,
+                    m_img_elt_size
+                );
+                append_value(
+                    m_storage.m_new_values,
+                    run.m_uniform_new,
+                    same_new,
+                    new_offset,
+                    run.m_count,
+                    _new_value,
+                    m_img_elt_size
+                );
+
+                ++run.m_count;
+                this->set_last_run(run);
+                ++m_num_elements;
+                return;
+            }
+        }
     }
 
-    std::copy_n(reinterpret_cast<std::uint8_t*>(&_index), sizeof(data::image::index_t), std::back_inserter(m_buffer));
-    std::copy_n(_old_value, m_img_elt_size, std::back_inserter(m_buffer));
-    std::copy_n(_new_value, m_img_elt_size, std::back_inserter(m_buffer));
+    this->push_run(_index, 1, _old_value, true, _new_value);
 }
 
 //------------------------------------------------------------------------------
 
-void image_diff::apply_diff(const data::image::sptr& _img) const
+void image_diff::add_run(
+    data::image::index_t _start,
+    std::size_t _count,
+    const data::image::buffer_t* _old_values,
+    const data::image::buffer_t* _new_value
+)
 {
-    const auto dump_lock = _img->dump_lock();
+    this->decompress();
 
-    for(std::size_t i = 0 ; i < num_elements() ; ++i)
+    while(_count > 0)
     {
-        apply_diff_elt(_img, i);
+        const std::size_t count = std::min<std::size_t>(_count, MAX_RUN);
+
+        bool uniform_old = true;
+        for(std::size_t i = 1 ; i < count && uniform_old ; ++i)
+        {
+            uniform_old = std::equal(_old_values, _old_values + m_img_elt_size, _old_values + i * m_img_elt_size);
+        }
+
+        bool extended = false;
+        if(!m_storage.m_runs.empty())
+        {
+            run_t run = this->last_run();
+
+            const auto* old_value = m_storage.m_old_values.data() + m_storage.m_old_values.size()
+                                    - (run.m_uniform_old ? 1 : run.m_count) * m_img_elt_size;
+            const auto* new_value = m_storage.m_new_values.data() + m_storage.m_new_values.size()
+                                    - (run.m_uniform_new ? 1 : run.m_count) * m_img_elt_size;
+
+            // The last run can be extended if its new value is the same, and if its old value is either per pixel, or
+            // the same as the uniform old value of the new run. A single pixel is both.
+            if(_start == run.m_index + run.m_count && run.m_count + count <= MAX_RUN
+               && run.m_uniform_new && std::equal(_new_value, _new_value + m_img_elt_size, new_value)
+               && (!run.m_uniform_old || run.m_count == 1
+                   || (uniform_old && std::equal(_old_values, _old_values + m_img_elt_size, old_value))))
+            {
+                if(run.m_uniform_old
+                   && !(uniform_old && std::equal(_old_values, _old_values + m_img_elt_size, old_value)))
+                {
+                    // A single pixel whose old value differs becomes per pixel
+                    run.m_uniform_old = false;
+                }
+
+                if(!run.m_uniform_old)
+                {
+                    m_storage.m_old_values.insert(
+                        m_storage.m_old_values.end(),
+                        _old_values,
+                        _old_values + count * m_img_elt_size
+                    );
+                }
+
+                run.m_count += count;
+                this->set_last_run(run);
+                m_num_elements += count;
+                extended        = true;
+            }
+        }
+
+        if(!extended)
+        {
+            this->push_run(_start, count, _old_values, uniform_old, _new_value);
+        }
+
+        _start      += count;
+        _old_values += count * m_img_elt_size;
+        _count      -= count;
     }
 }
 
 //------------------------------------------------------------------------------
 
+void image_diff::push_run(
+    data::image::index_t _index,
+    std::size_t _count,
+    const data::image::buffer_t* _old_values,
+    bool _uniform_old,
+    const data::image::buffer_t* _new_value
+)
+{
+    if(m_storage.m_runs.size() % POSITION_INTERVAL == 0)
+    {
+        m_positions.push_back(
+            {
+                .m_element    = m_num_elements,
+                .m_count      = m_storage.m_counts.size(),
+                .m_old_offset = m_storage.m_old_values.size(),
+                .m_new_offset = m_storage.m_new_values.size()
+            });
+    }
+
+    m_storage.m_runs.push_back(static_cast<std::uint64_t>(_index) << 1);
+    if(_count > 1)
+    {
+        m_storage.m_runs.back() |= SEVERAL_PIXELS;
+        m_storage.m_counts.push_back(static_cast<std::uint32_t>(_count) | (_uniform_old ? UNIFORM_OLD : 0) | UNIFORM_NEW);
+    }
+
+    const std::size_t old_size = _uniform_old ? m_img_elt_size : _count * m_img_elt_size;
+    m_storage.m_old_values.insert(m_storage.m_old_values.end(), _old_values, _old_values + old_size);
+    m_storage.m_new_values.insert(m_storage.m_new_values.end(), _new_value, _new_value + m_img_elt_size);
+
+    m_num_elements += _count;
+}
+
+//------------------------------------------------------------------------------
+
+image_diff::run_t image_diff::decode(std::uint64_t _run, std::uint32_t _count)
+{
+    run_t run {.m_index = static_cast<data::image::index_t>(_run >> 1)};
+
+    if((_run & SEVERAL_PIXELS) != 0)
+    {
+        run.m_count       = _count & MAX_RUN;
+        run.m_uniform_old = (_count & UNIFORM_OLD) != 0;
+        run.m_uniform_new = (_count & UNIFORM_NEW) != 0;
+    }
+
+    return run;
+}
+
+//------------------------------------------------------------------------------
+
+image_diff::run_t image_diff::next_run(const storage_t& _storage, std::size_t _run, position_t& _position) const
+{
+    const std::uint64_t key = _storage.m_runs[_run];
+    const run_t run         = decode(key, (key & SEVERAL_PIXELS) != 0 ? _storage.m_counts[_position.m_count++] : 0);
+
+    _position.m_element    += run.m_count;
+    _position.m_old_offset += (run.m_uniform_old ? 1 : run.m_count) * m_img_elt_size;
+    _position.m_new_offset += (run.m_uniform_new ? 1 : run.m_count) * m_img_elt_size;
+
+    return run;
+}
+
+//------------------------------------------------------------------------------
+
+image_diff::run_t image_diff::previous_run(const storage_t& _storage, std::size_t _run, position_t& _position) const
+{
+    const std::uint64_t key = _storage.m_runs[_run];
+    const run_t run         = decode(key, (key & SEVERAL_PIXELS) != 0 ? _storage.m_counts[--_position.m_count] : 0);
+
+    _position.m_element    -= run.m_count;
+    _position.m_old_offset -= (run.m_uniform_old ? 1 : run.m_count) * m_img_elt_size;
+    _position.m_new_offset -= (run.m_uniform_new ? 1 : run.m_count) * m_img_elt_size;
+
+    return run;
+}
+
+//------------------------------------------------------------------------------
+
+image_diff::run_t image_diff::last_run() const
+{
+    const std::uint64_t key = m_storage.m_runs.back();
+    return decode(key, (key & SEVERAL_PIXELS) != 0 ? m_storage.m_counts.back() : 0);
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff::set_last_run(const run_t& _run)
+{
+    SIGHT_ASSERT("The last run can only grow.", _run.m_count > 1);
+
+    const std::uint32_t count = static_cast<std::uint32_t>(_run.m_count)
+                                | (_run.m_uniform_old ? UNIFORM_OLD : 0)
+                                | (_run.m_uniform_new ? UNIFORM_NEW : 0);
+
+    std::uint64_t& key = m_storage.m_runs.back();
+    if((key & SEVERAL_PIXELS) != 0)
+    {
+        m_storage.m_counts.back() = count;
+    }
+    else
+    {
+        key |= SEVERAL_PIXELS;
+        m_storage.m_counts.push_back(count);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff::index_runs(std::size_t _first_run)
+{
+    // Keep the positions of the previous runs, and resume from the last one
+    m_positions.resize(std::min(m_positions.size(), (_first_run + POSITION_INTERVAL - 1) / POSITION_INTERVAL));
+
+    std::size_t run = 0;
+    position_t position;
+    if(!m_positions.empty())
+    {
+        run      = (m_positions.size() - 1) * POSITION_INTERVAL;
+        position = m_positions.back();
+    }
+
+    for( ; run < m_storage.m_runs.size() ; ++run)
+    {
+        if(run % POSITION_INTERVAL == 0 && run / POSITION_INTERVAL == m_positions.size())
+        {
+            m_positions.push_back(position);
+        }
+
+        [[maybe_unused]] const run_t decoded = this->next_run(m_storage, run, position);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff::apply_diff(const data::image::sptr& _img) const
+{
+    this->write(_img, false);
+}
+
+//------------------------------------------------------------------------------
+
 void image_diff::revert_diff(const data::image::sptr& _img) const
 {
-    const auto dump_lock = _img->dump_lock();
+    this->write(_img, true);
+}
+
+//------------------------------------------------------------------------------
 
-    for(std::size_t i = 0 ; i < num_elements() ; ++i)
+void image_diff::write(const data::image::sptr& _img, bool _revert) const
+{
+    if(m_num_elements == 0)
+    {
+        return;
+    }
+
+    SIGHT_ASSERT(
+        "The image pixels must be the size of the diff elements.",
+        _img->type().size() * _img->num_components() == m_img_elt_size
+    );
+
+    const storage_t decompressed = m_compressed ? this->decompressed() : storage_t {};
+    const storage_t& storage     = m_compressed ? decompressed : m_storage;
+
+    const auto dump_lock = _img->dump_lock();
+    auto* const buffer   = static_cast<std::uint8_t*>(_img->buffer());
+
+    const auto write_run =
+        [&](const run_t& _run, const position_t& _position)
+        {
+            const bool uniform         = _revert ? _run.m_uniform_old : _run.m_uniform_new;
+            const std::uint8_t* values = _revert
+                                         ? storage.m_old_values.data() + _position.m_old_offset
+                                         : storage.m_new_values.data() + _position.m_new_offset;
+            std::uint8_t* const pixels = buffer + _run.m_index * m_img_elt_size;
+
+            if(!uniform)
+            {
+                std::memcpy(pixels, values, _run.m_count * m_img_elt_size);
+            }
+            else if(m_img_elt_size == 1)
+            {
+                std::memset(pixels, *values, _run.m_count);
+            }
+            else
+            {
+                for(std::size_t i = 0 ; i < _run.m_count ; ++i)
+                {
+                    std::memcpy(pixels + i * m_img_elt_size, values, m_img_elt_size);
+                }
+            }
+        };
+
+    // Revert in the reverse order, so that the oldest value is restored if a pixel was modified several times
+    if(_revert)
+    {
+        position_t position {
+            .m_element    = m_num_elements,
+            .m_count      = storage.m_counts.size(),
+            .m_old_offset = storage.m_old_values.size(),
+            .m_new_offset = storage.m_new_values.size()
+        };
+        for(std::size_t run = storage.m_runs.size() ; run-- > 0 ; )
+        {
+            const run_t decoded = this->previous_run(storage, run, position);
+            write_run(decoded, position);
+        }
+    }
+    else
     {
-        revert_diff_elt(_img, i);
+        position_t position;
+        for(std::size_t run = 0 ; run < storage.m_runs.size() ; ++run)
+        {
+            const position_t start = position;
+            const run_t decoded    = this->next_run(storage, run, position);
+            write_run(decoded, start);
+        }
     }
 }
 
@@ -97,58 +475,179 @@ void image_diff::revert_diff(const data::image::sptr& _img) const
 
 std::size_t image_diff::size() const
 {
-    return m_buffer.size();
+    if(m_compressed)
+    {
+        return m_compressed->compressed_size();
+    }
+
+    return m_storage.m_runs.size() * sizeof(std::uint64_t) + m_storage.m_counts.size() * sizeof(std::uint32_t)
+           + m_storage.m_old_values.size() + m_storage.m_new_values.size() + m_positions.size() * sizeof(position_t);
 }
 
 //------------------------------------------------------------------------------
 
 std::size_t image_diff::num_elements() const
 {
-    return size() / m_elt_size;
+    return m_num_elements;
 }
 
 //------------------------------------------------------------------------------
 
 void image_diff::clear()
 {
-    m_buffer.clear();
+    m_storage.m_runs.clear();
+    m_storage.m_counts.clear();
+    m_storage.m_old_values.clear();
+    m_storage.m_new_values.clear();
+    m_positions.clear();
+    m_num_elements = 0;
+
+    m_compressed.reset();
+    m_compressed_runs     = 0;
+    m_compressed_counts   = 0;
+    m_compressed_old_size = 0;
 }
 
 //------------------------------------------------------------------------------
 
 void image_diff::shrink()
 {
-    m_buffer.shrink_to_fit();
+    m_storage.m_runs.shrink_to_fit();
+    m_storage.m_counts.shrink_to_fit();
+    m_storage.m_old_values.shrink_to_fit();
+    m_storage.m_new_values.shrink_to_fit();
+    m_positions.shrink_to_fit();
 }
 
 //------------------------------------------------------------------------------
 
-image_diff::element_t image_diff::get_element(std::size_t _index) const
+bool image_diff::compress(int _level)
 {
-    element_t elt {};
+    if(m_compressed || m_num_elements == 0)
+    {
+        return false;
+    }
+
+    // The arrays are written one after the other, without padding, the positions are rebuilt when decompressing
+    const std::size_t runs_size   = m_storage.m_runs.size() * sizeof(std::uint64_t);
+    const std::size_t counts_size = m_storage.m_counts.size() * sizeof(std::uint32_t);
+    const std::size_t old_size    = m_storage.m_old_values.size();
+    const std::size_t new_size    = m_storage.m_new_values.size();
+
+    std::vector<std::uint8_t> uncompressed(runs_size + counts_size + old_size + new_size);
+    std::uint8_t* out = uncompressed.data();
+    std::memcpy(out, m_storage.m_runs.data(), runs_size);
+    out += runs_size;
+    std::memcpy(out, m_storage.m_counts.data(), counts_size);
+    out += counts_size;
+    std::memcpy(out, m_storage.m_old_values.data(), old_size);
+    out += old_size;
+    std::memcpy(out, m_storage.m_new_values.data(), new_size);
+
+    auto compressed = core::memory::compressed_buffer::compress(
+        uncompressed.data(),
+        uncompressed.size(),
+        uncompressed.size(),
+        _level
+    );
+
+    if(!compressed)
+    {
+        return false;
+    }
 
-    elt.m_index = *reinterpret_cast<const data::image::index_t*>(&m_buffer[_index * m_elt_size]);
+    m_compressed          = std::move(compressed);
+    m_compressed_runs     = m_storage.m_runs.size();
+    m_compressed_counts   = m_storage.m_counts.size();
+    m_compressed_old_size = old_size;
 
-    elt.m_old_value = &m_buffer[_index * m_elt_size + sizeof(data::image::index_t)];
-    elt.m_new_value = &m_buffer[_index * m_elt_size + sizeof(data::image::index_t) + m_img_elt_size];
+    // Release the memory
+    m_storage   = storage_t {};
+    m_positions = {};
 
-    return elt;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff::decompress()
+{
+    if(!m_compressed)
+    {
+        return;
+    }
+
+    m_storage = this->decompressed();
+    this->index_runs(0);
+
+    m_compressed.reset();
+    m_compressed_runs     = 0;
+    m_compressed_counts   = 0;
+    m_compressed_old_size = 0;
 }
 
 //------------------------------------------------------------------------------
 
-void image_diff::apply_diff_elt(const data::image::sptr& _img, std::size_t _elt_index) const
+bool image_diff::is_compressed() const
 {
-    element_t elt = get_element(_elt_index);
-    _img->set_pixel(elt.m_index, elt.m_new_value);
+    return m_compressed != nullptr;
 }
 
 //------------------------------------------------------------------------------
 
-void image_diff::revert_diff_elt(const data::image::sptr& _img, std::size_t _elt_index) const
+image_diff::storage_t image_diff::decompressed() const
 {
-    element_t elt = get_element(_elt_index);
-    _img->set_pixel(elt.m_index, elt.m_old_value);
+    std::vector<std::uint8_t> uncompressed(m_compressed->size());
+    m_compressed->decompress(uncompressed.data());
+
+    const std::size_t runs_size   = m_compressed_runs * sizeof(std::uint64_t);
+    const std::size_t counts_size = m_compressed_counts * sizeof(std::uint32_t);
+    const auto old_begin          = uncompressed.begin() + std::ptrdiff_t(runs_size + counts_size);
+    const auto new_begin          = old_begin + std::ptrdiff_t(m_compressed_old_size);
+
+    storage_t storage;
+    storage.m_runs.resize(m_compressed_runs);
+    std::memcpy(storage.m_runs.data(), uncompressed.data(), runs_size);
+    storage.m_counts.resize(m_compressed_counts);
+    std::memcpy(storage.m_counts.data(), uncompressed.data() + runs_size, counts_size);
+    storage.m_old_values.assign(old_begin, new_begin);
+    storage.m_new_values.assign(new_begin, uncompressed.end());
+
+    return storage;
+}
+
+//------------------------------------------------------------------------------
+
+image_diff::element_t image_diff::get_element(std::size_t _index) const
+{
+    SIGHT_ASSERT("The diff must be decompressed to access its elements.", !m_compressed);
+    SIGHT_ASSERT("Element index out of range.", _index < m_num_elements);
+
+    // Last known position before the element, then decode the runs until the one holding the element
+    const auto known = std::prev(std::ranges::upper_bound(m_positions, _index, {}, &position_t::m_element));
+
+    std::size_t run     = static_cast<std::size_t>(known - m_positions.begin()) * POSITION_INTERVAL;
+    position_t position = *known;
+    position_t start;
+    run_t decoded;
+    do
+    {
+        start   = position;
+        decoded = this->next_run(m_storage, run++, position);
+    }
+    while(_index >= position.m_element);
+
+    const std::size_t offset = _index - start.m_element;
+
+    element_t elt {};
+
+    elt.m_index     = decoded.m_index + offset;
+    elt.m_old_value = m_storage.m_old_values.data() + start.m_old_offset
+                      + (decoded.m_uniform_old ? 0 : offset * m_img_elt_size);
+    elt.m_new_value = m_storage.m_new_values.data() + start.m_new_offset
+                      + (decoded.m_uniform_new ? 0 : offset * m_img_elt_size);
+
+    return elt;
 }
 
 } // namespace sight::filter::image
@@ -24,13 +24,24 @@
 
 #include <sight/filter/image/config.hpp>
 
+#include <core/memory/compressed_buffer.hpp>
+
 #include <data/image.hpp>
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace sight::filter::image
 {
 
 /**
  * @brief Class memorizing pixel changes in an image.
+ *
+ * The changes are stored as runs of consecutive pixels. The old and new values of a run are stored once if they are
+ * the same for all its pixels, which is the case of most runs written by painting tools on a label map. The diff can
+ * also be compressed with zstd to be kept in the undo history, apply_diff() and revert_diff() still work on a
+ * compressed diff, but the elements can only be accessed once it is decompressed.
  */
 class SIGHT_FILTER_IMAGE_CLASS_API image_diff
 {
@@ -71,13 +82,21 @@ public:
         const data::image::buffer_t* _new_value
     );
 
+    /// Append the diffs of a run of consecutive pixels, all set to the same new value.
+    SIGHT_FILTER_IMAGE_API void add_run(
+        data::image::index_t _start,
+        std::size_t _count,
+        const data::image::buffer_t* _old_values,
+        const data::image::buffer_t* _new_value
+    );
+
     /// Write the new values in the image.
     SIGHT_FILTER_IMAGE_API void apply_diff(const data::image::sptr& _img) const;
 
     /// Write the old value back in the image.
     SIGHT_FILTER_IMAGE_API void revert_diff(const data::image::sptr& _img) const;
 
-    /// Return the amount of memory actually used by the elements.
+    /// Return the amount of memory actually used by the elements, compressed or not.
     [[nodiscard]] SIGHT_FILTER_IMAGE_API std::size_t size() const;
 
     /// Returns the number of stored pixel diffs.
@@ -89,35 +108,166 @@ public:
     /// Reallocate the buffer to fit the actual size of the container.
     SIGHT_FILTER_IMAGE_API void shrink();
 
-    /// Returns the element at the given index
+    /**
+     * @brief Compress the diff with zstd and release the uncompressed buffers.
+     *
+     * @param _level zstd compression level
+     * @return false if the diff is empty, already compressed, or does not get smaller
+     */
+    SIGHT_FILTER_IMAGE_API bool compress(int _level = 1);
+
+    /// Decompress the diff, this is done automatically before adding new elements.
+    SIGHT_FILTER_IMAGE_API void decompress();
+
+    /// Return true if the diff is compressed.
+    [[nodiscard]] SIGHT_FILTER_IMAGE_API bool is_compressed() const;
+
+    /**
+     * @brief Returns the element at the given index, the diff must not be compressed.
+     *
+     * Up to POSITION_INTERVAL runs are decoded to find the element, use for_each_element() to read all of them.
+     */
     [[nodiscard]] SIGHT_FILTER_IMAGE_API element_t get_element(std::size_t _index) const;
 
+    /// Calls the given function with each element, in order, decoding each run once. The diff must not be compressed.
+    template<typename F>
+    void for_each_element(F&& _func) const;
+
     /// Returns the image index from the element at the given index
     [[nodiscard]] inline data::image::index_t get_element_diff_index(std::size_t _elt_index) const;
 
 private:
 
-    /// Write the new value in the image from one element.
-    void apply_diff_elt(const data::image::sptr& _img, std::size_t _elt_index) const;
+    /// Consecutive pixels of the image, decoded from the storage
+    struct run_t
+    {
+        /// Image index of the first pixel
+        data::image::index_t m_index {0};
+
+        /// Number of pixels
+        std::size_t m_count {1};
+
+        /// The value is stored once for all the pixels
+        bool m_uniform_old {true};
+        bool m_uniform_new {true};
+    };
+
+    /**
+     * Runs are stored without any offset, so that a run of a single pixel takes as much memory as its index:
+     * - m_runs holds the image index of the first pixel of each run shifted left by one, the lowest bit is set for
+     *   runs of several pixels,
+     * - m_counts holds the number of pixels and the uniform flags of the runs of several pixels only.
+     */
+    struct storage_t
+    {
+        std::vector<std::uint64_t> m_runs;
+        std::vector<std::uint32_t> m_counts;
+        std::vector<std::uint8_t> m_old_values;
+        std::vector<std::uint8_t> m_new_values;
+    };
+
+    /// Position in the storage of the first element of a run
+    struct position_t
+    {
+        /// Number of elements in the previous runs
+        std::size_t m_element {0};
+
+        /// Number of counts of the previous runs
+        std::size_t m_count {0};
+
+        /// Offsets of the values
+        std::size_t m_old_offset {0};
+        std::size_t m_new_offset {0};
+    };
+
+    /// Decode a run from its index and, for runs of several pixels, its count.
+    static run_t decode(std::uint64_t _run, std::uint32_t _count);
 
-    /// Write the old value back in the image from one element.
-    void revert_diff_elt(const data::image::sptr& _img, std::size_t _elt_index) const;
+    /// Decode the run at the given index, the position must be the one of the run and is moved to the next one.
+    [[nodiscard]] SIGHT_FILTER_IMAGE_API run_t next_run(
+        const storage_t& _storage,
+        std::size_t _run,
+        position_t& _position
+    ) const;
+
+    /// Decode the run at the given index, the position must be the one of the next run and is moved to this one.
+    [[nodiscard]] run_t previous_run(const storage_t& _storage, std::size_t _run, position_t& _position) const;
+
+    /// Return the last run, the storage must not be empty.
+    [[nodiscard]] run_t last_run() const;
+
+    /// Replace the last run, that can only grow.
+    void set_last_run(const run_t& _run);
+
+    /// Rebuild the positions of the runs, starting from the given run.
+    void index_runs(std::size_t _first_run);
+
+    /// Write the new or old values of all runs in the image.
+    void write(const data::image::sptr& _img, bool _revert) const;
+
+    /// Return the uncompressed runs, decompressing them in a temporary storage if needed.
+    [[nodiscard]] storage_t decompressed() const;
+
+    /// Start a new run with a single pixel, or the uniform old values of several pixels.
+    void push_run(
+        data::image::index_t _index,
+        std::size_t _count,
+        const data::image::buffer_t* _old_values,
+        bool _uniform_old,
+        const data::image::buffer_t* _new_value
+    );
 
     /// The size of a single pixel diff.
     std::size_t m_img_elt_size;
 
-    /// Size of an element (image index + old value + new value)
-    std::size_t m_elt_size;
+    /// The runs and their values.
+    storage_t m_storage;
+
+    /// Positions of one run out of POSITION_INTERVAL, to access the elements without decoding all the previous runs.
+    std::vector<position_t> m_positions;
 
-    /// The buffer holding the diff.
-    std::vector<std::uint8_t> m_buffer;
+    /// The number of pixel diffs.
+    std::size_t m_num_elements {0};
+
+    /// The storage compressed with zstd, shared between the copies of the diff.
+    std::shared_ptr<const core::memory::compressed_buffer> m_compressed;
+
+    /// Number of runs and counts, and size of the old values in the compressed storage.
+    std::size_t m_compressed_runs {0};
+    std::size_t m_compressed_counts {0};
+    std::size_t m_compressed_old_size {0};
 };
 
 //------------------------------------------------------------------------------
 
 data::image::index_t image_diff::get_element_diff_index(std::size_t _elt_index) const
 {
-    return *reinterpret_cast<const data::image::index_t*>(&m_buffer[_elt_index * m_elt_size]);
+    return get_element(_elt_index).m_index;
+}
+
+//------------------------------------------------------------------------------
+
+template<typename F>
+void image_diff::for_each_element(F&& _func) const
+{
+    SIGHT_ASSERT("The diff must be decompressed to access its elements.", !m_compressed);
+
+    position_t position;
+    for(std::size_t run = 0 ; run < m_storage.m_runs.size() ; ++run)
+    {
+        const position_t start = position;
+        const run_t decoded    = this->next_run(m_storage, run, position);
+
+        const data::image::buffer_t* old_value = m_storage.m_old_values.data() + start.m_old_offset;
+        const data::image::buffer_t* new_value = m_storage.m_new_values.data() + start.m_new_offset;
+        const std::size_t old_step             = decoded.m_uniform_old ? 0 : m_img_elt_size;
+        const std::size_t new_step             = decoded.m_uniform_new ? 0 : m_img_elt_size;
+
+        for(std::size_t i = 0 ; i < decoded.m_count ; ++i, old_value += old_step, new_value += new_step)
+        {
+            _func(element_t {decoded.m_index + i, old_value, new_value});
+        }
+    }
 }
 
 } // namespace sight::filter::image
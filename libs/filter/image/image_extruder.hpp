@@ -28,8 +28,6 @@
 #include <data/matrix4.hpp>
 #include <data/mesh.hpp>
 
-#include <glm/vec3.hpp>
-
 namespace sight::filter::image
 {
 
@@ -39,9 +37,13 @@ namespace sight::filter::image
  *
  * The only way to use this class is to call @ref extrude(const data::image::sptr&, const data::mesh::csptr&),
  * which sets all voxels inside of the mesh to an empty value. To compute this quickly, we loop over two dimensions out
- * of three, for each voxel, we launch a ray on the third dimension and get a list of intersections between this ray,
- * and triangles of the mesh. After that, we iterate over the voxel line on the third dimension and look where it's
- * located relatively to intersections, it allows to know if the voxel is inside or outside of the mesh.
+ * of three, for each line of voxels, we launch a ray on the third dimension and get the list of its intersections
+ * with the mesh from a geometry::data::mesh_bvh. The voxels between an odd intersection and the next one are inside of
+ * the mesh, and are set in a single pass.
+ *
+ * The hierarchy of the mesh is cached until its points or cells change, see geometry::data::mesh_bvh::get(), so
+ * extruding the same mesh again, for instance only in the region where another mesh changed, does not need to process
+ * its triangles again.
  *
  * @pre The input image must be in 3D.
  * @pre Input meshes must have cells with 3 or 4 points.
@@ -51,6 +53,13 @@ class SIGHT_FILTER_IMAGE_CLASS_API image_extruder final
 {
 public:
 
+    /// Box of voxels, from m_min included to m_max excluded.
+    struct region_t
+    {
+        data::image::size_t m_min {0, 0, 0};
+        data::image::size_t m_max {0, 0, 0};
+    };
+
     /**
      * @brief Sets all voxels of the image that are inside the mesh to an empty value.
      * @param _image image to extrude.
@@ -66,6 +75,37 @@ public:
         const data::matrix4::csptr& _transform
     );
 
+    /**
+     * @brief Sets the voxels of a region of the image that are inside the mesh to an empty value, the other voxels are
+     * not read nor written.
+     * @param _image image to extrude.
+     * @param _mesh mesh use to compute the extrusion.
+     * @param _transform transform of the image, if any.
+     * @param _region voxels to extrude, it is clipped to the image.
+     *
+     * @warning No data are locked here, it must be done before.
+     * @warning No signals are sent here, it must be done after.
+     */
+    static SIGHT_FILTER_IMAGE_API void extrude(
+        const data::image::sptr& _image,
+        const data::mesh::csptr& _mesh,
+        const data::matrix4::csptr& _transform,
+        const region_t& _region
+    );
+
+    /**
+     * @brief Returns the region of the image covered by the bounding box of a mesh.
+     *
+     * When a mesh changes, only the union of its regions before and after the change needs to be extruded again.
+     *
+     * @warning No data are locked here, it must be done before.
+     */
+    static SIGHT_FILTER_IMAGE_API region_t mesh_region(
+        const data::image::csptr& _image,
+        const data::mesh::csptr& _mesh,
+        const data::matrix4::csptr& _transform
+    );
+
     /**
      * @brief Stores parameters of the functor.
      * @warning It's not exported since it's only used by the functor.
@@ -75,6 +115,7 @@ public:
         data::image::sptr m_image;
         data::mesh::csptr m_mesh;
         data::matrix4::csptr m_transform;
+        region_t m_region;
     };
 
     /**
@@ -83,16 +124,6 @@ public:
      */
     template<typename IMAGE_TYPE>
     void operator()(parameters& _param);
-
-private:
-
-    /// Represents a 3D triangle by three points.
-    struct triangle
-    {
-        const glm::vec3 a;
-        const glm::vec3 b;
-        const glm::vec3 c;
-    };
 };
 
 } // namespace sight::filter::image
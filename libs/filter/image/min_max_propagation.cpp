@@ -20,8 +20,6 @@
  *
  ***********************************************************************/
 
-// cspell:ignore NOLINT NOLINTNEXTLINE
-
 #include "filter/image/min_max_propagation.hpp"
 
 #include <core/tools/dispatcher.hpp>
@@ -29,228 +27,549 @@
 #include <data/helper/medical_image.hpp>
 #include <data/image.hpp>
 
-#include <io/itk/itk.hpp>
-
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
 
-#include <itkFloodFilledImageFunctionConditionalIterator.h>
-#include <itkImage.h>
-#include <itkImageFunction.h>
-
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <unordered_map>
+#include <vector>
 
 namespace sight::filter::image
 {
 
-template<typename TImage>
-class min_max_propag_criterion : public itk::ImageFunction<TImage,
-                                                           bool>
+namespace
+{
+
+/// Inclusive range of voxels along the x axis
+struct span_t
+{
+    std::int64_t begin;
+    std::int64_t end;
+};
+
+using voxel_t = std::array<std::int64_t, 3>;
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Scanline flood fill, starting from the seeds, of the 6-connected voxels accepted by the min/max criterion.
+ *
+ * The voxels are filled by spans along the x axis. When a radius is used, the propagation is first clipped to the
+ * bounding box of the seeds spheres, then each row is restricted to the union of the spheres intervals on this row.
+ * These intervals are computed once per row, with only the seeds stored in the neighboring cells of a grid.
+ */
+template<typename PIXEL>
+class scanline_fill
 {
 public:
 
-    using self_t       = min_max_propag_criterion;
-    using superclass_t = itk::ImageFunction<TImage, bool>;
-    using Pointer      = itk::SmartPointer<self_t>;
+    //-----------------------------------------------------------------------------
+
+    scanline_fill(
+        const data::image& _in_image,
+        const data::image::csptr& _roi,
+        const std::vector<voxel_t>& _seeds,
+        double _radius,
+        bool _overwrite,
+        min_max_propagation::mode _mode
+    ) :
+        m_in(static_cast<const PIXEL*>(_in_image.buffer())),
+        m_in_components(_in_image.num_components()),
+        m_seeds(_seeds),
+        m_overwrite(_overwrite)
+    {
+        const auto& size    = _in_image.size();
+        const auto& spacing = _in_image.spacing();
+        for(std::size_t i = 0 ; i < 3 ; ++i)
+        {
+            m_size[i]    = static_cast<std::int64_t>(size[i]);
+            m_spacing[i] = spacing[i];
+        }
 
-    itkNewMacro(self_t);
-    itkTypeMacro(MinMaxPropagCriterion, ImageFunction);
+        if(_roi)
+        {
+            m_roi            = static_cast<const data::image::buffer_t*>(_roi->buffer());
+            m_roi_value_size = static_cast<unsigned int>(_roi->type().size());
+            m_roi_stride     = _roi->type().size() * _roi->num_components();
+        }
 
-    using pixel_t   = typename superclass_t::InputPixelType;
-    using index_t   = typename TImage::IndexType;
-    using spacing_t = typename TImage::SpacingType;
+        this->compute_range(_mode);
+        this->compute_bounding_box(_radius);
+    }
 
     //-----------------------------------------------------------------------------
 
-    min_max_propag_criterion() :
-        m_min(itk::NumericTraits<pixel_t>::max()),
-        m_max(itk::NumericTraits<pixel_t>::min()),
-        m_sqr_radius(std::numeric_limits<double>::infinity())
+    /// Fills the voxels, calls _fill(offset, first, last) for each new span, the offset being the row start
+    template<typename F>
+    void run(F _fill)
     {
+        std::vector<voxel_t> pending(m_seeds.rbegin(), m_seeds.rend());
+
+        while(!pending.empty())
+        {
+            const auto [x, y, z] = pending.back();
+            pending.pop_back();
+
+            const std::size_t row = this->row_offset(y, z);
+            if(this->is_visited(x, y, z) || !this->accepts(row + std::size_t(x)))
+            {
+                continue;
+            }
+
+            const span_t* const allowed = this->allowed_span(x, y, z);
+            if(allowed == nullptr)
+            {
+                continue;
+            }
+
+            // Extend the span on both sides
+            std::int64_t first = x;
+            while(first > allowed->begin && this->accepts_unvisited(first - 1, y, z, row))
+            {
+                --first;
+            }
+
+            std::int64_t last = x;
+            while(last < allowed->end && this->accepts_unvisited(last + 1, y, z, row))
+            {
+                ++last;
+            }
+
+            this->set_visited({first, last}, y, z);
+            _fill(row, first, last);
+
+            // Look for new spans in the neighboring rows
+            if(y > m_min[1])
+            {
+                this->push_spans({first, last}, y - 1, z, pending);
+            }
+
+            if(y < m_max[1])
+            {
+                this->push_spans({first, last}, y + 1, z, pending);
+            }
+
+            if(z > m_min[2])
+            {
+                this->push_spans({first, last}, y, z - 1, pending);
+            }
+
+            if(z < m_max[2])
+            {
+                this->push_spans({first, last}, y, z + 1, pending);
+            }
+        }
     }
 
+private:
+
     //-----------------------------------------------------------------------------
 
-    void set_params(
-        data::image::csptr _roi,
-        const std::vector<index_t>& _seeds,
-        double _radius,
-        bool _overwrite,
-        min_max_propagation::mode _mode
-)
+    void compute_range(min_max_propagation::mode _mode)
     {
-        std::vector<pixel_t> seed_values(_seeds.size());
+        std::vector<PIXEL> seed_values(m_seeds.size());
         std::ranges::transform(
-            _seeds,
+            m_seeds,
             seed_values.begin(),
-            [this](const index_t& _index){return this->GetInputImage()->GetPixel(_index);});
+            [this](const voxel_t& _seed)
+            {
+                return m_in[this->row_offset(_seed[1], _seed[2]) * m_in_components + std::size_t(_seed[0])
+                            * m_in_components];
+            });
 
-        if(!seed_values.empty())
+        if(seed_values.empty())
         {
-            if(_mode == min_max_propagation::stddev)
-            {
-                namespace boost_acc = boost::accumulators;
-                boost_acc::accumulator_set<double,
-                                           boost_acc::stats<boost_acc::tag::variance, boost_acc::tag::mean> > var_mean;
+            return;
+        }
+
+        if(_mode == min_max_propagation::stddev)
+        {
+            namespace boost_acc = boost::accumulators;
+            boost_acc::accumulator_set<double,
+                                       boost_acc::stats<boost_acc::tag::variance, boost_acc::tag::mean> > var_mean;
 
-                std::ranges::for_each(seed_values, [&](const auto& _x){var_mean(static_cast<double>(_x));});
+            std::ranges::for_each(seed_values, [&](const auto& _x){var_mean(static_cast<double>(_x));});
 
-                const auto mean               = boost_acc::mean(var_mean);
-                const auto standard_deviation = std::sqrt(boost_acc::variance(var_mean));
-                m_min = static_cast<pixel_t>(mean - standard_deviation);
-                m_max = static_cast<pixel_t>(mean + standard_deviation);
+            const auto mean               = boost_acc::mean(var_mean);
+            const auto standard_deviation = std::sqrt(boost_acc::variance(var_mean));
+            m_min_value = static_cast<PIXEL>(mean - standard_deviation);
+            m_max_value = static_cast<PIXEL>(mean + standard_deviation);
+        }
+        else
+        {
+            if(_mode == min_max_propagation::min || _mode == min_max_propagation::minmax)
+            {
+                m_min_value = *std::ranges::min_element(seed_values);
             }
             else
             {
-                if(_mode == min_max_propagation::min || _mode == min_max_propagation::minmax)
-                {
-                    m_min = *std::ranges::min_element(seed_values);
-                }
-                else
-                {
-                    m_min = itk::NumericTraits<pixel_t>::min();
-                }
+                m_min_value = std::numeric_limits<PIXEL>::min();
+            }
 
-                if(_mode == min_max_propagation::max || _mode == min_max_propagation::minmax)
-                {
-                    m_max = *std::ranges::max_element(seed_values);
-                }
-                else
-                {
-                    m_max = itk::NumericTraits<pixel_t>::max();
-                }
+            if(_mode == min_max_propagation::max || _mode == min_max_propagation::minmax)
+            {
+                m_max_value = *std::ranges::max_element(seed_values);
+            }
+            else
+            {
+                m_max_value = std::numeric_limits<PIXEL>::max();
             }
         }
+    }
 
-        // Radius is irrelevant if it's greater than the image diagonal.
-        const spacing_t& img_spacing = this->GetInputImage()->GetSpacing();
-        const auto img_size          = this->GetInputImage()->GetLargestPossibleRegion().GetSize();
+    //-----------------------------------------------------------------------------
 
-        const double r2 = _radius * _radius;
+    void compute_bounding_box(double _radius)
+    {
+        // Radius is irrelevant if it's greater than the image diagonal.
+        m_sqr_radius = _radius * _radius;
 
         double distance2 = 0;
-        for(typename TImage::IndexValueType i = 0 ; i < index_t::Dimension ; ++i)
+        for(std::size_t i = 0 ; i < 3 ; ++i)
         {
-            const double real_dim = double(img_size[std::uint32_t(i)]) * img_spacing[std::uint32_t(i)];
+            const double real_dim = double(m_size[i]) * m_spacing[i];
             distance2 += real_dim * real_dim;
         }
 
-        m_use_radius = (r2 <= distance2);
+        m_use_radius = (m_sqr_radius <= distance2);
+
+        if(!m_use_radius)
+        {
+            m_min = {0, 0, 0};
+            m_max = {m_size[0] - 1, m_size[1] - 1, m_size[2] - 1};
+        }
+        else
+        {
+            for(std::size_t i = 0 ; i < 3 ; ++i)
+            {
+                // Number of voxels covered by the radius, the whole axis if the spacing is null
+                m_extent[i] = m_spacing[i] > 0.
+                              ? std::min(static_cast<std::int64_t>(std::ceil(_radius / m_spacing[i])), m_size[i])
+                              : m_size[i];
+                m_min[i] = m_size[i];
+                m_max[i] = -1;
+            }
+
+            for(const auto& seed : m_seeds)
+            {
+                for(std::size_t i = 0 ; i < 3 ; ++i)
+                {
+                    m_min[i] = std::min(m_min[i], std::max<std::int64_t>(seed[i] - m_extent[i], 0));
+                    m_max[i] = std::max(m_max[i], std::min(seed[i] + m_extent[i], m_size[i] - 1));
+                }
+            }
+
+            // Index the seeds in a grid of cells as large as the radius in the (y, z) plane
+            m_cells_y = m_size[1] / std::max<std::int64_t>(m_extent[1], 1) + 1;
+            for(std::size_t i = 0 ; i < m_seeds.size() ; ++i)
+            {
+                m_grid[this->cell(m_seeds[i][1], m_seeds[i][2])].push_back(i);
+            }
+        }
+
+        for(std::size_t i = 0 ; i < 3 ; ++i)
+        {
+            m_box_size[i] = std::max<std::int64_t>(m_max[i] - m_min[i] + 1, 0);
+        }
+
+        const auto nb_rows = std::size_t(m_box_size[1] * m_box_size[2]);
+        m_visited.assign((nb_rows * std::size_t(m_box_size[0]) + 63) / 64, 0);
 
-        m_roi        = _roi;
-        m_sqr_radius = r2;
-        m_seeds      = _seeds;
-        m_overwrite  = _overwrite;
-        m_spacing    = img_spacing;
+        if(m_use_radius)
+        {
+            m_rows.resize(nb_rows);
+            m_row_ready.assign(nb_rows, false);
+        }
+        else if(nb_rows > 0)
+        {
+            m_full_row = {m_min[0], m_max[0]};
+        }
     }
 
     //-----------------------------------------------------------------------------
 
-    bool Evaluate(const typename superclass_t::PointType& point) const override // NOLINT(readability-identifier-naming)
+    [[nodiscard]] std::int64_t cell(std::int64_t _y, std::int64_t _z) const
     {
-        index_t index;
-        this->ConvertPointToNearestIndex(point, index);
-        return EvaluateAtIndex(index);
+        return (_z / std::max<std::int64_t>(m_extent[2], 1)) * m_cells_y + _y / std::max<std::int64_t>(m_extent[1], 1);
     }
 
     //-----------------------------------------------------------------------------
 
-    bool EvaluateAtIndex(const index_t& index) const override // NOLINT(readability-identifier-naming)
+    [[nodiscard]] std::size_t row_offset(std::int64_t _y, std::int64_t _z) const
     {
-        const pixel_t& current_value = this->GetInputImage()->GetPixel(index);
+        return std::size_t((_z * m_size[1] + _y) * m_size[0]);
+    }
+
+    //-----------------------------------------------------------------------------
+
+    [[nodiscard]] bool accepts(std::size_t _offset) const
+    {
+        const PIXEL value = m_in[_offset * m_in_components];
 
         // Check if the value is in the range.
-        if(current_value < m_min || current_value > m_max)
+        if(value < m_min_value || value > m_max_value)
         {
             return false;
         }
 
         // Check if writing is allowed.
-        if(!m_overwrite && current_value != itk::NumericTraits<pixel_t>::Zero)
+        if(!m_overwrite && value != PIXEL(0))
         {
             return false;
         }
 
         // Check if the pixel is inside the roi.
-        if(m_roi != nullptr && !is_in_roi(index))
-        {
-            return false;
-        }
+        return m_roi == nullptr
+               || !data::helper::medical_image::is_buf_null(m_roi + _offset * m_roi_stride, m_roi_value_size);
+    }
 
-        // Check if the max distance was reached
-        return !(m_use_radius && !is_inside_radius(index));
+    //-----------------------------------------------------------------------------
+
+    [[nodiscard]] bool accepts_unvisited(std::int64_t _x, std::int64_t _y, std::int64_t _z, std::size_t _row) const
+    {
+        return !this->is_visited(_x, _y, _z) && this->accepts(_row + std::size_t(_x));
     }
 
     //-----------------------------------------------------------------------------
 
-    // NOLINTNEXTLINE(readability-identifier-naming)
-    bool EvaluateAtContinuousIndex(const typename superclass_t::ContinuousIndexType& contIndex) const override
+    [[nodiscard]] std::size_t visited_index(std::int64_t _x, std::int64_t _y, std::int64_t _z) const
     {
-        index_t index;
-        this->ConvertContinuousIndexToNearestIndex(contIndex, index);
-        return EvaluateAtIndex(index);
+        return std::size_t(((_z - m_min[2]) * m_box_size[1] + (_y - m_min[1])) * m_box_size[0] + (_x - m_min[0]));
     }
 
     //-----------------------------------------------------------------------------
 
-    bool is_inside_radius(const index_t& _index) const
+    [[nodiscard]] bool is_visited(std::int64_t _x, std::int64_t _y, std::int64_t _z) const
     {
-        for(const auto& seed : m_seeds)
+        const std::size_t index = this->visited_index(_x, _y, _z);
+        return ((m_visited[index / 64] >> (index % 64)) & 1U) != 0U;
+    }
+
+    //-----------------------------------------------------------------------------
+
+    void set_visited(const span_t& _span, std::int64_t _y, std::int64_t _z)
+    {
+        const std::size_t first = this->visited_index(_span.begin, _y, _z);
+        const std::size_t last  = first + std::size_t(_span.end - _span.begin);
+        for(std::size_t index = first ; index <= last ; ++index)
         {
-            double distance2 = 0.;
+            m_visited[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+    }
 
-            for(typename TImage::IndexValueType i = 0 ; i < index_t::Dimension ; ++i)
+    //-----------------------------------------------------------------------------
+
+    /// Returns the intervals of the row inside the seeds spheres, sorted and disjoint
+    const std::vector<span_t>& row_spans(std::int64_t _y, std::int64_t _z)
+    {
+        const auto row = std::size_t((_z - m_min[2]) * m_box_size[1] + (_y - m_min[1]));
+        if(m_row_ready[row])
+        {
+            return m_rows[row];
+        }
+
+        std::vector<span_t>& spans = m_rows[row];
+
+        const std::int64_t cell_y = _y / std::max<std::int64_t>(m_extent[1], 1);
+        const std::int64_t cell_z = _z / std::max<std::int64_t>(m_extent[2], 1);
+
+        for(std::int64_t cz = cell_z - 1 ; cz <= cell_z + 1 ; ++cz)
+        {
+            for(std::int64_t cy = cell_y - 1 ; cy <= cell_y + 1 ; ++cy)
             {
-                const double dist_tmp = double(_index[std::uint32_t(i)] - seed[std::uint32_t(i)])
-                                        * m_spacing[std::uint32_t(i)];
-                distance2 += dist_tmp * dist_tmp;
+                if(cy < 0 || cz < 0 || cy >= m_cells_y)
+                {
+                    continue;
+                }
+
+                const auto it = m_grid.find(cz * m_cells_y + cy);
+                if(it == m_grid.end())
+                {
+                    continue;
+                }
+
+                for(const std::size_t seed_index : it->second)
+                {
+                    const voxel_t& seed = m_seeds[seed_index];
+                    const double dy     = double(_y - seed[1]) * m_spacing[1];
+                    const double dz     = double(_z - seed[2]) * m_spacing[2];
+
+                    // Same expression as the distance to the seed computed voxel by voxel
+                    const auto inside = [&](std::int64_t _dx)
+                                        {
+                                            const double dx = double(_dx) * m_spacing[0];
+                                            return dx * dx + dy * dy + dz * dz < m_sqr_radius;
+                                        };
+
+                    if(!inside(0))
+                    {
+                        continue;
+                    }
+
+                    // Largest offset along x inside the sphere, adjusted to match the exact expression above
+                    const double remaining = std::max(m_sqr_radius - dy * dy - dz * dz, 0.);
+                    const double max_half  = double(m_size[0]);
+                    std::int64_t half      = static_cast<std::int64_t>(
+                        m_spacing[0] > 0. ? std::min(std::sqrt(remaining) / m_spacing[0], max_half) : max_half
+                    );
+                    while(half > 0 && !inside(half))
+                    {
+                        --half;
+                    }
+
+                    while(half < m_size[0] && inside(half + 1))
+                    {
+                        ++half;
+                    }
+
+                    const std::int64_t begin = std::max(seed[0] - half, m_min[0]);
+                    const std::int64_t end   = std::min(seed[0] + half, m_max[0]);
+                    if(begin <= end)
+                    {
+                        spans.push_back({begin, end});
+                    }
+                }
             }
+        }
 
-            if(distance2 < m_sqr_radius)
+        // Merge the overlapping and adjacent intervals
+        std::ranges::sort(spans, {}, &span_t::begin);
+        std::size_t merged = 0;
+        for(std::size_t i = 1 ; i < spans.size() ; ++i)
+        {
+            if(spans[i].begin <= spans[merged].end + 1)
+            {
+                spans[merged].end = std::max(spans[merged].end, spans[i].end);
+            }
+            else
             {
-                return true;
+                spans[++merged] = spans[i];
             }
         }
 
-        return false;
+        spans.resize(spans.empty() ? 0 : merged + 1);
+        m_row_ready[row] = true;
+
+        return spans;
     }
 
     //-----------------------------------------------------------------------------
 
-    bool is_in_roi(const index_t& _index) const
+    /// Returns the interval of the row inside the seeds spheres that contains the voxel, if any
+    const span_t* allowed_span(std::int64_t _x, std::int64_t _y, std::int64_t _z)
     {
-        const auto dump_lock = m_roi->dump_lock();
-        const auto size      = m_roi->size();
-
-        const auto* roi_val =
-            reinterpret_cast<const data::image::buffer_t*>(
-                m_roi->get_pixel(
-                    std::size_t(_index[0]) + std::size_t(_index[1]) * size[0] + std::size_t(_index[2])
-                    * size[0] * size[1]
-                )
-            );
-
-        return !data::helper::medical_image::is_buf_null(roi_val, std::uint32_t(m_roi->type().size()));
+        if(!m_use_radius)
+        {
+            return &m_full_row;
+        }
+
+        const auto& spans = this->row_spans(_y, _z);
+        const auto it     = std::ranges::upper_bound(spans, _x, {}, &span_t::begin);
+        if(it == spans.begin() || std::prev(it)->end < _x)
+        {
+            return nullptr;
+        }
+
+        return &*std::prev(it);
     }
 
-private:
+    //-----------------------------------------------------------------------------
 
-    data::image::csptr m_roi;
+    /// Pushes the first voxel of each accepted run of a neighboring row, along the span
+    void push_spans(const span_t& _span, std::int64_t _y, std::int64_t _z, std::vector<voxel_t>& _pending)
+    {
+        const std::size_t row = this->row_offset(_y, _z);
 
-    pixel_t m_min;
-    pixel_t m_max;
+        const auto scan =
+            [&](const span_t& _allowed)
+            {
+                const std::int64_t first = std::max(_span.begin, _allowed.begin);
+                const std::int64_t last  = std::min(_span.end, _allowed.end);
 
-    std::vector<index_t> m_seeds;
+                bool in_run = false;
+                for(std::int64_t x = first ; x <= last ; ++x)
+                {
+                    const bool accepted = this->accepts_unvisited(x, _y, _z, row);
+                    if(accepted && !in_run)
+                    {
+                        _pending.push_back({x, _y, _z});
+                    }
 
-    double m_sqr_radius;
-    bool m_use_radius {false};
+                    in_run = accepted;
+                }
+            };
+
+        if(!m_use_radius)
+        {
+            scan(m_full_row);
+            return;
+        }
+
+        for(const span_t& allowed : this->row_spans(_y, _z))
+        {
+            if(allowed.begin > _span.end)
+            {
+                break;
+            }
+
+            if(allowed.end >= _span.begin)
+            {
+                scan(allowed);
+            }
+        }
+    }
+
+    const PIXEL* m_in;
+    std::size_t m_in_components;
+
+    const data::image::buffer_t* m_roi {nullptr};
+    std::size_t m_roi_stride {0};
+    unsigned int m_roi_value_size {0};
+
+    const std::vector<voxel_t>& m_seeds;
+
+    PIXEL m_min_value {std::numeric_limits<PIXEL>::max()};
+    PIXEL m_max_value {std::numeric_limits<PIXEL>::min()};
     bool m_overwrite {false};
-    spacing_t m_spacing;
+
+    std::array<std::int64_t, 3> m_size {};
+    std::array<double, 3> m_spacing {};
+
+    double m_sqr_radius {std::numeric_limits<double>::infinity()};
+    bool m_use_radius {false};
+
+    /// Radius in voxels along each axis
+    std::array<std::int64_t, 3> m_extent {};
+
+    /// Bounding box of the propagation
+    std::array<std::int64_t, 3> m_min {};
+    std::array<std::int64_t, 3> m_max {};
+    std::array<std::int64_t, 3> m_box_size {};
+
+    /// One bit per voxel of the bounding box already filled
+    std::vector<std::uint64_t> m_visited;
+
+    /// Seeds indices, by cell of the (y, z) plane
+    std::unordered_map<std::int64_t, std::vector<std::size_t> > m_grid;
+    std::int64_t m_cells_y {1};
+
+    /// Intervals of each row of the bounding box inside the spheres, computed on first use
+    std::vector<std::vector<span_t> > m_rows;
+    std::vector<bool> m_row_ready;
+
+    /// Whole row of the bounding box, used without radius
+    span_t m_full_row {0, -1};
 };
 
+} // namespace
+
 //-----------------------------------------------------------------------------
 
 struct min_max_propagator
@@ -261,7 +580,6 @@ struct min_max_propagator
         data::image::sptr output_image;
         data::image::csptr roi;
         image_diff diff;
-        image_diff out_diff;
         std::uint8_t value {};
         min_max_propagation::seeds_t seeds;
         double radius {};
@@ -274,57 +592,74 @@ struct min_max_propagator
     template<class PIXELTYPE>
     void operator()(parameters& _params)
     {
-        using image_t     = typename itk::Image<PIXELTYPE, 3>;
-        using criterion_t = min_max_propag_criterion<image_t>;
-
-        const typename image_t::Pointer itk_image = io::itk::move_to_itk<image_t>(_params.input_image);
+        const auto& size = _params.input_image->size();
 
-        std::vector<typename image_t::IndexType> itk_seeds;
+        // Seeds outside the image are ignored
+        std::vector<voxel_t> seeds;
         for(const auto& seed : _params.seeds)
         {
-            typename image_t::IndexType index;
-
-            for(typename image_t::IndexValueType i = 0 ; i < image_t::IndexType::Dimension ; ++i)
+            if(seed[0] < size[0] && seed[1] < size[1] && seed[2] < size[2])
             {
-                index[std::uint32_t(i)] = typename image_t::IndexValueType(seed[std::size_t(i)]);
+                seeds.push_back({std::int64_t(seed[0]), std::int64_t(seed[1]), std::int64_t(seed[2])});
             }
-
-            itk_seeds.push_back(index);
         }
 
-        typename criterion_t::Pointer criterion = criterion_t::New();
-        criterion->SetInputImage(itk_image);
-        criterion->set_params(_params.roi, itk_seeds, _params.radius, _params.overwrite, _params.mode);
-
-        itk::FloodFilledImageFunctionConditionalIterator<image_t, criterion_t> iter(itk_image, criterion, itk_seeds);
-
-        const auto dump_lock = _params.output_image->dump_lock();
-
-        {
-            const auto* in_buf          = static_cast<const data::image::buffer_t*>(_params.input_image->buffer());
-            const std::size_t in_stride = _params.input_image->type().size() * _params.input_image->num_components();
-
-            auto* out_buf                = static_cast<uint8_t*>(_params.output_image->buffer());
-            const std::size_t out_stride = _params.output_image->num_components();
-
-            for( ; !iter.IsAtEnd() ; ++iter)
+        const auto in_dump_lock  = _params.input_image->dump_lock();
+        const auto out_dump_lock = _params.output_image->dump_lock();
+        const auto roi_dump_lock = _params.roi
+                                   ? _params.roi->dump_lock()
+                                   : std::vector<core::memory::buffer_object::lock_t> {};
+
+        scanline_fill<PIXELTYPE> fill(
+            *_params.input_image,
+            _params.roi,
+            seeds,
+            _params.radius,
+            _params.overwrite,
+            _params.mode
+        );
+
+        const auto* in_buf          = static_cast<const data::image::buffer_t*>(_params.input_image->buffer());
+        const std::size_t in_stride = _params.input_image->type().size() * _params.input_image->num_components();
+
+        auto* out_buf                = static_cast<std::uint8_t*>(_params.output_image->buffer());
+        const std::size_t out_stride = _params.output_image->num_components();
+
+        // New value stored in the diff, with the size of an input pixel
+        std::vector<data::image::buffer_t> new_value(in_stride, 0);
+        new_value[0] = _params.value;
+
+        fill.run(
+            [&](std::size_t _row, std::int64_t _first, std::int64_t _last)
             {
-                const typename image_t::IndexType current_index = iter.GetIndex();
-
-                const auto buffer_index = static_cast<std::size_t>(itk_image->ComputeOffset(current_index));
-
-                auto* out_pix_buf = out_buf + buffer_index * out_stride;
-                if(*out_pix_buf != _params.value)
+                // Write the span and add the runs of modified voxels to the diff
+                std::size_t run_begin = 0;
+                std::size_t run_size  = 0;
+                for(std::size_t index = _row + std::size_t(_first) ; index <= _row + std::size_t(_last) ; ++index)
                 {
-                    _params.out_diff.add_diff(buffer_index, out_pix_buf, &_params.value);
-
-                    const auto* pix_buf = in_buf + in_stride * buffer_index;
-                    _params.diff.add_diff(buffer_index, pix_buf, &_params.value);
+                    auto* out_pix_buf = out_buf + index * out_stride;
+                    if(*out_pix_buf != _params.value)
+                    {
+                        if(run_size == 0)
+                        {
+                            run_begin = index;
+                        }
+
+                        ++run_size;
+                        *out_pix_buf = _params.value;
+                    }
+                    else if(run_size > 0)
+                    {
+                        _params.diff.add_run(run_begin, run_size, in_buf + run_begin * in_stride, new_value.data());
+                        run_size = 0;
+                    }
+                }
 
-                    *out_pix_buf = _params.value;
+                if(run_size > 0)
+                {
+                    _params.diff.add_run(run_begin, run_size, in_buf + run_begin * in_stride, new_value.data());
                 }
-            }
-        }
+            });
     }
 };
 
@@ -341,16 +676,14 @@ image_diff min_max_propagation::process(
     const mode _mode
 )
 {
-    const core::type type                  = _in_image->type();
-    const std::size_t in_image_pixel_size  = _in_image->type().size() * _in_image->num_components();
-    const std::size_t out_image_pixel_size = _out_image->type().size() * _out_image->num_components();
+    const core::type type                 = _in_image->type();
+    const std::size_t in_image_pixel_size = _in_image->type().size() * _in_image->num_components();
 
     min_max_propagator::parameters params;
     params.input_image  = _in_image;
     params.output_image = _out_image;
     params.roi          = _roi;
     params.diff         = image_diff(in_image_pixel_size);
-    params.out_diff     = image_diff(out_image_pixel_size);
     params.seeds        = _seeds;
     params.value        = _value;
     params.overwrite    = _overwrite;
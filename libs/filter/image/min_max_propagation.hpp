@@ -36,6 +36,9 @@ namespace sight::filter::image
 
 /**
  * @brief Flood fills an image as long as the neighboring voxels are greater than the smallest seed value.
+ *
+ * The 6-connected voxels are filled by spans along the x axis, the propagation being clipped beforehand to the spheres
+ * of the given radius around the seeds. The diff is built from the runs of modified voxels.
  */
 class min_max_propagation
 {
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2017-2023 IRCAD France
+ * Copyright (C) 2017-2024 IRCAD France
  * Copyright (C) 2017-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -34,7 +34,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -251,4 +253,294 @@ void image_diff_test::undo_redo_test()
 
 //------------------------------------------------------------------------------
 
+void image_diff_test::runs_test()
+{
+    const data::image::size_t size       = {{64, 64, 8}};
+    const data::image::spacing_t spacing = {{1., 1., 1.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+    const core::type type                = core::type::INT16;
+
+    data::image::sptr image = std::make_shared<data::image>();
+    utest_data::generator::image::generate_image(image, size, spacing, origin, type, data::image::gray_scale, 0);
+
+    const auto dump_lock = image->dump_lock();
+
+    const auto* const buffer = static_cast<const std::int16_t*>(image->buffer());
+    const std::vector<std::int16_t> original(buffer, buffer + image->num_elements());
+
+    image_diff diff(image->type().size());
+
+    struct change
+    {
+        data::image::index_t index;
+        std::int16_t old_value;
+        std::int16_t new_value;
+    };
+
+    std::vector<change> changes;
+    const auto set_pixel =
+        [&](data::image::index_t _index, std::int16_t _value)
+        {
+            const std::int16_t old_value = image->at<std::int16_t>(_index);
+            diff.add_diff(
+                _index,
+                reinterpret_cast<const data::image::buffer_t*>(&old_value),
+                reinterpret_cast<const data::image::buffer_t*>(&_value)
+            );
+            image->at<std::int16_t>(_index) = _value;
+            changes.push_back({_index, old_value, _value});
+        };
+
+    // A row with different old values and the same new value
+    for(data::image::index_t x = 0 ; x < 64 ; ++x)
+    {
+        set_pixel(64 + x, 5);
+    }
+
+    // A row with different new values
+    for(data::image::index_t x = 0 ; x < 64 ; ++x)
+    {
+        set_pixel(128 + x, std::int16_t(x));
+    }
+
+    // The same new value, then a few different ones in the middle of a row
+    for(data::image::index_t x = 0 ; x < 64 ; ++x)
+    {
+        set_pixel(192 + x, (x > 20 && x < 24) ? std::int16_t(9) : std::int16_t(7));
+    }
+
+    // Runs of pixels set to the same value, twice on the same row so that the old values of the second one are the
+    // same
+    const auto set_run =
+        [&](data::image::index_t _start, std::size_t _count, std::int16_t _value)
+        {
+            const auto first = image->begin<std::int16_t>() + std::ptrdiff_t(_start);
+            const std::vector<std::int16_t> old_values(first, first + std::ptrdiff_t(_count));
+            diff.add_run(
+                _start,
+                _count,
+                reinterpret_cast<const data::image::buffer_t*>(old_values.data()),
+                reinterpret_cast<const data::image::buffer_t*>(&_value)
+            );
+            for(std::size_t i = 0 ; i < _count ; ++i)
+            {
+                image->at<std::int16_t>(_start + i) = _value;
+                changes.push_back({_start + i, old_values[i], _value});
+            }
+        };
+
+    set_run(1024, 64, 3);
+    set_run(1024, 64, 4);
+    set_run(1088, 64, 4);
+
+    // The runs of consecutive pixels take less memory than one element per pixel
+    const std::size_t element_size = sizeof(data::image::index_t) + 2 * sizeof(std::int16_t);
+    CPPUNIT_ASSERT(diff.size() < changes.size() * element_size);
+
+    // Scattered pixels, some of them modified twice
+    for(data::image::index_t i = 0 ; i < 100 ; ++i)
+    {
+        set_pixel((i * 7919) % image->num_elements(), std::int16_t(i));
+        set_pixel((i * 7919) % image->num_elements(), std::int16_t(i + 1));
+    }
+
+    // Check the elements
+    CPPUNIT_ASSERT_EQUAL(changes.size(), diff.num_elements());
+    for(std::size_t i = 0 ; i < changes.size() ; ++i)
+    {
+        const image_diff::element_t elt = diff.get_element(i);
+        CPPUNIT_ASSERT_EQUAL(changes[i].index, elt.m_index);
+        CPPUNIT_ASSERT_EQUAL(changes[i].old_value, *reinterpret_cast<const std::int16_t*>(elt.m_old_value));
+        CPPUNIT_ASSERT_EQUAL(changes[i].new_value, *reinterpret_cast<const std::int16_t*>(elt.m_new_value));
+    }
+
+    // The visitor gives the same elements in the same order
+    std::size_t visited = 0;
+    diff.for_each_element(
+        [&](const image_diff::element_t& _elt)
+        {
+            CPPUNIT_ASSERT(visited < changes.size());
+            CPPUNIT_ASSERT_EQUAL(changes[visited].index, _elt.m_index);
+            CPPUNIT_ASSERT_EQUAL(changes[visited].old_value, *reinterpret_cast<const std::int16_t*>(_elt.m_old_value));
+            CPPUNIT_ASSERT_EQUAL(changes[visited].new_value, *reinterpret_cast<const std::int16_t*>(_elt.m_new_value));
+            ++visited;
+        });
+    CPPUNIT_ASSERT_EQUAL(changes.size(), visited);
+
+    const std::vector<std::int16_t> modified(buffer, buffer + image->num_elements());
+
+    // Revert, the pixels modified twice get their original value back
+    diff.revert_diff(image);
+    CPPUNIT_ASSERT(std::equal(original.begin(), original.end(), buffer));
+
+    diff.apply_diff(image);
+    CPPUNIT_ASSERT(std::equal(modified.begin(), modified.end(), buffer));
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff_test::compression_test()
+{
+    // A label map with a large propagation
+    const data::image::size_t size       = {{256, 256, 64}};
+    const data::image::spacing_t spacing = {{1., 1., 1.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+    const core::type type                = core::type::UINT8;
+
+    data::image::sptr image = std::make_shared<data::image>();
+    utest_data::generator::image::generate_image(image, size, spacing, origin, type, data::image::gray_scale);
+
+    const auto dump_lock = image->dump_lock();
+    auto* const buffer   = static_cast<std::uint8_t*>(image->buffer());
+
+    image_diff diff(image->type().size());
+
+    const std::uint8_t value = 1;
+    std::size_t nb_pixels    = 0;
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            // Rows of a sphere
+            const double dy      = double(y) - 128.;
+            const double dz      = (double(z) - 32.) * 4.;
+            const double half    = std::sqrt(std::max(100. * 100. - dy * dy - dz * dz, 0.));
+            const auto first     = static_cast<std::size_t>(128. - half);
+            const auto last      = static_cast<std::size_t>(128. + half);
+            const std::size_t row = (z * size[1] + y) * size[0];
+
+            if(half > 0.)
+            {
+                diff.add_run(row + first, last - first, buffer + row + first, &value);
+                std::memset(buffer + row + first, value, last - first);
+                nb_pixels += last - first;
+            }
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(nb_pixels, diff.num_elements());
+
+    // One run per row
+    const std::size_t uncompressed_size = diff.size();
+    CPPUNIT_ASSERT(uncompressed_size < nb_pixels);
+
+    const std::vector<std::uint8_t> modified(buffer, buffer + image->size_in_bytes());
+    const image_diff uncompressed(diff);
+
+    CPPUNIT_ASSERT(!diff.is_compressed());
+    CPPUNIT_ASSERT(diff.compress());
+    CPPUNIT_ASSERT(diff.is_compressed());
+    CPPUNIT_ASSERT(diff.size() < uncompressed_size);
+    CPPUNIT_ASSERT_EQUAL(nb_pixels, diff.num_elements());
+
+    // A compressed diff can not be compressed again
+    CPPUNIT_ASSERT(!diff.compress());
+
+    // Undo and redo work on the compressed diff, even from a copy
+    const image_diff copy(diff);
+    copy.revert_diff(image);
+    CPPUNIT_ASSERT(std::all_of(buffer, buffer + image->size_in_bytes(), [](std::uint8_t _v){return _v == 0;}));
+
+    diff.apply_diff(image);
+    CPPUNIT_ASSERT(std::equal(modified.begin(), modified.end(), buffer));
+    CPPUNIT_ASSERT(diff.is_compressed());
+
+    // The elements are the same once decompressed
+    diff.decompress();
+    CPPUNIT_ASSERT(!diff.is_compressed());
+    CPPUNIT_ASSERT_EQUAL(uncompressed_size, diff.size());
+    test_diff_equality<std::uint8_t>(uncompressed, diff);
+
+    // Concatenating a compressed diff
+    image_diff concatenated(image->type().size());
+    concatenated.add_diff(copy);
+    CPPUNIT_ASSERT_EQUAL(nb_pixels, concatenated.num_elements());
+    test_diff_equality<std::uint8_t>(uncompressed, concatenated);
+
+    // Adding a pixel to a compressed diff decompresses it
+    CPPUNIT_ASSERT(diff.compress());
+    const std::uint8_t old_value = 0;
+    diff.add_diff(0, &old_value, &value);
+    CPPUNIT_ASSERT(!diff.is_compressed());
+    CPPUNIT_ASSERT_EQUAL(nb_pixels + 1, diff.num_elements());
+    CPPUNIT_ASSERT_EQUAL(data::image::index_t(0), diff.get_element_diff_index(nb_pixels));
+}
+
+//------------------------------------------------------------------------------
+
+void image_diff_test::scattered_pixels_test()
+{
+    const data::image::size_t size       = {{256, 256, 16}};
+    const data::image::spacing_t spacing = {{1., 1., 1.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+    const core::type type                = core::type::UINT8;
+
+    data::image::sptr image = std::make_shared<data::image>();
+    utest_data::generator::image::generate_image(image, size, spacing, origin, type, data::image::gray_scale, 0);
+
+    const auto dump_lock = image->dump_lock();
+    auto* const buffer   = static_cast<std::uint8_t*>(image->buffer());
+    const std::vector<std::uint8_t> original(buffer, buffer + image->size_in_bytes());
+
+    image_diff diff(image->type().size());
+
+    // Isolated pixels, as written by a thin brush
+    constexpr std::size_t nb_pixels = 10000;
+    for(std::size_t i = 0 ; i < nb_pixels ; ++i)
+    {
+        const data::image::index_t index = i * 97;
+        const auto new_value             = static_cast<std::uint8_t>(i);
+        diff.add_diff(index, buffer + index, &new_value);
+        buffer[index] = new_value;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(nb_pixels, diff.num_elements());
+
+    // A pixel takes little more memory than its index and its values
+    const std::size_t element_size = sizeof(data::image::index_t) + 2 * sizeof(std::uint8_t);
+    CPPUNIT_ASSERT(diff.size() < nb_pixels * (element_size + 1));
+
+    for(std::size_t i = 0 ; i < nb_pixels ; i += 123)
+    {
+        const image_diff::element_t elt = diff.get_element(i);
+        CPPUNIT_ASSERT_EQUAL(data::image::index_t(i * 97), elt.m_index);
+        CPPUNIT_ASSERT_EQUAL(original[i * 97], *elt.m_old_value);
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::uint8_t>(i), *elt.m_new_value);
+    }
+
+    // A run that continues an isolated pixel, with different old values
+    const data::image::index_t start = (nb_pixels - 1) * 97 + 1;
+    const std::uint8_t new_value     = static_cast<std::uint8_t>(nb_pixels - 1);
+    const std::vector<std::uint8_t> old_values(buffer + start, buffer + start + 10);
+    diff.add_run(start, 10, old_values.data(), &new_value);
+    std::fill_n(buffer + start, 10, new_value);
+
+    CPPUNIT_ASSERT_EQUAL(nb_pixels + 10, diff.num_elements());
+    for(std::size_t i = 0 ; i < 10 ; ++i)
+    {
+        const image_diff::element_t elt = diff.get_element(nb_pixels + i);
+        CPPUNIT_ASSERT_EQUAL(start + i, elt.m_index);
+        CPPUNIT_ASSERT_EQUAL(old_values[i], *elt.m_old_value);
+        CPPUNIT_ASSERT_EQUAL(new_value, *elt.m_new_value);
+    }
+
+    const std::vector<std::uint8_t> modified(buffer, buffer + image->size_in_bytes());
+
+    diff.revert_diff(image);
+    CPPUNIT_ASSERT(std::equal(original.begin(), original.end(), buffer));
+
+    diff.apply_diff(image);
+    CPPUNIT_ASSERT(std::equal(modified.begin(), modified.end(), buffer));
+
+    // Same elements once compressed and decompressed
+    const image_diff uncompressed(diff);
+    const std::size_t uncompressed_size = diff.size();
+    CPPUNIT_ASSERT(diff.compress());
+    diff.decompress();
+    CPPUNIT_ASSERT_EQUAL(uncompressed_size, diff.size());
+    test_diff_equality<std::uint8_t>(uncompressed, diff);
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::filter::image::ut
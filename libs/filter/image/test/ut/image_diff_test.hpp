@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2021-2023 IRCAD France
+ * Copyright (C) 2021-2024 IRCAD France
  * Copyright (C) 2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -35,6 +35,9 @@ class image_diff_test : public CPPUNIT_NS::TestFixture
 CPPUNIT_TEST_SUITE(image_diff_test);
 CPPUNIT_TEST(store_diffs_test);
 CPPUNIT_TEST(undo_redo_test);
+CPPUNIT_TEST(runs_test);
+CPPUNIT_TEST(compression_test);
+CPPUNIT_TEST(scattered_pixels_test);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +50,15 @@ public:
 
     /// Test image_diff revert/apply methods.
     static void undo_redo_test();
+
+    /// Test the storage of runs of pixels, with uniform or different values.
+    static void runs_test();
+
+    /// Test the compression of a large diff.
+    static void compression_test();
+
+    /// Test the memory used by isolated pixels.
+    static void scattered_pixels_test();
 };
 
 } // namespace sight::filter::image::ut
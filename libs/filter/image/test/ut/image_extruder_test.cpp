@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2020-2023 IRCAD France
+ * Copyright (C) 2020-2024 IRCAD France
  * Copyright (C) 2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -22,8 +22,17 @@
 
 #include "image_extruder_test.hpp"
 
+#include <core/spy_log.hpp>
+
 #include <filter/image/image_extruder.hpp>
 
+#include <glm/ext/scalar_constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::filter::image::ut::image_extruder_test);
 
 namespace sight::filter::image::ut
@@ -31,6 +40,52 @@ namespace sight::filter::image::ut
 
 //------------------------------------------------------------------------------
 
+/// Generates a closed UV sphere centered on the origin
+static data::mesh::sptr generate_sphere(double _radius, int _rings, int _segments)
+{
+    auto mesh            = std::make_shared<data::mesh>();
+    const auto dump_lock = mesh->dump_lock();
+
+    mesh->push_point(0.F, 0.F, float(_radius));
+    for(int ring = 1 ; ring < _rings ; ++ring)
+    {
+        const double theta = glm::pi<double>() * ring / _rings;
+        for(int segment = 0 ; segment < _segments ; ++segment)
+        {
+            const double phi = 2. * glm::pi<double>() * segment / _segments;
+            mesh->push_point(
+                float(_radius * std::sin(theta) * std::cos(phi)),
+                float(_radius * std::sin(theta) * std::sin(phi)),
+                float(_radius * std::cos(theta))
+            );
+        }
+    }
+
+    const data::mesh::point_t south = mesh->push_point(0.F, 0.F, float(-_radius));
+
+    const auto index =
+        [&](int _ring, int _segment)
+        {
+            return data::mesh::point_t(1 + (_ring - 1) * _segments + _segment % _segments);
+        };
+
+    for(int segment = 0 ; segment < _segments ; ++segment)
+    {
+        mesh->push_cell(0, index(1, segment), index(1, segment + 1));
+        mesh->push_cell(south, index(_rings - 1, segment + 1), index(_rings - 1, segment));
+
+        for(int ring = 1 ; ring < _rings - 1 ; ++ring)
+        {
+            mesh->push_cell(index(ring, segment), index(ring + 1, segment), index(ring + 1, segment + 1));
+            mesh->push_cell(index(ring, segment), index(ring + 1, segment + 1), index(ring, segment + 1));
+        }
+    }
+
+    return mesh;
+}
+
+//------------------------------------------------------------------------------
+
 void image_extruder_test::setUp()
 {
     m_image = std::make_shared<data::image>();
@@ -244,4 +299,171 @@ void image_extruder_test::extrude_quad_mesh()
 
 //------------------------------------------------------------------------------
 
+void image_extruder_test::extrude_transformed_sphere()
+{
+    constexpr double radius = 10.;
+    const data::mesh::sptr mesh = generate_sphere(radius, 48, 64);
+
+    // The transform goes from the image to the mesh, the sphere is thus centered on the translation in the image.
+    const std::array<double, 3> center {16.3, 14.7, 18.1};
+    const auto transform = std::make_shared<data::matrix4>();
+    (*transform)(0, 3) = -center[0];
+    (*transform)(1, 3) = -center[1];
+    (*transform)(2, 3) = -center[2];
+
+    const data::image::origin_t origin {-2., 1., 0.5};
+    const data::image::spacing_t spacing {1., 0.8, 1.2};
+
+    const data::image::sptr image = std::make_shared<data::image>();
+    image->resize({40, 40, 30}, core::type::UINT8, data::image::pixel_format::gray_scale);
+    image->set_origin(origin);
+    image->set_spacing(spacing);
+
+    const auto dump_lock = image->dump_lock();
+    std::fill(image->begin(), image->end(), std::uint8_t(255));
+
+    filter::image::image_extruder::extrude(image, mesh, transform);
+
+    const data::image::size_t& size = image->size();
+    std::size_t num_inside          = 0;
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            for(std::size_t x = 0 ; x < size[0] ; ++x)
+            {
+                const double dx       = origin[0] + (double(x) + 0.5) * spacing[0] - center[0];
+                const double dy       = origin[1] + (double(y) + 0.5) * spacing[1] - center[1];
+                const double dz       = origin[2] + (double(z) + 0.5) * spacing[2] - center[2];
+                const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+                // The tessellation of the sphere is slightly inside of the analytic sphere.
+                if(std::abs(distance - radius) < 0.1)
+                {
+                    continue;
+                }
+
+                const std::uint8_t expected = distance < radius ? 0 : 255;
+                CPPUNIT_ASSERT_EQUAL(expected, image->at<std::uint8_t>(x, y, z));
+                num_inside += distance < radius ? 1 : 0;
+            }
+        }
+    }
+
+    CPPUNIT_ASSERT(num_inside > 0);
+}
+
+//------------------------------------------------------------------------------
+
+void image_extruder_test::extrude_region()
+{
+    const data::mesh::sptr mesh = generate_sphere(10., 24, 32);
+
+    const auto transform = std::make_shared<data::matrix4>();
+    (*transform)(0, 3) = -12.;
+    (*transform)(1, 3) = -11.;
+    (*transform)(2, 3) = -13.;
+
+    const auto make_image =
+        []
+        {
+            auto image = std::make_shared<data::image>();
+            image->resize({24, 24, 24}, core::type::UINT8, data::image::pixel_format::gray_scale);
+            image->set_spacing({1., 1., 1.});
+            const auto dump_lock = image->dump_lock();
+            std::fill(image->begin(), image->end(), std::uint8_t(255));
+            return image;
+        };
+
+    // Voxels whose center is inside of the bounding box of the sphere.
+    const data::image::sptr full = make_image();
+    const auto mesh_region       = filter::image::image_extruder::mesh_region(full, mesh, transform);
+    CPPUNIT_ASSERT(mesh_region.m_min == data::image::size_t({2, 1, 3}));
+    CPPUNIT_ASSERT(mesh_region.m_max == data::image::size_t({22, 21, 23}));
+
+    filter::image::image_extruder::extrude(full, mesh, transform);
+
+    // Only the voxels of the region must be modified.
+    const filter::image::image_extruder::region_t region {.m_min = {5, 0, 10}, .m_max = {14, 24, 17}};
+    const data::image::sptr partial = make_image();
+    filter::image::image_extruder::extrude(partial, mesh, transform, region);
+
+    const auto full_lock    = full->dump_lock();
+    const auto partial_lock = partial->dump_lock();
+    for(std::size_t z = 0 ; z < 24 ; ++z)
+    {
+        for(std::size_t y = 0 ; y < 24 ; ++y)
+        {
+            for(std::size_t x = 0 ; x < 24 ; ++x)
+            {
+                const bool in_region = x >= region.m_min[0] && x < region.m_max[0]
+                                       && y >= region.m_min[1] && y < region.m_max[1]
+                                       && z >= region.m_min[2] && z < region.m_max[2];
+
+                const std::uint8_t expected = in_region ? full->at<std::uint8_t>(x, y, z) : 255;
+                CPPUNIT_ASSERT_EQUAL(expected, partial->at<std::uint8_t>(x, y, z));
+            }
+        }
+    }
+
+    // Re-extruding the remaining voxels gives the same image as a full extrusion.
+    const filter::image::image_extruder::region_t remaining {.m_min = {0, 0, 0}, .m_max = {5, 24, 24}};
+    filter::image::image_extruder::extrude(partial, mesh, transform, remaining);
+    filter::image::image_extruder::extrude(partial, mesh, transform, {.m_min = {14, 0, 0}, .m_max = {24, 24, 24}});
+    filter::image::image_extruder::extrude(partial, mesh, transform, {.m_min = {5, 0, 0}, .m_max = {14, 24, 10}});
+    filter::image::image_extruder::extrude(partial, mesh, transform, {.m_min = {5, 0, 17}, .m_max = {14, 24, 24}});
+
+    CPPUNIT_ASSERT(std::equal(full->begin<std::uint8_t>(), full->end<std::uint8_t>(), partial->begin<std::uint8_t>()));
+}
+
+//------------------------------------------------------------------------------
+
+void image_extruder_test::extrude_benchmark()
+{
+    // Only run when profiling
+    static const char* const s_ENV_LOOP = std::getenv("PROFILETEST_LOOP");
+    if(s_ENV_LOOP == nullptr)
+    {
+        return;
+    }
+
+    // Check how many times the mesh is extruded
+    static const int s_LOOP_COUNT = std::max(1, std::stoi(s_ENV_LOOP));
+
+    const auto transform = std::make_shared<data::matrix4>();
+    (*transform)(0, 3) = -64.;
+    (*transform)(1, 3) = -64.;
+    (*transform)(2, 3) = -64.;
+
+    const data::image::sptr image = std::make_shared<data::image>();
+    image->resize({128, 128, 128}, core::type::UINT8, data::image::pixel_format::gray_scale);
+    image->set_spacing({1., 1., 1.});
+    const auto dump_lock = image->dump_lock();
+
+    double elapsed        = 0.;
+    std::size_t num_cells = 0;
+    for(int loop = 0 ; loop < s_LOOP_COUNT ; ++loop)
+    {
+        std::fill(image->begin(), image->end(), std::uint8_t(255));
+
+        // The hierarchy of a mesh is cached, use a new mesh to measure its construction as well.
+        const data::mesh::sptr mesh = generate_sphere(60., 100, 200);
+        num_cells = mesh->num_cells();
+
+        const auto start = std::chrono::steady_clock::now();
+        filter::image::image_extruder::extrude(image, mesh, transform);
+        elapsed += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(0), image->at<std::uint8_t>(64, 64, 64));
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(255), image->at<std::uint8_t>(1, 1, 1));
+    }
+
+    SIGHT_INFO(
+        "image_extruder: mesh of " << num_cells << " triangles in an image of 128^3 voxels, "
+        << elapsed / s_LOOP_COUNT << " ms"
+    );
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::filter::image::ut
@@ -37,6 +37,9 @@ class image_extruder_test : public CPPUNIT_NS::TestFixture
 CPPUNIT_TEST_SUITE(image_extruder_test);
 CPPUNIT_TEST(extrude_triangle_mesh);
 CPPUNIT_TEST(extrude_quad_mesh);
+CPPUNIT_TEST(extrude_transformed_sphere);
+CPPUNIT_TEST(extrude_region);
+CPPUNIT_TEST(extrude_benchmark);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -49,6 +52,12 @@ public:
 
     void extrude_quad_mesh();
 
+    void extrude_transformed_sphere();
+
+    void extrude_region();
+
+    void extrude_benchmark();
+
 private:
 
     const core::type m_type {core::type::INT8};
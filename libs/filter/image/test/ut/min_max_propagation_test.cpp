@@ -28,6 +28,13 @@
 
 #include <utest_data/generator/image.hpp>
 
+#include <core/spy_log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::filter::image::ut::min_max_propagation_test);
 
@@ -318,4 +325,252 @@ void min_max_propagation_test::radius_test()
 
 //------------------------------------------------------------------------------
 
+void min_max_propagation_test::anisotropic_radius_test()
+{
+    const data::image::size_t size       = {{41, 41, 41}};
+    const data::image::spacing_t spacing = {{0.5, 1., 2.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+    const core::type type                = core::type::INT16;
+
+    data::image::sptr image_in  = std::make_shared<data::image>();
+    data::image::sptr image_out = std::make_shared<data::image>();
+
+    utest_data::generator::image::generate_image(image_in, size, spacing, origin, type, data::image::gray_scale);
+    utest_data::generator::image::generate_image(
+        image_out,
+        size,
+        spacing,
+        origin,
+        core::type::UINT8,
+        data::image::gray_scale
+    );
+
+    // Two seeds, the propagation is the union of the two spheres
+    min_max_propagation::seeds_t seeds = {{{10, 20, 20}}, {{30, 20, 20}}};
+
+    const std::uint8_t value = 5;
+    const double radius      = 6.;
+
+    const auto dump_lock_in  = image_in->dump_lock();
+    const auto dump_lock_out = image_out->dump_lock();
+
+    const image_diff diff = min_max_propagation::process(
+        image_in,
+        image_out,
+        nullptr,
+        seeds,
+        value,
+        radius,
+        true,
+        min_max_propagation::min
+    );
+
+    // Compare each voxel with the distance to the closest seed
+    std::size_t nb_filled = 0;
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            for(std::size_t x = 0 ; x < size[0] ; ++x)
+            {
+                bool inside = false;
+                for(const auto& seed : seeds)
+                {
+                    const double dx = (double(x) - double(seed[0])) * spacing[0];
+                    const double dy = (double(y) - double(seed[1])) * spacing[1];
+                    const double dz = (double(z) - double(seed[2])) * spacing[2];
+                    inside = inside || (dx * dx + dy * dy + dz * dz < radius * radius);
+                }
+
+                const std::uint8_t expected = inside ? value : 0;
+                CPPUNIT_ASSERT_EQUAL(expected, image_out->at<std::uint8_t>(x, y, z));
+                nb_filled += inside ? 1 : 0;
+            }
+        }
+    }
+
+    // Each modified voxel is in the diff once, with the input value as old value
+    CPPUNIT_ASSERT_EQUAL(nb_filled, diff.num_elements());
+    for(std::size_t i = 0 ; i < diff.num_elements() ; ++i)
+    {
+        const auto element = diff.get_element(i);
+        CPPUNIT_ASSERT_EQUAL(value, image_out->at<std::uint8_t>(element.m_index));
+        CPPUNIT_ASSERT_EQUAL(std::int16_t(0), *reinterpret_cast<const std::int16_t*>(element.m_old_value));
+    }
+
+    // Propagating again changes nothing
+    const image_diff diff2 = min_max_propagation::process(
+        image_in,
+        image_out,
+        nullptr,
+        seeds,
+        value,
+        radius,
+        true,
+        min_max_propagation::min
+    );
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), diff2.num_elements());
+}
+
+//------------------------------------------------------------------------------
+
+void min_max_propagation_test::roi_test()
+{
+    const data::image::size_t size       = {{32, 32, 32}};
+    const data::image::spacing_t spacing = {{1., 1., 1.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+    const core::type type                = core::type::UINT8;
+
+    data::image::sptr image_in  = std::make_shared<data::image>();
+    data::image::sptr image_out = std::make_shared<data::image>();
+    data::image::sptr roi       = std::make_shared<data::image>();
+
+    utest_data::generator::image::generate_image(image_in, size, spacing, origin, type, data::image::gray_scale);
+    utest_data::generator::image::generate_image(image_out, size, spacing, origin, type, data::image::gray_scale);
+    utest_data::generator::image::generate_image(roi, size, spacing, origin, type, data::image::gray_scale);
+
+    // The cube is not overwritten, the roi is the half x < 16
+    draw_cube(image_in, 1);
+
+    const auto dump_lock_in  = image_in->dump_lock();
+    const auto dump_lock_out = image_out->dump_lock();
+    const auto dump_lock_roi = roi->dump_lock();
+
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            for(std::size_t x = 0 ; x < 16 ; ++x)
+            {
+                roi->at<std::uint8_t>(x, y, z) = 1;
+            }
+        }
+    }
+
+    min_max_propagation::seeds_t seed = {{{0, 0, 0}}};
+    const std::uint8_t value          = 2;
+
+    min_max_propagation::process(
+        image_in,
+        image_out,
+        roi,
+        seed,
+        value,
+        500,
+        false,
+        min_max_propagation::max
+    );
+
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            for(std::size_t x = 0 ; x < size[0] ; ++x)
+            {
+                const bool filled           = x < 16 && image_in->at<std::uint8_t>(x, y, z) == 0;
+                const std::uint8_t expected = filled ? value : 0;
+                CPPUNIT_ASSERT_EQUAL(expected, image_out->at<std::uint8_t>(x, y, z));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void min_max_propagation_test::stroke_benchmark()
+{
+    // Only run when profiling
+    static const char* const s_ENV_LOOP = std::getenv("PROFILETEST_LOOP");
+    if(s_ENV_LOOP == nullptr)
+    {
+        return;
+    }
+
+    // Check how many strokes to propagate
+    static const int s_LOOP_COUNT = std::max(1, std::stoi(s_ENV_LOOP));
+
+    // CT like image: a sphere of soft tissue in the air
+    const data::image::size_t size       = {{256, 256, 256}};
+    const data::image::spacing_t spacing = {{0.7, 0.7, 1.}};
+    const data::image::origin_t origin   = {{0., 0., 0.}};
+
+    data::image::sptr image_in  = std::make_shared<data::image>();
+    data::image::sptr image_out = std::make_shared<data::image>();
+
+    utest_data::generator::image::generate_image(
+        image_in,
+        size,
+        spacing,
+        origin,
+        core::type::INT16,
+        data::image::gray_scale
+    );
+    utest_data::generator::image::generate_image(
+        image_out,
+        size,
+        spacing,
+        origin,
+        core::type::UINT8,
+        data::image::gray_scale
+    );
+
+    const auto dump_lock_in  = image_in->dump_lock();
+    const auto dump_lock_out = image_out->dump_lock();
+
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            for(std::size_t x = 0 ; x < size[0] ; ++x)
+            {
+                const double dx = double(x) - 128.;
+                const double dy = double(y) - 128.;
+                const double dz = double(z) - 128.;
+                image_in->at<std::int16_t>(x, y, z) = dx * dx + dy * dy + dz * dz < 100. * 100.
+                                                      ? std::int16_t(40 + (x + y + z) % 20)
+                                                      : std::int16_t(-1000);
+            }
+        }
+    }
+
+    // A brush stroke
+    min_max_propagation::seeds_t seeds;
+    for(std::size_t i = 0 ; i < 40 ; ++i)
+    {
+        seeds.insert({{90 + i * 2, 128, 128}});
+    }
+
+    for(const double radius : {5., 10., 20.})
+    {
+        double elapsed        = 0.;
+        std::size_t nb_voxels = 0;
+        for(int i = 0 ; i < s_LOOP_COUNT ; ++i)
+        {
+            std::fill(image_out->begin<std::uint8_t>(), image_out->end<std::uint8_t>(), std::uint8_t(0));
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto diff  = min_max_propagation::process(
+                image_in,
+                image_out,
+                nullptr,
+                seeds,
+                1,
+                radius,
+                true,
+                min_max_propagation::minmax
+            );
+            elapsed  += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            nb_voxels = diff.num_elements();
+        }
+
+        CPPUNIT_ASSERT(nb_voxels > 0);
+        SIGHT_INFO(
+            "min_max_propagation: radius " << radius << " mm, " << nb_voxels << " voxels in "
+            << elapsed / s_LOOP_COUNT << " ms"
+        );
+    }
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::filter::image::ut
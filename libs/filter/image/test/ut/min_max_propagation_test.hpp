@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2018-2023 IRCAD France
+ * Copyright (C) 2018-2024 IRCAD France
  * Copyright (C) 2018-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -33,6 +33,9 @@ CPPUNIT_TEST_SUITE(min_max_propagation_test);
 CPPUNIT_TEST(min_propag_test);
 CPPUNIT_TEST(max_propag_test);
 CPPUNIT_TEST(radius_test);
+CPPUNIT_TEST(anisotropic_radius_test);
+CPPUNIT_TEST(roi_test);
+CPPUNIT_TEST(stroke_benchmark);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -44,6 +47,9 @@ public:
     static void min_propag_test();
     static void max_propag_test();
     static void radius_test();
+    static void anisotropic_radius_test();
+    static void roi_test();
+    static void stroke_benchmark();
 };
 
 } // namespace sight::filter::image::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2017-2023 IRCAD France
+ * Copyright (C) 2017-2024 IRCAD France
  * Copyright (C) 2017-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -24,9 +24,61 @@
 
 #include <core/spy_log.hpp>
 
+#include <algorithm>
+#include <array>
+#include <functional>
+
 namespace sight::filter::vision
 {
 
+namespace
+{
+
+/// Layout of the lookup table: each channel is shifted right to quantize it, then left to its place in the index
+struct lut_layout
+{
+    /// Right shift of each channel value, 8 drops the channel
+    std::array<int, 3> quantization;
+
+    /// Left shift of each quantized channel in the index
+    std::array<int, 3> position;
+
+    /// Channel duplicated in the third one by the colour space conversion, -1 if none
+    int duplicated;
+
+    /// Number of entries
+    int size;
+};
+
+//------------------------------------------------------------------------------
+
+constexpr lut_layout make_layout(const col_space& _c)
+{
+    switch(_c)
+    {
+        case bgr:
+            // 6 bits per channel
+            return {{2, 2, 2}, {12, 6, 0}, -1, 1 << 18};
+
+        case h_sv:
+            return {{0, 0, 8}, {8, 0, 0}, 1, 1 << 16};
+
+        default:
+            return {{0, 0, 8}, {8, 0, 0}, 0, 1 << 16};
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/// Threshold a response like cv::threshold() does in masker::make_mask()
+inline std::uint8_t classify(float _response, float _threshold, const detection_mode& _d)
+{
+    const bool above = _response > _threshold;
+    return (_d == bg_ll ? !above : above) ? 255 : 0;
+}
+
+} // namespace
+
 // Define the morphological element used
 const cv::Mat masker::MORPHELEMENT =
     cv::getStructuringElement(
@@ -75,6 +127,8 @@ void masker::train_foreground_model(
         this->m_colorspace
     );
     this->m_foreground_model = sight::filter::vision::masker::train_model_from_samples(s, _num_clusters);
+
+    this->update_response_table();
 }
 
 //------------------------------------------------------------------------------
@@ -87,6 +141,8 @@ void masker::train_background_model(
 {
     const cv::Mat s = sight::filter::vision::masker::make_training_samples(_rgb_img, _selection_mask, m_colorspace);
     m_background_model = sight::filter::vision::masker::train_model_from_samples(s, _num_clusters);
+
+    this->update_response_table();
 }
 
 //------------------------------------------------------------------------------
@@ -108,28 +164,35 @@ cv::Mat masker::make_mask(const cv::Mat& _test_img, const cv::Size& _down_size,
 
     const cv::Mat i = convert_colour_space(t2, m_colorspace);
 
-    switch(m_detectionmode)
+    if(!m_mask_table.empty())
     {
-        case fg_ll:
+        m = make_lookup_mask(i, test_img_mask2);
+    }
+    else
+    {
+        switch(m_detectionmode)
         {
-            cv::Mat fg_response = make_response_image(i, m_foreground_model, test_img_mask2);
-            cv::threshold(fg_response, m, m_threshold, 255, cv::THRESH_BINARY);
-            break;
-        }
+            case fg_ll:
+            {
+                cv::Mat fg_response = make_response_image(i, m_foreground_model, test_img_mask2);
+                cv::threshold(fg_response, m, m_threshold, 255, cv::THRESH_BINARY);
+                break;
+            }
 
-        case bg_ll:
-        {
-            cv::Mat bg_response = make_response_image(i, m_background_model, test_img_mask2);
-            cv::threshold(bg_response, m, m_threshold, 255, cv::THRESH_BINARY_INV);
-            break;
-        }
+            case bg_ll:
+            {
+                cv::Mat bg_response = make_response_image(i, m_background_model, test_img_mask2);
+                cv::threshold(bg_response, m, m_threshold, 255, cv::THRESH_BINARY_INV);
+                break;
+            }
 
-        case ll_ratio:
-        {
-            cv::Mat fg_response = make_response_image(i, m_foreground_model, test_img_mask2);
-            cv::Mat bg_response = make_response_image(i, m_background_model, test_img_mask2);
-            cv::threshold(fg_response - bg_response, m, m_threshold, 255, cv::THRESH_BINARY);
-            break;
+            case ll_ratio:
+            {
+                cv::Mat fg_response = make_response_image(i, m_foreground_model, test_img_mask2);
+                cv::Mat bg_response = make_response_image(i, m_background_model, test_img_mask2);
+                cv::threshold(fg_response - bg_response, m, m_threshold, 255, cv::THRESH_BINARY);
+                break;
+            }
         }
     }
 
@@ -151,6 +214,8 @@ void masker::set_threshold(double _t)
 {
     m_threshold         = _t;
     m_has_set_threshold = true;
+
+    this->update_mask_table();
 }
 
 //------------------------------------------------------------------------------
@@ -172,6 +237,21 @@ bool masker::is_model_learned()
 
 //------------------------------------------------------------------------------
 
+void masker::set_lookup_table(bool _enabled)
+{
+    m_lookup_table = _enabled;
+    this->update_response_table();
+}
+
+//------------------------------------------------------------------------------
+
+bool masker::use_lookup_table() const
+{
+    return m_lookup_table;
+}
+
+//------------------------------------------------------------------------------
+
 cv::Mat masker::make_response_image(
     const cv::Mat& _i,
     const cv::Ptr<cv::ml::EM> _model,
@@ -218,6 +298,153 @@ cv::Mat masker::make_response_image(
 
 //------------------------------------------------------------------------------
 
+std::vector<float> masker::make_response_table(const cv::Ptr<cv::ml::EM>& _model, const col_space& _c)
+{
+    const lut_layout layout = make_layout(_c);
+    std::vector<float> table(static_cast<std::size_t>(layout.size));
+
+    // Parallelization of the prediction of each entry, from the center of its quantization interval
+    cv::parallel_for_(
+        cv::Range(0, layout.size),
+        [&](const cv::Range& _range)
+        {
+            cv::Mat sample = cv::Mat::zeros(3, 1, CV_32FC1);
+            for(int r = _range.start ; r < _range.end ; ++r)
+            {
+                for(int channel_idx = 0 ; channel_idx < 3 ; ++channel_idx)
+                {
+                    const int quantization = layout.quantization[channel_idx];
+                    if(quantization < 8)
+                    {
+                        const int level = (r >> layout.position[channel_idx]) & ((1 << (8 - quantization)) - 1);
+                        sample.at<float>(channel_idx) = static_cast<float>(level << quantization)
+                                                        + static_cast<float>((1 << quantization) - 1) / 2.F;
+                    }
+                }
+
+                if(layout.duplicated >= 0)
+                {
+                    sample.at<float>(2) = sample.at<float>(layout.duplicated);
+                }
+
+                table[static_cast<std::size_t>(r)] = static_cast<float>(_model->predict2(sample, cv::noArray())[0]);
+            }
+        });
+
+    return table;
+}
+
+//------------------------------------------------------------------------------
+
+void masker::update_response_table()
+{
+    m_response_table.clear();
+    m_mask_table.clear();
+
+    if(!m_lookup_table || !this->is_model_learned())
+    {
+        return;
+    }
+
+    switch(m_detectionmode)
+    {
+        case fg_ll:
+            m_response_table = make_response_table(m_foreground_model, m_colorspace);
+            break;
+
+        case bg_ll:
+            m_response_table = make_response_table(m_background_model, m_colorspace);
+            break;
+
+        case ll_ratio:
+        {
+            m_response_table = make_response_table(m_foreground_model, m_colorspace);
+            const std::vector<float> bg_response = make_response_table(m_background_model, m_colorspace);
+            std::transform(
+                m_response_table.begin(),
+                m_response_table.end(),
+                bg_response.begin(),
+                m_response_table.begin(),
+                std::minus<>()
+            );
+            break;
+        }
+    }
+
+    this->update_mask_table();
+}
+
+//------------------------------------------------------------------------------
+
+void masker::update_mask_table()
+{
+    if(m_response_table.empty())
+    {
+        return;
+    }
+
+    // cv::threshold() compares the float responses with the threshold converted to float
+    const auto threshold = static_cast<float>(m_threshold);
+
+    m_mask_table.resize(m_response_table.size());
+    std::transform(
+        m_response_table.begin(),
+        m_response_table.end(),
+        m_mask_table.begin(),
+        [&](float _response){return classify(_response, threshold, m_detectionmode);});
+
+    // make_response_image() leaves a zero response outside the filter mask
+    m_outside_value = classify(0.F, threshold, m_detectionmode);
+}
+
+//------------------------------------------------------------------------------
+
+cv::Mat masker::make_lookup_mask(const cv::Mat& _i, const cv::Mat& _in_img_mask) const
+{
+    SIGHT_ASSERT("Only 3 channels 8 bits images are supported", _i.type() == CV_8UC3);
+
+    const lut_layout layout     = make_layout(m_colorspace);
+    const std::uint8_t* table   = m_mask_table.data();
+    const bool uses_filter_mask = !_in_img_mask.empty();
+
+    cv::Mat output(_i.rows, _i.cols, CV_8UC1);
+
+    cv::parallel_for_(
+        cv::Range(0, _i.rows),
+        [&](const cv::Range& _range)
+        {
+            const auto [q0, q1, q2] = layout.quantization;
+            const auto [p0, p1, p2] = layout.position;
+
+            for(int row = _range.start ; row < _range.end ; ++row)
+            {
+                const uchar* pixel_ptr = _i.ptr<uchar>(row);
+                uchar* output_ptr      = output.ptr<uchar>(row);
+
+                // Keep the lookup loop branchless, the filter mask is applied afterwards
+                for(int col = 0 ; col < _i.cols ; ++col, pixel_ptr += 3)
+                {
+                    output_ptr[col] = table[((pixel_ptr[0] >> q0) << p0)
+                                            | ((pixel_ptr[1] >> q1) << p1)
+                                            | ((pixel_ptr[2] >> q2) << p2)];
+                }
+
+                if(uses_filter_mask)
+                {
+                    const uchar* mask_ptr = _in_img_mask.ptr<uchar>(row);
+                    for(int col = 0 ; col < _i.cols ; ++col)
+                    {
+                        output_ptr[col] = mask_ptr[col] == 0 ? m_outside_value : output_ptr[col];
+                    }
+                }
+            }
+        });
+
+    return output;
+}
+
+//------------------------------------------------------------------------------
+
 cv::Mat masker::convert_colour_space(const cv::Mat& _src, const col_space& _c)
 {
     cv::Mat output;
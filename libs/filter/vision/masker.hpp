@@ -27,6 +27,9 @@
 #include <opencv2/ml.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace sight::filter::vision
 {
 
@@ -55,6 +58,11 @@ enum detection_mode
  * @brief Class performing OpenCV Expectation Maximization segmentation after a learning step of two color models. One
  * for the foreground objects that we need to segment and a second one for the background.
  *
+ * The models can also be compiled into a lookup table of the colour space, rebuilt each time a model is trained or the
+ * threshold changes, to classify each pixel with a single memory access instead of an EM prediction. For h_sv, l_ab and
+ * y_cr_cb, only two channels are kept, the table covers all their values and gives the same mask as the models. For bgr,
+ * the channels are quantized on 6 bits.
+ *
  * @see Documentation from OpenCV https://docs.opencv.org/master/dc/dd6/ml_intro.html#ml_intro_em
  */
 class SIGHT_FILTER_VISION_CLASS_API masker
@@ -95,6 +103,12 @@ public:
     /// Return if a model is learned
     SIGHT_FILTER_VISION_API bool is_model_learned();
 
+    /// Enable or disable the classification with a lookup table, the table is built now if the models are learned
+    SIGHT_FILTER_VISION_API void set_lookup_table(bool _enabled);
+
+    /// Return if the classification uses a lookup table
+    [[nodiscard]] SIGHT_FILTER_VISION_API bool use_lookup_table() const;
+
 private:
 
     /// Make a response mask from a model on a given image inside a mask
@@ -116,6 +130,18 @@ private:
     /// OpenCV operations to remove holes in the mask
     static cv::Mat remove_mask_holes(const cv::Mat& _m, std::size_t _n, cv::InputArray _inside_mask);
 
+    /// Compute the response of a model for every entry of the lookup table
+    static std::vector<float> make_response_table(const cv::Ptr<cv::ml::EM>& _model, const col_space& _c);
+
+    /// Rebuild the response table from the learned models, or clear it if the lookup table is disabled
+    void update_response_table();
+
+    /// Threshold the response table into the binary lookup table
+    void update_mask_table();
+
+    /// Make the binary mask of an image in the model colour space with the lookup table
+    [[nodiscard]] cv::Mat make_lookup_mask(const cv::Mat& _in_img, const cv::Mat& _in_img_mask) const;
+
     /// Foreground and background models
     cv::Ptr<cv::ml::EM> m_foreground_model;
     cv::Ptr<cv::ml::EM> m_background_model;
@@ -130,6 +156,18 @@ private:
     /// Store if the threshold is set
     bool m_has_set_threshold {false};
 
+    /// Store if the classification uses a lookup table
+    bool m_lookup_table {false};
+
+    /// Response of the models for each entry of the lookup table
+    std::vector<float> m_response_table;
+
+    /// Thresholded responses, 255 for the foreground and 0 for the background
+    std::vector<std::uint8_t> m_mask_table;
+
+    /// Value of the pixels outside the filter mask, a zero response thresholded like the others
+    std::uint8_t m_outside_value {0};
+
     /// Morphological element type
     static constexpr int MORPHTYPE = cv::MORPH_ELLIPSE;
 
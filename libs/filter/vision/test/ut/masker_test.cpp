@@ -0,0 +1,232 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "masker_test.hpp"
+
+#include <filter/vision/masker.hpp>
+
+#include <core/spy_log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(sight::filter::vision::ut::masker_test);
+
+namespace sight::filter::vision::ut
+{
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+
+/// Green foreground on the left half and red background on the right half, with some noise
+cv::Mat make_scene(const cv::Size& _size, std::uint64_t _seed)
+{
+    cv::Mat scene(_size, CV_16SC3, cv::Scalar(50, 60, 190));
+    scene(cv::Rect(0, 0, _size.width / 2, _size.height)).setTo(cv::Scalar(60, 170, 70));
+
+    cv::Mat noise(_size, CV_16SC3);
+    cv::RNG rng(_seed);
+    rng.fill(noise, cv::RNG::NORMAL, 0, 10);
+
+    cv::Mat output;
+    cv::Mat(scene + noise).convertTo(output, CV_8UC3);
+    return output;
+}
+
+//------------------------------------------------------------------------------
+
+cv::Mat make_half_mask(const cv::Size& _size, bool _left)
+{
+    cv::Mat mask = cv::Mat::zeros(_size, CV_8UC1);
+    const int half = _size.width / 2;
+    mask(cv::Rect(_left ? 0 : half, 0, _size.width - half, _size.height)).setTo(255);
+    return mask;
+}
+
+//------------------------------------------------------------------------------
+
+/// Region of interest of the masking, the foreground touches its border
+cv::Mat make_filter_mask(const cv::Size& _size)
+{
+    cv::Mat mask = cv::Mat::zeros(_size, CV_8UC1);
+    mask(cv::Rect(16, 16, _size.width - 32, _size.height - 32)).setTo(255);
+    return mask;
+}
+
+//------------------------------------------------------------------------------
+
+void train(masker& _masker, const cv::Size& _size)
+{
+    const cv::Mat scene = make_scene(_size, 1);
+    _masker.train_foreground_model(scene, make_half_mask(_size, true), 2);
+    _masker.train_background_model(scene, make_half_mask(_size, false), 2);
+}
+
+//------------------------------------------------------------------------------
+
+double threshold(detection_mode _d)
+{
+    // The likelihoods are logarithms, the ratio is a difference
+    return _d == ll_ratio ? 1. : -20.;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+void masker_test::setUp()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void masker_test::tearDown()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void masker_test::lookup_table_test()
+{
+    const cv::Size size(160, 120);
+    const cv::Mat scene       = make_scene(size, 2);
+    const cv::Mat filter_mask = make_filter_mask(size);
+
+    for(const col_space c : {h_sv, l_ab, y_cr_cb})
+    {
+        for(const detection_mode d : {fg_ll, bg_ll, ll_ratio})
+        {
+            const std::string msg = "colour space " + std::to_string(c) + ", mode " + std::to_string(d);
+
+            // The table is built by the learning steps
+            masker colour_masker(c, d);
+            colour_masker.set_lookup_table(true);
+            colour_masker.set_threshold(threshold(d));
+            train(colour_masker, size);
+            CPPUNIT_ASSERT_MESSAGE(msg, colour_masker.use_lookup_table());
+
+            const cv::Mat lookup_mask = colour_masker.make_mask(scene, size, filter_mask);
+
+            colour_masker.set_lookup_table(false);
+            CPPUNIT_ASSERT_MESSAGE(msg, !colour_masker.use_lookup_table());
+            const cv::Mat model_mask = colour_masker.make_mask(scene, size, filter_mask);
+
+            // Two channels colour spaces are not quantized, the masks are identical
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, 0, cv::countNonZero(lookup_mask != model_mask));
+
+            if(d == ll_ratio)
+            {
+                CPPUNIT_ASSERT_MESSAGE(msg, cv::countNonZero(lookup_mask) > 0);
+            }
+
+            // Changing the threshold after the table is built
+            colour_masker.set_lookup_table(true);
+            colour_masker.set_threshold(threshold(d) + 5.);
+            const cv::Mat lookup_mask2 = colour_masker.make_mask(scene, size, filter_mask);
+            colour_masker.set_lookup_table(false);
+            const cv::Mat model_mask2 = colour_masker.make_mask(scene, size, filter_mask);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, 0, cv::countNonZero(lookup_mask2 != model_mask2));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void masker_test::lookup_table_quantized_test()
+{
+    const cv::Size size(160, 120);
+    const cv::Mat scene       = make_scene(size, 2);
+    const cv::Mat filter_mask = make_filter_mask(size);
+
+    masker colour_masker(bgr, ll_ratio);
+    colour_masker.set_threshold(threshold(ll_ratio));
+    train(colour_masker, size);
+    const cv::Mat model_mask = colour_masker.make_mask(scene, size, filter_mask);
+
+    colour_masker.set_lookup_table(true);
+    const cv::Mat lookup_mask = colour_masker.make_mask(scene, size, filter_mask);
+
+    // The colours are quantized on 6 bits, only a few pixels close to the decision boundary may differ
+    CPPUNIT_ASSERT(cv::countNonZero(lookup_mask) > 0);
+    CPPUNIT_ASSERT_LESS(size.area() / 100, cv::countNonZero(lookup_mask != model_mask));
+}
+
+//------------------------------------------------------------------------------
+
+void masker_test::lookup_table_benchmark()
+{
+    // Only run when profiling
+    static const char* const s_ENV_LOOP = std::getenv("PROFILETEST_LOOP");
+    if(s_ENV_LOOP == nullptr)
+    {
+        return;
+    }
+
+    // Check how many frames to mask
+    static const int s_LOOP_COUNT = std::max(1, std::stoi(s_ENV_LOOP));
+
+    const int nb_frames = 4 * s_LOOP_COUNT;
+
+    // Same settings as module::filter::vision::colour_image_masking on a HD frame
+    const cv::Size size(1280, 720);
+    const cv::Mat scene       = make_scene(size, 2);
+    const cv::Mat filter_mask = make_filter_mask(size);
+
+    masker colour_masker(h_sv, ll_ratio);
+    colour_masker.set_threshold(threshold(ll_ratio));
+    train(colour_masker, size);
+
+    const auto measure =
+        [&]
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for(int i = 0 ; i < nb_frames ; ++i)
+            {
+                const cv::Mat mask = colour_masker.make_mask(scene, size, filter_mask);
+                CPPUNIT_ASSERT(!mask.empty());
+            }
+
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / nb_frames;
+        };
+
+    const double model_time = measure();
+
+    const auto start = std::chrono::steady_clock::now();
+    colour_masker.set_lookup_table(true);
+    const double build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double lookup_time = measure();
+
+    SIGHT_INFO(
+        "masker: models " << model_time * 1e3 << " ms/frame, lookup table " << lookup_time * 1e3
+        << " ms/frame (x" << model_time / lookup_time << "), table built in " << build_time * 1e3 << " ms"
+    );
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace sight::filter::vision::ut
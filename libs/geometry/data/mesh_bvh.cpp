@@ -0,0 +1,842 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "geometry/data/mesh_bvh.hpp"
+
+#include <core/spy_log.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string_view>
+
+namespace sight::geometry::data
+{
+
+namespace point = sight::data::iterator::point;
+namespace cell  = sight::data::iterator::cell;
+
+namespace
+{
+
+/// Maximum number of triangles in a leaf
+constexpr std::size_t MAX_LEAF_SIZE = 8;
+
+/// Number of bins used to find the best split of a node
+constexpr std::size_t NUM_BINS = 16;
+
+/// Maximum depth of the hierarchy, it bounds the size of the traversal stack
+constexpr std::size_t MAX_DEPTH = 60;
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+//------------------------------------------------------------------------------
+
+struct box_t
+{
+    glm::dvec3 min {INF};
+    glm::dvec3 max {-INF};
+
+    //------------------------------------------------------------------------------
+
+    void extend(const glm::dvec3& _p)
+    {
+        min = glm::min(min, _p);
+        max = glm::max(max, _p);
+    }
+
+    //------------------------------------------------------------------------------
+
+    void extend(const box_t& _box)
+    {
+        min = glm::min(min, _box.min);
+        max = glm::max(max, _box.max);
+    }
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] double half_area() const
+    {
+        if(min.x > max.x)
+        {
+            return 0.;
+        }
+
+        const glm::dvec3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/// Returns the range of distances along the ray inside the box, empty if the ray misses it
+std::pair<double, double> clip_ray(
+    const glm::dvec3& _min,
+    const glm::dvec3& _max,
+    const glm::dvec3& _origin,
+    const glm::dvec3& _inv_direction,
+    double _near,
+    double _far
+)
+{
+    for(glm::length_t axis = 0 ; axis < 3 ; ++axis)
+    {
+        if(std::isinf(_inv_direction[axis]))
+        {
+            // The ray is parallel to the slab
+            if(_origin[axis] < _min[axis] || _origin[axis] > _max[axis])
+            {
+                return {INF, -INF};
+            }
+
+            continue;
+        }
+
+        double t0 = (_min[axis] - _origin[axis]) * _inv_direction[axis];
+        double t1 = (_max[axis] - _origin[axis]) * _inv_direction[axis];
+        if(t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        _near = std::max(_near, t0);
+        _far  = std::min(_far, t1);
+    }
+
+    return {_near, _far};
+}
+
+//------------------------------------------------------------------------------
+
+/// Squared distance from a point to a box
+double distance2(const glm::dvec3& _min, const glm::dvec3& _max, const glm::dvec3& _p)
+{
+    const glm::dvec3 d = glm::max(glm::max(_min - _p, _p - _max), glm::dvec3(0.));
+    return glm::dot(d, d);
+}
+
+//------------------------------------------------------------------------------
+
+/// "Fast, Minimum Storage Ray/Triangle Intersection", Tomas Muller, Ben Trumbore, as intersect_triangle()
+std::optional<double> intersect_triangle(
+    const glm::dvec3& _origin,
+    const glm::dvec3& _direction,
+    const std::array<glm::dvec3, 3>& _triangle
+)
+{
+    const glm::dvec3 edge1 = _triangle[1] - _triangle[0];
+    const glm::dvec3 edge2 = _triangle[2] - _triangle[0];
+    const glm::dvec3 pvec  = glm::cross(_direction, edge2);
+    const double det       = glm::dot(edge1, pvec);
+
+    // The ray lies in the plane of the triangle
+    if(std::abs(det) <= 1e-12 * glm::length(edge1) * glm::length(pvec))
+    {
+        return std::nullopt;
+    }
+
+    const double inv_det = 1. / det;
+
+    const glm::dvec3 tvec = _origin - _triangle[0];
+    const double u        = inv_det * glm::dot(tvec, pvec);
+    if(u < 0. || u > 1.)
+    {
+        return std::nullopt;
+    }
+
+    const glm::dvec3 qvec = glm::cross(tvec, edge1);
+    const double v        = inv_det * glm::dot(_direction, qvec);
+    if(v < 0. || u + v > 1.)
+    {
+        return std::nullopt;
+    }
+
+    return inv_det * glm::dot(edge2, qvec);
+}
+
+//------------------------------------------------------------------------------
+
+/// Closest point of a triangle, from "Real-Time Collision Detection", Christer Ericson
+glm::dvec3 closest_point_on_triangle(const glm::dvec3& _p, const std::array<glm::dvec3, 3>& _triangle)
+{
+    const glm::dvec3& a = _triangle[0];
+    const glm::dvec3& b = _triangle[1];
+    const glm::dvec3& c = _triangle[2];
+
+    const glm::dvec3 ab = b - a;
+    const glm::dvec3 ac = c - a;
+    const glm::dvec3 ap = _p - a;
+
+    const double d1 = glm::dot(ab, ap);
+    const double d2 = glm::dot(ac, ap);
+    if(d1 <= 0. && d2 <= 0.)
+    {
+        return a;
+    }
+
+    const glm::dvec3 bp = _p - b;
+    const double d3     = glm::dot(ab, bp);
+    const double d4     = glm::dot(ac, bp);
+    if(d3 >= 0. && d4 <= d3)
+    {
+        return b;
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+    if(vc <= 0. && d1 >= 0. && d3 <= 0.)
+    {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const glm::dvec3 cp = _p - c;
+    const double d5     = glm::dot(ab, cp);
+    const double d6     = glm::dot(ac, cp);
+    if(d6 >= 0. && d5 <= d6)
+    {
+        return c;
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+    if(vb <= 0. && d2 >= 0. && d6 <= 0.)
+    {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+    if(va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+    {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const double denom = 1. / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//------------------------------------------------------------------------------
+
+/// Hashes the first elements of a mesh array
+template<typename T>
+std::size_t hash_array(const sight::data::mesh& _mesh, std::size_t _count)
+{
+    if(_count == 0)
+    {
+        return 0;
+    }
+
+    const auto* const bytes = reinterpret_cast<const char*>(&*_mesh.cbegin<T>());
+    return std::hash<std::string_view>()(std::string_view(bytes, _count * sizeof(T)));
+}
+
+//------------------------------------------------------------------------------
+
+/// Hashes the positions and the cells of a mesh, they can be written without changing its last_modified() counter
+std::size_t content_hash(const sight::data::mesh& _mesh)
+{
+    const auto dump_lock = _mesh.dump_lock();
+
+    std::size_t hash = hash_array<point::xyz>(_mesh, _mesh.num_points());
+    std::size_t cells_hash = 0;
+    if(_mesh.cell_type() == sight::data::mesh::cell_type_t::triangle)
+    {
+        cells_hash = hash_array<cell::triangle>(_mesh, _mesh.num_cells());
+    }
+    else if(_mesh.cell_type() == sight::data::mesh::cell_type_t::quad)
+    {
+        cells_hash = hash_array<cell::quad>(_mesh, _mesh.num_cells());
+    }
+
+    hash ^= cells_hash + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::size_t>(_mesh.cell_type()) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+mesh_bvh::mesh_bvh(const sight::data::mesh& _mesh, const glm::dmat4& _transform)
+{
+    const auto dump_lock = _mesh.dump_lock();
+
+    const auto points = _mesh.cbegin<point::xyz>();
+    const auto add_triangle =
+        [&](sight::data::mesh::cell_t _a, sight::data::mesh::cell_t _b, sight::data::mesh::cell_t _c, std::size_t _cell)
+        {
+            const auto transform =
+                [&](sight::data::mesh::cell_t _index)
+                {
+                    const auto& p = *(points + std::ptrdiff_t(_index));
+                    return glm::dvec3(_transform * glm::dvec4(p.x, p.y, p.z, 1.));
+                };
+
+            m_triangles.push_back({transform(_a), transform(_b), transform(_c)});
+            m_cells.push_back(_cell);
+        };
+
+    std::size_t index = 0;
+    if(_mesh.cell_type() == sight::data::mesh::cell_type_t::triangle)
+    {
+        m_triangles.reserve(_mesh.num_cells());
+        m_cells.reserve(_mesh.num_cells());
+        for(const auto& c : _mesh.crange<cell::triangle>())
+        {
+            add_triangle(c.pt[0], c.pt[1], c.pt[2], index++);
+        }
+    }
+    else if(_mesh.cell_type() == sight::data::mesh::cell_type_t::quad)
+    {
+        m_triangles.reserve(std::size_t(_mesh.num_cells()) * 2);
+        m_cells.reserve(std::size_t(_mesh.num_cells()) * 2);
+        for(const auto& c : _mesh.crange<cell::quad>())
+        {
+            add_triangle(c.pt[0], c.pt[1], c.pt[2], index);
+            add_triangle(c.pt[2], c.pt[3], c.pt[0], index++);
+        }
+    }
+
+    this->build();
+}
+
+//------------------------------------------------------------------------------
+
+mesh_bvh::mesh_bvh(const fw_vertex_position& _vertex, const fw_vertex_index& _vertex_index)
+{
+    m_triangles.reserve(_vertex_index.size());
+    m_cells.reserve(_vertex_index.size());
+
+    const auto point =
+        [&](int _index)
+        {
+            const auto& p = _vertex[std::size_t(_index)];
+            return glm::dvec3(p[0], p[1], p[2]);
+        };
+
+    for(std::size_t i = 0 ; i < _vertex_index.size() ; ++i)
+    {
+        const auto& triangle = _vertex_index[i];
+        m_triangles.push_back({point(triangle[0]), point(triangle[1]), point(triangle[2])});
+        m_cells.push_back(i);
+    }
+
+    this->build();
+}
+
+//------------------------------------------------------------------------------
+
+std::size_t mesh_bvh::num_triangles() const
+{
+    return m_triangles.size();
+}
+
+//------------------------------------------------------------------------------
+
+bool mesh_bvh::empty() const
+{
+    return m_triangles.empty();
+}
+
+//------------------------------------------------------------------------------
+
+std::array<glm::dvec3, 2> mesh_bvh::bounds() const
+{
+    if(m_nodes.empty())
+    {
+        return {glm::dvec3(0.), glm::dvec3(0.)};
+    }
+
+    return {m_nodes[0].m_min, m_nodes[0].m_max};
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh::build()
+{
+    if(m_triangles.empty())
+    {
+        return;
+    }
+
+    SIGHT_ASSERT(
+        "Too many triangles: " << m_triangles.size(),
+        m_triangles.size() <= std::numeric_limits<std::uint32_t>::max()
+    );
+
+    std::vector<std::uint32_t> indices(m_triangles.size());
+    std::vector<glm::dvec3> centroids(m_triangles.size());
+    for(std::size_t i = 0 ; i < m_triangles.size() ; ++i)
+    {
+        indices[i]   = std::uint32_t(i);
+        centroids[i] = (m_triangles[i][0] + m_triangles[i][1] + m_triangles[i][2]) / 3.;
+    }
+
+    // A binary tree with leaves of at least one triangle has less than 2n nodes
+    m_nodes.reserve(2 * m_triangles.size());
+    m_nodes.push_back({.m_min = {}, .m_max = {}, .m_first = 0, .m_count = std::uint32_t(m_triangles.size())});
+    this->split(0, indices, centroids, 0);
+
+    // Sort the triangles in the order of the leaves
+    std::vector<triangle_t> triangles(m_triangles.size());
+    std::vector<std::size_t> cells(m_cells.size());
+    for(std::size_t i = 0 ; i < indices.size() ; ++i)
+    {
+        triangles[i] = m_triangles[indices[i]];
+        cells[i]     = m_cells[indices[i]];
+    }
+
+    m_triangles = std::move(triangles);
+    m_cells     = std::move(cells);
+    m_nodes.shrink_to_fit();
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh::split(
+    std::size_t _node,
+    std::vector<std::uint32_t>& _indices,
+    const std::vector<glm::dvec3>& _centroids,
+    std::size_t _depth
+)
+{
+    const std::size_t first = m_nodes[_node].m_first;
+    const std::size_t count = m_nodes[_node].m_count;
+    const auto begin        = _indices.begin() + std::ptrdiff_t(first);
+    const auto end          = begin + std::ptrdiff_t(count);
+
+    box_t box;
+    box_t centroid_box;
+    for(auto it = begin ; it != end ; ++it)
+    {
+        for(const auto& p : m_triangles[*it])
+        {
+            box.extend(p);
+        }
+
+        centroid_box.extend(_centroids[*it]);
+    }
+
+    m_nodes[_node].m_min = box.min;
+    m_nodes[_node].m_max = box.max;
+
+    if(count <= 2 || _depth >= MAX_DEPTH)
+    {
+        return;
+    }
+
+    // Split along the largest axis of the centroids
+    const glm::dvec3 extent = centroid_box.max - centroid_box.min;
+    const glm::length_t axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    if(extent[axis] <= 0.)
+    {
+        return;
+    }
+
+    // Find the best split between bins with the surface area heuristic
+    const double scale = double(NUM_BINS) / extent[axis];
+    const auto bin_of  =
+        [&](std::uint32_t _index)
+        {
+            return std::min(NUM_BINS - 1, std::size_t((_centroids[_index][axis] - centroid_box.min[axis]) * scale));
+        };
+
+    std::array<box_t, NUM_BINS> bin_boxes;
+    std::array<std::size_t, NUM_BINS> bin_counts {};
+    for(auto it = begin ; it != end ; ++it)
+    {
+        const std::size_t bin = bin_of(*it);
+        ++bin_counts[bin];
+        for(const auto& p : m_triangles[*it])
+        {
+            bin_boxes[bin].extend(p);
+        }
+    }
+
+    std::array<double, NUM_BINS> right_costs {};
+    box_t right_box;
+    std::size_t right_count = 0;
+    for(std::size_t bin = NUM_BINS - 1 ; bin > 0 ; --bin)
+    {
+        right_box.extend(bin_boxes[bin]);
+        right_count      += bin_counts[bin];
+        right_costs[bin] = double(right_count) * right_box.half_area();
+    }
+
+    std::size_t best_bin = 0;
+    double best_cost     = INF;
+    box_t left_box;
+    std::size_t left_count = 0;
+    for(std::size_t bin = 0 ; bin < NUM_BINS - 1 ; ++bin)
+    {
+        left_box.extend(bin_boxes[bin]);
+        left_count += bin_counts[bin];
+
+        const double cost = double(left_count) * left_box.half_area() + right_costs[bin + 1];
+        if(left_count > 0 && left_count < count && cost < best_cost)
+        {
+            best_cost = cost;
+            best_bin  = bin;
+        }
+    }
+
+    // Keep small nodes as leaves when splitting them does not pay
+    if(count <= MAX_LEAF_SIZE && best_cost >= double(count) * box.half_area())
+    {
+        return;
+    }
+
+    auto middle = std::partition(begin, end, [&](std::uint32_t _index){return bin_of(_index) <= best_bin;});
+    if(middle == begin || middle == end)
+    {
+        middle = begin + std::ptrdiff_t(count / 2);
+        std::nth_element(
+            begin,
+            middle,
+            end,
+            [&](std::uint32_t _a, std::uint32_t _b){return _centroids[_a][axis] < _centroids[_b][axis];});
+    }
+
+    const auto left_size = std::uint32_t(middle - begin);
+
+    // The first child follows its parent, the second one follows the subtree of the first child
+    m_nodes.push_back({.m_min = {}, .m_max = {}, .m_first = std::uint32_t(first), .m_count = left_size});
+    this->split(_node + 1, _indices, _centroids, _depth + 1);
+
+    const std::size_t right = m_nodes.size();
+    m_nodes.push_back(
+        {.m_min = {}, .m_max = {}, .m_first = std::uint32_t(first) + left_size,
+         .m_count = std::uint32_t(count) - left_size
+        });
+    this->split(right, _indices, _centroids, _depth + 1);
+
+    m_nodes[_node].m_first = std::uint32_t(right);
+    m_nodes[_node].m_count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+template<typename FUNC>
+void mesh_bvh::traverse(
+    const glm::dvec3& _origin,
+    const glm::dvec3& _direction,
+    double _min_distance,
+    double& _max_distance,
+    FUNC _func
+) const
+{
+    if(m_nodes.empty())
+    {
+        return;
+    }
+
+    const glm::dvec3 inv_direction = 1. / _direction;
+
+    std::array<std::pair<std::uint32_t, double>, MAX_DEPTH + 2> stack {};
+    std::size_t stack_size = 0;
+
+    const auto [root_near, root_far] =
+        clip_ray(m_nodes[0].m_min, m_nodes[0].m_max, _origin, inv_direction, _min_distance, _max_distance);
+    if(root_near > root_far)
+    {
+        return;
+    }
+
+    stack[stack_size++] = {0, root_near};
+
+    while(stack_size > 0)
+    {
+        const auto [index, near] = stack[--stack_size];
+
+        // The function may have reduced the maximum distance since the node was pushed
+        if(near > _max_distance)
+        {
+            continue;
+        }
+
+        const node_t& node = m_nodes[index];
+        if(node.m_count > 0)
+        {
+            for(std::size_t i = node.m_first ; i < node.m_first + node.m_count ; ++i)
+            {
+                _func(i);
+            }
+
+            continue;
+        }
+
+        const std::uint32_t first  = index + 1;
+        const std::uint32_t second = node.m_first;
+
+        const auto [first_near, first_far] =
+            clip_ray(m_nodes[first].m_min, m_nodes[first].m_max, _origin, inv_direction, _min_distance, _max_distance);
+        const auto [second_near, second_far] =
+            clip_ray(
+                m_nodes[second].m_min,
+                m_nodes[second].m_max,
+                _origin,
+                inv_direction,
+                _min_distance,
+                _max_distance
+            );
+
+        const bool first_hit  = first_near <= first_far;
+        const bool second_hit = second_near <= second_far;
+
+        // Push the farthest child first, to visit the nearest one first
+        if(first_hit && second_hit)
+        {
+            if(first_near <= second_near)
+            {
+                stack[stack_size++] = {second, second_near};
+                stack[stack_size++] = {first, first_near};
+            }
+            else
+            {
+                stack[stack_size++] = {first, first_near};
+                stack[stack_size++] = {second, second_near};
+            }
+        }
+        else if(first_hit)
+        {
+            stack[stack_size++] = {first, first_near};
+        }
+        else if(second_hit)
+        {
+            stack[stack_size++] = {second, second_near};
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<double> mesh_bvh::crossings(
+    const glm::dvec3& _origin,
+    const glm::dvec3& _direction,
+    double _min_distance,
+    double _max_distance
+) const
+{
+    std::vector<double> distances;
+
+    this->traverse(
+        _origin,
+        _direction,
+        _min_distance,
+        _max_distance,
+        [&](std::size_t _triangle)
+        {
+            const auto t = intersect_triangle(_origin, _direction, m_triangles[_triangle]);
+            if(t && *t > _min_distance && *t < _max_distance)
+            {
+                distances.push_back(*t);
+            }
+        });
+
+    std::ranges::sort(distances);
+
+    // A ray crossing an edge or a vertex hits all the triangles sharing it
+    const auto last = std::unique(
+        distances.begin(),
+        distances.end(),
+        [](double _a, double _b)
+        {
+            return _b - _a <= 1e-9 * std::max(1., std::abs(_b));
+        });
+    distances.erase(last, distances.end());
+
+    return distances;
+}
+
+//------------------------------------------------------------------------------
+
+bool mesh_bvh::contains(const glm::dvec3& _point) const
+{
+    return this->crossings(_point, {0., 0., -1.}, 0., INF).size() % 2 == 1;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<std::uint8_t> mesh_bvh::contains(const std::vector<glm::dvec3>& _points) const
+{
+    std::vector<std::uint8_t> result(_points.size(), 0);
+
+    // NOLINTNEXTLINE(clang-diagnostic-unknown-pragmas)
+    #pragma omp parallel for
+    for(std::int64_t i = 0 ; i < std::int64_t(_points.size()) ; ++i)
+    {
+        result[std::size_t(i)] = this->contains(_points[std::size_t(i)]) ? 1 : 0;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+std::optional<mesh_bvh::hit_t> mesh_bvh::intersect(
+    const glm::dvec3& _origin,
+    const glm::dvec3& _direction,
+    double _max_distance
+) const
+{
+    std::optional<hit_t> hit;
+
+    this->traverse(
+        _origin,
+        _direction,
+        0.,
+        _max_distance,
+        [&](std::size_t _triangle)
+        {
+            const auto t = intersect_triangle(_origin, _direction, m_triangles[_triangle]);
+            if(t && *t >= 0. && *t <= _max_distance)
+            {
+                // Farther leaves are skipped from now on
+                _max_distance = *t;
+                hit           = hit_t {.distance = *t, .point = _origin + *t * _direction, .cell = m_cells[_triangle]};
+            }
+        });
+
+    return hit;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<double> mesh_bvh::intersect_all(const glm::dvec3& _origin, const glm::dvec3& _direction) const
+{
+    return this->crossings(_origin, _direction, -INF, INF);
+}
+
+//------------------------------------------------------------------------------
+
+mesh_bvh::hit_t mesh_bvh::closest_point(const glm::dvec3& _point) const
+{
+    SIGHT_ASSERT("The mesh is empty", !m_nodes.empty());
+
+    hit_t best {.distance = INF, .point = {}, .cell = 0};
+    double best_distance2 = INF;
+
+    std::array<std::pair<std::uint32_t, double>, MAX_DEPTH + 2> stack {};
+    std::size_t stack_size = 0;
+    stack[stack_size++] = {0, distance2(m_nodes[0].m_min, m_nodes[0].m_max, _point)};
+
+    while(stack_size > 0)
+    {
+        const auto [index, node_distance2] = stack[--stack_size];
+        if(node_distance2 >= best_distance2)
+        {
+            continue;
+        }
+
+        const node_t& node = m_nodes[index];
+        if(node.m_count > 0)
+        {
+            for(std::size_t i = node.m_first ; i < node.m_first + node.m_count ; ++i)
+            {
+                const glm::dvec3 p = closest_point_on_triangle(_point, m_triangles[i]);
+                const glm::dvec3 d = p - _point;
+                const double d2    = glm::dot(d, d);
+                if(d2 < best_distance2)
+                {
+                    best_distance2 = d2;
+                    best.point     = p;
+                    best.cell      = m_cells[i];
+                }
+            }
+
+            continue;
+        }
+
+        const std::uint32_t first     = index + 1;
+        const std::uint32_t second    = node.m_first;
+        const double first_distance2  = distance2(m_nodes[first].m_min, m_nodes[first].m_max, _point);
+        const double second_distance2 = distance2(m_nodes[second].m_min, m_nodes[second].m_max, _point);
+
+        // Push the farthest child first, to visit the nearest one first
+        if(first_distance2 <= second_distance2)
+        {
+            stack[stack_size++] = {second, second_distance2};
+            stack[stack_size++] = {first, first_distance2};
+        }
+        else
+        {
+            stack[stack_size++] = {first, first_distance2};
+            stack[stack_size++] = {second, second_distance2};
+        }
+    }
+
+    best.distance = std::sqrt(best_distance2);
+    return best;
+}
+
+//------------------------------------------------------------------------------
+
+double mesh_bvh::distance(const glm::dvec3& _point) const
+{
+    return this->closest_point(_point).distance;
+}
+
+//------------------------------------------------------------------------------
+
+mesh_bvh::csptr mesh_bvh::get(const sight::data::mesh::csptr& _mesh)
+{
+    SIGHT_ASSERT("The mesh must not be null", _mesh);
+
+    struct entry_t
+    {
+        std::weak_ptr<const sight::data::mesh> mesh;
+        std::size_t hash;
+        csptr bvh;
+    };
+
+    static std::mutex s_mutex;
+    static std::map<const sight::data::mesh*, entry_t> s_cache;
+
+    // Forget the destroyed meshes, their hierarchies are released as soon as nobody else holds them
+    const auto purge = []{std::erase_if(s_cache, [](const auto& _entry){return _entry.second.mesh.expired();});};
+
+    const std::size_t hash = content_hash(*_mesh);
+
+    {
+        std::lock_guard lock(s_mutex);
+        purge();
+
+        const auto it = s_cache.find(_mesh.get());
+        if(it != s_cache.end() && it->second.mesh.lock() == _mesh && it->second.hash == hash)
+        {
+            return it->second.bvh;
+        }
+    }
+
+    // Build outside of the lock, other meshes may be queried meanwhile
+    auto bvh = std::make_shared<const mesh_bvh>(*_mesh);
+
+    std::lock_guard lock(s_mutex);
+    purge();
+    s_cache[_mesh.get()] = {.mesh = _mesh, .hash = hash, .bvh = bvh};
+
+    return bvh;
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace sight::geometry::data
@@ -0,0 +1,214 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/geometry/data/config.hpp>
+
+#include "geometry/data/types.hpp"
+
+#include <data/mesh.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace sight::geometry::data
+{
+
+/**
+ * @brief Bounding volume hierarchy built over the triangles of a mesh.
+ *
+ * It answers point containment, ray casting and closest point queries in logarithmic time instead of testing every
+ * triangle, which matters when the same mesh is queried many times, for instance to voxelize it or to check a large
+ * set of landmarks. Quad cells are split in two triangles, other cell types are ignored.
+ *
+ * The hierarchy is immutable once built. Use get() to share the hierarchy of a sight::data::mesh, it is only built
+ * again when the points or the cells of the mesh have changed.
+ *
+ * @code{.cpp}
+    const auto bvh = geometry::data::mesh_bvh::get(mesh);
+    const bool inside = bvh->contains({10., 20., 30.});
+    if(const auto hit = bvh->intersect(origin, direction); hit)
+    {
+        SIGHT_INFO("Cell " << hit->cell << " hit at " << hit->distance);
+    }
+   @endcode
+ */
+class SIGHT_GEOMETRY_DATA_CLASS_API mesh_bvh
+{
+public:
+
+    using sptr  = std::shared_ptr<mesh_bvh>;
+    using csptr = std::shared_ptr<const mesh_bvh>;
+
+    /// Result of a ray or closest point query
+    struct hit_t
+    {
+        /// Distance along the ray, in units of the ray direction, or euclidean distance to the closest point
+        double distance;
+
+        /// Point of the mesh
+        glm::dvec3 point;
+
+        /// Index of the cell in the mesh
+        std::size_t cell;
+    };
+
+    /// Builds an empty hierarchy.
+    mesh_bvh() = default;
+
+    /**
+     * @brief Builds the hierarchy of the triangle or quad cells of a mesh.
+     * @param _mesh mesh, the caller must hold a lock on it
+     * @param _transform transform applied to the points of the mesh
+     */
+    SIGHT_GEOMETRY_DATA_API explicit mesh_bvh(
+        const sight::data::mesh& _mesh,
+        const glm::dmat4& _transform = glm::dmat4(1.)
+    );
+
+    /// Builds the hierarchy of triangles given by their vertex indices.
+    SIGHT_GEOMETRY_DATA_API mesh_bvh(const fw_vertex_position& _vertex, const fw_vertex_index& _vertex_index);
+
+    /// Returns the number of triangles.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API std::size_t num_triangles() const;
+
+    /// Returns true if there is no triangle.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API bool empty() const;
+
+    /// Returns the minimum and maximum corners of the bounding box of all the triangles.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API std::array<glm::dvec3, 2> bounds() const;
+
+    /**
+     * @brief Returns true if the point is inside the volume enclosed by the mesh.
+     *
+     * Like is_inclosed_volume(), the crossings of a ray cast along -z are counted, so the mesh should be closed.
+     */
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API bool contains(const glm::dvec3& _point) const;
+
+    /// Tests several points at once, in parallel. The result holds 1 for the points inside the mesh, 0 otherwise.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API std::vector<std::uint8_t> contains(
+        const std::vector<glm::dvec3>& _points
+    ) const;
+
+    /**
+     * @brief Returns the nearest intersection of a ray with the mesh.
+     * @param _origin origin of the ray
+     * @param _direction direction of the ray, its norm is the unit of the returned distance
+     * @param _max_distance intersections farther than this distance are ignored
+     */
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API std::optional<hit_t> intersect(
+        const glm::dvec3& _origin,
+        const glm::dvec3& _direction,
+        double _max_distance = std::numeric_limits<double>::max()
+    ) const;
+
+    /**
+     * @brief Returns the distances of all the intersections of a ray with the mesh, sorted in ascending order.
+     *
+     * The ray is cast in both ways, so the distances can be negative. An intersection on an edge or a vertex shared by
+     * several triangles is only returned once.
+     */
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API std::vector<double> intersect_all(
+        const glm::dvec3& _origin,
+        const glm::dvec3& _direction
+    ) const;
+
+    /// Returns the closest point of the mesh, which must not be empty.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API hit_t closest_point(const glm::dvec3& _point) const;
+
+    /// Returns the distance from a point to the mesh, which must not be empty.
+    [[nodiscard]] SIGHT_GEOMETRY_DATA_API double distance(const glm::dvec3& _point) const;
+
+    /**
+     * @brief Returns the hierarchy of a mesh, shared by all the callers.
+     *
+     * The hierarchy is cached until the mesh is destroyed, and built again if the positions or the cells of the mesh
+     * changed since. They are hashed at each call rather than relying on sight::data::object::last_modified(), which
+     * is not incremented when the buffers are written without a locked_ptr. Hashing is linear in the size of the mesh
+     * but much cheaper than building the hierarchy. The caller must hold a lock on the mesh.
+     *
+     * The entries of the destroyed meshes are dropped by the next call.
+     */
+    SIGHT_GEOMETRY_DATA_API static csptr get(const sight::data::mesh::csptr& _mesh);
+
+private:
+
+    using triangle_t = std::array<glm::dvec3, 3>;
+
+    /// Node of the hierarchy. Leaves reference a range of triangles, inner nodes have their first child right after
+    /// them and their second child at m_first.
+    struct node_t
+    {
+        glm::dvec3 m_min;
+        glm::dvec3 m_max;
+        std::uint32_t m_first;
+        std::uint32_t m_count;
+    };
+
+    /// Builds the nodes once the triangles are set.
+    void build();
+
+    /// Computes the box of a node, then splits it and its children recursively.
+    void split(
+        std::size_t _node,
+        std::vector<std::uint32_t>& _indices,
+        const std::vector<glm::dvec3>& _centroids,
+        std::size_t _depth
+    );
+
+    /**
+     * @brief Calls a function with the index of each triangle of the leaves crossed by a ray, nearest leaves first.
+     * @param _max_distance farthest distance along the ray, the function may reduce it to skip farther leaves
+     */
+    template<typename FUNC>
+    void traverse(
+        const glm::dvec3& _origin,
+        const glm::dvec3& _direction,
+        double _min_distance,
+        double& _max_distance,
+        FUNC _func
+    ) const;
+
+    /// Returns the sorted distances of the intersections between the two distances, without duplicates.
+    [[nodiscard]] std::vector<double> crossings(
+        const glm::dvec3& _origin,
+        const glm::dvec3& _direction,
+        double _min_distance,
+        double _max_distance
+    ) const;
+
+    std::vector<triangle_t> m_triangles;
+
+    /// Index of the cell of each triangle
+    std::vector<std::size_t> m_cells;
+
+    std::vector<node_t> m_nodes;
+};
+
+} // namespace sight::geometry::data
@@ -38,7 +38,9 @@ namespace sight::geometry::data
 {
 
 /**
- * @brief
+ * @brief Returns true if the point is inside the volume enclosed by the triangles, by testing all of them.
+ *
+ * To test many points against the same mesh, build a mesh_bvh instead.
  */
 SIGHT_GEOMETRY_DATA_API bool is_inclosed_volume(
     const fw_vertex_position& _vertex,
@@ -0,0 +1,484 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "mesh_bvh_test.hpp"
+
+#include <core/spy_log.hpp>
+
+#include <data/mt/locked_ptr.hpp>
+
+#include <geometry/data/mesh_bvh.hpp>
+#include <geometry/data/mesh_functions.hpp>
+
+#include <glm/ext/scalar_constants.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(sight::geometry::data::ut::mesh_bvh_test);
+
+namespace sight::geometry::data::ut
+{
+
+//------------------------------------------------------------------------------
+
+/// Generates a closed UV sphere
+static void generate_sphere(
+    fw_vertex_position& _vertex,
+    fw_vertex_index& _vertex_index,
+    double _radius,
+    int _rings,
+    int _segments
+)
+{
+    _vertex.push_back({0.F, 0.F, float(_radius)});
+    for(int ring = 1 ; ring < _rings ; ++ring)
+    {
+        const double theta = glm::pi<double>() * ring / _rings;
+        for(int segment = 0 ; segment < _segments ; ++segment)
+        {
+            const double phi = 2. * glm::pi<double>() * segment / _segments;
+            _vertex.push_back(
+                {
+                    float(_radius * std::sin(theta) * std::cos(phi)),
+                    float(_radius * std::sin(theta) * std::sin(phi)),
+                    float(_radius * std::cos(theta))
+                });
+        }
+    }
+
+    _vertex.push_back({0.F, 0.F, float(-_radius)});
+
+    const int south = int(_vertex.size()) - 1;
+    const auto index =
+        [&](int _ring, int _segment)
+        {
+            return 1 + (_ring - 1) * _segments + _segment % _segments;
+        };
+
+    for(int segment = 0 ; segment < _segments ; ++segment)
+    {
+        _vertex_index.push_back({0, index(1, segment), index(1, segment + 1)});
+        _vertex_index.push_back({south, index(_rings - 1, segment + 1), index(_rings - 1, segment)});
+
+        for(int ring = 1 ; ring < _rings - 1 ; ++ring)
+        {
+            _vertex_index.push_back({index(ring, segment), index(ring + 1, segment), index(ring + 1, segment + 1)});
+            _vertex_index.push_back({index(ring, segment), index(ring + 1, segment + 1), index(ring, segment + 1)});
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/// Generates a cube from -1 to 1, made of triangles or quads
+static sight::data::mesh::sptr generate_cube(sight::data::mesh::cell_type_t _cell_type)
+{
+    auto mesh            = std::make_shared<sight::data::mesh>();
+    const auto dump_lock = mesh->dump_lock();
+
+    for(const float z : {-1.F, 1.F})
+    {
+        mesh->push_point(-1.F, -1.F, z);
+        mesh->push_point(1.F, -1.F, z);
+        mesh->push_point(1.F, 1.F, z);
+        mesh->push_point(-1.F, 1.F, z);
+    }
+
+    const std::array<std::array<sight::data::mesh::point_t, 4>, 6> faces {{
+        {0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4}, {1, 2, 6, 5}, {2, 3, 7, 6}, {3, 0, 4, 7}
+    }
+    };
+
+    for(const auto& f : faces)
+    {
+        if(_cell_type == sight::data::mesh::cell_type_t::quad)
+        {
+            mesh->push_cell(f[0], f[1], f[2], f[3]);
+        }
+        else
+        {
+            mesh->push_cell(f[0], f[1], f[2]);
+            mesh->push_cell(f[2], f[3], f[0]);
+        }
+    }
+
+    return mesh;
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::setUp()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::tearDown()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::contains_test()
+{
+    fw_vertex_position vertex;
+    fw_vertex_index vertex_index;
+    generate_sphere(vertex, vertex_index, 10., 24, 32);
+
+    const mesh_bvh bvh(vertex, vertex_index);
+    CPPUNIT_ASSERT_EQUAL(vertex_index.size(), bvh.num_triangles());
+    CPPUNIT_ASSERT(!bvh.empty());
+
+    const auto [min, max] = bvh.bounds();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-10., min.z, 1e-5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10., max.z, 1e-5);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(-12., 12.);
+
+    std::vector<glm::dvec3> points;
+    for(std::size_t i = 0 ; i < 2000 ; ++i)
+    {
+        points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+    }
+
+    const std::vector<std::uint8_t> inside = bvh.contains(points);
+    CPPUNIT_ASSERT_EQUAL(points.size(), inside.size());
+
+    for(std::size_t i = 0 ; i < points.size() ; ++i)
+    {
+        const glm::dvec3& p = points[i];
+        const bool expected = is_inclosed_volume(vertex, vertex_index, {p.x, p.y, p.z});
+
+        CPPUNIT_ASSERT_EQUAL(expected, bvh.contains(p));
+        CPPUNIT_ASSERT_EQUAL(expected, inside[i] == 1);
+
+        // The tessellation is within 0.1 of the sphere
+        const double radius = glm::length(p);
+        if(std::abs(radius - 10.) > 0.1)
+        {
+            CPPUNIT_ASSERT_EQUAL(radius < 10., expected);
+        }
+    }
+
+    // Empty hierarchy
+    const mesh_bvh empty;
+    CPPUNIT_ASSERT(empty.empty());
+    CPPUNIT_ASSERT(!empty.contains({0., 0., 0.}));
+    CPPUNIT_ASSERT(!empty.intersect({0., 0., 0.}, {1., 0., 0.}).has_value());
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::intersect_test()
+{
+    fw_vertex_position vertex;
+    fw_vertex_index vertex_index;
+    generate_sphere(vertex, vertex_index, 10., 24, 32);
+
+    const mesh_bvh bvh(vertex, vertex_index);
+
+    std::mt19937 generator(0);
+    std::normal_distribution<double> distribution;
+
+    for(std::size_t i = 0 ; i < 500 ; ++i)
+    {
+        const glm::dvec3 direction = glm::normalize(
+            glm::dvec3(distribution(generator), distribution(generator), distribution(generator))
+        );
+
+        // From the center, the sphere is hit once
+        const auto hit = bvh.intersect({0., 0., 0.}, direction);
+        CPPUNIT_ASSERT(hit.has_value());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(10., hit->distance, 0.15);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(hit->distance, glm::length(hit->point), 1e-9);
+        CPPUNIT_ASSERT(hit->cell < vertex_index.size());
+
+        // The hit point lies on the returned triangle
+        const auto& cell = vertex_index[hit->cell];
+        double t         = NAN;
+        double u         = NAN;
+        double v         = NAN;
+        CPPUNIT_ASSERT(
+            intersect_triangle(
+                {0., 0., 0.},
+                {direction.x, direction.y, direction.z},
+                {vertex[std::size_t(cell[0])][0], vertex[std::size_t(cell[0])][1], vertex[std::size_t(cell[0])][2]},
+                {vertex[std::size_t(cell[1])][0], vertex[std::size_t(cell[1])][1], vertex[std::size_t(cell[1])][2]},
+                {vertex[std::size_t(cell[2])][0], vertex[std::size_t(cell[2])][1], vertex[std::size_t(cell[2])][2]},
+                t,
+                u,
+                v
+            )
+        );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(hit->distance, t, 1e-6);
+
+        // Too short
+        CPPUNIT_ASSERT(!bvh.intersect({0., 0., 0.}, direction, 9.).has_value());
+
+        // From outside, the nearest side is hit
+        const glm::dvec3 origin = direction * -20.;
+        const auto outside_hit  = bvh.intersect(origin, direction);
+        CPPUNIT_ASSERT(outside_hit.has_value());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(10., outside_hit->distance, 0.15);
+
+        // Both ways, from the center
+        const std::vector<double> distances = bvh.intersect_all({0., 0., 0.}, direction);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), distances.size());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(-10., distances[0], 0.15);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(10., distances[1], 0.15);
+
+        // The direction is the unit of the distances
+        const auto scaled_hit = bvh.intersect({0., 0., 0.}, direction * 2.);
+        CPPUNIT_ASSERT(scaled_hit.has_value());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(hit->distance / 2., scaled_hit->distance, 1e-9);
+    }
+
+    // Through the poles, the ray crosses vertices shared by many triangles
+    const std::vector<double> distances = bvh.intersect_all({0., 0., 0.}, {0., 0., 1.});
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), distances.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-10., distances[0], 1e-5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10., distances[1], 1e-5);
+
+    // Missing the sphere
+    CPPUNIT_ASSERT(!bvh.intersect({20., 0., 0.}, {0., 0., 1.}).has_value());
+    CPPUNIT_ASSERT(bvh.intersect_all({20., 0., 0.}, {0., 1., 0.}).empty());
+    CPPUNIT_ASSERT(!bvh.intersect({0., 0., 20.}, {0., 0., 1.}).has_value());
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::closest_point_test()
+{
+    const auto cube      = generate_cube(sight::data::mesh::cell_type_t::triangle);
+    const auto dump_lock = cube->dump_lock();
+
+    const mesh_bvh bvh(*cube);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(12), bvh.num_triangles());
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(-3., 3.);
+
+    for(std::size_t i = 0 ; i < 1000 ; ++i)
+    {
+        const glm::dvec3 p(distribution(generator), distribution(generator), distribution(generator));
+
+        // Distance to the surface of the cube
+        const glm::dvec3 outside = glm::max(glm::abs(p) - glm::dvec3(1.), glm::dvec3(0.));
+        const double inside      = 1. - std::max(std::abs(p.x), std::max(std::abs(p.y), std::abs(p.z)));
+        const double expected    = inside > 0. ? inside : glm::length(outside);
+
+        const mesh_bvh::hit_t hit = bvh.closest_point(p);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, hit.distance, 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, bvh.distance(p), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(hit.distance, glm::length(hit.point - p), 1e-9);
+
+        // The closest point is on the surface
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(
+            1.,
+            std::max(std::abs(hit.point.x), std::max(std::abs(hit.point.y), std::abs(hit.point.z))),
+            1e-9
+        );
+        CPPUNIT_ASSERT(hit.cell < 12);
+        CPPUNIT_ASSERT_EQUAL(inside > 0., bvh.contains(p));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::quad_test()
+{
+    const auto cube      = generate_cube(sight::data::mesh::cell_type_t::quad);
+    const auto dump_lock = cube->dump_lock();
+
+    // Move the cube to [9;11]
+    auto transform = glm::dmat4(1.);
+    transform[3] = glm::dvec4(10., 10., 10., 1.);
+
+    const mesh_bvh bvh(*cube, transform);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(12), bvh.num_triangles());
+
+    const auto [min, max] = bvh.bounds();
+    CPPUNIT_ASSERT(min == glm::dvec3(9.));
+    CPPUNIT_ASSERT(max == glm::dvec3(11.));
+
+    CPPUNIT_ASSERT(bvh.contains({10., 10., 10.}));
+    CPPUNIT_ASSERT(bvh.contains({10.5, 9.5, 10.9}));
+    CPPUNIT_ASSERT(!bvh.contains({0., 0., 0.}));
+    CPPUNIT_ASSERT(!bvh.contains({10., 10., 11.5}));
+
+    // The cells are the quads
+    const auto hit = bvh.intersect({10.5, 10.5, 0.}, {0., 0., 1.});
+    CPPUNIT_ASSERT(hit.has_value());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(9., hit->distance, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), hit->cell);
+
+    const auto side_hit = bvh.intersect({10.5, 10.5, 10.5}, {1., 0., 0.});
+    CPPUNIT_ASSERT(side_hit.has_value());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, side_hit->distance, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), side_hit->cell);
+
+    // Along an edge shared by two triangles of a quad and by two quads
+    const std::vector<double> distances = bvh.intersect_all({9., 9., 0.}, {0., 0., 1.});
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), distances.size());
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::cache_test()
+{
+    auto cube = generate_cube(sight::data::mesh::cell_type_t::triangle);
+
+    mesh_bvh::csptr bvh;
+    {
+        const auto dump_lock = cube->dump_lock();
+        bvh = mesh_bvh::get(cube);
+        CPPUNIT_ASSERT(bvh);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(12), bvh->num_triangles());
+
+        // Not modified, the same hierarchy is returned
+        CPPUNIT_ASSERT_EQUAL(bvh, mesh_bvh::get(cube));
+    }
+
+    // Reading the mesh does not change it
+    {
+        const sight::data::mesh::csptr const_cube = cube;
+        const sight::data::mt::locked_ptr lock(const_cube);
+        CPPUNIT_ASSERT_EQUAL(bvh, mesh_bvh::get(cube));
+    }
+
+    // Add a face and build the hierarchy again
+    {
+        const sight::data::mt::locked_ptr lock(cube);
+        lock->push_cell(0, 2, 6);
+    }
+
+    {
+        const auto dump_lock   = cube->dump_lock();
+        const auto bvh_updated = mesh_bvh::get(cube);
+        CPPUNIT_ASSERT(bvh != bvh_updated);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(13), bvh_updated->num_triangles());
+        CPPUNIT_ASSERT_EQUAL(bvh_updated, mesh_bvh::get(cube));
+    }
+
+    // The previous hierarchy is still valid for those who hold it
+    CPPUNIT_ASSERT_EQUAL(std::size_t(12), bvh->num_triangles());
+
+    // Another mesh has its own hierarchy
+    auto other_cube = generate_cube(sight::data::mesh::cell_type_t::quad);
+    {
+        const auto dump_lock = other_cube->dump_lock();
+        CPPUNIT_ASSERT(mesh_bvh::get(other_cube) != mesh_bvh::get(cube));
+    }
+
+    // Moving a point without a locked_ptr does not change last_modified(), the hierarchy is still built again
+    {
+        const auto dump_lock     = cube->dump_lock();
+        const auto bvh_before    = mesh_bvh::get(cube);
+        const auto last_modified = cube->last_modified();
+
+        cube->begin<sight::data::iterator::point::xyz>()->x = 20.F;
+        CPPUNIT_ASSERT_EQUAL(last_modified, cube->last_modified());
+
+        const auto bvh_moved = mesh_bvh::get(cube);
+        CPPUNIT_ASSERT(bvh_before != bvh_moved);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(20., bvh_moved->bounds()[1].x, 1e-9);
+    }
+
+    // The hierarchy of a destroyed mesh is released by the next call
+    std::weak_ptr<const mesh_bvh> released;
+    {
+        const auto dump_lock = other_cube->dump_lock();
+        released = mesh_bvh::get(other_cube);
+    }
+    other_cube.reset();
+    CPPUNIT_ASSERT(!released.expired());
+    {
+        const auto dump_lock = cube->dump_lock();
+        CPPUNIT_ASSERT(mesh_bvh::get(cube));
+    }
+    CPPUNIT_ASSERT(released.expired());
+}
+
+//------------------------------------------------------------------------------
+
+void mesh_bvh_test::contains_benchmark()
+{
+    // Only run when profiling
+    static const char* const s_ENV_LOOP = std::getenv("PROFILETEST_LOOP");
+    if(s_ENV_LOOP == nullptr)
+    {
+        return;
+    }
+
+    // Check how many times the points are tested
+    static const int s_LOOP_COUNT = std::max(1, std::stoi(s_ENV_LOOP));
+
+    fw_vertex_position vertex;
+    fw_vertex_index vertex_index;
+    generate_sphere(vertex, vertex_index, 10., 100, 200);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(-12., 12.);
+
+    std::vector<glm::dvec3> points;
+    for(std::size_t i = 0 ; i < 1000 ; ++i)
+    {
+        points.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+    }
+
+    double brute_force_elapsed = 0.;
+    double bvh_elapsed         = 0.;
+    for(int loop = 0 ; loop < s_LOOP_COUNT ; ++loop)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::uint8_t> expected;
+        for(const auto& p : points)
+        {
+            expected.push_back(is_inclosed_volume(vertex, vertex_index, {p.x, p.y, p.z}) ? 1 : 0);
+        }
+
+        brute_force_elapsed +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        const mesh_bvh bvh(vertex, vertex_index);
+        const std::vector<std::uint8_t> inside = bvh.contains(points);
+        bvh_elapsed += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        CPPUNIT_ASSERT(expected == inside);
+    }
+
+    SIGHT_INFO(
+        "mesh_bvh: " << points.size() << " points in a mesh of " << vertex_index.size() << " triangles, "
+        << brute_force_elapsed / s_LOOP_COUNT << " ms with is_inclosed_volume, "
+        << bvh_elapsed / s_LOOP_COUNT << " ms with the hierarchy, including its construction"
+    );
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace sight::geometry::data::ut
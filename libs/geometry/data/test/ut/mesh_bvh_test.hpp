@@ -0,0 +1,65 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace sight::geometry::data::ut
+{
+
+class mesh_bvh_test : public CPPUNIT_NS::TestFixture
+{
+CPPUNIT_TEST_SUITE(mesh_bvh_test);
+CPPUNIT_TEST(contains_test);
+CPPUNIT_TEST(intersect_test);
+CPPUNIT_TEST(closest_point_test);
+CPPUNIT_TEST(quad_test);
+CPPUNIT_TEST(cache_test);
+CPPUNIT_TEST(contains_benchmark);
+CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    // interface
+    void setUp() override;
+    void tearDown() override;
+
+    /// Compares the point containment with is_inclosed_volume().
+    static void contains_test();
+
+    /// Tests the ray casting against the triangles of a sphere.
+    static void intersect_test();
+
+    /// Tests the closest point and the distance to a cube.
+    static void closest_point_test();
+
+    /// Tests a mesh made of quads, with a transform.
+    static void quad_test();
+
+    /// Tests that the hierarchy is shared, built again when the mesh is modified, and released with the mesh.
+    static void cache_test();
+
+    /// Compares the time of is_inclosed_volume() and of the hierarchy to test many points.
+    static void contains_benchmark();
+};
+
+} // namespace sight::geometry::data::ut
@@ -169,15 +169,32 @@ void grabber::clear_timeline(data::frame_tl& _tl)
     {
         // Clear the timeline: send a black frame
         const core::clock::type timestamp = _tl.get_newer_timestamp() + 1;
+        const std::size_t size            = _tl.get_width() * _tl.get_height() * _tl.num_components();
 
-        SPTR(data::frame_tl::buffer_t) buffer = _tl.create_buffer(timestamp);
-        auto* dest_buffer = reinterpret_cast<std::uint8_t*>(buffer->add_element(0));
-
-        std::memset(dest_buffer, 0, _tl.get_width() * _tl.get_height() * _tl.num_components());
-
-        // push buffer and notify
         _tl.clear_timeline();
-        _tl.push_object(buffer);
+
+        if(_tl.get_ring())
+        {
+            // The frames of the timeline are written in its ring, the black frame is skipped if all slots are borrowed
+            data::timeline::ring::writer writer = _tl.begin_push();
+            if(!writer)
+            {
+                return;
+            }
+
+            std::memset(writer.data(), 0, size);
+            _tl.publish(writer, timestamp);
+        }
+        else
+        {
+            SPTR(data::frame_tl::buffer_t) buffer = _tl.create_buffer(timestamp);
+            auto* dest_buffer = reinterpret_cast<std::uint8_t*>(buffer->add_element(0));
+
+            std::memset(dest_buffer, 0, size);
+
+            // push buffer and notify
+            _tl.push_object(buffer);
+        }
 
         auto sig_tl = _tl.signal<data::timeline::signals::pushed_t>(
             data::timeline::signals::PUSHED
@@ -0,0 +1,95 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "decoder.hpp"
+
+#include <core/thread/pool.hpp>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <algorithm>
+
+namespace sight::io::bitmap
+{
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+
+void read(reader& _reader, backend _backend, decoder::input_t _input, const data::image::sptr& _image)
+{
+    // Reads the input in place
+    boost::iostreams::stream<boost::iostreams::array_source> stream(
+        reinterpret_cast<const char*>(_input.data()),
+        _input.size()
+    );
+
+    _reader.set_object(_image);
+    _reader.read(stream, _backend);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+decoder::decoder(backend _backend, std::size_t _nb_threads) :
+    m_backend(_backend)
+{
+    SIGHT_THROW_IF("A backend must be chosen to decode images from memory.", _backend == backend::any);
+
+    m_readers.resize(std::max<std::size_t>(_nb_threads, 1));
+    std::ranges::generate(m_readers, []{return std::make_shared<reader>();});
+}
+
+//------------------------------------------------------------------------------
+
+decoder::~decoder() = default;
+
+//------------------------------------------------------------------------------
+
+void decoder::decode(input_t _input, const data::image::sptr& _image)
+{
+    read(*m_readers.front(), m_backend, _input, _image);
+}
+
+//------------------------------------------------------------------------------
+
+void decoder::decode(const std::vector<input_t>& _inputs, const std::vector<data::image::sptr>& _images)
+{
+    SIGHT_THROW_IF("There must be one image per input.", _inputs.size() != _images.size());
+
+    core::thread::parallel_for(
+        0,
+        std::ptrdiff_t(_inputs.size()),
+        [&](std::ptrdiff_t _begin, std::ptrdiff_t _end, std::size_t _chunk)
+        {
+            for(auto i = std::size_t(_begin) ; i < std::size_t(_end) ; ++i)
+            {
+                read(*m_readers[_chunk], m_backend, _inputs[i], _images[i]);
+            }
+        },
+        m_readers.size()
+    );
+}
+
+} // namespace sight::io::bitmap
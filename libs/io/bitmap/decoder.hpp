@@ -0,0 +1,103 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/io/bitmap/config.hpp>
+
+#include "backend.hpp"
+#include "reader.hpp"
+
+#include <data/image.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sight::io::bitmap
+{
+
+/**
+ * @brief Decoding session, which decodes images from memory with the same backend.
+ *
+ * Unlike creating a reader for each image, the codec contexts are kept between images. With several threads, batches
+ * of images are decoded in parallel on the shared thread pool, each thread using its own codec context. The images are
+ * only reallocated when their size or format changes.
+ *
+ * A session is not thread safe, it must be used by one thread at a time.
+ */
+class SIGHT_IO_BITMAP_CLASS_API decoder final
+{
+public:
+
+    /// Encoded image
+    using input_t = std::span<const std::uint8_t>;
+
+    /// Delete default constructors and assignment operators
+    decoder(const decoder&)            = delete;
+    decoder(decoder&&)                 = delete;
+    decoder& operator=(const decoder&) = delete;
+    decoder& operator=(decoder&&)      = delete;
+
+    /**
+     * @brief Constructor
+     * @param _backend the backend to use, ANY is not allowed since there is no file extension
+     * @param _nb_threads maximum number of images decoded in parallel by batches
+     * @throw core::exception if the backend is ANY
+     */
+    SIGHT_IO_BITMAP_API explicit decoder(backend _backend = backend::libtiff, std::size_t _nb_threads = 1);
+
+    /// Destructor
+    SIGHT_IO_BITMAP_API ~decoder();
+
+    /**
+     * @brief Decodes an image
+     * @param _input the encoded image
+     * @param _image the image to fill
+     */
+    SIGHT_IO_BITMAP_API void decode(input_t _input, const data::image::sptr& _image);
+
+    /**
+     * @brief Decodes images in parallel
+     * @param _inputs the encoded images
+     * @param _images the images to fill, one per input
+     */
+    SIGHT_IO_BITMAP_API void decode(const std::vector<input_t>& _inputs, const std::vector<data::image::sptr>& _images);
+
+    /// Returns the backend used by the session
+    [[nodiscard]] backend get_backend() const noexcept;
+
+private:
+
+    backend m_backend;
+
+    /// One reader per thread, keeping the codec contexts
+    std::vector<reader::sptr> m_readers;
+};
+
+//------------------------------------------------------------------------------
+
+inline backend decoder::get_backend() const noexcept
+{
+    return m_backend;
+}
+
+} // namespace sight::io::bitmap
@@ -0,0 +1,114 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "encoder.hpp"
+
+#include <core/thread/pool.hpp>
+
+#include <algorithm>
+
+namespace sight::io::bitmap
+{
+
+encoder::encoder(backend _backend, writer::mode _mode, std::size_t _nb_threads) :
+    m_backend(_backend),
+    m_mode(_mode)
+{
+    SIGHT_THROW_IF("A backend must be chosen to encode images in memory.", _backend == backend::any);
+
+    m_writers.resize(std::max<std::size_t>(_nb_threads, 1));
+    std::ranges::generate(m_writers, []{return std::make_shared<writer>();});
+}
+
+//------------------------------------------------------------------------------
+
+encoder::~encoder() = default;
+
+//------------------------------------------------------------------------------
+
+std::size_t encoder::encode(const data::image::csptr& _image, std::vector<std::uint8_t>& _output)
+{
+    const auto& writer = m_writers.front();
+    writer->set_object(_image);
+    return writer->write(_output, m_backend, m_mode);
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<std::size_t> encoder::encode(const std::vector<data::image::csptr>& _images, buffers_t& _outputs)
+{
+    return encode(_images.size(), [&](std::size_t _index){return _images[_index];}, _outputs);
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<std::size_t> encoder::encode(
+    const data::frame_tl& _timeline,
+    const std::vector<CSPTR(data::frame_tl::buffer_t)>& _frames,
+    buffers_t& _outputs
+)
+{
+    return encode(
+        _frames.size(),
+        [&](std::size_t _index)
+        {
+            // The image only views the frame, which is kept alive by the image
+            auto image = std::make_shared<data::image>();
+            _timeline.view(*image, _frames[_index]);
+            return data::image::csptr(image);
+        },
+        _outputs
+    );
+}
+
+//------------------------------------------------------------------------------
+
+template<typename F>
+std::vector<std::size_t> encoder::encode(std::size_t _count, F _image, buffers_t& _outputs)
+{
+    if(_outputs.size() < _count)
+    {
+        _outputs.resize(_count);
+    }
+
+    std::vector<std::size_t> sizes(_count, 0);
+
+    core::thread::parallel_for(
+        0,
+        std::ptrdiff_t(_count),
+        [&](std::ptrdiff_t _begin, std::ptrdiff_t _end, std::size_t _chunk)
+        {
+            const auto& writer = m_writers[_chunk];
+            for(auto i = std::size_t(_begin) ; i < std::size_t(_end) ; ++i)
+            {
+                // The writer only keeps a weak pointer on the image
+                const data::image::csptr image = _image(i);
+                writer->set_object(image);
+                sizes[i] = writer->write(_outputs[i], m_backend, m_mode);
+            }
+        },
+        m_writers.size()
+    );
+
+    return sizes;
+}
+
+} // namespace sight::io::bitmap
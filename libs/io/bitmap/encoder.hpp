@@ -0,0 +1,137 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/io/bitmap/config.hpp>
+
+#include "backend.hpp"
+#include "writer.hpp"
+
+#include <data/frame_tl.hpp>
+#include <data/image.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sight::io::bitmap
+{
+
+/**
+ * @brief Encoding session, which encodes images in memory with the same backend.
+ *
+ * Unlike creating a writer for each image, the codec contexts are kept between images and the output buffers are
+ * reused: they are only grown when an image does not fit. With several threads, batches of images are encoded in
+ * parallel on the shared thread pool, each thread using its own codec context.
+ *
+ * A session is not thread safe, it must be used by one thread at a time.
+ *
+ * @code{.cpp}
+    io::bitmap::encoder encoder(io::bitmap::backend::libjpeg, io::bitmap::writer::mode::fast, 4);
+    std::vector<std::vector<std::uint8_t> > outputs;
+    const auto sizes = encoder.encode(images, outputs);
+   @endcode
+ */
+class SIGHT_IO_BITMAP_CLASS_API encoder final
+{
+public:
+
+    /// Output buffers of a batch, only the first bytes returned by encode() are meaningful
+    using buffers_t = std::vector<std::vector<std::uint8_t> >;
+
+    /// Delete default constructors and assignment operators
+    encoder(const encoder&)            = delete;
+    encoder(encoder&&)                 = delete;
+    encoder& operator=(const encoder&) = delete;
+    encoder& operator=(encoder&&)      = delete;
+
+    /**
+     * @brief Constructor
+     * @param _backend the backend to use, ANY is not allowed since there is no file extension
+     * @param _mode FAST or BEST compression
+     * @param _nb_threads maximum number of images encoded in parallel by batches
+     * @throw core::exception if the backend is ANY
+     */
+    SIGHT_IO_BITMAP_API explicit encoder(
+        backend _backend        = backend::libtiff,
+        writer::mode _mode      = writer::mode::fast,
+        std::size_t _nb_threads = 1
+    );
+
+    /// Destructor
+    SIGHT_IO_BITMAP_API ~encoder();
+
+    /**
+     * @brief Encodes an image
+     * @param _image the image to encode
+     * @param _output the buffer to write to, grown if it is not big enough
+     * @return the size of the encoded image
+     */
+    SIGHT_IO_BITMAP_API std::size_t encode(const data::image::csptr& _image, std::vector<std::uint8_t>& _output);
+
+    /**
+     * @brief Encodes images in parallel
+     * @param _images the images to encode
+     * @param _outputs the buffers to write to, one per image, added or grown if needed
+     * @return the sizes of the encoded images
+     */
+    SIGHT_IO_BITMAP_API std::vector<std::size_t> encode(
+        const std::vector<data::image::csptr>& _images,
+        buffers_t& _outputs
+    );
+
+    /**
+     * @brief Encodes frames of a timeline in parallel, without copying them
+     * @param _timeline the timeline holding the frames, which gives their format
+     * @param _frames the buffers of the timeline to encode, the first element of each buffer is encoded
+     * @param _outputs the buffers to write to, one per frame, added or grown if needed
+     * @return the sizes of the encoded frames
+     */
+    SIGHT_IO_BITMAP_API std::vector<std::size_t> encode(
+        const data::frame_tl& _timeline,
+        const std::vector<CSPTR(data::frame_tl::buffer_t)>& _frames,
+        buffers_t& _outputs
+    );
+
+    /// Returns the backend used by the session
+    [[nodiscard]] backend get_backend() const noexcept;
+
+private:
+
+    /// Encodes images in parallel, calling _image(index) to get each image
+    template<typename F>
+    std::vector<std::size_t> encode(std::size_t _count, F _image, buffers_t& _outputs);
+
+    backend m_backend;
+    writer::mode m_mode;
+
+    /// One writer per thread, keeping the codec contexts
+    std::vector<writer::sptr> m_writers;
+};
+
+//------------------------------------------------------------------------------
+
+inline backend encoder::get_backend() const noexcept
+{
+    return m_backend;
+}
+
+} // namespace sight::io::bitmap
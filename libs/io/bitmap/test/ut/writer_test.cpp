@@ -26,14 +26,21 @@
 #include <core/os/temp_path.hpp>
 #include <core/tools/uuid.hpp>
 
+#include <io/bitmap/decoder.hpp>
+#include <io/bitmap/encoder.hpp>
 #include <io/bitmap/writer.hpp>
 #include <io/dicom/reader/file.hpp>
 
 #include <utest/filter.hpp>
 #include <utest/profiling.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <future>
+#include <numeric>
+#include <thread>
 
 // This is for putenv() which is part of <cstdlib>
 // cspell:ignore hicpp nvjpeg LIBJPEG LIBTIFF LUMA Acuson IMWRITE IMREAD ANYDEPTH ANYCOLOR OPENCV stoull
@@ -1019,4 +1026,236 @@ void writer_test::profiling_test()
     }
 }
 
+//------------------------------------------------------------------------------
+
+inline static std::vector<data::image::csptr> synthetic_images(std::size_t _count)
+{
+    std::vector<data::image::csptr> images;
+    for(std::uint32_t seed = 0 ; seed < _count ; ++seed)
+    {
+        images.push_back(get_synthetic_image(seed));
+    }
+
+    return images;
+}
+
+//------------------------------------------------------------------------------
+
+void writer_test::session_test()
+{
+    const auto images = synthetic_images(8);
+
+    for(const auto backend : {backend::libjpeg, backend::libtiff, backend::libpng, backend::openjpeg})
+    {
+        const auto& [backend_name, ext] = backend_to_string(backend);
+
+        // Reference: one writer per image
+        std::vector<std::vector<std::uint8_t> > expected(images.size());
+        for(std::size_t i = 0 ; i < images.size() ; ++i)
+        {
+            auto writer = std::make_shared<io::bitmap::writer>();
+            writer->set_object(images[i]);
+            expected[i].resize(writer->write(expected[i], backend));
+        }
+
+        // The session reuses its buffers: encode twice to check that the second pass does not depend on the first
+        io::bitmap::encoder encoder(backend, writer::mode::fast, 4);
+        io::bitmap::encoder::buffers_t outputs;
+        std::vector<std::size_t> sizes;
+        for(std::size_t pass = 0 ; pass < 2 ; ++pass)
+        {
+            CPPUNIT_ASSERT_NO_THROW(sizes = encoder.encode(images, outputs));
+            CPPUNIT_ASSERT_EQUAL(images.size(), sizes.size());
+
+            for(std::size_t i = 0 ; i < images.size() ; ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE(backend_name, expected[i].size(), sizes[i]);
+                CPPUNIT_ASSERT_MESSAGE(
+                    backend_name,
+                    std::equal(expected[i].begin(), expected[i].end(), outputs[i].begin())
+                );
+            }
+        }
+
+        // Single image encoding
+        std::vector<std::uint8_t> output;
+        CPPUNIT_ASSERT_EQUAL(expected[0].size(), encoder.encode(images[0], output));
+
+        // Decode the batch
+        io::bitmap::decoder decoder(backend, 4);
+        std::vector<io::bitmap::decoder::input_t> inputs;
+        std::vector<data::image::sptr> decoded;
+        for(std::size_t i = 0 ; i < images.size() ; ++i)
+        {
+            inputs.emplace_back(outputs[i].data(), sizes[i]);
+            decoded.push_back(std::make_shared<data::image>());
+        }
+
+        CPPUNIT_ASSERT_NO_THROW(decoder.decode(inputs, decoded));
+
+        for(std::size_t i = 0 ; i < images.size() ; ++i)
+        {
+            CPPUNIT_ASSERT(images[i]->size() == decoded[i]->size());
+
+            // Compare pixels only for lossless backend
+            if(backend == backend::libtiff || backend == backend::libpng)
+            {
+                CPPUNIT_ASSERT_MESSAGE(backend_name, *images[i] == *decoded[i]);
+            }
+        }
+    }
+
+    // ANY can not be used without file
+    CPPUNIT_ASSERT_THROW(io::bitmap::encoder(backend::any), core::exception);
+    CPPUNIT_ASSERT_THROW(io::bitmap::decoder(backend::any), core::exception);
+
+    // Errors of the threads are forwarded
+    io::bitmap::encoder encoder(backend::libpng, writer::mode::fast, 4);
+    auto images_and_empty = images;
+    images_and_empty.push_back(std::make_shared<data::image>());
+    io::bitmap::encoder::buffers_t outputs;
+    CPPUNIT_ASSERT_THROW(encoder.encode(images_and_empty, outputs), core::exception);
+}
+
+//------------------------------------------------------------------------------
+
+void writer_test::session_frame_tl_test()
+{
+    const auto image = get_synthetic_image(0);
+    const auto& size = image->size();
+
+    auto timeline = std::make_shared<data::frame_tl>();
+    timeline->init_pool_size(size[0], size[1], image->type(), data::frame_tl::pixel_format::rgb, 10);
+
+    std::vector<CSPTR(data::frame_tl::buffer_t)> frames;
+    {
+        const auto dump_lock = image->dump_lock();
+        for(core::clock::type timestamp = 1 ; timestamp <= 6 ; ++timestamp)
+        {
+            auto buffer = timeline->create_buffer(timestamp);
+            std::memcpy(buffer->add_element(0), image->buffer(), image->size_in_bytes());
+            timeline->push_object(buffer);
+            frames.push_back(buffer);
+        }
+    }
+
+    io::bitmap::encoder encoder(backend::libtiff, writer::mode::fast, 3);
+    std::vector<std::uint8_t> expected;
+    expected.resize(encoder.encode(image, expected));
+
+    io::bitmap::encoder::buffers_t outputs;
+    const auto sizes = encoder.encode(*timeline, frames, outputs);
+    CPPUNIT_ASSERT_EQUAL(frames.size(), sizes.size());
+
+    for(std::size_t i = 0 ; i < frames.size() ; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(expected.size(), sizes[i]);
+        CPPUNIT_ASSERT(std::equal(expected.begin(), expected.end(), outputs[i].begin()));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void writer_test::throughput_benchmark()
+{
+    // Only run when profiling
+    static const char* const s_ENV_LOOP = std::getenv("PROFILETEST_LOOP");
+    if(s_ENV_LOOP == nullptr)
+    {
+        return;
+    }
+
+    // Check how many images to encode
+    static const std::size_t s_LOOP_COUNT = std::max(std::size_t(1), std::size_t(std::stoull(s_ENV_LOOP)));
+
+    const auto images = synthetic_images(16 * s_LOOP_COUNT);
+
+    std::size_t input_size = 0;
+    for(const auto& image : images)
+    {
+        input_size += image->size_in_bytes();
+    }
+
+    const std::size_t nb_threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    const auto report =
+        [&](const std::string& _label, const auto& _encode)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t output_size = _encode();
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            SIGHT_INFO(
+                _label << ": " << static_cast<double>(images.size()) / elapsed << " images/s, "
+                << static_cast<double>(input_size) / elapsed / 1e6 << " MB/s, ratio "
+                << static_cast<double>(input_size) / static_cast<double>(output_size)
+            );
+
+            return output_size;
+        };
+
+    const std::vector<std::pair<backend, writer::mode> > backends {
+        {backend::libjpeg, writer::mode::fast},
+        {backend::libjpeg, writer::mode::best},
+        {backend::libtiff, writer::mode::fast},
+        {backend::libtiff, writer::mode::best},
+        {backend::libpng, writer::mode::fast},
+        {backend::libpng, writer::mode::best},
+        {backend::openjpeg, writer::mode::fast}
+    };
+
+    for(const auto& [backend, mode] : backends)
+    {
+        const auto& [backend_name, ext] = backend_to_string(backend);
+        const std::string label         = backend_name + " (" + mode_to_string(mode) + ")";
+
+        // Former usage: a writer, and thus a codec context, for each image
+        report(
+            label + " - writer per image",
+            [&]
+            {
+                std::size_t total = 0;
+                std::vector<std::uint8_t> output;
+                for(const auto& image : images)
+                {
+                    auto writer = std::make_shared<io::bitmap::writer>();
+                    writer->set_object(image);
+                    total += writer->write(output, backend, mode);
+                }
+
+                return total;
+            });
+
+        const std::size_t session_size = report(
+            label + " - session",
+            [&]
+            {
+                std::size_t total = 0;
+                io::bitmap::encoder encoder(backend, mode);
+                std::vector<std::uint8_t> output;
+                for(const auto& image : images)
+                {
+                    total += encoder.encode(image, output);
+                }
+
+                return total;
+            });
+
+        const std::size_t batch_size = report(
+            label + " - batch (" + std::to_string(nb_threads) + " threads)",
+            [&]
+            {
+                io::bitmap::encoder encoder(backend, mode, nb_threads);
+                io::bitmap::encoder::buffers_t outputs;
+                const auto sizes = encoder.encode(images, outputs);
+                return std::accumulate(sizes.begin(), sizes.end(), std::size_t(0));
+            });
+
+        // The batch encodes the same streams as the session, whatever the number of threads
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(label, session_size, batch_size);
+    }
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::io::bitmap::ut
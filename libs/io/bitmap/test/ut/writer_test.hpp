@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2021-2023 IRCAD France
+ * Copyright (C) 2021-2024 IRCAD France
  * Copyright (C) 2017 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -42,6 +42,9 @@ public:
     CPPUNIT_TEST(wrong_path_test);
     CPPUNIT_TEST(from_dicom_test);
     CPPUNIT_TEST(profiling_test);
+    CPPUNIT_TEST(session_test);
+    CPPUNIT_TEST(session_frame_tl_test);
+    CPPUNIT_TEST(throughput_benchmark);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -57,6 +60,9 @@ public:
     static void wrong_path_test();
     static void from_dicom_test();
     static void profiling_test();
+    static void session_test();
+    static void session_frame_tl_test();
+    static void throughput_benchmark();
 };
 
 } // namespace sight::io::bitmap::ut
@@ -25,6 +25,7 @@
 
 #include <core/compare.hpp>
 #include <core/macros.hpp>
+#include <core/thread/pool.hpp>
 
 #include <data/dicom/sop.hpp>
 #include <data/helper/medical_image.hpp>
@@ -50,6 +51,11 @@
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+
 // cspell: ignore orthogonalize
 namespace sight::io::dicom::reader
 {
@@ -969,29 +975,42 @@ inline static data::matrix4 compute_image_transform(
 
 //------------------------------------------------------------------------------
 
-inline static data::series_set::sptr read_image_instance(
-    const data::series& _source,
-    const core::jobs::job::sptr& _job,
-    std::unique_ptr<std::vector<char> >& _gdcm_instance_buffer,
-    std::size_t _instance                   = 0,
-    data::series_set::sptr _splitted_series = nullptr
-)
+/// A decoded DICOM instance, ready to be copied into an image buffer.
+struct decoded_instance
 {
-    if(_job && _job->cancel_requested())
-    {
-        return nullptr;
-    }
+    /// The instance file path
+    std::string filename;
+
+    /// The reader, which owns the dataset
+    std::unique_ptr<gdcm::ImageReader> reader;
+
+    /// The image, converted to a suitable format
+    gdcm::Image image;
+
+    /// The rescaler, if there is a Rescale Intercept / Rescale Slope
+    std::unique_ptr<gdcm::Rescaler> rescaler;
+};
+
+//------------------------------------------------------------------------------
+
+inline static decoded_instance decode_instance(const data::series& _source, std::size_t _instance)
+{
+    decoded_instance decoded;
 
     // Read the DICOM file using GDCM ImageReader
-    gdcm::ImageReader gdcm_reader;
-    const std::string& filename = _source.get_file(_instance).string();
+    decoded.filename = _source.get_file(_instance).string();
+    decoded.reader   = std::make_unique<gdcm::ImageReader>();
+
+    const std::string& filename = decoded.filename;
+    auto& gdcm_reader           = *decoded.reader;
     gdcm_reader.SetFileName(filename.c_str());
 
     SIGHT_INFO("Reading DICOM file '" << filename << "'.");
     SIGHT_THROW_IF("Cannot read DICOM file '" << filename << "'.", !gdcm_reader.Read());
 
     // Get the image and convert it to a suitable format
-    const auto& gdcm_image = convert_gdcm_image(gdcm_reader.GetImage(), filename);
+    decoded.image          = convert_gdcm_image(gdcm_reader.GetImage(), filename);
+    const auto& gdcm_image = decoded.image;
 
     // Get the dataset and the input pixel format
     const auto& gdcm_dataset = gdcm_reader.GetFile().GetDataSet();
@@ -1037,15 +1056,30 @@ inline static data::series_set::sptr read_image_instance(
 
     // Initialize the rescaler if there is a Rescale Intercept / Rescale Slope
     // The Rescale Intercept / Rescale Slope can be specific to each instance !
-    std::unique_ptr<gdcm::Rescaler> gdcm_rescaler;
     if(use_intercept || use_slope)
     {
-        gdcm_rescaler = std::make_unique<gdcm::Rescaler>();
-        gdcm_rescaler->SetIntercept(fixed_intercept);
-        gdcm_rescaler->SetSlope(fixed_slope);
-        gdcm_rescaler->SetPixelFormat(gdcm_image.GetPixelFormat());
+        decoded.rescaler = std::make_unique<gdcm::Rescaler>();
+        decoded.rescaler->SetIntercept(fixed_intercept);
+        decoded.rescaler->SetSlope(fixed_slope);
+        decoded.rescaler->SetPixelFormat(gdcm_image.GetPixelFormat());
     }
 
+    return decoded;
+}
+
+//------------------------------------------------------------------------------
+
+/// Creates the image series of a decoded instance, if needed.
+/// @return the series set, or nullptr if the job has been canceled
+inline static data::series_set::sptr prepare_image_series(
+    const data::series& _source,
+    const core::jobs::job::sptr& _job,
+    const decoded_instance& _decoded,
+    data::series_set::sptr _splitted_series
+)
+{
+    const auto& gdcm_image = _decoded.image;
+
     // Create the ImageSeries, if needed, get or compute needed image information
     // Special case here: if the current image is a volume, and we have more than one instance, we have no other
     // choice than splitting the series.
@@ -1058,14 +1092,15 @@ inline static data::series_set::sptr read_image_instance(
         }
 
         // User may have canceled the job
-        if(const auto& image_series = new_image_series(_source, _job, gdcm_image, gdcm_rescaler, filename);
+        if(const auto& image_series =
+               new_image_series(_source, _job, gdcm_image, _decoded.rescaler, _decoded.filename);
            image_series)
         {
             // Add the dataset to allow access to all DICOM attributes (not only the ones we have converted)
-            image_series->set_data_set(gdcm_dataset);
+            image_series->set_data_set(_decoded.reader->GetFile().GetDataSet());
 
             // Also save the file path. It could be useful to keep a link to the original file.
-            image_series->set_file(filename);
+            image_series->set_file(_decoded.filename);
 
             const auto& transform = compute_image_transform(gdcm_image, image_series);
             image_series->data::image::set_origin(transform.position<data::image::origin_t>());
@@ -1091,36 +1126,82 @@ inline static data::series_set::sptr read_image_instance(
         return nullptr;
     }
 
-    // Use the last series as current series
-    auto image_series    = std::static_pointer_cast<data::image_series>(_splitted_series->back());
-    const auto dump_lock = image_series->dump_lock();
+    return _splitted_series;
+}
+
+//------------------------------------------------------------------------------
+
+/// Writes a decoded instance into its slice of an image series, or into the whole image if it is a volume.
+/// @return false if the job has been canceled
+inline static bool write_instance(
+    const data::series& _source,
+    const core::jobs::job::sptr& _job,
+    const decoded_instance& _decoded,
+    data::image_series& _image_series,
+    std::unique_ptr<std::vector<char> >& _gdcm_instance_buffer,
+    std::size_t _instance
+)
+{
+    const bool split = _decoded.image.GetNumberOfDimensions() >= 3 && _source.num_instances() > 1;
 
     // Add the dataset to allow access to all DICOM attributes (not only the ones we have converted)
-    image_series->set_data_set(gdcm_dataset, _instance);
+    _image_series.set_data_set(_decoded.reader->GetFile().GetDataSet(), _instance);
 
     // Also save the file path. It could be useful to keep a link to the original file.
-    image_series->set_file(filename, _instance);
+    _image_series.set_file(_decoded.filename, _instance);
 
     // Get the output buffer (as char* since gdcm takes char* as input)
     // If the series will be splitted by instance, we keep 0 as instance number
-    char* const instance_buffer = &image_series->at<char>(0, 0, split ? 0 : _instance, 0);
+    char* const instance_buffer = &_image_series.at<char>(0, 0, split ? 0 : _instance, 0);
     SIGHT_ASSERT("Null buffer.", instance_buffer != nullptr);
 
     // Compute the size
     const std::size_t instance_buffer_size =
-        split ? image_series->size_in_bytes()
-              : image_series->size_in_bytes() / std::max(std::size_t(1), _source.num_instances());
+        split ? _image_series.size_in_bytes()
+              : _image_series.size_in_bytes() / std::max(std::size_t(1), _source.num_instances());
 
     // Read the image data and fill the image series
-    if(!read_buffer(
-           _job,
-           gdcm_image,
-           gdcm_rescaler,
-           _gdcm_instance_buffer,
-           instance_buffer,
-           instance_buffer_size,
-           filename
-    ))
+    return read_buffer(
+        _job,
+        _decoded.image,
+        _decoded.rescaler,
+        _gdcm_instance_buffer,
+        instance_buffer,
+        instance_buffer_size,
+        _decoded.filename
+    );
+}
+
+//------------------------------------------------------------------------------
+
+inline static data::series_set::sptr read_image_instance(
+    const data::series& _source,
+    const core::jobs::job::sptr& _job,
+    std::unique_ptr<std::vector<char> >& _gdcm_instance_buffer,
+    std::size_t _instance                   = 0,
+    data::series_set::sptr _splitted_series = nullptr
+)
+{
+    if(_job && _job->cancel_requested())
+    {
+        return nullptr;
+    }
+
+    // Read and decode the DICOM file
+    const auto decoded = decode_instance(_source, _instance);
+
+    _splitted_series = prepare_image_series(_source, _job, decoded, std::move(_splitted_series));
+    if(!_splitted_series)
+    {
+        // Job have been canceled
+        return nullptr;
+    }
+
+    // Use the last series as current series
+    auto image_series    = std::static_pointer_cast<data::image_series>(_splitted_series->back());
+    const auto dump_lock = image_series->dump_lock();
+
+    if(!write_instance(_source, _job, decoded, *image_series, _gdcm_instance_buffer, _instance))
     {
         // Job have been canceled
         return nullptr;
@@ -1131,7 +1212,105 @@ inline static data::series_set::sptr read_image_instance(
 
 //------------------------------------------------------------------------------
 
-inline static data::series_set::sptr read_image(const data::series& _source, const core::jobs::job::sptr& _job)
+/// Reads all the instances of a series, whose volume has been allocated from the first one, already decoded.
+/// Each instance is decoded, rescaled and converted directly into its slice of the image series buffer, on the
+/// shared thread pool. Instances that are volumes themselves are read serially afterwards, as they split the series.
+/// @return false if the job has been canceled
+/// @throw core::exception if a slice does not have the dimensions or the pixel format of the first one
+inline static bool read_image_instances_parallel(
+    const data::series& _source,
+    const core::jobs::job::sptr& _job,
+    const decoded_instance& _first,
+    const data::series_set::sptr& _splitted_series
+)
+{
+    const auto image_series = std::static_pointer_cast<data::image_series>(_splitted_series->back());
+    const auto dump_lock    = image_series->dump_lock();
+
+    // Allocates the slots of all instances up front, so each chunk can set its own datasets without reallocation
+    const std::size_t num_instances = _source.num_instances();
+    image_series->set_file(_source.get_file(num_instances - 1), num_instances - 1);
+
+    const auto& first_format = _first.image.GetPixelFormat();
+
+    std::mutex volumes_mutex;
+    std::vector<std::size_t> volumes;
+    std::atomic_bool canceled {false};
+
+    core::thread::parallel_for(
+        0,
+        std::ptrdiff_t(num_instances),
+        [&](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+        {
+            // The rescale buffer is reused for all instances of a chunk
+            std::unique_ptr<std::vector<char> > gdcm_instance_buffer;
+
+            for(auto instance = std::size_t(_begin) ; instance < std::size_t(_end) ; ++instance)
+            {
+                if(canceled || (_job && _job->cancel_requested()))
+                {
+                    canceled = true;
+                    return;
+                }
+
+                // The first instance is already decoded
+                std::optional<decoded_instance> decoded_storage;
+                const auto& decoded = instance == 0
+                                      ? _first
+                                      : decoded_storage.emplace(decode_instance(_source, instance));
+                const auto& image   = decoded.image;
+
+                if(image.GetNumberOfDimensions() >= 3)
+                {
+                    std::lock_guard lock(volumes_mutex);
+                    volumes.push_back(instance);
+                    continue;
+                }
+
+                // A slice that does not match the allocated volume would be written out of bounds
+                const auto& format = image.GetPixelFormat();
+                SIGHT_THROW_IF(
+                    "DICOM file '" << decoded.filename << "' does not have the same dimensions, bits allocated or "
+                    << "samples per pixel as '" << _first.filename << "'.",
+                    image.GetDimension(0) != _first.image.GetDimension(0)
+                    || image.GetDimension(1) != _first.image.GetDimension(1)
+                    || format.GetBitsAllocated() != first_format.GetBitsAllocated()
+                    || format.GetSamplesPerPixel() != first_format.GetSamplesPerPixel()
+                );
+
+                if(!write_instance(_source, _job, decoded, *image_series, gdcm_instance_buffer, instance))
+                {
+                    canceled = true;
+                    return;
+                }
+            }
+        });
+
+    if(canceled)
+    {
+        return false;
+    }
+
+    std::ranges::sort(volumes);
+    std::unique_ptr<std::vector<char> > gdcm_instance_buffer;
+    for(const auto instance : volumes)
+    {
+        if(!read_image_instance(_source, _job, gdcm_instance_buffer, instance, _splitted_series))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+inline static data::series_set::sptr read_image(
+    const data::series& _source,
+    const core::jobs::job::sptr& _job,
+    bool _parallel
+)
 {
     if(_job && _job->cancel_requested())
     {
@@ -1139,10 +1318,11 @@ inline static data::series_set::sptr read_image(const data::series& _source, con
     }
 
     // Read first instance to get image information
-    // readImageInstance() returns a series set, because the series can be splitted in rare cases,
+    // prepare_image_series() returns a series set, because the series can be splitted in rare cases,
     // like US 4D Volume.
-    std::unique_ptr<std::vector<char> > gdcm_instance_buffer;
-    auto splitted_series = read_image_instance(_source, _job, gdcm_instance_buffer, 0);
+    const std::size_t num_instances = _source.num_instances();
+    const auto first                = decode_instance(_source, 0);
+    auto splitted_series            = prepare_image_series(_source, _job, first, nullptr);
 
     if(!splitted_series)
     {
@@ -1150,15 +1330,40 @@ inline static data::series_set::sptr read_image(const data::series& _source, con
         return nullptr;
     }
 
-    // Read the other instances if necessary
-    for(std::size_t instance = 1, end = _source.num_instances() ; instance < end ; ++instance)
+    // In parallel mode, the instances are read concurrently if they are slices of the volume allocated by the first one
+    std::unique_ptr<std::vector<char> > gdcm_instance_buffer;
+    if(_parallel && num_instances > 2 && splitted_series->size() == 1
+       && first.image.GetNumberOfDimensions() < 3
+       && std::static_pointer_cast<data::image_series>(splitted_series->back())->size()[2] == num_instances)
     {
-        if(_job && _job->cancel_requested())
+        if(!read_image_instances_parallel(_source, _job, first, splitted_series))
         {
+            // Job have been canceled
             return nullptr;
         }
+    }
+    else
+    {
+        {
+            const auto image_series = std::static_pointer_cast<data::image_series>(splitted_series->back());
+            const auto dump_lock    = image_series->dump_lock();
+            if(!write_instance(_source, _job, first, *image_series, gdcm_instance_buffer, 0))
+            {
+                // Job have been canceled
+                return nullptr;
+            }
+        }
 
-        read_image_instance(_source, _job, gdcm_instance_buffer, instance, splitted_series);
+        // Read the other instances if necessary
+        for(std::size_t instance = 1 ; instance < num_instances ; ++instance)
+        {
+            if(_job && _job->cancel_requested())
+            {
+                return nullptr;
+            }
+
+            read_image_instance(_source, _job, gdcm_instance_buffer, instance, splitted_series);
+        }
     }
 
     for(const auto& series : *splitted_series)
@@ -1554,7 +1759,7 @@ public:
             if(source->get_dicom_type() == data::series::dicom_t::image)
             {
                 // Read an image series
-                splitted_series = read_image(*source, m_job);
+                splitted_series = read_image(*source, m_job, m_parallel);
             }
             else if(source->get_dicom_type() == data::series::dicom_t::model)
             {
@@ -1696,6 +1901,9 @@ public:
 
     /// The default job. Allows to watch for cancellation and report progress.
     core::jobs::job::sptr m_job;
+
+    /// If true, the instances of an image series are decoded concurrently.
+    bool m_parallel {false};
 };
 
 file::file() :
@@ -1835,6 +2043,20 @@ void file::set_sorted(const data::series_set::sptr& _sorted)
 
 //------------------------------------------------------------------------------
 
+void file::set_parallel(bool _parallel)
+{
+    m_pimpl->m_parallel = _parallel;
+}
+
+//------------------------------------------------------------------------------
+
+bool file::parallel() const
+{
+    return m_pimpl->m_parallel;
+}
+
+//------------------------------------------------------------------------------
+
 core::jobs::base::sptr file::get_job() const
 {
     return m_pimpl->m_job;
@@ -81,6 +81,12 @@ public:
     /// @param[in] _sorted The Series with their associated files
     SIGHT_IO_DICOM_API void set_sorted(const data::series_set::sptr& _sorted);
 
+    /// Enables or disables the parallel read mode. When enabled, the instances of an image series are decoded,
+    /// rescaled and converted concurrently on core::thread::pool, directly into their slice of the image buffer.
+    /// @param[in] _parallel true to enable the parallel read mode (false by default)
+    SIGHT_IO_DICOM_API void set_parallel(bool _parallel);
+    SIGHT_IO_DICOM_API bool parallel() const;
+
     /// Set/get the current job
     SIGHT_IO_DICOM_API core::jobs::base::sptr get_job() const override;
     SIGHT_IO_DICOM_API void set_job(core::jobs::job::sptr _job);
@@ -38,6 +38,9 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::io::dicom::ut::reader_test);
@@ -47,7 +50,7 @@ namespace sight::io::dicom::ut
 
 //------------------------------------------------------------------------------
 
-inline static sight::data::series_set::sptr read(const std::filesystem::path _path)
+inline static sight::data::series_set::sptr read(const std::filesystem::path _path, bool _parallel = false)
 {
     CPPUNIT_ASSERT_MESSAGE(
         "The dicom directory '" + _path.string() + "' does not exist",
@@ -59,6 +62,7 @@ inline static sight::data::series_set::sptr read(const std::filesystem::path _pa
     auto reader = std::make_shared<io::dicom::reader::file>();
     reader->set_object(series_set);
     reader->set_folder(_path);
+    reader->set_parallel(_parallel);
 
     CPPUNIT_ASSERT_NO_THROW(reader->read());
 
@@ -875,4 +879,100 @@ void reader_test::read_ultrasound_multiframe_image_test()
     }
 }
 
+//------------------------------------------------------------------------------
+
+inline static const std::vector<std::filesystem::path>& parallel_test_folders()
+{
+    static const std::vector<std::filesystem::path> s_FOLDERS {
+        utest_data::dir() / "sight/Patient/Dicom/JMSGenou",
+        utest_data::dir() / "sight/Patient/Dicom/DicomDB/01-CT-DICOM_LIVER",
+        utest_data::dir() / "sight/Patient/Dicom/DicomDB/46-MR-BARRE-MONO2-12-shoulder",
+        utest_data::dir() / "sight/Patient/Dicom/DicomDB/83-CT-MultipleRescale",
+        utest_data::dir() / "sight/Patient/Dicom/DicomDB/85-MR-TemporalPosition",
+        utest_data::dir() / "us/Enhanced US Volume Storage/GE, 3D+t, lossy JPEG"
+    };
+
+    return s_FOLDERS;
+}
+
+//------------------------------------------------------------------------------
+
+void reader_test::read_parallel_test()
+{
+    if(utest::filter::ignore_slow_tests())
+    {
+        return;
+    }
+
+    for(const auto& folder : parallel_test_folders())
+    {
+        const auto& serial_set   = read(folder);
+        const auto& parallel_set = read(folder, true);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(folder.string(), serial_set->size(), parallel_set->size());
+
+        for(std::size_t i = 0 ; i < serial_set->size() ; ++i)
+        {
+            const auto& serial   = std::dynamic_pointer_cast<data::image_series>(serial_set->at(i));
+            const auto& parallel = std::dynamic_pointer_cast<data::image_series>(parallel_set->at(i));
+            CPPUNIT_ASSERT_MESSAGE(folder.string(), serial && parallel);
+
+            CPPUNIT_ASSERT_MESSAGE(folder.string(), serial->size() == parallel->size());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(folder.string(), serial->type(), parallel->type());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(folder.string(), serial->num_instances(), parallel->num_instances());
+
+            const auto serial_lock   = serial->dump_lock();
+            const auto parallel_lock = parallel->dump_lock();
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(folder.string(), serial->size_in_bytes(), parallel->size_in_bytes());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(
+                folder.string(),
+                0,
+                std::memcmp(serial->buffer(), parallel->buffer(), serial->size_in_bytes())
+            );
+
+            for(std::size_t instance = 0 ; instance < serial->num_instances() ; ++instance)
+            {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE(
+                    folder.string(),
+                    serial->get_file(instance),
+                    parallel->get_file(instance)
+                );
+                CPPUNIT_ASSERT_EQUAL_MESSAGE(
+                    folder.string(),
+                    serial->get_instance_number(instance),
+                    parallel->get_instance_number(instance)
+                );
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void reader_test::benchmark_parallel_read()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    for(const auto& folder : parallel_test_folders())
+    {
+        // Warm up the file system cache, so that both reads are comparable
+        read(folder);
+
+        const auto start = std::chrono::steady_clock::now();
+        read(folder);
+        const auto serial = std::chrono::steady_clock::now();
+        read(folder, true);
+        const auto parallel = std::chrono::steady_clock::now();
+
+        SIGHT_INFO(
+            "DICOM read - " << folder.filename().string() << ": serial "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(serial - start).count() << " ms, parallel "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(parallel - serial).count() << " ms"
+        );
+    }
+}
+
 } // namespace sight::io::dicom::ut
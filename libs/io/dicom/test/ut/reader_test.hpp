@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2018 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -41,6 +41,8 @@ CPPUNIT_TEST(read_ct_series_set_issue01_test);
 CPPUNIT_TEST(read_enhanced_us_volume_test);
 CPPUNIT_TEST(read_ultrasound_image_test);
 CPPUNIT_TEST(read_ultrasound_multiframe_image_test);
+CPPUNIT_TEST(read_parallel_test);
+CPPUNIT_TEST(benchmark_parallel_read);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -80,6 +82,12 @@ public:
 
     /// Read Ultrasound Multi-frame image Storage
     static void read_ultrasound_multiframe_image_test();
+
+    /// Compare serial and parallel reads
+    static void read_parallel_test();
+
+    /// Measure serial and parallel read times
+    static void benchmark_parallel_read();
 };
 
 } // namespace sight::io::dicom::ut
@@ -0,0 +1,79 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "compressed_image_message.hpp"
+
+#include "io/igtl/detail/packed_message.hpp"
+
+namespace sight::io::igtl::detail
+{
+
+compressed_image_message::compressed_image_message()
+{
+#if defined(OpenIGTLink_HEADER_VERSION)
+    m_SendMessageType    = packed_message::COMPRESSED_IMAGE_TYPE;
+    m_ReceiveMessageType = packed_message::COMPRESSED_IMAGE_TYPE;
+#else
+    m_DefaultBodyType = packed_message::COMPRESSED_IMAGE_TYPE;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+compressed_image_message::~compressed_image_message()
+= default;
+
+//-----------------------------------------------------------------------------
+
+const std::uint8_t* compressed_image_message::body()
+{
+    return static_cast<const std::uint8_t*>(this->GetPackBodyPointer());
+}
+
+//-----------------------------------------------------------------------------
+
+std::size_t compressed_image_message::body_size()
+{
+    return static_cast<std::size_t>(this->GetPackBodySize());
+}
+
+//-----------------------------------------------------------------------------
+
+int compressed_image_message::GetBodyPackSize()
+{
+    return static_cast<int>(this->GetBodySizeToRead());
+}
+
+//-----------------------------------------------------------------------------
+
+int compressed_image_message::PackBody()
+{
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int compressed_image_message::UnpackBody()
+{
+    return 1;
+}
+
+} //namespace sight::io::igtl::detail
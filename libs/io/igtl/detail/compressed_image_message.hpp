@@ -0,0 +1,84 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/io/igtl/config.hpp>
+
+#include <igtlMessageBase.h>
+
+#include <cstdint>
+
+// FIXME
+#ifndef WIN32
+    #define OVERRIDE_ON_LINUX override
+#else
+    #define OVERRIDE_ON_LINUX
+#endif
+
+namespace sight::io::igtl::detail
+{
+
+/**
+ * @brief COMPIMG message received from the network.
+ *
+ * The body is kept as received and decoded by converter::compressed_image_converter. These messages are sent by
+ * packed_message::from_compressed_image(), which is why they can not be packed.
+ */
+class SIGHT_IO_IGTL_CLASS_API compressed_image_message : public ::igtl::MessageBase
+{
+public:
+
+    using self_t        = compressed_image_message;
+    using superclass    = ::igtl::MessageBase;
+    using Pointer       = ::igtl::SmartPointer<self_t>;
+    using const_pointer = ::igtl::SmartPointer<const self_t>;
+
+    igtlTypeMacro(compressed_image_message, ::igtl::MessageBase);
+    igtlNewMacro(compressed_image_message);
+
+    /// Returns the received body
+    [[nodiscard]] SIGHT_IO_IGTL_API const std::uint8_t* body();
+
+    /// Returns the size of the received body
+    [[nodiscard]] SIGHT_IO_IGTL_API std::size_t body_size();
+
+protected:
+
+    /// Constructor
+    SIGHT_IO_IGTL_API compressed_image_message();
+
+    /// Destructor
+    SIGHT_IO_IGTL_API ~compressed_image_message() override;
+
+private:
+
+    /// Override, returns the size of the received body
+    int GetBodyPackSize() OVERRIDE_ON_LINUX; // FIXME
+
+    /// Override, can not be packed
+    int PackBody() OVERRIDE_ON_LINUX; // FIXME
+
+    /// Override, the body is decoded by the converter
+    int UnpackBody() OVERRIDE_ON_LINUX; // FIXME
+};
+
+} //namespace sight::io::igtl::detail
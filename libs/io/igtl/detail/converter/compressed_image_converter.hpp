@@ -0,0 +1,94 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "io/igtl/detail/converter/base.hpp"
+#include "io/igtl/detail/exception/conversion.hpp"
+
+namespace sight::io::igtl::detail::converter
+{
+
+/**
+ *
+ * @brief class to decode COMPIMG messages to data::image
+ *
+ * Images are compressed when they are sent, by packed_message::from_compressed_image(), so this converter only
+ * works in one direction and is never selected to convert an object.
+ */
+class SIGHT_IO_IGTL_CLASS_API compressed_image_converter :
+    public base
+{
+public:
+
+    /// Constructor
+    SIGHT_IO_IGTL_API compressed_image_converter();
+
+    /// Destructor
+    SIGHT_IO_IGTL_API ~compressed_image_converter() override;
+
+    /**
+     * @brief decode a COMPIMG message to a data::object
+     *
+     * @return a data::image decoded from a compressed_image_message
+     */
+    [[nodiscard]] SIGHT_IO_IGTL_API data::object::sptr from_igtl_message(::igtl::MessageBase::Pointer _src) const
+    override;
+
+    /**
+     * @brief not supported, images are compressed by packed_message::from_compressed_image()
+     *
+     * @throw io::igtl::detail::exception::conversion
+     */
+    [[nodiscard]] SIGHT_IO_IGTL_API ::igtl::MessageBase::Pointer from_fw_data_object(data::object::csptr _src) const
+    override;
+
+    /**
+     * @brief create a new compressed_image_converter smart pointer
+     *
+     * @return a smart pointer to a compressed_image_converter
+     */
+    SIGHT_IO_IGTL_API static base::sptr New();
+
+    /**
+     * @brief get the igtlType supported for conversion
+     *
+     * @return the igtlType supported for conversion
+     */
+    [[nodiscard]] SIGHT_IO_IGTL_API std::string const& get_igtl_type() const override;
+
+    /**
+     * @brief get the fwData object type supported for conversion, empty since objects are not converted
+     *
+     * @return an empty string
+     */
+    [[nodiscard]] SIGHT_IO_IGTL_API std::string const& get_fw_data_object_type() const override;
+
+private:
+
+    /// igtl type supported for conversion
+    static const std::string IGTL_TYPE;
+
+    /// fwData type supported for conversion
+    static const std::string FWDATA_OBJECT_TYPE;
+};
+
+} // namespace sight::io::igtl::detail::converter
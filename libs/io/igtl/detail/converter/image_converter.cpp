@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -33,6 +33,7 @@
 #include <igtlImageMessage.h>
 
 #include <algorithm>
+#include <cstring>
 
 namespace sight::io::igtl::detail::converter
 {
@@ -58,8 +59,6 @@ image_converter::~image_converter()
     ::igtl::Matrix4x4 matrix;
 
     const auto dump_lock = src_img->dump_lock();
-    auto itr             = src_img->begin();
-    auto itr_end         = src_img->end();
 
     ::igtl::ImageMessage::Pointer dest = ::igtl::ImageMessage::New();
     ::igtl::IdentityMatrix(matrix);
@@ -72,11 +71,11 @@ image_converter::~image_converter()
     dest->SetDimensions(
         static_cast<int>(src_img->size()[0]),
         static_cast<int>(src_img->size()[1]),
-        static_cast<int>(src_img->size()[2])
+        // 2D images have a null third dimension
+        static_cast<int>(std::max<std::size_t>(src_img->size()[2], 1))
     );
     dest->AllocateScalars();
-    char* igtl_img_buffer = reinterpret_cast<char*>(dest->GetScalarPointer());
-    std::copy(itr, itr_end, igtl_img_buffer);
+    std::memcpy(dest->GetScalarPointer(), src_img->buffer(), src_img->size_in_bytes());
     return {dest.GetPointer()};
 }
 
@@ -85,7 +84,6 @@ image_converter::~image_converter()
 data::object::sptr image_converter::from_igtl_message(const ::igtl::MessageBase::Pointer _src) const
 {
     ::igtl::ImageMessage::Pointer src_img;
-    char* igtl_image_buffer    = nullptr;
     data::image::sptr dest_img = std::make_shared<data::image>();
     const auto dump_lock       = dest_img->dump_lock();
     std::array<float, 3> igtl_spacing {};
@@ -110,6 +108,10 @@ data::object::sptr image_converter::from_igtl_message(const ::igtl::MessageBase:
     {
         format = data::image::pixel_format::gray_scale;
     }
+    else if(src_img->GetNumComponents() == 2)
+    {
+        format = data::image::pixel_format::rg;
+    }
     else if(src_img->GetNumComponents() == 3)
     {
         format = data::image::pixel_format::rgb;
@@ -124,9 +126,7 @@ data::object::sptr image_converter::from_igtl_message(const ::igtl::MessageBase:
     }
 
     dest_img->resize(size, image_type_converter::get_fw_tools_type(std::uint8_t(src_img->GetScalarType())), format);
-    auto dest_iter = dest_img->begin();
-    igtl_image_buffer = reinterpret_cast<char*>(src_img->GetScalarPointer());
-    std::copy(igtl_image_buffer, igtl_image_buffer + src_img->GetImageSize(), dest_iter);
+    std::memcpy(dest_img->buffer(), src_img->GetScalarPointer(), static_cast<std::size_t>(src_img->GetImageSize()));
 
     if(sight::data::helper::medical_image::check_image_validity(dest_img))
     {
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -22,6 +22,7 @@
 
 #include "message_factory.hpp"
 
+#include "io/igtl/detail/compressed_image_message.hpp"
 #include "io/igtl/detail/raw_message.hpp"
 
 #include <igtlImageMessage.h>
@@ -53,6 +54,7 @@ message_factory::creator_container_t message_factory::init_factory()
     container["TDATA"]     = &MessageMaker< ::igtl::TrackingDataMessage, false>::create_message;
     container["STT_TDATA"] = &MessageMaker< ::igtl::StartTrackingDataMessage, false>::create_message;
     container["STP_TDATA"] = &MessageMaker< ::igtl::StopTrackingDataMessage, false>::create_message;
+    container["COMPIMG"]   = &MessageMaker<compressed_image_message, false>::create_message;
 
     return container;
 }
@@ -0,0 +1,462 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "io/igtl/detail/packed_message.hpp"
+
+#include "io/igtl/detail/data_converter.hpp"
+#include "io/igtl/detail/exception/conversion.hpp"
+#include "io/igtl/detail/image_type_converter.hpp"
+
+#include <io/bitmap/reader.hpp>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <igtl_util.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if !defined(_WIN32)
+  #include <sys/socket.h>
+  #include <sys/uio.h>
+  #include <cerrno>
+#endif
+
+namespace sight::io::igtl::detail
+{
+
+namespace
+{
+
+constexpr std::size_t TYPE_OFFSET        = 2;
+constexpr std::size_t TYPE_SIZE          = 12;
+constexpr std::size_t DEVICE_NAME_OFFSET = TYPE_OFFSET + TYPE_SIZE;
+constexpr std::size_t DEVICE_NAME_SIZE   = 20;
+constexpr std::size_t TIMESTAMP_OFFSET   = DEVICE_NAME_OFFSET + DEVICE_NAME_SIZE;
+constexpr std::size_t BODY_SIZE_OFFSET   = TIMESTAMP_OFFSET + 8;
+constexpr std::size_t CRC_OFFSET         = BODY_SIZE_OFFSET + 8;
+
+constexpr std::uint8_t ENDIAN_BIG    = 1;
+constexpr std::uint8_t ENDIAN_LITTLE = 2;
+constexpr std::uint8_t COORD_LPS     = 2;
+
+//------------------------------------------------------------------------------
+
+/// Writes an unsigned integer in network byte order
+template<typename T>
+std::uint8_t* write_be(std::uint8_t* _out, T _value)
+{
+    for(std::size_t i = sizeof(T) ; i-- > 0 ; )
+    {
+        *_out++ = static_cast<std::uint8_t>(_value >> (8 * i));
+    }
+
+    return _out;
+}
+
+//------------------------------------------------------------------------------
+
+/// Reads an unsigned integer in network byte order
+template<typename T>
+T read_be(const std::uint8_t*& _in)
+{
+    T value = 0;
+    for(std::size_t i = 0 ; i < sizeof(T) ; ++i)
+    {
+        value = static_cast<T>((value << 8) | *_in++);
+    }
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+std::uint8_t native_endian()
+{
+    return std::endian::native == std::endian::big ? ENDIAN_BIG : ENDIAN_LITTLE;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+packed_message packed_message::from_object(const data::object::csptr& _obj)
+{
+    // Images are not copied, however derived classes like image_series keep their own converter
+    if(_obj->get_classname() == data::image::classname())
+    {
+        return from_image(std::dynamic_pointer_cast<const data::image>(_obj));
+    }
+
+    return from_msg(data_converter::get_instance()->from_fw_object(_obj));
+}
+
+//------------------------------------------------------------------------------
+
+packed_message packed_message::from_msg(::igtl::MessageBase::Pointer _msg)
+{
+    _msg->Pack();
+
+    packed_message message;
+    std::memcpy(message.m_header.data(), _msg->GetPackPointer(), HEADER_SIZE);
+    message.m_body      = static_cast<const std::uint8_t*>(_msg->GetPackBodyPointer());
+    message.m_body_size = static_cast<std::size_t>(_msg->GetPackBodySize());
+    message.m_msg       = _msg;
+    return message;
+}
+
+//------------------------------------------------------------------------------
+
+packed_message packed_message::from_image(const data::image::csptr& _image)
+{
+    packed_message message;
+    message.write_image_header(*_image);
+    message.m_image     = _image;
+    message.m_locks     = _image->dump_lock();
+    message.m_body      = static_cast<const std::uint8_t*>(_image->buffer());
+    message.m_body_size = _image->size_in_bytes();
+    message.write_header(IMAGE_TYPE);
+
+    return message;
+}
+
+//------------------------------------------------------------------------------
+
+packed_message packed_message::from_compressed_image(
+    const data::image::csptr& _image,
+    bitmap::backend _backend,
+    bitmap::writer::mode _mode
+)
+{
+    const auto& size = _image->size();
+    if(size[0] == 0 || size[1] == 0 || size[2] > 1)
+    {
+        throw exception::conversion("Only 2D images can be compressed");
+    }
+
+    // Writers keep the state of their codec, so each thread reuses its own
+    thread_local const auto s_writer = std::make_shared<bitmap::writer>();
+
+    auto encoded = std::make_shared<std::vector<std::uint8_t> >();
+    try
+    {
+        s_writer->set_object(_image);
+        encoded->resize(s_writer->write(*encoded, _backend, _mode));
+    }
+    catch(const std::exception& e)
+    {
+        throw exception::conversion(std::string("Cannot compress the image: ") + e.what());
+    }
+
+    packed_message message;
+    message.write_image_header(*_image);
+
+    std::uint8_t* const codec_header = message.m_header.data() + HEADER_SIZE + IMAGE_HEADER_SIZE;
+    std::fill_n(codec_header, CODEC_HEADER_SIZE, std::uint8_t(0));
+    codec_header[0]        = static_cast<std::uint8_t>(_backend);
+    message.m_header_size += CODEC_HEADER_SIZE;
+
+    message.m_body      = encoded->data();
+    message.m_body_size = encoded->size();
+    message.m_encoded   = std::move(encoded);
+    message.write_header(COMPRESSED_IMAGE_TYPE);
+
+    return message;
+}
+
+//------------------------------------------------------------------------------
+
+packed_message packed_message::from_query(const std::string& _type)
+{
+    packed_message message;
+    message.write_header(_type);
+    return message;
+}
+
+//------------------------------------------------------------------------------
+
+void packed_message::write_image_header(const data::image& _image)
+{
+    const auto& size = _image.size();
+    for(const auto dim : size)
+    {
+        if(dim > std::numeric_limits<std::uint16_t>::max())
+        {
+            throw exception::conversion("Image is too large to be sent with OpenIGTLink");
+        }
+    }
+
+    // 2D images have a null third dimension
+    const std::array<std::uint16_t, 3> igtl_size {
+        std::uint16_t(size[0]),
+        std::uint16_t(size[1]),
+        std::uint16_t(std::max<std::size_t>(size[2], 1))
+    };
+
+    // Image header, the orientation is the identity
+    std::uint8_t* out = m_header.data() + HEADER_SIZE;
+    out    = write_be<std::uint16_t>(out, 1);
+    *out++ = static_cast<std::uint8_t>(_image.num_components());
+    *out++ = image_type_converter::get_igtl_type(_image.type());
+    *out++ = native_endian();
+    *out++ = COORD_LPS;
+    for(const auto dim : igtl_size)
+    {
+        out = write_be(out, dim);
+    }
+
+    const auto& spacing = _image.spacing();
+    const auto& origin  = _image.origin();
+    std::array<float, 12> matrix {};
+    matrix[0]  = float(spacing[0]);
+    matrix[4]  = float(spacing[1]);
+    matrix[8]  = float(spacing[2]);
+    matrix[9]  = float(origin[0]);
+    matrix[10] = float(origin[1]);
+    matrix[11] = float(origin[2]);
+    for(const float value : matrix)
+    {
+        out = write_be(out, std::bit_cast<std::uint32_t>(value));
+    }
+
+    // The whole volume is sent
+    for(std::size_t i = 0 ; i < 3 ; ++i)
+    {
+        out = write_be<std::uint16_t>(out, 0);
+    }
+
+    for(const auto dim : igtl_size)
+    {
+        out = write_be(out, dim);
+    }
+
+    m_header_size = HEADER_SIZE + IMAGE_HEADER_SIZE;
+}
+
+//------------------------------------------------------------------------------
+
+void packed_message::write_header(const std::string& _type)
+{
+    const auto now      = std::chrono::system_clock::now().time_since_epoch();
+    const auto sec      = std::chrono::duration_cast<std::chrono::seconds>(now);
+    const auto nsec     = std::chrono::duration_cast<std::chrono::nanoseconds>(now - sec).count();
+    const auto fraction = static_cast<std::uint64_t>((static_cast<std::uint64_t>(nsec) << 32) / 1000000000ULL);
+
+    std::uint8_t* const body_header = m_header.data() + HEADER_SIZE;
+    const std::size_t body_header_size = m_header_size - HEADER_SIZE;
+
+    igtl_uint64 crc = crc64(nullptr, 0, 0);
+    crc = crc64(body_header, body_header_size, crc);
+    crc = crc64(const_cast<std::uint8_t*>(m_body), m_body_size, crc); // NOLINT
+
+    std::uint8_t* const header = m_header.data();
+    write_be<std::uint16_t>(header, 1);
+    std::strncpy(reinterpret_cast<char*>(header + TYPE_OFFSET), _type.c_str(), TYPE_SIZE);
+    write_be<std::uint64_t>(
+        header + TIMESTAMP_OFFSET,
+        (static_cast<std::uint64_t>(sec.count()) << 32) | fraction
+    );
+    write_be<std::uint64_t>(header + BODY_SIZE_OFFSET, body_header_size + m_body_size);
+    write_be<std::uint64_t>(header + CRC_OFFSET, crc);
+}
+
+//------------------------------------------------------------------------------
+
+packed_message::image_header packed_message::read_image_header(const std::uint8_t* _data)
+{
+    image_header header;
+
+    const std::uint8_t* in = _data + 2;
+    header.num_components = *in++;
+    header.scalar_type    = *in++;
+    header.endian         = *in++;
+    ++in;
+    for(auto& dim : header.size)
+    {
+        dim = read_be<std::uint16_t>(in);
+    }
+
+    for(auto& value : header.matrix)
+    {
+        value = std::bit_cast<float>(read_be<std::uint32_t>(in));
+    }
+
+    for(auto& offset : header.subvolume_offset)
+    {
+        offset = read_be<std::uint16_t>(in);
+    }
+
+    for(auto& dim : header.subvolume_size)
+    {
+        dim = read_be<std::uint16_t>(in);
+    }
+
+    return header;
+}
+
+//------------------------------------------------------------------------------
+
+data::image::spacing_t packed_message::image_header::spacing() const
+{
+    data::image::spacing_t spacing {};
+    for(std::size_t i = 0 ; i < 3 ; ++i)
+    {
+        spacing[i] = std::hypot(double(matrix[3 * i]), double(matrix[3 * i + 1]), double(matrix[3 * i + 2]));
+    }
+
+    return spacing;
+}
+
+//------------------------------------------------------------------------------
+
+data::image::origin_t packed_message::image_header::origin() const
+{
+    return {double(matrix[9]), double(matrix[10]), double(matrix[11])};
+}
+
+//------------------------------------------------------------------------------
+
+data::image::sptr packed_message::read_compressed_image(const std::uint8_t* _body, std::size_t _size)
+{
+    if(_size < IMAGE_HEADER_SIZE + CODEC_HEADER_SIZE)
+    {
+        throw exception::conversion("Truncated compressed image message");
+    }
+
+    const image_header header = read_image_header(_body);
+    const auto backend        = static_cast<bitmap::backend>(_body[IMAGE_HEADER_SIZE]);
+
+    const char* const encoded = reinterpret_cast<const char*>(_body + IMAGE_HEADER_SIZE + CODEC_HEADER_SIZE);
+    boost::iostreams::stream<boost::iostreams::array_source> stream(
+        encoded,
+        _size - IMAGE_HEADER_SIZE - CODEC_HEADER_SIZE
+    );
+
+    // Readers keep the state of their codec, so each thread reuses its own
+    thread_local const auto s_reader = std::make_shared<bitmap::reader>();
+
+    auto image = std::make_shared<data::image>();
+    try
+    {
+        s_reader->set_object(image);
+        s_reader->read(stream, backend);
+    }
+    catch(const std::exception& e)
+    {
+        throw exception::conversion(std::string("Cannot decompress the image: ") + e.what());
+    }
+
+    if(image->size()[0] != header.size[0] || image->size()[1] != header.size[1])
+    {
+        throw exception::conversion("The size of the decompressed image does not match its header");
+    }
+
+    image->set_spacing(header.spacing());
+    image->set_origin(header.origin());
+
+    return image;
+}
+
+//------------------------------------------------------------------------------
+
+bool packed_message::is_native_endian(const image_header& _header)
+{
+    return _header.endian == native_endian();
+}
+
+//------------------------------------------------------------------------------
+
+void packed_message::set_device_name(const std::string& _device_name)
+{
+    // Not null-terminated when the name is 20 characters long, as igtl does
+    std::strncpy(
+        reinterpret_cast<char*>(m_header.data() + DEVICE_NAME_OFFSET),
+        _device_name.c_str(),
+        DEVICE_NAME_SIZE
+    );
+}
+
+//------------------------------------------------------------------------------
+
+bool packed_message::send(::igtl::Socket& _socket) const
+{
+#if defined(_WIN32)
+    return _socket.Send(m_header.data(), int(m_header_size)) == 1
+           && (m_body_size == 0 || _socket.Send(m_body, int(m_body_size)) == 1);
+#else
+    if(_socket.m_SocketDescriptor < 0)
+    {
+        return false;
+    }
+
+    std::array<iovec, 2> buffers {
+        iovec {const_cast<std::uint8_t*>(m_header.data()), m_header_size}, // NOLINT
+        iovec {const_cast<std::uint8_t*>(m_body), m_body_size}             // NOLINT
+    };
+    msghdr msg {};
+    msg.msg_iov    = buffers.data();
+    msg.msg_iovlen = m_body_size == 0 ? 1 : 2;
+
+  #if defined(MSG_NOSIGNAL)
+    constexpr int flags = MSG_NOSIGNAL;
+  #else
+    constexpr int flags = 0;
+  #endif
+
+    // Like igtl::Socket::Send(), loop until everything is sent
+    while(msg.msg_iovlen > 0)
+    {
+        const ssize_t sent = ::sendmsg(_socket.m_SocketDescriptor, &msg, flags);
+        if(sent < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        auto remaining = static_cast<std::size_t>(sent);
+        while(msg.msg_iovlen > 0 && remaining >= msg.msg_iov->iov_len)
+        {
+            remaining -= msg.msg_iov->iov_len;
+            ++msg.msg_iov;
+            --msg.msg_iovlen;
+        }
+
+        if(msg.msg_iovlen > 0)
+        {
+            msg.msg_iov->iov_base = static_cast<std::uint8_t*>(msg.msg_iov->iov_base) + remaining;
+            msg.msg_iov->iov_len -= remaining;
+        }
+    }
+
+    return true;
+#endif
+}
+
+} // namespace sight::io::igtl::detail
@@ -0,0 +1,192 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/io/igtl/config.hpp>
+// Patched header.
+#include "io/igtl/patch/igtlSocket.h"
+
+#include <core/memory/buffer_object.hpp>
+
+#include <data/image.hpp>
+#include <data/object.hpp>
+
+#include <io/bitmap/backend.hpp>
+#include <io/bitmap/writer.hpp>
+
+#include <igtlMessageBase.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sight::io::igtl::detail
+{
+
+/**
+ * @brief OpenIGTLink message packed once and sent to one or several sockets without copying its body.
+ *
+ * The header is kept apart from the body, so that the device name can be changed for each destination. The body is
+ * either the pack of an igtl message or, for images, the image header followed by the image buffer itself. The message
+ * holds a dump lock on the image until it is destroyed.
+ *
+ * 2D images may also be sent as COMPIMG messages, which are not part of OpenIGTLink: the body is the IMAGE header,
+ * followed by a codec header and the image encoded by an io::bitmap backend. They are only sent to receivers that
+ * asked for them with a GET_COMPIMG query, so that plain OpenIGTLink peers keep receiving IMAGE messages.
+ */
+class SIGHT_IO_IGTL_CLASS_API packed_message
+{
+public:
+
+    /// Size of the header of any message
+    static constexpr std::size_t HEADER_SIZE = 58;
+
+    /// Size of the header at the beginning of the body of an IMAGE message
+    static constexpr std::size_t IMAGE_HEADER_SIZE = 72;
+
+    /// Type of the IMAGE messages
+    static constexpr auto IMAGE_TYPE = "IMAGE";
+
+    /// Size of the codec header following the image header at the beginning of the body of a COMPIMG message
+    static constexpr std::size_t CODEC_HEADER_SIZE = 4;
+
+    /// Type of the compressed image messages
+    static constexpr auto COMPRESSED_IMAGE_TYPE = "COMPIMG";
+
+    /// Type of the query sent by a receiver able to decode compressed image messages
+    static constexpr auto COMPRESSED_IMAGE_QUERY = "GET_COMPIMG";
+
+    /// Content of the header of an IMAGE message body
+    struct image_header
+    {
+        std::uint8_t num_components {1};
+        std::uint8_t scalar_type {0};
+        std::uint8_t endian {0};
+        std::array<std::uint16_t, 3> size {};
+        std::array<float, 12> matrix {};
+        std::array<std::uint16_t, 3> subvolume_offset {};
+        std::array<std::uint16_t, 3> subvolume_size {};
+
+        /// Returns the size in bytes of the pixels, given the size of a component
+        [[nodiscard]] std::size_t data_size(std::size_t _component_size) const;
+
+        /// Returns the spacing, i.e. the norms of the columns of the orientation matrix
+        [[nodiscard]] SIGHT_IO_IGTL_API data::image::spacing_t spacing() const;
+
+        /// Returns the origin, i.e. the translation of the orientation matrix
+        [[nodiscard]] SIGHT_IO_IGTL_API data::image::origin_t origin() const;
+    };
+
+    /**
+     * @brief Packs an object, images are not copied.
+     * @throw io::igtl::exception if the object can not be converted
+     */
+    SIGHT_IO_IGTL_API static packed_message from_object(const data::object::csptr& _obj);
+
+    /// Packs an igtl message, the body is then sent from the pack of the message.
+    SIGHT_IO_IGTL_API static packed_message from_msg(::igtl::MessageBase::Pointer _msg);
+
+    /**
+     * @brief Packs an image as an IMAGE message, the pixels are then sent from the image buffer.
+     * @throw io::igtl::exception if the image is too large for the protocol
+     */
+    SIGHT_IO_IGTL_API static packed_message from_image(const data::image::csptr& _image);
+
+    /**
+     * @brief Packs a 2D image as a COMPIMG message, encoded with an io::bitmap backend.
+     * @throw io::igtl::detail::exception::conversion if the image is not 2D or can not be encoded by the backend
+     */
+    SIGHT_IO_IGTL_API static packed_message from_compressed_image(
+        const data::image::csptr& _image,
+        bitmap::backend _backend,
+        bitmap::writer::mode _mode = bitmap::writer::mode::fast
+    );
+
+    /// Packs a message without body, like a query
+    SIGHT_IO_IGTL_API static packed_message from_query(const std::string& _type);
+
+    /// Reads the header of an IMAGE message body
+    SIGHT_IO_IGTL_API static image_header read_image_header(const std::uint8_t* _data);
+
+    /// Returns true if the data of an IMAGE message has the byte order of this machine
+    SIGHT_IO_IGTL_API static bool is_native_endian(const image_header& _header);
+
+    /**
+     * @brief Decodes the body of a COMPIMG message
+     * @throw io::igtl::detail::exception::conversion if the body is truncated or can not be decoded
+     */
+    SIGHT_IO_IGTL_API static data::image::sptr read_compressed_image(const std::uint8_t* _body, std::size_t _size);
+
+    /// Sets the device name written in the header
+    SIGHT_IO_IGTL_API void set_device_name(const std::string& _device_name);
+
+    /// Returns the size of the message, header included
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Sends the message with a single gathered write, if the platform allows it.
+     * @return false if the socket is closed
+     */
+    SIGHT_IO_IGTL_API bool send(::igtl::Socket& _socket) const;
+
+private:
+
+    packed_message() = default;
+
+    /// Writes the image header of an image in the header of the message
+    void write_image_header(const data::image& _image);
+
+    /// Writes the header of the message, the CRC covers the image header, if any, and the body
+    void write_header(const std::string& _type);
+
+    /// Header of the message, followed by the image header for IMAGE messages, and the codec header for COMPIMG
+    std::array<std::uint8_t, HEADER_SIZE + IMAGE_HEADER_SIZE + CODEC_HEADER_SIZE> m_header {};
+    std::size_t m_header_size {HEADER_SIZE};
+
+    /// Remaining part of the body
+    const std::uint8_t* m_body {nullptr};
+    std::size_t m_body_size {0};
+
+    /// Owners of the body
+    ::igtl::MessageBase::Pointer m_msg;
+    data::image::csptr m_image;
+    std::vector<core::memory::buffer_object::lock_t> m_locks;
+    std::shared_ptr<const std::vector<std::uint8_t> > m_encoded;
+};
+
+//------------------------------------------------------------------------------
+
+inline std::size_t packed_message::size() const
+{
+    return m_header_size + m_body_size;
+}
+
+//------------------------------------------------------------------------------
+
+inline std::size_t packed_message::image_header::data_size(std::size_t _component_size) const
+{
+    return std::size_t(subvolume_size[0]) * subvolume_size[1] * subvolume_size[2] * num_components
+           * _component_size;
+}
+
+} // namespace sight::io::igtl::detail
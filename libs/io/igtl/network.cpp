@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2014-2023 IRCAD France
+ * Copyright (C) 2014-2024 IRCAD France
  * Copyright (C) 2014-2018 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -25,8 +25,13 @@
 #include "io/igtl/exception.hpp"
 
 #include <io/igtl/detail/data_converter.hpp>
+#include <io/igtl/detail/image_type_converter.hpp>
 #include <io/igtl/detail/message_factory.hpp>
 
+#include <igtl_header.h>
+#include <igtl_util.h>
+
+#include <algorithm>
 #include <cmath>
 
 #if defined(_WIN32)
@@ -63,22 +68,30 @@ network::~network()
 
 bool network::send_object(const data::object::csptr& _obj)
 {
-    ::igtl::MessageBase::Pointer msg;
-
-    detail::data_converter::sptr converter = detail::data_converter::get_instance();
-    msg = converter->from_fw_object(_obj);
-    msg->SetDeviceName(m_device_name_out.c_str());
-    msg->Pack();
-    return m_socket->Send(msg->GetPackPointer(), msg->GetPackSize()) == 1;
+    return this->send_packed(detail::packed_message::from_object(_obj));
 }
 
 //------------------------------------------------------------------------------
 
 bool network::send_msg(::igtl::MessageBase::Pointer _msg)
 {
-    _msg->SetDeviceName(m_device_name_out.c_str());
-    _msg->Pack();
-    return m_socket->Send(_msg->GetPackPointer(), _msg->GetPackSize()) == 1;
+    return this->send_packed(detail::packed_message::from_msg(_msg));
+}
+
+//------------------------------------------------------------------------------
+
+bool network::send_packed(const detail::packed_message& _msg)
+{
+    detail::packed_message msg = _msg;
+    msg.set_device_name(m_device_name_out);
+    return msg.send(*m_socket);
+}
+
+//------------------------------------------------------------------------------
+
+bool network::request_compressed_images()
+{
+    return this->send_packed(detail::packed_message::from_query(detail::packed_message::COMPRESSED_IMAGE_QUERY));
 }
 
 //------------------------------------------------------------------------------
@@ -185,31 +198,153 @@ data::object::sptr network::receive_object(std::string& _device_name, double& _t
 
 ::igtl::MessageBase::Pointer network::receive_body(::igtl::MessageHeader::Pointer const _header_msg)
 {
-    int unpack_result = 0;
-    int result        = 0;
-    ::igtl::MessageBase::Pointer msg;
+    if(_header_msg == nullptr)
+    {
+        throw sight::io::igtl::exception("Invalid header message");
+    }
 
+    ::igtl::MessageBase::Pointer msg = this->create_body(_header_msg);
+    this->receive_data(msg->GetPackBodyPointer(), static_cast<std::size_t>(msg->GetPackBodySize()));
+    return unpack_body(msg);
+}
+
+//------------------------------------------------------------------------------
+
+network::frame_t network::receive_frame(
+    ::igtl::MessageHeader::Pointer _header_msg,
+    data::frame_tl& _timeline,
+    core::clock::type _timestamp
+)
+{
+    return this->receive_frame(
+        _header_msg,
+        [&_timeline, _timestamp](
+            std::size_t _width,
+            std::size_t _height,
+            core::type _type,
+            enum data::frame_tl::pixel_format _format)
+        {
+            if(_timeline.get_width() != _width || _timeline.get_height() != _height || _timeline.type() != _type
+               || _timeline.pixel_format() != _format)
+            {
+                _timeline.init_pool_size(_width, _height, _type, _format);
+            }
+
+            return _timeline.create_buffer(_timestamp);
+        });
+}
+
+//------------------------------------------------------------------------------
+
+network::frame_t network::receive_frame(
+    ::igtl::MessageHeader::Pointer _header_msg,
+    const frame_allocator_t& _allocator
+)
+{
     if(_header_msg == nullptr)
     {
         throw sight::io::igtl::exception("Invalid header message");
     }
 
-    msg = io::igtl::detail::message_factory::create(_header_msg->GetDeviceType());
-    msg->SetMessageHeader(_header_msg);
-    msg->AllocatePack();
-    result = m_socket->Receive(msg->GetPackBodyPointer(), msg->GetPackBodySize());
+    // The image header is only at the beginning of the body with a version 1 header, without extended header
+    const auto body_size = static_cast<std::size_t>(_header_msg->GetBodySizeToRead());
+    if(std::string(_header_msg->GetDeviceType()) != detail::packed_message::IMAGE_TYPE
+       || _header_msg->GetHeaderVersion() != IGTL_HEADER_VERSION_1
+       || body_size < detail::packed_message::IMAGE_HEADER_SIZE)
+    {
+        return this->receive_body(_header_msg);
+    }
 
-    if(result == -1) // Timeout
+    std::array<std::uint8_t, detail::packed_message::IMAGE_HEADER_SIZE> image_header_data {};
+    this->receive_data(image_header_data.data(), image_header_data.size());
+    const auto image_header     = detail::packed_message::read_image_header(image_header_data.data());
+    const std::size_t remaining = body_size - detail::packed_message::IMAGE_HEADER_SIZE;
+
+    enum data::frame_tl::pixel_format format = data::frame_tl::pixel_format::undefined;
+    switch(image_header.num_components)
     {
-        throw sight::io::igtl::exception("Network timeout");
+        case 1:
+            format = data::frame_tl::pixel_format::gray_scale;
+            break;
+
+        case 3:
+            format = data::frame_tl::pixel_format::rgb;
+            break;
+
+        case 4:
+            format = data::frame_tl::pixel_format::rgba;
+            break;
+
+        default:
+            break;
     }
 
-    if(result == 0) // Error
+    core::type type;
+    try
     {
-        throw sight::io::igtl::exception("Network Error");
+        type = detail::image_type_converter::get_fw_tools_type(image_header.scalar_type);
     }
+    catch(const core::exception&)
+    {
+        format = data::frame_tl::pixel_format::undefined;
+    }
+
+    // Only whole 2D images fit in a frame, other images are received in a message for the generic converter
+    SPTR(data::frame_tl::buffer_t) buffer;
+    if(format != data::frame_tl::pixel_format::undefined
+       && image_header.size == image_header.subvolume_size && image_header.size[2] <= 1
+       && remaining == image_header.data_size(type.size()))
+    {
+        buffer = _allocator(image_header.size[0], image_header.size[1], type, format);
+    }
+
+    if(!buffer)
+    {
+        ::igtl::MessageBase::Pointer msg = this->create_body(_header_msg);
+        auto* const body                 = static_cast<std::uint8_t*>(msg->GetPackBodyPointer());
+        std::copy(image_header_data.begin(), image_header_data.end(), body);
+        this->receive_data(body + image_header_data.size(), remaining);
+        return unpack_body(msg);
+    }
+
+    std::uint8_t* const frame = buffer->add_element(0);
+    this->receive_data(frame, remaining);
+
+    // Same check as igtl::MessageBase::Unpack(), the CRC covers the image header and the pixels
+    igtl_uint64 crc = crc64(nullptr, 0, 0);
+    crc = crc64(image_header_data.data(), image_header_data.size(), crc);
+    crc = crc64(frame, remaining, crc);
+    if(crc != static_cast<const igtl_header*>(_header_msg->GetPackPointer())->crc)
+    {
+        throw exception("Body pack is not valid");
+    }
+
+    if(!detail::packed_message::is_native_endian(image_header) && type.size() > 1)
+    {
+        for(std::uint8_t* value = frame ; value != frame + remaining ; value += type.size())
+        {
+            std::reverse(value, value + type.size());
+        }
+    }
+
+    return buffer;
+}
+
+//------------------------------------------------------------------------------
+
+::igtl::MessageBase::Pointer network::create_body(const ::igtl::MessageHeader::Pointer& _header_msg)
+{
+    ::igtl::MessageBase::Pointer msg = io::igtl::detail::message_factory::create(_header_msg->GetDeviceType());
+    msg->SetMessageHeader(_header_msg);
+    msg->AllocatePack();
+    return msg;
+}
+
+//------------------------------------------------------------------------------
 
-    unpack_result = msg->Unpack();
+::igtl::MessageBase::Pointer network::unpack_body(const ::igtl::MessageBase::Pointer& _msg)
+{
+    const int unpack_result = _msg->Unpack();
     if(unpack_result == ::igtl::MessageHeader::UNPACK_UNDEF)
     {
         throw sight::io::igtl::exception("Network Error");
@@ -217,7 +352,7 @@ data::object::sptr network::receive_object(std::string& _device_name, double& _t
 
     if(unpack_result == ::igtl::MessageHeader::UNPACK_BODY)
     {
-        return msg;
+        return _msg;
     }
 
     throw exception("Body pack is not valid");
@@ -225,6 +360,22 @@ data::object::sptr network::receive_object(std::string& _device_name, double& _t
 
 //------------------------------------------------------------------------------
 
+void network::receive_data(void* _data, std::size_t _size)
+{
+    const int result = m_socket->Receive(_data, static_cast<int>(_size));
+    if(result == -1) // Timeout
+    {
+        throw sight::io::igtl::exception("Network timeout");
+    }
+
+    if(result == 0) // Error
+    {
+        throw sight::io::igtl::exception("Network Error");
+    }
+}
+
+//------------------------------------------------------------------------------
+
 ::igtl::Socket::Pointer network::get_socket() const
 {
     return m_socket;
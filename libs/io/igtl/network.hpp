@@ -26,15 +26,22 @@
 // Patched header.
 #include "io/igtl/patch/igtlSocket.h"
 
+#include "io/igtl/detail/packed_message.hpp"
+
+#include <core/clock.hpp>
 #include <core/exception.hpp>
 
+#include <data/frame_tl.hpp>
 #include <data/object.hpp>
 
 #include <igtlMessageHeader.h>
 #include <igtlSocket.h>
 
+#include <atomic>
+#include <functional>
 #include <set>
 #include <string>
+#include <variant>
 
 namespace sight::io::igtl
 {
@@ -89,6 +96,12 @@ public:
      */
     SIGHT_IO_IGTL_API bool send_msg(::igtl::MessageBase::Pointer _msg);
 
+    /**
+     * @brief send a packed message with the device name of this instance, the body is not copied
+     * @param[in] _msg message to send, that can be shared by several instances
+     */
+    SIGHT_IO_IGTL_API bool send_packed(const detail::packed_message& _msg);
+
     /**
      * @brief receive header
      * @throw igtl::exception on error (network error or timeout).
@@ -105,6 +118,68 @@ public:
      */
     SIGHT_IO_IGTL_API ::igtl::MessageBase::Pointer receive_body(::igtl::MessageHeader::Pointer _header);
 
+    /// Buffer of a frame timeline holding a received image, or message to convert when the image does not fit in it
+    using frame_t = std::variant<SPTR(data::frame_tl::buffer_t), ::igtl::MessageBase::Pointer>;
+
+    /**
+     * @brief receive the body of an IMAGE message directly in a new buffer of a frame timeline, when possible
+     *
+     * Only whole 2D images with 1, 3 or 4 components, sent with a version 1 header, fit in a frame. The timeline is
+     * initialized again if the format of the image differs. The buffer is not pushed in the timeline.
+     * Any other message is received like receive_body() does, so that it can still be converted.
+     *
+     * @param[in] _header header of the message
+     * @param[in] _timeline timeline where the buffer is allocated
+     * @param[in] _timestamp timestamp of the buffer
+     * @throw igtl::exception on error (network error, timeout or invalid CRC).
+     * @return buffer holding the image, or the unpacked message if the image does not fit in a frame
+     */
+    SIGHT_IO_IGTL_API frame_t receive_frame(
+        ::igtl::MessageHeader::Pointer _header,
+        data::frame_tl& _timeline,
+        core::clock::type _timestamp
+    );
+
+    /// Allocates the buffer receiving an image of the given width, height, type and format, or returns nullptr
+    using frame_allocator_t = std::function<SPTR(data::frame_tl::buffer_t)(
+                                                std::size_t,
+                                                std::size_t,
+                                                core::type,
+                                                enum data::frame_tl::pixel_format
+                                            )>;
+
+    /**
+     * @brief receive the body of an IMAGE message directly in a buffer given by an allocator, when possible
+     *
+     * The allocator is only called once the format of the image is known, before the pixels are received. It lets
+     * the caller lock its timeline only to allocate the buffer, and not during the transfer.
+     * If the allocator returns nullptr, the message is received like receive_body() does.
+     *
+     * @param[in] _header header of the message
+     * @param[in] _allocator function allocating the buffer of the image
+     * @throw igtl::exception on error (network error, timeout or invalid CRC).
+     * @return buffer holding the image, or the unpacked message if the image does not fit in a frame
+     */
+    SIGHT_IO_IGTL_API frame_t receive_frame(::igtl::MessageHeader::Pointer _header, const frame_allocator_t& _allocator);
+
+    /**
+     * @brief send a GET_COMPIMG query, to ask the peer to send 2D images compressed
+     *
+     * Peers that do not support compressed images ignore the query and keep sending IMAGE messages.
+     * @return true if the query was sent
+     */
+    SIGHT_IO_IGTL_API bool request_compressed_images();
+
+    /**
+     * @brief return true if the peer asked for compressed images, with a GET_COMPIMG query
+     */
+    [[nodiscard]] bool accepts_compressed_images() const;
+
+    /**
+     * @brief set whether the peer asked for compressed images
+     */
+    void set_accepts_compressed_images(bool _accepts);
+
     /**
      * @brief get socket
      *
@@ -162,6 +237,15 @@ protected:
     /// Patched version: Doesn't rely on VTK_HAVE_SO_REUSEADDR to add option SO_REUSEADDR.
     static int bind_socket(int _socket_descriptor, std::uint16_t _port);
 
+    /// Creates a message of the type given by the header, with an allocated body
+    static ::igtl::MessageBase::Pointer create_body(const ::igtl::MessageHeader::Pointer& _header);
+
+    /// Unpacks a received body, throws if the body is not valid
+    static ::igtl::MessageBase::Pointer unpack_body(const ::igtl::MessageBase::Pointer& _msg);
+
+    /// Receives exactly _size bytes, throws on network error or timeout
+    void receive_data(void* _data, std::size_t _size);
+
     /// client socket
     ::igtl::Socket::Pointer m_socket;
 
@@ -173,6 +257,23 @@ protected:
 
     /// device name in the sent message
     std::string m_device_name_out;
+
+    /// true if the peer asked for compressed images, set by the thread receiving its messages
+    std::atomic_bool m_accepts_compressed_images {false};
 };
 
+//------------------------------------------------------------------------------
+
+inline bool network::accepts_compressed_images() const
+{
+    return m_accepts_compressed_images;
+}
+
+//------------------------------------------------------------------------------
+
+inline void network::set_accepts_compressed_images(bool _accepts)
+{
+    m_accepts_compressed_images = _accepts;
+}
+
 } // namespace sight::io::igtl
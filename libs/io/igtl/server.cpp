@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2014-2023 IRCAD France
+ * Copyright (C) 2014-2024 IRCAD France
  * Copyright (C) 2014-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -27,10 +27,23 @@
 #include <core/spy_log.hpp>
 
 #include <io/igtl/detail/data_converter.hpp>
+#include <io/igtl/detail/exception/conversion.hpp>
 #include <io/igtl/detail/message_factory.hpp>
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+
+#if defined(_WIN32)
+  #include <winsock2.h>
+#else
+  #include <sys/select.h>
+  #include <sys/socket.h>
+#endif
+
 namespace sight::io::igtl
 {
 
@@ -74,66 +87,276 @@ void server::run_server()
 {
     client::sptr new_client;
 
+    // Clients waiting for a GET_COMPIMG query, on their own thread so that other clients are still accepted meanwhile
+    std::vector<std::future<void> > pending_clients;
+
     while(this->started())
     {
         new_client = this->wait_for_connection();
         if(new_client != nullptr)
         {
-            core::mt::scoped_lock lock(m_mutex);
-            if(m_receive_timeout.has_value())
+            std::erase_if(
+                pending_clients,
+                [](const std::future<void>& _f)
+                {
+                    return _f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                });
+
+            if(this->image_compression().has_value())
             {
-                new_client->get_socket()->SetReceiveTimeout(static_cast<int>(m_receive_timeout.value()));
+                pending_clients.push_back(
+                    std::async(
+                        std::launch::async,
+                        [this, new_client]
+                        {
+                            receive_compression_query(*new_client);
+                            this->add_client(new_client);
+                        })
+                );
+            }
+            else
+            {
+                this->add_client(new_client);
             }
-
-            m_clients.push_back(new_client);
         }
     }
+
+    for(auto& pending_client : pending_clients)
+    {
+        pending_client.wait();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void server::add_client(const client::sptr& _client)
+{
+    core::mt::scoped_lock lock(m_mutex);
+
+    // The server may have been stopped while the client was waiting for its query
+    if(!m_is_started)
+    {
+        _client->disconnect();
+        return;
+    }
+
+    if(m_receive_timeout.has_value())
+    {
+        _client->get_socket()->SetReceiveTimeout(static_cast<int>(m_receive_timeout.value()));
+    }
+
+    m_clients.push_back(_client);
+}
+
+//------------------------------------------------------------------------------
+
+void server::receive_compression_query(client& _client)
+{
+    const int socket = _client.get_socket()->m_SocketDescriptor;
+
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    FD_SET(socket, &sockets);
+    timeval timeout {0, COMPRESSION_QUERY_TIMEOUT * 1000};
+    if(::select(socket + 1, &sockets, nullptr, nullptr, &timeout) <= 0)
+    {
+        return;
+    }
+
+    // Peek the header, so that any other message is left for the listeners
+    constexpr std::size_t type_offset = 2;
+    std::array<char, detail::packed_message::HEADER_SIZE> header {};
+    const auto peeked = static_cast<int>(::recv(socket, header.data(), int(header.size()), MSG_PEEK));
+    if(peeked != int(header.size())
+       || std::strncmp(header.data() + type_offset, detail::packed_message::COMPRESSED_IMAGE_QUERY, 12) != 0)
+    {
+        return;
+    }
+
+    // The query has no body
+    if(_client.get_socket()->Receive(header.data(), int(header.size())) == int(header.size()))
+    {
+        _client.set_accepts_compressed_images(true);
+    }
 }
 
 //------------------------------------------------------------------------------
 
 void server::broadcast(const data::object::csptr& _obj)
 {
-    std::vector<client::sptr>::iterator it;
+    auto image = std::dynamic_pointer_cast<const data::image>(_obj);
+    std::vector<client::sptr> clients;
+    std::optional<std::pair<bitmap::backend, bitmap::writer::mode> > compression;
+    {
+        core::mt::scoped_lock lock(m_mutex);
+        clients     = m_clients;
+        compression = m_compression;
+    }
 
-    for(it = m_clients.begin() ; it != m_clients.end() ; )
+    if(compression.has_value() && image && _obj->get_classname() == data::image::classname()
+       && image->size()[2] <= 1)
     {
-        if(!(*it)->send_object(_obj))
-        {
-            core::mt::scoped_lock lock(m_mutex);
-            (*it)->disconnect();
-            it = m_clients.erase(it);
-        }
-        else
+
+        const auto accepts = [](const client::sptr& _c){return _c->accepts_compressed_images();};
+        if(std::any_of(clients.begin(), clients.end(), accepts))
         {
-            ++it;
+            std::optional<detail::packed_message> compressed;
+            try
+            {
+                compressed = detail::packed_message::from_compressed_image(
+                    image,
+                    compression->first,
+                    compression->second
+                );
+            }
+            catch(const detail::exception::conversion& e)
+            {
+                SIGHT_WARN(std::string(e.what()) + ", images are no longer compressed.");
+                this->set_image_compression(std::nullopt);
+            }
+
+            if(compressed.has_value())
+            {
+                // The image message is only built for the clients that do not accept compressed images
+                if(std::all_of(clients.begin(), clients.end(), accepts))
+                {
+                    this->broadcast(clients, *compressed, nullptr);
+                }
+                else
+                {
+                    this->broadcast(clients, detail::packed_message::from_image(image), &*compressed);
+                }
+
+                return;
+            }
         }
     }
+
+    this->broadcast(clients, detail::packed_message::from_object(_obj), nullptr);
 }
 
 //------------------------------------------------------------------------------
 
 void server::broadcast(::igtl::MessageBase::Pointer _msg)
 {
-    std::vector<client::sptr>::iterator it;
+    this->broadcast(detail::packed_message::from_msg(_msg));
+}
+
+//------------------------------------------------------------------------------
+
+void server::broadcast(const detail::packed_message& _msg)
+{
+    // Like receive_headers(), which may hold the mutex while waiting for the network, the mutex is not held while
+    // sending
+    std::vector<client::sptr> clients;
+    {
+        core::mt::scoped_lock lock(m_mutex);
+        clients = m_clients;
+    }
+
+    this->broadcast(clients, _msg, nullptr);
+}
+
+//------------------------------------------------------------------------------
+
+void server::broadcast(
+    const std::vector<client::sptr>& _clients,
+    const detail::packed_message& _msg,
+    const detail::packed_message* _compressed
+)
+{
+    const auto send =
+        [&](const client::sptr& _client)
+        {
+            const bool compressed = _compressed != nullptr && _client->accepts_compressed_images();
+            return static_cast<char>(_client->send_packed(compressed ? *_compressed : _msg));
+        };
+
+    const std::size_t nb_clients = _clients.size();
+    std::vector<char> sent(nb_clients, 0);
+
+    // The senders are kept alive while sending, even if the server is stopped meanwhile
+    std::shared_ptr<core::thread::pool> senders;
+    if(nb_clients > 1)
+    {
+        core::mt::scoped_lock lock(m_mutex);
+        senders = m_senders;
+    }
 
-    for(it = m_clients.begin() ; it != m_clients.end() ; )
+    if(!senders)
     {
-        if(!(*it)->send_msg(_msg))
+        for(std::size_t i = 0 ; i < nb_clients ; ++i)
         {
-            core::mt::scoped_lock lock(m_mutex);
-            (*it)->disconnect();
-            it = m_clients.erase(it);
+            sent[i] = send(_clients[i]);
         }
-        else
+    }
+    else
+    {
+        // A slow client does not delay the others
+        core::thread::parallel_for(
+            0,
+            std::ptrdiff_t(nb_clients),
+            [&](std::ptrdiff_t _begin, std::ptrdiff_t _end)
+            {
+                for(std::ptrdiff_t i = _begin ; i < _end ; ++i)
+                {
+                    const auto index = static_cast<std::size_t>(i);
+                    sent[index] = send(_clients[index]);
+                }
+            },
+            nb_clients,
+            *senders
+        );
+    }
+
+    for(std::size_t i = 0 ; i < nb_clients ; ++i)
+    {
+        if(sent[i] == 0)
         {
-            ++it;
+            core::mt::scoped_lock lock(m_mutex);
+            _clients[i]->disconnect();
+            std::erase(m_clients, _clients[i]);
         }
     }
 }
 
 //------------------------------------------------------------------------------
 
+void server::set_image_compression(std::optional<bitmap::backend> _backend, bitmap::writer::mode _mode)
+{
+    core::mt::scoped_lock lock(m_mutex);
+    if(_backend.has_value())
+    {
+        m_compression = std::make_pair(*_backend, _mode);
+    }
+    else
+    {
+        m_compression.reset();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::optional<std::pair<bitmap::backend, bitmap::writer::mode> > server::image_compression() const
+{
+    core::mt::scoped_lock lock(m_mutex);
+    return m_compression;
+}
+
+//------------------------------------------------------------------------------
+
+bool server::compresses_images() const
+{
+    core::mt::scoped_lock lock(m_mutex);
+    return m_compression.has_value()
+           && std::any_of(
+        m_clients.begin(),
+        m_clients.end(),
+        [](const client::sptr& _client){return _client->accepts_compressed_images();});
+}
+
+//------------------------------------------------------------------------------
+
 void server::start(std::uint16_t _port)
 {
     core::mt::scoped_lock lock(m_mutex);
@@ -157,6 +380,7 @@ void server::start(std::uint16_t _port)
         throw exception("Cannot create server on port : " + std::to_string(_port));
     }
 
+    m_senders    = std::make_shared<core::thread::pool>(MAX_SENDERS);
     m_is_started = true;
 }
 
@@ -196,6 +420,9 @@ void server::stop()
 
     m_clients.clear();
 
+    // Broadcasts in progress keep their own reference
+    m_senders.reset();
+
     // HACK: patched version of closeSocket
     sight::io::igtl::network::close_socket(m_server_socket->m_SocketDescriptor);
     m_server_socket->m_SocketDescriptor = -1;
@@ -267,6 +494,14 @@ std::vector< ::igtl::MessageHeader::Pointer> server::receive_headers()
 
             if(header_msg->Unpack() == ::igtl::MessageBase::UNPACK_HEADER)
             {
+                // The query has no body and is not forwarded to the listeners
+                if(std::string(header_msg->GetDeviceType()) == detail::packed_message::COMPRESSED_IMAGE_QUERY)
+                {
+                    client->set_accepts_compressed_images(true);
+                    header_msgs.emplace_back();
+                    continue;
+                }
+
                 const std::string device_name = header_msg->GetDeviceName();
 
                 if(m_filtering_by_device_name)
@@ -30,13 +30,16 @@
 
 #include <core/exception.hpp>
 #include <core/mt/types.hpp>
+#include <core/thread/pool.hpp>
 
 #include <igtlServerSocket.h>
 
 #include <list>
+#include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
-#include <optional>
 
 namespace sight::io::igtl
 {
@@ -87,6 +90,8 @@ public:
 
     /**
      * @brief method to broadcast to all client the obj
+     *
+     * The object is converted once, then sent to the clients in parallel. Images are sent from their own buffer.
      */
     SIGHT_IO_IGTL_API void broadcast(const data::object::csptr& _obj);
 
@@ -95,6 +100,32 @@ public:
      */
     SIGHT_IO_IGTL_API void broadcast(::igtl::MessageBase::Pointer _msg);
 
+    /**
+     * @brief method to broadcast to all client a packed message, clients that fail to receive it are disconnected
+     */
+    SIGHT_IO_IGTL_API void broadcast(const detail::packed_message& _msg);
+
+    /**
+     * @brief enable the compression of 2D images sent to the clients that ask for it with a GET_COMPIMG query
+     *
+     * The query is expected right after the connection, or among the messages received from the client. Other clients
+     * keep receiving IMAGE messages. If an image can not be compressed by the backend, compression is disabled.
+     *
+     * @param[in] _backend io::bitmap backend used to encode the images, std::nullopt to disable compression
+     * @param[in] _mode FAST or BEST compression
+     */
+    SIGHT_IO_IGTL_API void set_image_compression(
+        std::optional<bitmap::backend> _backend,
+        bitmap::writer::mode _mode = bitmap::writer::mode::fast
+    );
+
+    /// Returns the backend and mode used to compress the images, if compression is enabled
+    [[nodiscard]] SIGHT_IO_IGTL_API std::optional<std::pair<bitmap::backend, bitmap::writer::mode> >
+    image_compression() const;
+
+    /// Returns true if compression is enabled and at least one client asked for compressed images
+    [[nodiscard]] SIGHT_IO_IGTL_API bool compresses_images() const;
+
     /**
      * @brief get the port
      *
@@ -156,6 +187,19 @@ private:
 
     static void remove_client(client::sptr _client);
 
+    /// Sends a message to the clients, or the compressed message to the clients that accept it, if any
+    void broadcast(
+        const std::vector<client::sptr>& _clients,
+        const detail::packed_message& _msg,
+        const detail::packed_message* _compressed
+    );
+
+    /// Waits a little for a GET_COMPIMG query from a new client, and only consumes it if it is one
+    static void receive_compression_query(client& _client);
+
+    /// Adds a new client, or disconnects it if the server is stopped
+    void add_client(const client::sptr& _client);
+
     /// server socket
     ::igtl::ServerSocket::Pointer m_server_socket;
 
@@ -179,6 +223,18 @@ private:
 
     /// Optional timeout for receiving message from clients
     std::optional<unsigned int> m_receive_timeout;
+
+    /// Threads sending a broadcast message to the clients, created by start() and reset by stop(), guarded by m_mutex
+    std::shared_ptr<core::thread::pool> m_senders;
+
+    /// Maximum number of threads sending a broadcast message
+    static constexpr std::size_t MAX_SENDERS = 8;
+
+    /// Backend and mode used to compress the images, if enabled, guarded by m_mutex
+    std::optional<std::pair<bitmap::backend, bitmap::writer::mode> > m_compression;
+
+    /// Time waited for a GET_COMPIMG query from a new client, in milliseconds
+    static constexpr int COMPRESSION_QUERY_TIMEOUT = 100;
 };
 
 //------------------------------------------------------------------------------
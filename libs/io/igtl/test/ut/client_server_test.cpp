@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2022-2023 IRCAD France
+ * Copyright (C) 2022-2024 IRCAD France
  *
  * This file is part of Sight.
  *
@@ -21,13 +21,22 @@
 
 #include "client_server_test.hpp"
 
+#include <core/spy_log.hpp>
+
+#include <data/frame_tl.hpp>
+#include <data/image.hpp>
+
 #include <io/igtl/client.hpp>
+#include <io/igtl/detail/data_converter.hpp>
 #include <io/igtl/detail/message_factory.hpp>
 #include <io/igtl/exception.hpp>
 #include <io/igtl/server.hpp>
 
 #include <igtlStringMessage.h>
 
+#include <chrono>
+#include <cstring>
+#include <numeric>
 #include <thread>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::io::igtl::ut::client_server_test);
@@ -44,6 +53,20 @@ static std::future<void> s_server_future;
 
 //------------------------------------------------------------------------------
 
+static data::image::sptr create_image(const data::image::size_t& _size, enum data::image::pixel_format _format)
+{
+    auto image = std::make_shared<data::image>();
+    image->resize(_size, core::type::UINT16, _format);
+    image->set_spacing({0.5, 0.25, 2.});
+    image->set_origin({1., 2., 3.});
+
+    const auto dump_lock = image->dump_lock();
+    std::iota(image->begin<std::uint16_t>(), image->end<std::uint16_t>(), std::uint16_t(0));
+    return image;
+}
+
+//------------------------------------------------------------------------------
+
 void client_server_test::setUp()
 {
     // Create server
@@ -309,4 +332,237 @@ void client_server_test::server_body_exception_test()
 
 //------------------------------------------------------------------------------
 
+void client_server_test::image_to_client()
+{
+    const auto image = create_image({64, 32, 8}, data::image::pixel_format::rgb);
+
+    CPPUNIT_ASSERT_MESSAGE("Number of connected client", s_server->num_clients() == 1);
+    s_server->broadcast(image);
+
+    std::string device_name;
+    data::object::sptr obj;
+    CPPUNIT_ASSERT_NO_THROW(obj = s_client->receive_object(device_name));
+    CPPUNIT_ASSERT_EQUAL(std::string("Sight_Tests_Server"), device_name);
+
+    const auto received = std::dynamic_pointer_cast<data::image>(obj);
+    CPPUNIT_ASSERT(received);
+    CPPUNIT_ASSERT(image->size() == received->size());
+    CPPUNIT_ASSERT(image->type() == received->type());
+    CPPUNIT_ASSERT_EQUAL(image->pixel_format(), received->pixel_format());
+    CPPUNIT_ASSERT(image->spacing() == received->spacing());
+    CPPUNIT_ASSERT(image->origin() == received->origin());
+
+    const auto dump_lock          = image->dump_lock();
+    const auto received_dump_lock = received->dump_lock();
+    CPPUNIT_ASSERT_EQUAL(image->size_in_bytes(), received->size_in_bytes());
+    CPPUNIT_ASSERT(std::memcmp(image->buffer(), received->buffer(), image->size_in_bytes()) == 0);
+}
+
+//------------------------------------------------------------------------------
+
+void client_server_test::image_to_frame_tl()
+{
+    const auto image = create_image({64, 32, 0}, data::image::pixel_format::rgba);
+    auto timeline    = std::make_shared<data::frame_tl>();
+
+    s_server->broadcast(image);
+
+    ::igtl::MessageHeader::Pointer header;
+    CPPUNIT_ASSERT_NO_THROW(header = s_client->receive_header());
+    CPPUNIT_ASSERT(header);
+
+    sight::io::igtl::network::frame_t frame;
+    CPPUNIT_ASSERT_NO_THROW(frame = s_client->receive_frame(header, *timeline, 42.));
+    auto buffer = std::get<SPTR(data::frame_tl::buffer_t)>(frame);
+    CPPUNIT_ASSERT(buffer);
+    CPPUNIT_ASSERT_EQUAL(42., buffer->get_timestamp());
+
+    // The timeline is initialized with the format of the image
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64), timeline->get_width());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(32), timeline->get_height());
+    CPPUNIT_ASSERT(core::type::UINT16 == timeline->type());
+    CPPUNIT_ASSERT(data::frame_tl::pixel_format::rgba == timeline->pixel_format());
+
+    const auto dump_lock = image->dump_lock();
+    CPPUNIT_ASSERT(std::memcmp(image->buffer(), &buffer->get_element(0), image->size_in_bytes()) == 0);
+
+    // Other messages are received as regular messages, and the next message can still be read
+    ::igtl::StringMessage::Pointer string_msg = ::igtl::StringMessage::New();
+    string_msg->SetString("Hello from server!");
+    s_server->broadcast(static_cast< ::igtl::MessageBase::Pointer>(string_msg));
+
+    // Volumes and 2 components images do not fit in a frame, they are received for the generic converter
+    const auto volume = create_image({16, 8, 4}, data::image::pixel_format::gray_scale);
+    s_server->broadcast(volume);
+    const auto two_components = create_image({16, 8, 0}, data::image::pixel_format::rg);
+    s_server->broadcast(two_components);
+    s_server->broadcast(image);
+
+    CPPUNIT_ASSERT_NO_THROW(header = s_client->receive_header());
+    CPPUNIT_ASSERT_NO_THROW(frame = s_client->receive_frame(header, *timeline, 43.));
+    auto* msg = std::get_if< ::igtl::MessageBase::Pointer>(&frame);
+    CPPUNIT_ASSERT(msg != nullptr && msg->IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(std::string("STRING"), std::string((*msg)->GetDeviceType()));
+
+    for(const auto& expected : {volume, two_components})
+    {
+        CPPUNIT_ASSERT_NO_THROW(header = s_client->receive_header());
+        CPPUNIT_ASSERT_NO_THROW(frame = s_client->receive_frame(header, *timeline, 44.));
+        msg = std::get_if< ::igtl::MessageBase::Pointer>(&frame);
+        CPPUNIT_ASSERT(msg != nullptr && msg->IsNotNull());
+
+        const auto received = std::dynamic_pointer_cast<data::image>(
+            detail::data_converter::get_instance()->from_igtl_message(*msg)
+        );
+        CPPUNIT_ASSERT(received);
+        CPPUNIT_ASSERT(expected->size() == received->size());
+        CPPUNIT_ASSERT_EQUAL(expected->pixel_format(), received->pixel_format());
+
+        const auto expected_dump_lock = expected->dump_lock();
+        const auto received_dump_lock = received->dump_lock();
+        CPPUNIT_ASSERT(std::memcmp(expected->buffer(), received->buffer(), expected->size_in_bytes()) == 0);
+    }
+
+    // The timeline is left untouched by the other messages
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64), timeline->get_width());
+
+    CPPUNIT_ASSERT_NO_THROW(header = s_client->receive_header());
+    CPPUNIT_ASSERT_NO_THROW(frame = s_client->receive_frame(header, *timeline, 45.));
+    buffer = std::get<SPTR(data::frame_tl::buffer_t)>(frame);
+    CPPUNIT_ASSERT(std::memcmp(image->buffer(), &buffer->get_element(0), image->size_in_bytes()) == 0);
+}
+
+//------------------------------------------------------------------------------
+
+void client_server_test::compressed_image_to_client()
+{
+    CPPUNIT_ASSERT(!s_server->image_compression().has_value());
+    s_server->set_image_compression(sight::io::bitmap::backend::libpng);
+    CPPUNIT_ASSERT(s_server->image_compression().has_value());
+
+    // s_client did not ask for compressed images
+    CPPUNIT_ASSERT(!s_server->compresses_images());
+
+    // This client asks for compressed images, while s_client does not
+    auto compressed_client = std::make_shared<sight::io::igtl::client>();
+    compressed_client->connect("127.0.0.1", s_server->get_port());
+    compressed_client->add_authorized_device("Sight_Tests_Server");
+    CPPUNIT_ASSERT(compressed_client->request_compressed_images());
+
+    std::uint32_t timeout = 0;
+    while(s_server->num_clients() < 2 && timeout < 1000)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        timeout += 100;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), s_server->num_clients());
+    CPPUNIT_ASSERT(s_server->compresses_images());
+    s_server->set_message_device_name("Sight_Tests_Server");
+
+    const auto image = create_image({64, 32, 0}, data::image::pixel_format::rgb);
+    s_server->broadcast(image);
+
+    const auto check =
+        [&](sight::io::igtl::client& _client, const std::string& _expected_type)
+        {
+            ::igtl::MessageHeader::Pointer header;
+            CPPUNIT_ASSERT_NO_THROW(header = _client.receive_header());
+            CPPUNIT_ASSERT(header);
+            CPPUNIT_ASSERT_EQUAL(_expected_type, std::string(header->GetDeviceType()));
+
+            ::igtl::MessageBase::Pointer msg;
+            CPPUNIT_ASSERT_NO_THROW(msg = _client.receive_body(header));
+            const auto received = std::dynamic_pointer_cast<data::image>(
+                detail::data_converter::get_instance()->from_igtl_message(msg)
+            );
+            CPPUNIT_ASSERT(received);
+            CPPUNIT_ASSERT_EQUAL(image->size()[0], received->size()[0]);
+            CPPUNIT_ASSERT_EQUAL(image->size()[1], received->size()[1]);
+            CPPUNIT_ASSERT(image->type() == received->type());
+            CPPUNIT_ASSERT(image->spacing() == received->spacing());
+            CPPUNIT_ASSERT(image->origin() == received->origin());
+
+            // PNG is lossless
+            const auto dump_lock          = image->dump_lock();
+            const auto received_dump_lock = received->dump_lock();
+            CPPUNIT_ASSERT_EQUAL(image->size_in_bytes(), received->size_in_bytes());
+            CPPUNIT_ASSERT(std::memcmp(image->buffer(), received->buffer(), image->size_in_bytes()) == 0);
+        };
+
+    check(*compressed_client, "COMPIMG");
+    check(*s_client, "IMAGE");
+
+    compressed_client->disconnect();
+}
+
+//------------------------------------------------------------------------------
+
+void client_server_test::benchmark_image_streaming()
+{
+    // Only run when profiling
+    if(std::getenv("PROFILETEST_LOOP") == nullptr)
+    {
+        return;
+    }
+
+    // A 3D ultrasound volume
+    const auto image                 = create_image({256, 256, 64}, data::image::pixel_format::gray_scale);
+    constexpr std::size_t nb_volumes = 50;
+
+    const auto run =
+        [&](const std::string& _label, const auto& _send, const auto& _receive)
+        {
+            std::thread sender(
+                [&]
+                {
+                    for(std::size_t i = 0 ; i < nb_volumes ; ++i)
+                    {
+                        _send();
+                    }
+                });
+
+            const auto start = std::chrono::steady_clock::now();
+            for(std::size_t i = 0 ; i < nb_volumes ; ++i)
+            {
+                _receive();
+            }
+
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            sender.join();
+
+            SIGHT_INFO(
+                "igtl - " << _label << ": " << static_cast<double>(nb_volumes) / elapsed << " messages/s, "
+                << static_cast<double>(nb_volumes * image->size_in_bytes()) / elapsed / 1e6 << " MB/s"
+            );
+        };
+
+    const auto receive =
+        [&]
+        {
+            std::string device_name;
+            CPPUNIT_ASSERT(s_client->receive_object(device_name));
+        };
+
+    // Former path: the image is copied into an igtl::ImageMessage, which is then packed
+    run(
+        "image message",
+        [&]
+        {
+            ::igtl::MessageBase::Pointer msg;
+            {
+                const auto dump_lock = image->dump_lock();
+                msg = detail::data_converter::get_instance()->from_fw_object(image);
+            }
+            s_server->broadcast(msg);
+        },
+        receive
+    );
+
+    // Packed path: the header is serialized on the stack and the pixels are sent from the image buffer
+    run("packed image", [&]{s_server->broadcast(image);}, receive);
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::io::igtl::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2022-2023 IRCAD France
+ * Copyright (C) 2022-2024 IRCAD France
  *
  * This file is part of Sight.
  *
@@ -36,6 +36,10 @@ CPPUNIT_TEST(client_header_exception_test);
 CPPUNIT_TEST(server_header_exception_test);
 CPPUNIT_TEST(client_body_exception_test);
 CPPUNIT_TEST(server_body_exception_test);
+CPPUNIT_TEST(image_to_client);
+CPPUNIT_TEST(image_to_frame_tl);
+CPPUNIT_TEST(compressed_image_to_client);
+CPPUNIT_TEST(benchmark_image_streaming);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -49,6 +53,10 @@ public:
     static void server_header_exception_test();
     static void client_body_exception_test();
     static void server_body_exception_test();
+    static void image_to_client();
+    static void image_to_frame_tl();
+    static void compressed_image_to_client();
+    static void benchmark_image_streaming();
 };
 
 } // namespace sight::io::igtl::ut
@@ -23,6 +23,7 @@
 
 #include <sight/io/session/config.hpp>
 
+#include "io/session/detail/core/lazy_stream.hpp"
 #include "io/session/helper.hpp"
 #include "io/session/macros.hpp"
 
@@ -50,8 +51,8 @@ inline static void write(
 {
     const auto array = helper::safe_cast<data::array>(_object);
 
-    // Add a version number. Not mandatory, but could help for future release
-    helper::write_version<data::array>(_tree, 1);
+    // Add a version number. Version 2 adds a raw header in front of the buffer.
+    helper::write_version<data::array>(_tree, 2);
 
     // Size
     boost::property_tree::ptree sizes_tree;
@@ -73,9 +74,10 @@ inline static void write(
         _password
     );
 
-    // Write back to the archive
-    const auto& buffer = array->get_buffer_object();
-    ostream->write(static_cast<const char*>(buffer->buffer()), static_cast<std::streamsize>(buffer->size()));
+    // Write back to the archive, straight from the locked buffer
+    const auto dump_lock = array->dump_lock();
+    const auto& buffer   = array->get_buffer_object();
+    helper::write_raw(*ostream, buffer->buffer(), buffer->size());
 }
 
 //------------------------------------------------------------------------------
@@ -92,7 +94,7 @@ inline static data::array::sptr read(
     auto array = helper::cast_or_create<data::array>(_object);
 
     // Check version number. Not mandatory, but could help for future release
-    helper::read_version<data::array>(_tree, 0, 1);
+    const auto version = helper::read_version<data::array>(_tree, 0, 2);
 
     // IsBufferOwner
     array->set_is_buffer_owner(_tree.get<bool>(IS_BUFFER_OWNER, false));
@@ -106,6 +108,23 @@ inline static data::array::sptr read(
         sizes.push_back(size);
     }
 
+    const auto& uuid      = _tree.get<std::string>(UUID);
+    const auto& file_path = std::filesystem::path(uuid + ARRAY);
+
+    if(!sizes.empty() && version >= 2 && detail::is_lazy_loading())
+    {
+        // Only set the array information: the buffer will be read from the archive the first time it is locked
+        array->set_buffer(nullptr, true, sizes, _tree.get<std::string>(TYPE));
+
+        // An empty array has nothing to load
+        if(const auto size_in_bytes = array->size_in_bytes(); size_in_bytes > 0)
+        {
+            detail::set_lazy_stream(array->get_buffer_object(), _archive, file_path, _password, size_in_bytes);
+        }
+
+        return array;
+    }
+
     if(!sizes.empty())
     {
         array->resize(sizes, _tree.get<std::string>(TYPE), true);
@@ -116,13 +135,17 @@ inline static data::array::sptr read(
     core::memory::buffer_object::lock_t locker_source(buffer_object);
 
     // Create the istream from the input file inside the archive
-    const auto& uuid    = _tree.get<std::string>(UUID);
-    const auto& istream = _archive.open_file(
-        std::filesystem::path(uuid + ARRAY),
-        _password
-    );
+    const auto& istream = _archive.open_file(file_path, _password);
 
-    istream->read(static_cast<char*>(buffer_object->buffer()), static_cast<std::streamsize>(buffer_object->size()));
+    if(version < 2)
+    {
+        // Legacy format, without header
+        istream->read(static_cast<char*>(locker_source.buffer()), static_cast<std::streamsize>(buffer_object->size()));
+    }
+    else
+    {
+        helper::read_raw(*istream, locker_source.buffer(), buffer_object->size());
+    }
 
     return array;
 }
@@ -0,0 +1,194 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "lazy_stream.hpp"
+
+#include <core/memory/buffer_manager.hpp>
+
+#include <data/object.hpp>
+
+#include <io/session/helper.hpp>
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sight::io::session::detail
+{
+
+//------------------------------------------------------------------------------
+
+/// Keeps the archive alive as long as the stream of one of its files is used
+class archive_istream final : public std::istream
+{
+public:
+
+    archive_istream(zip::archive_reader::uptr _archive, std::unique_ptr<std::istream> _istream) :
+        std::istream(_istream->rdbuf()),
+        m_archive(std::move(_archive)),
+        m_istream(std::move(_istream))
+    {
+    }
+
+private:
+
+    zip::archive_reader::uptr m_archive;
+    std::unique_ptr<std::istream> m_istream;
+};
+
+//------------------------------------------------------------------------------
+
+/// Lazy loading state of the current thread, set by lazy_loading_scope
+thread_local bool g_lazy_loading = false;
+
+//------------------------------------------------------------------------------
+
+struct lazy_registry
+{
+    std::map<std::filesystem::path, std::vector<std::weak_ptr<core::memory::buffer_object> > > buffers;
+    std::mutex mutex;
+};
+
+//------------------------------------------------------------------------------
+
+static lazy_registry& get_lazy_registry()
+{
+    static lazy_registry registry;
+    return registry;
+}
+
+//------------------------------------------------------------------------------
+
+lazy_stream::lazy_stream(
+    const zip::archive_reader& _archive,
+    std::filesystem::path _file_path,
+    core::crypto::secure_string _password,
+    std::size_t _size
+) :
+    m_archive_path(_archive.get_archive_path()),
+    m_format(_archive.is_raw() ? zip::archive::archive_format::filesystem : zip::archive::archive_format::DEFAULT),
+    m_file_path(std::move(_file_path)),
+    m_password(std::move(_password)),
+    m_size(_size)
+{
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(std::istream) lazy_stream::get()
+{
+    SIGHT_THROW_IF(
+        "Archive '" << m_archive_path.string() << "' does not exist anymore or has been moved.",
+        !std::filesystem::exists(m_archive_path)
+    );
+
+    auto archive        = zip::archive_reader::get(m_archive_path, m_format);
+    auto archive_stream = archive->open_file(m_file_path, m_password);
+    auto istream        = std::make_shared<archive_istream>(std::move(archive), std::move(archive_stream));
+
+    // Check the header, the stream is then positioned at the beginning of the data
+    helper::read_raw_header(*istream, m_size);
+
+    return istream;
+}
+
+//------------------------------------------------------------------------------
+
+lazy_loading_scope::lazy_loading_scope(bool _lazy_loading) :
+    m_previous(std::exchange(g_lazy_loading, _lazy_loading))
+{
+}
+
+//------------------------------------------------------------------------------
+
+lazy_loading_scope::~lazy_loading_scope()
+{
+    g_lazy_loading = m_previous;
+}
+
+//------------------------------------------------------------------------------
+
+bool is_lazy_loading()
+{
+    return g_lazy_loading;
+}
+
+//------------------------------------------------------------------------------
+
+void set_lazy_stream(
+    const core::memory::buffer_object::sptr& _buffer,
+    const zip::archive_reader& _archive,
+    const std::filesystem::path& _file_path,
+    const core::crypto::secure_string& _password,
+    std::size_t _size
+)
+{
+    // The buffer is loaded on demand, whatever the loading mode of the buffer manager is
+    _buffer->set_istream_factory(
+        std::make_shared<lazy_stream>(_archive, _file_path, _password, _size),
+        _size,
+        "",
+        core::memory::other,
+        std::make_shared<core::memory::buffer_malloc_policy>(),
+        core::memory::buffer_manager::lazy
+    );
+
+    // Remember the buffer, to be able to load it before the archive is overwritten
+    auto& registry = get_lazy_registry();
+    std::unique_lock lock(registry.mutex);
+    auto& buffers = registry.buffers[std::filesystem::weakly_canonical(_archive.get_archive_path())];
+
+    if(buffers.size() == buffers.capacity())
+    {
+        std::erase_if(buffers, [](const auto& _buffer){return _buffer.expired();});
+    }
+
+    buffers.emplace_back(_buffer);
+}
+
+//------------------------------------------------------------------------------
+
+void restore_lazy_buffers(const std::filesystem::path& _archive_path)
+{
+    std::vector<std::weak_ptr<core::memory::buffer_object> > buffers;
+    {
+        auto& registry = get_lazy_registry();
+        std::unique_lock lock(registry.mutex);
+        if(const auto& it = registry.buffers.find(std::filesystem::weakly_canonical(_archive_path));
+           it != registry.buffers.end())
+        {
+            buffers.swap(it->second);
+            registry.buffers.erase(it);
+        }
+    }
+
+    for(const auto& weak_buffer : buffers)
+    {
+        if(const auto buffer = weak_buffer.lock(); buffer)
+        {
+            // Locking the buffer loads it
+            const core::memory::buffer_object::lock_t lock(buffer);
+        }
+    }
+}
+
+} // namespace sight::io::session::detail
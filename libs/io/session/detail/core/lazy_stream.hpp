@@ -0,0 +1,119 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <sight/io/session/config.hpp>
+
+#include <core/crypto/secure_string.hpp>
+#include <core/memory/buffer_object.hpp>
+#include <core/memory/stream/in/factory.hpp>
+
+#include <io/zip/archive_reader.hpp>
+
+#include <filesystem>
+
+namespace sight::io::session::detail
+{
+
+/**
+ * @brief Stream factory that reads a raw payload from a session archive, on demand.
+ *
+ * It allows core::memory::buffer_manager to load the buffer the first time it is locked, when the session reader is
+ * configured for lazy loading. The archive is opened again each time a stream is requested, so the factory does not
+ * keep any file open.
+ */
+class lazy_stream final : public core::memory::stream::in::factory
+{
+public:
+
+    /// Constructor
+    /// @param _archive the archive which contains the payload
+    /// @param _file_path the path of the file in the archive
+    /// @param _password the password needed to decrypt the file
+    /// @param _size the size of the payload, without its raw header
+    lazy_stream(
+        const zip::archive_reader& _archive,
+        std::filesystem::path _file_path,
+        core::crypto::secure_string _password,
+        std::size_t _size
+    );
+
+protected:
+
+    /// Opens the archive and returns a stream positioned after the raw header of the payload
+    SPTR(std::istream) get() override;
+
+private:
+
+    const std::filesystem::path m_archive_path;
+    const zip::archive::archive_format m_format;
+    const std::filesystem::path m_file_path;
+    const core::crypto::secure_string m_password;
+    const std::size_t m_size;
+};
+
+/// Enables or disables the lazy loading of the session payloads read by the calling thread, as long as it lives
+class lazy_loading_scope final
+{
+public:
+
+    /// Delete default constructors and assignment operators
+    lazy_loading_scope(const lazy_loading_scope&)            = delete;
+    lazy_loading_scope(lazy_loading_scope&&)                 = delete;
+    lazy_loading_scope& operator=(const lazy_loading_scope&) = delete;
+    lazy_loading_scope& operator=(lazy_loading_scope&&)      = delete;
+
+    /// Constructor
+    /// @param _lazy_loading if true, the payloads read by the calling thread are loaded on demand
+    explicit lazy_loading_scope(bool _lazy_loading);
+
+    /// Destructor, restores the previous state
+    ~lazy_loading_scope();
+
+private:
+
+    const bool m_previous;
+};
+
+/// Returns true if the session payloads read by the calling thread must be loaded on demand
+/// @see lazy_loading_scope
+bool is_lazy_loading();
+
+/// Binds a buffer to a raw payload of a session archive. The buffer is released, and will be loaded on demand.
+/// @param _buffer the buffer object to bind. Its size must match the payload one
+/// @param _archive the archive which contains the payload
+/// @param _file_path the path of the file in the archive
+/// @param _password the password needed to decrypt the file
+/// @param _size the size of the payload
+void set_lazy_stream(
+    const core::memory::buffer_object::sptr& _buffer,
+    const zip::archive_reader& _archive,
+    const std::filesystem::path& _file_path,
+    const core::crypto::secure_string& _password,
+    std::size_t _size
+);
+
+/// Loads all the buffers which are still bound to a given archive. This must be done before overwriting it.
+/// @param _archive_path the path of the archive, or of the root folder for the filesystem format
+void restore_lazy_buffers(const std::filesystem::path& _archive_path);
+
+} // namespace sight::io::session::detail
@@ -21,6 +21,8 @@
 
 #include "session_deserializer.hpp"
 
+#include "lazy_stream.hpp"
+
 #include <data/mt/locked_ptr.hpp>
 
 #include <io/session/helper.hpp>
@@ -240,7 +242,8 @@ data::object::sptr session_deserializer::deserialize(
     const std::filesystem::path& _archive_path,
     const archive::archive_format _archive_format,
     const secure_string& _password,
-    const password_keeper::encryption_policy _encryption_policy
+    const password_keeper::encryption_policy _encryption_policy,
+    bool _lazy_loading
 ) const
 {
     zip::archive_reader::uptr archive;
@@ -284,6 +287,9 @@ data::object::sptr session_deserializer::deserialize(
     // Initialize the object cache
     std::map<std::string, data::object::sptr> cache;
 
+    // Tells the deserializers whether they can defer the loading of the payloads
+    const lazy_loading_scope lazy_loading(_lazy_loading);
+
     return deep_deserialize(cache, *archive, tree, _password, _encryption_policy);
 }
 
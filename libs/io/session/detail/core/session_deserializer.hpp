@@ -61,12 +61,14 @@ public:
     /// @param _archive_format how files are stored in the archive. @see sight::io::zip::archive::archiveFormat
     /// @param _password password to use for optional decryption. Empty password means no decryption
     /// @param _encryption_policy the encryption policy: @see sight::io::session::password_keeper::encryption_policy
+    /// @param _lazy_loading if true, image and array payloads are read from the archive the first time they are locked
     sight::data::object::sptr deserialize(
         const std::filesystem::path& _archive_path,
         io::zip::archive::archive_format _archive_format                    = io::zip::archive::archive_format::DEFAULT,
         const core::crypto::secure_string& _password                        = "",
         core::crypto::password_keeper::encryption_policy _encryption_policy = core::crypto::password_keeper::
-        encryption_policy::password
+        encryption_policy::password,
+        bool _lazy_loading                                                  = false
     ) const;
 
     /// Set a deserialization function for an object
@@ -21,6 +21,8 @@
 
 #include "session_serializer.hpp"
 
+#include "lazy_stream.hpp"
+
 #include <data/mt/locked_ptr.hpp>
 
 #include <io/session/helper.hpp>
@@ -258,13 +260,20 @@ void session_serializer::serialize(
             SIGHT_ERROR(message);
         }
 
+        // Buffers lazily loaded from the archive must be loaded before it is overwritten
+        restore_lazy_buffers(_archive_path.parent_path());
+
         // Create the archive that will hold all binary files
         archive = zip::archive_writer::get(_archive_path.parent_path(), _archive_format);
     }
     else
     {
+        // Buffers lazily loaded from the archive must be loaded before it is overwritten
+        restore_lazy_buffers(_archive_path);
+
         // Create the archive that will hold the property tree and all binary files
-        archive = zip::archive_writer::get(_archive_path, _archive_format);
+        // Files are compressed concurrently while the objects are serialized
+        archive = zip::archive_writer::get(_archive_path, _archive_format, true);
     }
 
     // Initialize the ptree cache
@@ -283,11 +292,16 @@ void session_serializer::serialize(
     }
     else
     {
-        // Open the ostream from the json stored into the archive
-        auto ostream = archive->open_file(get_index_file_path(), _password, zip::method::DEFAULT, zip::level::best);
+        {
+            // Open the ostream from the json stored into the archive
+            auto ostream = archive->open_file(get_index_file_path(), _password, zip::method::DEFAULT, zip::level::best);
+
+            // Write the final property tree back to the archive
+            boost::property_tree::write_json(*ostream, tree, false);
+        }
 
-        // Write the final property tree back to the archive
-        boost::property_tree::write_json(*ostream, tree, false);
+        // Wait for all files to be compressed and written, reporting the errors
+        archive->flush();
     }
 }
 
@@ -23,6 +23,7 @@
 
 #include <sight/io/session/config.hpp>
 
+#include "io/session/detail/core/lazy_stream.hpp"
 #include "io/session/helper.hpp"
 #include "io/session/macros.hpp"
 
@@ -33,9 +34,6 @@
 #include <vtkImageData.h>
 #include <vtkSmartPointer.h>
 #include <vtkXMLImageDataReader.h>
-#include <vtkXMLImageDataWriter.h>
-
-#define USE_VTK
 
 namespace sight::io::session::detail::image
 {
@@ -59,13 +57,10 @@ constexpr static auto DEPTH {"Depth"};
 
 //------------------------------------------------------------------------------
 
-inline static std::filesystem::path get_file_path(const std::string& _uuid)
+inline static std::filesystem::path get_file_path(const std::string& _uuid, const int _version = 2)
 {
-#if defined(USE_VTK)
-    constexpr auto ext = ".vti";
-#else
-    constexpr auto ext = ".raw";
-#endif
+    // Version 1 stored the pixels in a VTK XML file, version 2 stores them as a raw payload
+    const auto* const ext = _version < 2 ? ".vti" : ".raw";
 
     return std::filesystem::path(_uuid + "/" + data::image::leaf_classname() + ext);
 }
@@ -82,8 +77,8 @@ inline static void write(
 {
     auto image = helper::safe_cast<data::image>(_object);
 
-    // Add a version number. Not mandatory, but could help for future release
-    helper::write_version<data::image>(_tree, 1);
+    // Add a version number. Version 2 replaces the VTK XML file by a raw payload.
+    helper::write_version<data::image>(_tree, 2);
 
     // Serialize image
     const auto& size = image->size();
@@ -138,29 +133,9 @@ inline static void write(
         sight::io::zip::level::best
     );
 
-#if defined(USE_VTK)
-    /// @todo For now, toVTKImage doesn't handle all pixel formats we handle. For example, BGR is written as RGB.
-    /// It should be better to convert it, even if, here we don't really care as we save the real pixel format and
-    /// restore it back. It is faster, but produce a non standard vti file.
-    auto vtk_image = vtkSmartPointer<vtkImageData>::New();
-    io::vtk::to_vtk_image(image, vtk_image);
-
-    // Create the vtk writer
-    const auto& vtk_writer = vtkSmartPointer<vtkXMLImageDataWriter>::New();
-    vtk_writer->SetCompressorTypeToNone();
-    vtk_writer->SetDataModeToBinary();
-    vtk_writer->WriteToOutputStringOn();
-    vtk_writer->SetInputData(vtk_image);
-
-    // Write to internal string...
-    vtk_writer->Update();
-
-    // Write back to the archive
-    (*ostream) << vtk_writer->GetOutputString();
-#else
-    // Write the image data as raw bytes
-    ostream->write(reinterpret_cast<const char*>(image->buffer()), std::streamsize(image->size_in_bytes()));
-#endif
+    // Write the image data as a raw payload, straight from the locked buffer
+    const auto dump_lock = image->dump_lock();
+    helper::write_raw(*ostream, image->buffer(), image->size_in_bytes());
 }
 
 //------------------------------------------------------------------------------
@@ -174,11 +149,10 @@ inline static data::image::sptr read(
 )
 {
     // Create or reuse the object
-    auto image           = helper::cast_or_create<data::image>(_object);
-    const auto dump_lock = image->dump_lock();
+    auto image = helper::cast_or_create<data::image>(_object);
 
     // Check version number. Not mandatory, but could help for future release
-    helper::read_version<data::image>(_tree, 0, 1);
+    const auto version = helper::read_version<data::image>(_tree, 0, 2);
 
     // Deserialize image
     const auto& size_tree          = _tree.get_child(SIZE);
@@ -232,38 +206,52 @@ inline static data::image::sptr read(
     }
 
     const auto& serialized_uuid = _tree.get<std::string>(UUID);
+    const auto& file_path       = get_file_path(serialized_uuid, version);
+
+    if(version >= 2 && detail::is_lazy_loading())
+    {
+        // Only set the image information: the pixels will be read from the archive the first time the buffer is locked
+        image->set_buffer(nullptr, true, type, size, format);
+
+        // An empty image has nothing to load
+        if(const auto size_in_bytes = image->size_in_bytes(); size_in_bytes > 0)
+        {
+            detail::set_lazy_stream(image->get_buffer_object(), _archive, file_path, _password, size_in_bytes);
+        }
+
+        return image;
+    }
+
+    const auto dump_lock = image->dump_lock();
 
     // Read the image data
     // Create the istream from the input file inside the archive
-    const auto& istream = _archive.open_file(
-        get_file_path(serialized_uuid),
-        _password
-    );
+    const auto& istream = _archive.open_file(file_path, _password);
+
+    if(version < 2)
+    {
+        // "Convert" it to a string
+        const std::string content {std::istreambuf_iterator<char>(*istream), std::istreambuf_iterator<char>()};
 
-#if defined(USE_VTK)
-    // "Convert" it to a string
-    const std::string content {std::istreambuf_iterator<char>(*istream), std::istreambuf_iterator<char>()};
-
-    // Create the vtk reader
-    auto vtk_reader = vtkSmartPointer<vtkXMLImageDataReader>::New();
-    vtk_reader->ReadFromInputStringOn();
-    vtk_reader->SetInputString(content);
-    vtk_reader->Update();
-
-    // Convert from VTK
-    io::vtk::from_vtk_image(vtk_reader->GetOutput(), image);
-#endif
-
-    /// @todo We should convert VTK RGB back to BGR if the original image is BGR and we produced a real vti files by
-    /// converting BGR to RGB, which is not the case right now (see io::vtk::toVTKImage). For now, we simply switch
-    /// back
-    /// to the correct pixel type.
-    image->resize(size, type, format);
-
-#if !defined(USE_VTK)
-    // Read the image data as raw bytes
-    istream->read(reinterpret_cast<char*>(image->buffer()), std::streamsize(image->size_in_bytes()));
-#endif
+        // Create the vtk reader
+        auto vtk_reader = vtkSmartPointer<vtkXMLImageDataReader>::New();
+        vtk_reader->ReadFromInputStringOn();
+        vtk_reader->SetInputString(content);
+        vtk_reader->Update();
+
+        // Convert from VTK
+        io::vtk::from_vtk_image(vtk_reader->GetOutput(), image);
+
+        /// @note VTK RGB images are not converted back to BGR, as the BGR images were written as RGB ones, so we
+        /// simply switch back to the correct pixel type.
+        image->resize(size, type, format);
+    }
+    else
+    {
+        // Read the image data as a raw payload, straight into the image buffer
+        image->resize(size, type, format);
+        helper::read_raw(*istream, image->buffer(), image->size_in_bytes());
+    }
 
     return image;
 }
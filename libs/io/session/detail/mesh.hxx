@@ -33,13 +33,90 @@
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 #include <vtkXMLPolyDataReader.h>
-#include <vtkXMLPolyDataWriter.h>
 
 namespace sight::io::session::detail::mesh
 {
 
 constexpr static auto UUID {"uuid"};
 constexpr static auto MESH {"/mesh.vtp"};
+constexpr static auto MESH_RAW {"/mesh.raw"};
+constexpr static auto NUM_POINTS {"NumPoints"};
+constexpr static auto NUM_CELLS {"NumCells"};
+constexpr static auto CELL_TYPE {"CellType"};
+constexpr static auto ATTRIBUTES {"Attributes"};
+
+//------------------------------------------------------------------------------
+
+/// Calls _func for each array of the mesh, in serialization order, with the iterator type and the number of elements
+template<typename F>
+inline static void for_each_array(data::mesh::cell_type_t _cell_type, data::mesh::attribute _attributes, F&& _func)
+{
+    namespace point = data::iterator::point;
+    namespace cell  = data::iterator::cell;
+
+    const auto has = [_attributes](data::mesh::attribute _attribute)
+                     {
+                         return static_cast<bool>(_attributes & _attribute);
+                     };
+
+    _func(point::xyz {}, true);
+
+    switch(_cell_type)
+    {
+        case data::mesh::cell_type_t::point:
+            _func(cell::point {}, false);
+            break;
+
+        case data::mesh::cell_type_t::line:
+            _func(cell::line {}, false);
+            break;
+
+        case data::mesh::cell_type_t::triangle:
+            _func(cell::triangle {}, false);
+            break;
+
+        case data::mesh::cell_type_t::quad:
+            _func(cell::quad {}, false);
+            break;
+
+        case data::mesh::cell_type_t::tetra:
+            _func(cell::tetra {}, false);
+            break;
+
+        default:
+            SIGHT_THROW("Unsupported cell type '" << static_cast<int>(_cell_type) << "'.");
+    }
+
+    if(has(data::mesh::attribute::point_colors))
+    {
+        _func(point::rgba {}, true);
+    }
+
+    if(has(data::mesh::attribute::point_normals))
+    {
+        _func(point::nxyz {}, true);
+    }
+
+    if(has(data::mesh::attribute::point_tex_coords))
+    {
+        _func(point::uv {}, true);
+    }
+
+    if(has(data::mesh::attribute::cell_colors))
+    {
+        _func(cell::rgba {}, false);
+    }
+
+    if(has(data::mesh::attribute::cell_normals))
+    {
+        _func(cell::nxyz {}, false);
+    }
+
+    if(has(data::mesh::attribute::cell_tex_coords))
+    {
+        _func(cell::uv {}, false);
+    }
+}
 
 //------------------------------------------------------------------------------
 
@@ -53,31 +130,46 @@ inline static void write(
 {
     const auto mesh = helper::safe_cast<data::mesh>(_object);
 
-    // Add a version number. Not mandatory, but could help for future release
-    helper::write_version<data::mesh>(_tree, 1);
+    // Add a version number. Version 2 replaces the VTK XML file by raw payloads.
+    helper::write_version<data::mesh>(_tree, 2);
 
-    // Convert the mesh to VTK
-    const auto& vtk_mesh = vtkSmartPointer<vtkPolyData>::New();
-    io::vtk::helper::mesh::to_vtk_mesh(mesh, vtk_mesh);
+    const auto num_points = mesh->num_points();
+    const auto num_cells  = mesh->num_cells();
+    const auto cell_type  = mesh->cell_type();
+    const auto attributes = mesh->attributes();
 
-    // Create the vtk writer
-    const auto& vtk_writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
-    vtk_writer->SetCompressorTypeToNone();
-    vtk_writer->SetDataModeToBinary();
-    vtk_writer->WriteToOutputStringOn();
-    vtk_writer->SetInputData(vtk_mesh);
+    _tree.put(NUM_POINTS, num_points);
+    _tree.put(NUM_CELLS, num_cells);
+    _tree.put(CELL_TYPE, static_cast<int>(cell_type));
+    _tree.put(ATTRIBUTES, static_cast<int>(attributes));
 
-    // Write to internal string...
-    vtk_writer->Update();
+    // Like VTK, a mesh without points or without cells is empty
+    if(num_points == 0 || num_cells == 0)
+    {
+        return;
+    }
 
     // Create the output file inside the archive
     const auto& ostream = _archive.open_file(
-        std::filesystem::path(mesh->get_uuid() + MESH),
+        std::filesystem::path(mesh->get_uuid() + MESH_RAW),
         _password
     );
 
-    // Write back to the archive
-    (*ostream) << vtk_writer->GetOutputString();
+    // Write each array as a raw payload, straight from the locked buffers
+    const auto dump_lock = mesh->dump_lock();
+
+    for_each_array(
+        cell_type,
+        attributes,
+        [&](auto _type, bool _is_point)
+        {
+            using type_t = decltype(_type);
+            helper::write_raw(
+                *ostream,
+                &*mesh->template cbegin<type_t>(),
+                std::size_t(_is_point ? num_points : num_cells) * sizeof(type_t)
+            );
+        });
 }
 
 //------------------------------------------------------------------------------
@@ -94,10 +186,52 @@ inline static data::mesh::sptr read(
     auto mesh = helper::cast_or_create<data::mesh>(_object);
 
     // Check version number. Not mandatory, but could help for future release
-    helper::read_version<data::mesh>(_tree, 0, 1);
+    const auto version = helper::read_version<data::mesh>(_tree, 0, 2);
+
+    const auto& uuid = _tree.get<std::string>(UUID);
+
+    if(version >= 2)
+    {
+        const auto num_points = _tree.get<data::mesh::size_t>(NUM_POINTS);
+        const auto num_cells  = _tree.get<data::mesh::size_t>(NUM_CELLS);
+        const auto cell_type  = static_cast<data::mesh::cell_type_t>(_tree.get<int>(CELL_TYPE));
+        const auto attributes = static_cast<data::mesh::attribute>(_tree.get<int>(ATTRIBUTES));
+
+        mesh->clear();
+
+        // Like VTK, a mesh without points or without cells is empty
+        if(num_points == 0 || num_cells == 0)
+        {
+            return mesh;
+        }
+
+        // Create the istream from the input file inside the archive
+        const auto& istream = _archive.open_file(
+            std::filesystem::path(uuid + MESH_RAW),
+            _password
+        );
+
+        // Read each array as a raw payload, straight into the mesh buffers
+        const auto dump_lock = mesh->dump_lock();
+        mesh->resize(num_points, num_cells, cell_type, attributes);
+
+        for_each_array(
+            cell_type,
+            attributes,
+            [&](auto _type, bool _is_point)
+            {
+                using type_t = decltype(_type);
+                helper::read_raw(
+                    *istream,
+                    &*mesh->template begin<type_t>(),
+                    std::size_t(_is_point ? num_points : num_cells) * sizeof(type_t)
+                );
+            });
+
+        return mesh;
+    }
 
-    // Create the istream from the input file inside the archive
-    const auto& uuid    = _tree.get<std::string>(UUID);
+    // Legacy format: create the istream from the VTK file inside the archive
     const auto& istream = _archive.open_file(
         std::filesystem::path(uuid + MESH),
         _password
@@ -30,7 +30,11 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <array>
+#include <cstdint>
+#include <istream>
 #include <optional>
+#include <ostream>
 
 namespace sight::io::session::helper
 {
@@ -110,6 +114,72 @@ inline static void write_string(
     _tree.put(_key, base64);
 }
 
+/// Header written in front of each raw binary payload: a magic number, the payload format version and its size
+struct raw_header
+{
+    std::array<char, 4> magic {'S', 'R', 'A', 'W'};
+    std::uint32_t version {1};
+    std::uint64_t size {0};
+};
+
+/// Convenience function to write a raw binary payload, a small header followed by the contiguous buffer
+/// @param[inout] _ostream the output stream, usually a file in the archive
+/// @param[in] _buffer the buffer to write, which must stay locked during the call
+/// @param[in] _size the size in bytes of the buffer
+inline static void write_raw(std::ostream& _ostream, const void* const _buffer, const std::size_t _size)
+{
+    const raw_header header {.size = _size};
+    _ostream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if(_size > 0)
+    {
+        _ostream.write(static_cast<const char*>(_buffer), static_cast<std::streamsize>(_size));
+    }
+
+    SIGHT_THROW_IF("Cannot write raw payload of " << _size << " bytes.", !_ostream.good());
+}
+
+/// Convenience function to read the header of a raw binary payload written by write_raw()
+/// @param[inout] _istream the input stream, usually a file in the archive
+/// @param[in] _size the expected size in bytes of the payload
+inline static void read_raw_header(std::istream& _istream, const std::size_t _size)
+{
+    raw_header header;
+    const raw_header expected;
+    _istream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    SIGHT_THROW_IF(
+        "Invalid raw payload header.",
+        static_cast<std::size_t>(_istream.gcount()) != sizeof(header)
+        || header.magic != expected.magic
+        || header.version > expected.version
+    );
+
+    SIGHT_THROW_IF(
+        "Unexpected raw payload size: '" << header.size << "' bytes, expected '" << _size << "' bytes.",
+        header.size != _size
+    );
+}
+
+/// Convenience function to read a raw binary payload written by write_raw(), straight into the destination buffer
+/// @param[inout] _istream the input stream, usually a file in the archive
+/// @param[out] _buffer the destination buffer, which must stay locked during the call
+/// @param[in] _size the expected size in bytes of the payload
+inline static void read_raw(std::istream& _istream, void* const _buffer, const std::size_t _size)
+{
+    read_raw_header(_istream, _size);
+
+    if(_size > 0)
+    {
+        _istream.read(static_cast<char*>(_buffer), static_cast<std::streamsize>(_size));
+
+        SIGHT_THROW_IF(
+            "Truncated raw payload: '" << _istream.gcount() << "' bytes read, expected '" << _size << "' bytes.",
+            static_cast<std::size_t>(_istream.gcount()) != _size
+        );
+    }
+}
+
 /// Convenience function to cast and check an object
 /// Mainly to factorize error management
 /// @param[in] _object the object to cast to type T
@@ -63,7 +63,8 @@ public:
             m_session_reader->get_file(),
             m_archive_format,
             m_password->get_password(),
-            m_encryption_policy
+            m_encryption_policy,
+            m_lazy_loading
         );
     }
 
@@ -84,6 +85,9 @@ public:
 
     /// Archive format to use
     archive::archive_format m_archive_format;
+
+    /// If true, images and arrays are loaded on demand
+    bool m_lazy_loading {false};
 };
 
 session_reader::session_reader() :
@@ -134,6 +138,13 @@ void session_reader::set_archive_format(const archive::archive_format _archive_f
 
 //------------------------------------------------------------------------------
 
+void session_reader::set_lazy_loading(bool _lazy_loading)
+{
+    m_pimpl->m_lazy_loading = _lazy_loading;
+}
+
+//------------------------------------------------------------------------------
+
 void session_reader::set_custom_deserializer(const std::string& _class_name, deserializer_t _deserializer)
 {
     m_pimpl->m_session_deserializer.set_custom_deserializer(_class_name, _deserializer);
@@ -96,6 +96,11 @@ public:
     /// @param _archive_format how files are stored in the archive: @see sight::io::zip::archive::archiveFormat
     SIGHT_IO_SESSION_API void set_archive_format(zip::archive::archive_format _archive_format);
 
+    /// Enables the lazy loading of images and arrays
+    /// @param _lazy_loading if true, the payloads are read from the archive the first time their buffer is locked. The
+    ///                      archive must then stay available, until it is overwritten by a session_writer.
+    SIGHT_IO_SESSION_API void set_lazy_loading(bool _lazy_loading);
+
     /// Set a deserialization function for an object
     /// @param _class_name the name of the object to serialize
     /// @param _deserializer the function pointer to the deserialization function
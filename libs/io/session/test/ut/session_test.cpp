@@ -24,6 +24,7 @@
 
 #include <core/crypto/aes256.hpp>
 #include <core/crypto/base64.hpp>
+#include <core/memory/buffer_manager.hpp>
 #include <core/os/temp_path.hpp>
 #include <core/tools/uuid.hpp>
 
@@ -66,6 +67,8 @@
 #include <geometry/data/mesh.hpp>
 
 #include <io/dicom/reader/series_set.hpp>
+#include <io/vtk/helper/mesh.hpp>
+#include <io/vtk/vtk.hpp>
 #include <io/session/detail/core/session_deserializer.hpp>
 #include <io/session/detail/core/session_serializer.hpp>
 #include <io/session/helper.hpp>
@@ -80,6 +83,12 @@
 #include <utest_data/generator/image.hpp>
 #include <utest_data/generator/mesh.hpp>
 
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkXMLImageDataWriter.h>
+#include <vtkXMLPolyDataWriter.h>
+
 #include <random>
 
 // Registers the fixture into the 'registry'
@@ -1689,4 +1698,171 @@ void session_test::custom_serializer_test()
     }
 }
 
+//------------------------------------------------------------------------------
+
+/// Writes a VTK XML file, like the version 1 of the image and mesh serializers did
+template<typename W>
+inline static void write_legacy_vtk(
+    zip::archive_writer& _archive,
+    const std::filesystem::path& _path,
+    vtkDataObject* const _data_object,
+    const core::crypto::secure_string& _password
+)
+{
+    const auto& vtk_writer = vtkSmartPointer<W>::New();
+    vtk_writer->SetCompressorTypeToNone();
+    vtk_writer->SetDataModeToBinary();
+    vtk_writer->WriteToOutputStringOn();
+    vtk_writer->SetInputData(_data_object);
+    vtk_writer->Update();
+
+    const auto& ostream = _archive.open_file(_path, _password);
+    (*ostream) << vtk_writer->GetOutputString();
+}
+
+//------------------------------------------------------------------------------
+
+inline static void legacy_image_serialize(
+    zip::archive_writer& _archive,
+    boost::property_tree::ptree& _tree,
+    data::object::csptr _object,
+    std::map<std::string, data::object::csptr>& _children,
+    const core::crypto::secure_string& _password = ""
+)
+{
+    // Use the current serializer for the metadata, which are the same in version 1
+    session_writer::serializer(data::image::classname())(_archive, _tree, _object, _children, _password);
+    helper::write_version<data::image>(_tree, 1);
+
+    const auto image = helper::safe_cast<data::image>(_object);
+    auto vtk_image   = vtkSmartPointer<vtkImageData>::New();
+    io::vtk::to_vtk_image(image, vtk_image);
+
+    write_legacy_vtk<vtkXMLImageDataWriter>(
+        _archive,
+        image->get_uuid() + "/" + data::image::leaf_classname() + ".vti",
+        vtk_image,
+        _password
+    );
+}
+
+//------------------------------------------------------------------------------
+
+inline static void legacy_mesh_serialize(
+    zip::archive_writer& _archive,
+    boost::property_tree::ptree& _tree,
+    data::object::csptr _object,
+    std::map<std::string, data::object::csptr>& /*unused*/,
+    const core::crypto::secure_string& _password = ""
+)
+{
+    helper::write_version<data::mesh>(_tree, 1);
+
+    const auto mesh     = helper::safe_cast<data::mesh>(_object);
+    const auto vtk_mesh = vtkSmartPointer<vtkPolyData>::New();
+    io::vtk::helper::mesh::to_vtk_mesh(mesh, vtk_mesh);
+
+    write_legacy_vtk<vtkXMLPolyDataWriter>(_archive, mesh->get_uuid() + "/mesh.vtp", vtk_mesh, _password);
+}
+
+//------------------------------------------------------------------------------
+
+template<typename T>
+inline static void test_legacy(const serializer_t& _legacy_serializer)
+{
+    // Create a temporary directory
+    core::os::temp_dir tmp_dir;
+    const auto test_path = tmp_dir / (T::leaf_classname() + "_legacy.zip");
+
+    // Write the session using the version 1 format
+    {
+        auto session_writer = std::make_shared<io::session::session_writer>();
+        session_writer->set_object(create<T>(0));
+        session_writer->set_file(test_path);
+        session_writer->set_custom_serializer(T::classname(), _legacy_serializer);
+        CPPUNIT_ASSERT_NO_THROW(session_writer->write());
+    }
+
+    // Read it back with the current deserializer
+    {
+        auto session_reader = std::make_shared<io::session::session_reader>();
+        session_reader->set_file(test_path);
+        CPPUNIT_ASSERT_NO_THROW(session_reader->read());
+
+        const auto actual_object = std::dynamic_pointer_cast<T>(session_reader->get_object());
+        CPPUNIT_ASSERT(actual_object);
+        CPPUNIT_ASSERT(*create<T>(0) == *actual_object);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void session_test::legacy_payload_test()
+{
+    // Sessions written with VTK XML payloads must still be readable
+    test_legacy<data::image>(legacy_image_serialize);
+    test_legacy<data::mesh>(legacy_mesh_serialize);
+}
+
+//------------------------------------------------------------------------------
+
+template<typename T>
+inline static void test_lazy(const std::filesystem::path& _test_path)
+{
+    // Write the session
+    {
+        auto session_writer = std::make_shared<io::session::session_writer>();
+        session_writer->set_object(create<T>(0));
+        session_writer->set_file(_test_path);
+        CPPUNIT_ASSERT_NO_THROW(session_writer->write());
+    }
+
+    typename T::sptr actual_object;
+
+    // Read it back, the payload stays in the archive until the first lock
+    {
+        auto session_reader = std::make_shared<io::session::session_reader>();
+        session_reader->set_file(_test_path);
+        session_reader->set_lazy_loading(true);
+        CPPUNIT_ASSERT_NO_THROW(session_reader->read());
+
+        actual_object = std::dynamic_pointer_cast<T>(session_reader->get_object());
+        CPPUNIT_ASSERT(actual_object);
+        CPPUNIT_ASSERT(!actual_object->get_buffer_object()->is_empty());
+    }
+
+    // Overwriting the archive must not break buffers that are still lazy
+    {
+        auto session_reader = std::make_shared<io::session::session_reader>();
+        session_reader->set_file(_test_path);
+        session_reader->set_lazy_loading(true);
+        CPPUNIT_ASSERT_NO_THROW(session_reader->read());
+        const auto lazy_object = std::dynamic_pointer_cast<T>(session_reader->get_object());
+
+        auto session_writer = std::make_shared<io::session::session_writer>();
+        session_writer->set_object(create<T>(1));
+        session_writer->set_file(_test_path);
+        CPPUNIT_ASSERT_NO_THROW(session_writer->write());
+
+        CPPUNIT_ASSERT(*create<T>(0) == *lazy_object);
+    }
+
+    CPPUNIT_ASSERT(*create<T>(0) == *actual_object);
+}
+
+//------------------------------------------------------------------------------
+
+void session_test::lazy_loading_test()
+{
+    // The lazy loading is a reader option, it does not depend on the buffer manager loading mode
+    CPPUNIT_ASSERT_EQUAL(
+        core::memory::buffer_manager::direct,
+        core::memory::buffer_manager::get()->get_loading_mode()
+    );
+
+    core::os::temp_dir tmp_dir;
+    test_lazy<data::image>(tmp_dir / "image_lazy.zip");
+    test_lazy<data::array>(tmp_dir / "array_lazy.zip");
+}
+
 } // namespace sight::io::session::ut
@@ -70,6 +70,8 @@ public:
     CPPUNIT_TEST(set_test);
 
     CPPUNIT_TEST(custom_serializer_test);
+    CPPUNIT_TEST(legacy_payload_test);
+    CPPUNIT_TEST(lazy_loading_test);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -117,6 +119,8 @@ public:
     static void set_test();
 
     static void custom_serializer_test();
+    static void legacy_payload_test();
+    static void lazy_loading_test();
 };
 
 } // namespace sight::io::session::ut
@@ -24,13 +24,19 @@
 #include "exception/write.hpp"
 
 #include "minizip/mz.h"
+#include "minizip/mz_crypt.h"
 #include "minizip/mz_os.h"
 #include "minizip/mz_strm.h"
+#include "minizip/mz_strm_mem.h"
 #include "minizip/mz_strm_os.h"
+#include "minizip/mz_strm_zlib.h"
+#include "minizip/mz_strm_zstd.h"
 #include "minizip/mz_zip.h"
 #include "minizip/mz_zip_rw.h"
 
 #include <core/exceptionmacros.hpp>
+#include <core/thread/pool.hpp>
+#include <core/thread/worker.hpp>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -43,10 +49,19 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <streambuf>
 #include <tuple>
+#include <vector>
 
 /**
  * Do not mark `madeby` as incorrect.
@@ -138,6 +153,25 @@ inline std::tuple<std::uint16_t, std::int16_t> to_minizip_parameter(method _meth
     return {minizip_method, minizip_level};
 }
 
+/// Convert argument to minizip dialect, using the default method of the archive format if needed
+inline std::tuple<std::uint16_t, std::int16_t> to_minizip_parameter(
+    archive::archive_format _format,
+    method _method,
+    level _level
+)
+{
+    return to_minizip_parameter(
+        _method != method::DEFAULT
+        ? _method
+        : _format == archive::archive_format::compatible
+        ? method::deflate
+        : _format == archive::archive_format::optimized
+        ? method::zstd
+        : method::DEFAULT,
+        _level
+    );
+}
+
 class raw_archive_writer final : public archive_writer
 {
 public:
@@ -305,16 +339,7 @@ public:
         m_zip_handle(std::move(_zip_handle))
     {
         // Translate to minizip dialect
-        auto [minizipMethod, minizipLevel] = to_minizip_parameter(
-            _method != method::DEFAULT
-            ? _method
-            : m_zip_handle->m_format == archive::archive_format::compatible
-            ? method::deflate
-            : m_zip_handle->m_format == archive::archive_format::optimized
-            ? method::zstd
-            : method::DEFAULT,
-            _level
-        );
+        auto [minizipMethod, minizipLevel] = to_minizip_parameter(m_zip_handle->m_format, _method, _level);
 
         // Set compression method and level
         mz_zip_writer_set_compress_method(m_zip_handle->m_zip_writer, minizipMethod);
@@ -495,6 +520,703 @@ private:
     std::shared_ptr<zip_handle> m_zip_handle;
 };
 
+/// A file written in memory, compressed on core::thread::pool and finally appended to the archive by the writer thread
+struct staged_file
+{
+    /// Path to the file converted to string because on Windows std::filesystem::path.c_str() returns a wchar*
+    std::string file_name;
+
+    /// The password, if the file must be encrypted
+    core::crypto::secure_string password;
+
+    /// Compression parameters, in minizip dialect
+    method compression_method {method::DEFAULT};
+    level compression_level {level::DEFAULT};
+    std::uint16_t minizip_method {MZ_COMPRESS_METHOD_ZSTD};
+    std::int16_t minizip_level {MZ_COMPRESS_LEVEL_DEFAULT};
+
+    /// The file content, compressed if 'compressed' is true
+    std::vector<char> data;
+
+    /// True if data holds the compressed file, false if minizip must compress it while writing it
+    bool compressed {false};
+
+    /// Size of the original content
+    std::int64_t uncompressed_size {0};
+
+    /// CRC32 of the original content
+    std::uint32_t crc {0};
+
+    /// Extra field holding the hash of the original content, like minizip writer does
+    std::vector<std::uint8_t> extrafield;
+};
+
+/// Compresses a staged file, in the same format as minizip would do it while writing the archive
+/// Encrypted files and files too big for minizip memory streams are left as is, to be processed by minizip.
+inline void compress(staged_file& _file)
+{
+    // Memory streams are limited to 2GB, use a safety margin for files that do not compress
+    constexpr auto max_size = std::size_t(std::numeric_limits<std::int32_t>::max() / 2);
+    if(!_file.password.empty() || _file.data.size() > max_size)
+    {
+        return;
+    }
+
+    const auto size = std::int32_t(_file.data.size());
+    _file.uncompressed_size = size;
+
+    // CRC32
+    _file.crc = mz_crypt_crc32_update(0, reinterpret_cast<const std::uint8_t*>(_file.data.data()), size);
+
+    // Hash, stored in an extra field
+    void* hash                = mz_crypt_sha_create();
+    std::uint16_t algorithm   = MZ_HASH_SHA256;
+    std::uint16_t digest_size = MZ_HASH_SHA256_SIZE;
+
+    SIGHT_THROW_EXCEPTION_IF(exception::write("Cannot create hash instance", MZ_MEM_ERROR), hash == nullptr);
+
+    if(mz_crypt_sha_set_algorithm(hash, algorithm) != MZ_OK)
+    {
+        algorithm   = MZ_HASH_SHA1;
+        digest_size = MZ_HASH_SHA1_SIZE;
+        mz_crypt_sha_set_algorithm(hash, algorithm);
+    }
+
+    std::array<std::uint8_t, MZ_HASH_MAX_SIZE> digest {};
+    mz_crypt_sha_begin(hash);
+    mz_crypt_sha_update(hash, _file.data.data(), size);
+    mz_crypt_sha_end(hash, digest.data(), digest_size);
+    mz_crypt_sha_delete(&hash);
+
+    const auto push_uint16 = [&](std::uint16_t _value)
+                             {
+                                 _file.extrafield.push_back(std::uint8_t(_value & 0xff));
+                                 _file.extrafield.push_back(std::uint8_t(_value >> 8));
+                             };
+
+    push_uint16(MZ_ZIP_EXTENSION_HASH);
+    push_uint16(std::uint16_t(4 + digest_size));
+    push_uint16(algorithm);
+    push_uint16(digest_size);
+    _file.extrafield.insert(_file.extrafield.end(), digest.begin(), digest.begin() + digest_size);
+
+    if(_file.minizip_method == MZ_COMPRESS_METHOD_STORE)
+    {
+        _file.compressed = true;
+        return;
+    }
+
+    // Compress into a memory stream
+    void* mem_stream = mz_stream_mem_create();
+    mz_stream_mem_set_grow_size(mem_stream, std::max(std::int32_t(1024 * 1024), size / 4));
+    mz_stream_mem_open(mem_stream, nullptr, MZ_OPEN_MODE_CREATE);
+
+    void* compress_stream = _file.minizip_method == MZ_COMPRESS_METHOD_DEFLATE
+                            ? mz_stream_zlib_create()
+                            : mz_stream_zstd_create();
+
+    mz_stream_set_prop_int64(compress_stream, MZ_STREAM_PROP_COMPRESS_LEVEL, _file.minizip_level);
+    mz_stream_set_base(compress_stream, mem_stream);
+
+    std::int32_t result = mz_stream_open(compress_stream, nullptr, MZ_OPEN_MODE_WRITE);
+    if(result == MZ_OK)
+    {
+        result = mz_stream_write(compress_stream, _file.data.data(), size) == size ? MZ_OK : MZ_WRITE_ERROR;
+    }
+
+    mz_stream_close(compress_stream);
+
+    const void* buffer = nullptr;
+    std::int32_t length = 0;
+    mz_stream_mem_get_buffer(mem_stream, &buffer);
+    length = std::int32_t(mz_stream_mem_tell(mem_stream));
+
+    if(result == MZ_OK && buffer != nullptr && length >= 0)
+    {
+        const auto* const begin = static_cast<const char*>(buffer);
+        _file.data.assign(begin, begin + length);
+        _file.compressed = true;
+    }
+
+    mz_stream_delete(&compress_stream);
+    mz_stream_mem_delete(&mem_stream);
+
+    SIGHT_THROW_EXCEPTION_IF(
+        exception::write("Cannot compress file '" + _file.file_name + "'. Error code: " + std::to_string(result), result),
+        result != MZ_OK
+    );
+}
+
+/// A file too big to be staged in memory, whose chunks are written by the writer thread as soon as they are produced
+struct streamed_file
+{
+    /// Protects all the other members
+    std::mutex mutex;
+
+    /// Notified each time a chunk is pushed or popped, and when the file is closed or fails
+    std::condition_variable cv;
+
+    /// The chunks waiting to be written
+    std::deque<std::vector<char> > chunks;
+
+    /// True once the last chunk has been pushed
+    bool closed {false};
+
+    /// The error that occurred while writing the file, if any
+    std::exception_ptr error;
+};
+
+class parallel_zip_archive_writer;
+
+/// A stream buffer that stages everything written in a staged_file. When the file gets too big, its content is
+/// streamed to the archive in chunks instead.
+class staging_buffer final : public std::streambuf
+{
+public:
+
+    staging_buffer(parallel_zip_archive_writer& _writer, std::unique_ptr<staged_file> _file) :
+        m_writer(_writer),
+        m_file(std::move(_file))
+    {
+    }
+
+    /// Submits the staged file, or the last chunk of the streamed one.
+    inline void close();
+
+protected:
+
+    //------------------------------------------------------------------------------
+
+    int_type overflow(int_type _c) override
+    {
+        if(!traits_type::eq_int_type(_c, traits_type::eof()))
+        {
+            const char c = traits_type::to_char_type(_c);
+            this->xsputn(&c, 1);
+        }
+
+        return traits_type::not_eof(_c);
+    }
+
+    //------------------------------------------------------------------------------
+
+    inline std::streamsize xsputn(const char* _buffer, std::streamsize _size) override;
+
+private:
+
+    parallel_zip_archive_writer& m_writer;
+    std::unique_ptr<staged_file> m_file;
+
+    /// Set once the file is streamed
+    std::shared_ptr<streamed_file> m_streamed;
+};
+
+/// The stream returned by parallel_zip_archive_writer::open_file(). The file is submitted when the stream is destroyed.
+class staging_ostream final : public std::ostream
+{
+public:
+
+    staging_ostream(parallel_zip_archive_writer& _writer, std::unique_ptr<staged_file> _file) :
+        std::ostream(nullptr),
+        m_writer(_writer),
+        m_buffer(_writer, std::move(_file))
+    {
+        this->rdbuf(&m_buffer);
+    }
+
+    inline ~staging_ostream() override;
+
+private:
+
+    parallel_zip_archive_writer& m_writer;
+    staging_buffer m_buffer;
+};
+
+class parallel_zip_archive_writer final : public archive_writer
+{
+public:
+
+    SIGHT_DECLARE_CLASS(parallel_zip_archive_writer, archive_writer);
+
+    /// Delete default constructors and assignment operators, as we don't want to allow resources duplication
+    parallel_zip_archive_writer()                                              = delete;
+    parallel_zip_archive_writer(const parallel_zip_archive_writer&)            = delete;
+    parallel_zip_archive_writer(parallel_zip_archive_writer&&)                 = delete;
+    parallel_zip_archive_writer& operator=(const parallel_zip_archive_writer&) = delete;
+    parallel_zip_archive_writer& operator=(parallel_zip_archive_writer&&)      = delete;
+
+    /// Maximum size of the files staged in memory, waiting to be compressed or written. A single bigger file is allowed.
+    static constexpr std::size_t MAX_STAGED_SIZE = std::size_t(1024) * 1024 * 1024;
+
+    /// Files bigger than this are not staged, but streamed in chunks of this size and compressed by minizip.
+    static constexpr std::size_t STREAMING_THRESHOLD = std::size_t(64) * 1024 * 1024;
+
+    /// Maximum number of chunks of a streamed file waiting to be written.
+    static constexpr std::size_t MAX_STREAMED_CHUNKS = 2;
+
+    parallel_zip_archive_writer(const std::filesystem::path& _archive_path, const archive_format _format) :
+        archive_writer(_archive_path),
+        m_zip_handle(std::make_shared<zip_handle>(_archive_path, _format)),
+        m_writer(core::thread::worker::make())
+    {
+        m_writer->set_thread_name("zip_writer");
+    }
+
+    ~parallel_zip_archive_writer() override
+    {
+        try
+        {
+            this->flush();
+        }
+        catch(const std::exception& e)
+        {
+            SIGHT_ERROR("Cannot write archive '" + m_zip_handle->m_archive_path + "': " + e.what());
+        }
+
+        m_writer->stop();
+    }
+
+    //------------------------------------------------------------------------------
+
+    std::unique_ptr<std::ostream> open_file(
+        const std::filesystem::path& _file_path,
+        const core::crypto::secure_string& _password = "",
+        const method _method                         = method::DEFAULT,
+        const level _level                           = level::DEFAULT
+    ) override
+    {
+        // Report the errors of the previous files before writing a new one
+        this->rethrow_error();
+
+        auto file = std::make_unique<staged_file>();
+        file->file_name          = _file_path.string();
+        file->password           = _password;
+        file->compression_method = _method;
+        file->compression_level  = _level;
+        std::tie(file->minizip_method, file->minizip_level) =
+            to_minizip_parameter(m_zip_handle->m_format, _method, _level);
+
+        return std::make_unique<staging_ostream>(*this, std::move(file));
+    }
+
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] bool is_raw() const override
+    {
+        return false;
+    }
+
+    //------------------------------------------------------------------------------
+
+    void flush() override
+    {
+        // Tasks are processed in order by the writer, so once this one is done, all the previous ones are
+        m_writer->post_task<void>([]{}).wait();
+
+        this->rethrow_error();
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Compresses the file on the thread pool, then appends it to the archive on the writer thread
+    /// @throw std::exception if the file can not be submitted
+    void submit(std::unique_ptr<staged_file> _file)
+    {
+        const std::size_t size = _file->data.size();
+
+        // Back pressure: don't stage too much data in memory. The writer does not progress while a file is streamed.
+        {
+            std::unique_lock lock(m_mutex);
+            while(m_streaming == 0 && m_staged_size > 0 && m_staged_size + size > MAX_STAGED_SIZE)
+            {
+                // Help the pool if called from one of its threads, to avoid a dead lock
+                lock.unlock();
+                const bool helped = core::thread::pool::get().run_pending_task();
+                lock.lock();
+
+                if(!helped)
+                {
+                    m_staged_cv.wait_for(lock, std::chrono::milliseconds(10));
+                }
+            }
+
+            m_staged_size += size;
+        }
+
+        auto compressed = std::make_shared<std::promise<std::unique_ptr<staged_file> > >();
+        auto future     = compressed->get_future().share();
+
+        try
+        {
+            m_writer->post(
+                [this, future, size]
+                {
+                    try
+                    {
+                        this->write(*future.get());
+                    }
+                    catch(...)
+                    {
+                        this->set_error(std::current_exception());
+                    }
+
+                    {
+                        std::unique_lock lock(m_mutex);
+                        m_staged_size -= size;
+                    }
+
+                    m_staged_cv.notify_all();
+                });
+        }
+        catch(...)
+        {
+            std::unique_lock lock(m_mutex);
+            m_staged_size -= size;
+            throw;
+        }
+
+        // The writer waits for the compressed file, so it must be set even if the compression can not be posted
+        auto file = std::shared_ptr<staged_file>(std::move(_file));
+        const auto compress_file =
+            [compressed, file]
+            {
+                try
+                {
+                    compress(*file);
+                    compressed->set_value(std::make_unique<staged_file>(std::move(*file)));
+                }
+                catch(...)
+                {
+                    compressed->set_exception(std::current_exception());
+                }
+            };
+
+        try
+        {
+            core::thread::pool::get().post(compress_file);
+        }
+        catch(...)
+        {
+            compress_file();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Opens a file in the archive on the writer thread, which then writes the chunks pushed with push() until the file
+    /// is closed. The files submitted afterwards are written once it is closed.
+    std::shared_ptr<streamed_file> stream(const staged_file& _file)
+    {
+        auto streamed = std::make_shared<streamed_file>();
+
+        {
+            std::unique_lock lock(m_mutex);
+            ++m_streaming;
+        }
+
+        try
+        {
+            m_writer->post(
+                [this, streamed, file_name = _file.file_name, password = _file.password,
+                 compression_method = _file.compression_method, compression_level = _file.compression_level]
+                {
+                    try
+                    {
+                        zip_sink sink(
+                            std::make_shared<zip_file_handle>(
+                                m_zip_handle,
+                                file_name,
+                                password,
+                                compression_method,
+                                compression_level
+                            )
+                        );
+
+                        for( ; ; )
+                        {
+                            std::vector<char> chunk;
+                            {
+                                std::unique_lock lock(streamed->mutex);
+                                streamed->cv.wait(lock, [&]{return !streamed->chunks.empty() || streamed->closed;});
+
+                                if(streamed->chunks.empty())
+                                {
+                                    break;
+                                }
+
+                                chunk = std::move(streamed->chunks.front());
+                                streamed->chunks.pop_front();
+                            }
+
+                            streamed->cv.notify_all();
+                            write_chunks(sink, chunk);
+                        }
+                    }
+                    catch(...)
+                    {
+                        {
+                            std::unique_lock lock(streamed->mutex);
+                            streamed->error = std::current_exception();
+                            streamed->chunks.clear();
+                        }
+
+                        streamed->cv.notify_all();
+                        this->set_error(std::current_exception());
+                    }
+
+                    {
+                        std::unique_lock lock(m_mutex);
+                        --m_streaming;
+                    }
+
+                    m_staged_cv.notify_all();
+                });
+        }
+        catch(...)
+        {
+            std::unique_lock lock(m_mutex);
+            --m_streaming;
+            throw;
+        }
+
+        return streamed;
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Queues a chunk of a streamed file, waiting for the writer if too many chunks are already queued
+    /// @throw std::exception if the file can not be written
+    static void push(streamed_file& _streamed, std::vector<char>&& _chunk)
+    {
+        std::unique_lock lock(_streamed.mutex);
+        while(!_streamed.error && _streamed.chunks.size() >= MAX_STREAMED_CHUNKS)
+        {
+            // Help the pool if called from one of its threads, as the writer may wait for a compression
+            lock.unlock();
+            const bool helped = core::thread::pool::get().run_pending_task();
+            lock.lock();
+
+            if(!helped)
+            {
+                _streamed.cv.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+
+        if(_streamed.error)
+        {
+            std::rethrow_exception(_streamed.error);
+        }
+
+        _streamed.chunks.push_back(std::move(_chunk));
+        lock.unlock();
+        _streamed.cv.notify_all();
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Pushes the last chunk of a streamed file
+    /// @throw std::exception if the file can not be written
+    static void close(streamed_file& _streamed, std::vector<char>&& _chunk)
+    {
+        if(!_chunk.empty())
+        {
+            push(_streamed, std::move(_chunk));
+        }
+
+        {
+            std::unique_lock lock(_streamed.mutex);
+            _streamed.closed = true;
+        }
+
+        _streamed.cv.notify_all();
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Keeps the first error, to be thrown by the next call to open_file() or flush()
+    void set_error(std::exception_ptr _error)
+    {
+        std::unique_lock lock(m_mutex);
+        if(!m_error)
+        {
+            m_error = std::move(_error);
+        }
+    }
+
+private:
+
+    //------------------------------------------------------------------------------
+
+    /// Throws the first error that occurred while compressing or writing a file, if any
+    void rethrow_error()
+    {
+        std::unique_lock lock(m_mutex);
+        if(m_error)
+        {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Writes a buffer with minizip, which compresses and encrypts it
+    static void write_chunks(zip_sink& _sink, const std::vector<char>& _data)
+    {
+        for(std::size_t offset = 0 ; offset < _data.size() ; )
+        {
+            const auto chunk = std::min(_data.size() - offset, std::size_t(std::numeric_limits<std::int32_t>::max()));
+            offset += std::size_t(_sink.write(_data.data() + offset, std::streamsize(chunk)));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    /// Appends a file to the archive. Only called from the writer thread.
+    void write(const staged_file& _file)
+    {
+        if(!_file.compressed)
+        {
+            // Let minizip compress and encrypt the file
+            zip_sink sink(
+                std::make_shared<zip_file_handle>(
+                    m_zip_handle,
+                    _file.file_name,
+                    _file.password,
+                    _file.compression_method,
+                    _file.compression_level
+                )
+            );
+
+            write_chunks(sink, _file.data);
+            return;
+        }
+
+        void* zip = nullptr;
+        mz_zip_writer_get_zip_handle(m_zip_handle->m_zip_writer, &zip);
+
+        const auto now = time(nullptr);
+
+        mz_zip_file zip_file;
+        std::memset(&zip_file, 0, sizeof(zip_file));
+
+        zip_file.version_madeby     = MZ_VERSION_MADEBY;
+        zip_file.flag               = MZ_ZIP_FLAG_UTF8;
+        zip_file.compression_method = _file.minizip_method;
+        zip_file.modified_date      = now;
+        zip_file.accessed_date      = now;
+        zip_file.creation_date      = now;
+        zip_file.filename           = _file.file_name.c_str();
+        zip_file.crc                = _file.crc;
+        zip_file.compressed_size    = std::int64_t(_file.data.size());
+        zip_file.uncompressed_size  = _file.uncompressed_size;
+        zip_file.extrafield         = _file.extrafield.data();
+        zip_file.extrafield_size    = std::uint16_t(_file.extrafield.size());
+
+        // Write the already compressed data as is
+        auto result = mz_zip_entry_write_open(zip, &zip_file, _file.minizip_level, 1, nullptr);
+
+        if(result == MZ_OK && !_file.data.empty())
+        {
+            const auto written = mz_zip_entry_write(zip, _file.data.data(), std::int32_t(_file.data.size()));
+            result = written == std::int32_t(_file.data.size()) ? MZ_OK : (written < 0 ? written : MZ_WRITE_ERROR);
+        }
+
+        const auto close_result = mz_zip_entry_close_raw(zip, _file.uncompressed_size, _file.crc);
+
+        result = result == MZ_OK ? close_result : result;
+
+        SIGHT_THROW_EXCEPTION_IF(
+            exception::write(
+                "Cannot write file '"
+                + _file.file_name
+                + "' in archive '"
+                + m_zip_handle->m_archive_path
+                + "'. Error code: "
+                + std::to_string(result),
+                result
+            ),
+            result != MZ_OK
+        );
+    }
+
+    /// Zip handle, only used by the writer thread.
+    std::shared_ptr<zip_handle> m_zip_handle;
+
+    /// The single thread that appends files to the archive, in submission order.
+    core::thread::worker::sptr m_writer;
+
+    /// Protects m_staged_size, m_streaming and m_error.
+    std::mutex m_mutex;
+
+    /// Notified each time a file has been written.
+    std::condition_variable m_staged_cv;
+
+    /// Size of the files staged in memory.
+    std::size_t m_staged_size {0};
+
+    /// Number of streamed files not yet written.
+    std::size_t m_streaming {0};
+
+    /// The first error that occurred while compressing or writing a file.
+    std::exception_ptr m_error;
+};
+
+//------------------------------------------------------------------------------
+
+inline void staging_buffer::close()
+{
+    if(m_streamed)
+    {
+        parallel_zip_archive_writer::close(*m_streamed, std::move(m_file->data));
+    }
+    else
+    {
+        m_writer.submit(std::move(m_file));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline std::streamsize staging_buffer::xsputn(const char* _buffer, std::streamsize _size)
+{
+    constexpr auto threshold = parallel_zip_archive_writer::STREAMING_THRESHOLD;
+
+    for(std::streamsize offset = 0 ; offset < _size ; )
+    {
+        const auto count = std::min(_size - offset, std::streamsize(threshold - m_file->data.size()));
+        m_file->data.insert(m_file->data.end(), _buffer + offset, _buffer + offset + count);
+        offset += count;
+
+        // Once the file is too big, the staged content is sent to the writer, so at most a chunk is kept in memory
+        if(m_file->data.size() >= threshold)
+        {
+            if(!m_streamed)
+            {
+                m_streamed = m_writer.stream(*m_file);
+            }
+
+            parallel_zip_archive_writer::push(*m_streamed, std::exchange(m_file->data, {}));
+        }
+    }
+
+    return _size;
+}
+
+//------------------------------------------------------------------------------
+
+inline staging_ostream::~staging_ostream()
+{
+    // A destructor can not throw, so the error is reported by the next call to open_file() or flush()
+    try
+    {
+        m_buffer.close();
+    }
+    catch(...)
+    {
+        m_writer.set_error(std::current_exception());
+    }
+}
+
 } // namespace
 
 archive_writer::archive_writer(const std::filesystem::path& _archive_path) :
@@ -504,9 +1226,16 @@ archive_writer::archive_writer(const std::filesystem::path& _archive_path) :
 
 //------------------------------------------------------------------------------
 
+void archive_writer::flush()
+{
+}
+
+//------------------------------------------------------------------------------
+
 archive_writer::uptr archive_writer::get(
     const std::filesystem::path& _archive_path,
-    const archive_format _format
+    const archive_format _format,
+    bool _parallel
 )
 {
     if(_format == archive_format::filesystem)
@@ -514,6 +1243,11 @@ archive_writer::uptr archive_writer::get(
         return std::make_unique<raw_archive_writer>(_archive_path);
     }
 
+    if(_parallel)
+    {
+        return std::make_unique<parallel_zip_archive_writer>(_archive_path, _format);
+    }
+
     return std::make_unique<zip_archive_writer>(_archive_path, _format);
 }
 
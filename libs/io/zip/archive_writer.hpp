@@ -72,9 +72,16 @@ public:
     /// Shared factory. It uses a cache mechanism to return the same instance for the same archive_path.
     /// @param _archive_path path of the archive file. The file will be kept opened as long as the instance leave.
     /// @param _format the format of the archive. @see sight::io::zip::archive::archiveFormat
+    /// @param _parallel if true, files are written in memory, compressed concurrently on core::thread::pool when their
+    ///                  stream is destroyed, and appended to the archive by a single writer thread, in the order their
+    ///                  streams are destroyed. Files bigger than 64 MiB are not kept in memory: they are appended in
+    ///                  chunks as they are written, and the files submitted meanwhile are appended after them.
+    ///                  Call flush() to wait for the completion. Errors are thrown by the next call to open_file() or
+    ///                  flush(). Ignored for the filesystem format.
     SIGHT_IO_ZIP_API static archive_writer::uptr get(
         const std::filesystem::path& _archive_path,
-        archive_format _format = archive_format::DEFAULT
+        archive_format _format = archive_format::DEFAULT,
+        bool _parallel         = false
     );
 
     /// Returns an std::ostream to read an archived file
@@ -92,6 +99,10 @@ public:
     /// Returns true for raw archive
     [[nodiscard]] SIGHT_IO_ZIP_API virtual bool is_raw() const = 0;
 
+    /// Waits until all the files whose stream has been destroyed are written in the archive.
+    /// @throw io::zip::exception::write or any exception that occurred while compressing or writing a file
+    SIGHT_IO_ZIP_API virtual void flush();
+
 protected:
 
     /// Constructor
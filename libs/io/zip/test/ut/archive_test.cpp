@@ -32,6 +32,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(sight::io::zip::ut::archive_test);
@@ -246,6 +247,96 @@ void archive_test::raw_test()
 
 //------------------------------------------------------------------------------
 
+void archive_test::parallel_test()
+{
+    // Create a temporary file
+    core::os::temp_dir tmp_dir;
+
+    struct entry
+    {
+        std::string name;
+        core::crypto::secure_string password;
+        method compression_method {method::DEFAULT};
+        level compression_level {level::DEFAULT};
+        std::string content;
+    };
+
+    // Build some contents, big enough to be compressed in several blocks
+    std::vector<entry> entries;
+    for(std::size_t i = 0 ; i < 16 ; ++i)
+    {
+        std::string content;
+        for(std::size_t j = 0 ; j < (i + 1) * 10000 ; ++j)
+        {
+            content += std::to_string(j * i % 1237) + ",";
+        }
+
+        entries.push_back({"entry_" + std::to_string(i), "", method::DEFAULT, level::DEFAULT, content});
+    }
+
+    entries.push_back({"empty", "", method::DEFAULT, level::DEFAULT, ""});
+    entries.push_back({"stored", "", method::store, level::DEFAULT, entries[1].content});
+    entries.push_back({"deflate_best", "", method::deflate, level::best, entries[2].content});
+    entries.push_back({"zstd_fast", "", method::zstd, level::fast, entries[3].content});
+    entries.push_back({"encrypted", "password", method::zstd, level::best, entries[4].content});
+    entries.push_back({"sub/directory/entry", "", method::DEFAULT, level::DEFAULT, entries[5].content});
+
+    // Bigger than 64 MiB, so it is streamed to the archive instead of being staged in memory
+    std::string streamed;
+    while(streamed.size() < std::size_t(80) * 1024 * 1024)
+    {
+        streamed += entries[streamed.size() % 16].content;
+    }
+
+    entries.insert(entries.begin() + 8, {"streamed", "", method::DEFAULT, level::DEFAULT, streamed});
+    entries.push_back({"streamed_encrypted", "password", method::deflate, level::fast, streamed});
+
+    for(const auto format : {archive::archive_format::compatible, archive::archive_format::optimized})
+    {
+        const std::filesystem::path archive_path = tmp_dir
+                                                   / ("parallel_" + std::string(archive::archive_format_to_string(format))
+                                                      + ".zip");
+
+        {
+            // Create the parallel archive writer
+            auto archive_writer = archive_writer::get(archive_path, format, true);
+            CPPUNIT_ASSERT(archive_writer->is_a("sight::io::zip::archive_writer"));
+            CPPUNIT_ASSERT(!archive_writer->is_raw());
+
+            for(const auto& entry : entries)
+            {
+                auto ostream = archive_writer->open_file(
+                    entry.name,
+                    entry.password,
+                    entry.compression_method,
+                    entry.compression_level
+                );
+                ostream->write(entry.content.data(), static_cast<std::streamsize>(entry.content.size()));
+            }
+
+            // All files must be written after a flush
+            CPPUNIT_ASSERT_NO_THROW(archive_writer->flush());
+        }
+
+        {
+            // Create the archive reader
+            auto archive_reader = archive_reader::get(archive_path);
+
+            // Read back the files, in a different order
+            for(auto it = entries.crbegin() ; it != entries.crend() ; ++it)
+            {
+                std::string buffer(it->content.size(), 0);
+                auto istream = archive_reader->open_file(it->name, it->password);
+                istream->read(buffer.data(), static_cast<std::streamsize>(it->content.size()));
+
+                CPPUNIT_ASSERT_EQUAL_MESSAGE(it->name, it->content, buffer);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
 void archive_test::archive_format_to_string_test()
 {
     // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
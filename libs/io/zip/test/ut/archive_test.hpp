@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2021 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -34,6 +34,7 @@ CPPUNIT_TEST(new_test);
 CPPUNIT_TEST(singleton_test);
 CPPUNIT_TEST(open_test);
 CPPUNIT_TEST(raw_test);
+CPPUNIT_TEST(parallel_test);
 CPPUNIT_TEST(archive_format_to_string_test);
 CPPUNIT_TEST(string_to_archive_format);
 CPPUNIT_TEST_SUITE_END();
@@ -48,6 +49,7 @@ public:
     static void singleton_test();
     static void open_test();
     static void raw_test();
+    static void parallel_test();
     static void archive_format_to_string_test();
     static void string_to_archive_format();
 };
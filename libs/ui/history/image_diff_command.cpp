@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2017-2023 IRCAD France
+ * Copyright (C) 2017-2024 IRCAD France
  * Copyright (C) 2017 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -38,6 +38,12 @@ image_diff_command::image_diff_command(const data::image::sptr& _img, filter::im
     m_diff(std::move(_diff))
 {
     m_diff.shrink();
+
+    // Large diffs are compressed to fit more commands in the history, small ones are not worth it
+    if(m_diff.size() >= COMPRESSION_THRESHOLD)
+    {
+        m_diff.compress();
+    }
 }
 
 //------------------------------------------------------------------------------
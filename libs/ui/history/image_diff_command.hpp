@@ -41,7 +41,7 @@ public:
     /// Constructor, uses an image and a change list for that image.
     SIGHT_UI_HISTORY_API image_diff_command(const data::image::sptr& _img, filter::image::image_diff _diff);
 
-    /// The diff size.
+    /// The diff size, compressed if it is large enough.
     [[nodiscard]] SIGHT_UI_HISTORY_API std::size_t size() const override;
 
     /// Apply diff.
@@ -60,6 +60,9 @@ private:
     data::image::buffer_modified_signal_t::sptr m_modified_sig;
 
     filter::image::image_diff m_diff;
+
+    /// Diffs larger than this size, in bytes, are compressed
+    static constexpr std::size_t COMPRESSION_THRESHOLD = 4 * 1024;
 };
 
 } // namespace sight::ui::history
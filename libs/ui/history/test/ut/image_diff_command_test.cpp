@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2017-2023 IRCAD France
+ * Copyright (C) 2017-2024 IRCAD France
  * Copyright (C) 2017-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -164,4 +164,60 @@ void image_diff_command_test::get_size_test()
 
 //------------------------------------------------------------------------------
 
+void image_diff_command_test::compressed_size_test()
+{
+    const data::image::size_t size              = {{64, 64, 64}};
+    const data::image::spacing_t spacing        = {{1., 1., 1.}};
+    const data::image::origin_t origin          = {{0., 0., 0.}};
+    const core::type type                       = core::type::UINT8;
+    const enum data::image::pixel_format format = data::image::gray_scale;
+
+    data::image::sptr image = std::make_shared<data::image>();
+
+    utest_data::generator::image::generate_image(image, size, spacing, origin, type, format);
+
+    const auto dump_lock = image->dump_lock();
+
+    filter::image::image_diff diff(image->type().size());
+
+    const std::uint8_t newvalue = 1;
+    const std::uint8_t oldvalue = 0;
+
+    // Draw in a sagittal slice, no pixels are consecutive in the buffer
+    for(std::size_t z = 0 ; z < size[2] ; ++z)
+    {
+        for(std::size_t y = 0 ; y < size[1] ; ++y)
+        {
+            const data::image::index_t index = (z * size[1] + y) * size[0] + 32;
+            diff.add_diff(index, &oldvalue, &newvalue);
+            image->set_pixel(index, &newvalue);
+        }
+    }
+
+    const std::size_t uncompressed_size = diff.size();
+
+    ui::history::image_diff_command image_diff_command(image, diff);
+
+    // The diff is compressed, it takes less memory than one index and two values per pixel
+    const std::size_t element_size = sizeof(data::image::index_t) + 2 * sizeof(std::uint8_t);
+    CPPUNIT_ASSERT(image_diff_command.size() < uncompressed_size);
+    CPPUNIT_ASSERT(image_diff_command.size() < diff.num_elements() * element_size);
+
+    // Undo and redo still work
+    CPPUNIT_ASSERT(image_diff_command.undo());
+    for(std::size_t i = 0 ; i < image->size_in_bytes() ; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(std::uint8_t(0), *reinterpret_cast<std::uint8_t*>(image->get_pixel(i)));
+    }
+
+    CPPUNIT_ASSERT(image_diff_command.redo());
+    for(std::size_t i = 0 ; i < diff.num_elements() ; ++i)
+    {
+        const data::image::index_t index = diff.get_element_diff_index(i);
+        CPPUNIT_ASSERT_EQUAL(newvalue, *reinterpret_cast<std::uint8_t*>(image->get_pixel(index)));
+    }
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::ui::history::ut
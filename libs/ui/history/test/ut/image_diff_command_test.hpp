@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2021-2023 IRCAD France
+ * Copyright (C) 2021-2024 IRCAD France
  * Copyright (C) 2017 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -32,6 +32,7 @@ class image_diff_command_test : public CPPUNIT_NS::TestFixture
 CPPUNIT_TEST_SUITE(image_diff_command_test);
 CPPUNIT_TEST(undoredo_test);
 CPPUNIT_TEST(get_size_test);
+CPPUNIT_TEST(compressed_size_test);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -43,6 +44,7 @@ public:
     // Test
     static void undoredo_test();
     static void get_size_test();
+    static void compressed_size_test();
 };
 
 } // namespace sight::ui::history::ut
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2017-2023 IRCAD France
+ * Copyright (C) 2017-2024 IRCAD France
  * Copyright (C) 2017-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -25,6 +25,7 @@
 #include <core/memory/buffer_manager.hpp>
 #include <core/memory/buffer_object.hpp>
 #include <core/profiling.hpp>
+#include <core/thread/pool.hpp>
 
 #include <viz/scene3d/ogre.hpp>
 #include <viz/scene3d/utils.hpp>
@@ -192,51 +193,57 @@ void pre_integration_table::tf_update(const data::transfer_function::csptr& _tf,
         // Inverse of the sampling accounted by the TF.
         const float sampling_adjustment_factor = 200.F;
 
-        // NOLINTNEXTLINE(clang-diagnostic-unknown-pragmas)
-        #pragma omp parallel for schedule(dynamic)
-        for(int sb = 0 ; sb < static_cast<int>(m_texture_size) ; ++sb)
-        {
-            for(int sf = 0 ; sf < static_cast<int>(m_texture_size) ; ++sf)
+        // Rows do not have the same cost, so they are spread over several chunks per thread of the pool
+        core::thread::parallel_for(
+            0,
+            static_cast<std::ptrdiff_t>(m_texture_size),
+            [&](std::ptrdiff_t _row_begin, std::ptrdiff_t _row_end)
             {
-                glm::vec4 res(0.F);
-
-                const float d = (_sample_distance * sampling_adjustment_factor) / static_cast<float>(sb - sf);
-
-                if(sb != sf)
+                for(auto sb = static_cast<int>(_row_begin) ; sb < static_cast<int>(_row_end) ; ++sb)
                 {
-                    const float opacity = 1.F - std::exp(-d * (m_integral_table[sb].a - m_integral_table[sf].a));
-
-                    const glm::vec3 colour =
-                        (d * (glm::vec3(m_integral_table[sb]) - glm::vec3(m_integral_table[sf]))) / opacity;
-
-                    res = glm::vec4(colour, opacity);
+                    for(int sf = 0 ; sf < static_cast<int>(m_texture_size) ; ++sf)
+                    {
+                        glm::vec4 res(0.F);
+
+                        const float d = (_sample_distance * sampling_adjustment_factor) / static_cast<float>(sb - sf);
+
+                        if(sb != sf)
+                        {
+                            const float opacity =
+                                1.F - std::exp(-d * (m_integral_table[sb].a - m_integral_table[sf].a));
+
+                            const glm::vec3 colour =
+                                (d * (glm::vec3(m_integral_table[sb]) - glm::vec3(m_integral_table[sf]))) / opacity;
+
+                            res = glm::vec4(colour, opacity);
+                        }
+                        else
+                        {
+                            data::transfer_function::value_t value              = sb + m_value_interval.first;
+                            data::transfer_function::color_t interpolated_color = _tf->sample(value);
+
+                            res =
+                                glm::vec4(
+                                    interpolated_color.r,
+                                    interpolated_color.g,
+                                    interpolated_color.b,
+                                    interpolated_color.a
+                                );
+
+                            res.a = 1.F - std::pow(1.F - res.a, _sample_distance * sampling_adjustment_factor);
+                        }
+
+                        res = glm::clamp(res, 0.F, 1.F);
+
+                        m_table[static_cast<unsigned>(sb) * m_texture_size + static_cast<unsigned>(sf)] = {
+                            static_cast<uint8_t>(res.b * 255.F),
+                            static_cast<uint8_t>(res.g * 255.F),
+                            static_cast<uint8_t>(res.r * 255.F),
+                            static_cast<uint8_t>(res.a * 255.F)
+                        };
+                    }
                 }
-                else
-                {
-                    data::transfer_function::value_t value              = sb + m_value_interval.first;
-                    data::transfer_function::color_t interpolated_color = _tf->sample(value);
-
-                    res =
-                        glm::vec4(
-                            interpolated_color.r,
-                            interpolated_color.g,
-                            interpolated_color.b,
-                            interpolated_color.a
-                        );
-
-                    res.a = 1.F - std::pow(1.F - res.a, _sample_distance * sampling_adjustment_factor);
-                }
-
-                res = glm::clamp(res, 0.F, 1.F);
-
-                m_table[static_cast<unsigned>(sb) * m_texture_size + static_cast<unsigned>(sf)] = {
-                    static_cast<uint8_t>(res.b * 255.F),
-                    static_cast<uint8_t>(res.g * 255.F),
-                    static_cast<uint8_t>(res.r * 255.F),
-                    static_cast<uint8_t>(res.a * 255.F)
-                };
-            }
-        }
+            });
 
         // Store table in texture buffer.
         Ogre::HardwarePixelBufferSharedPtr pix_buffer = m_table_texture->getBuffer();
@@ -25,6 +25,10 @@
 #include <app/extension/config.hpp>
 #include <app/extension/parameters.hpp>
 
+#include <core/thread/pool.hpp>
+
+#include <string>
+
 namespace sight::module::app
 {
 
@@ -37,6 +41,21 @@ void plugin::start()
     sight::app::extension::config::get()->parse_plugin_infos();
     sight::app::extension::parameters::get_default()->parse_plugin_infos();
 
+    // Sets the number of threads shared by all services for parallel computations
+    const std::string pool_size_key = "thread_pool_size";
+    if(this->get_module()->has_parameter(pool_size_key))
+    {
+        const std::string pool_size = this->get_module()->get_parameter_value(pool_size_key);
+        try
+        {
+            core::thread::pool::get().set_concurrency(std::stoul(pool_size));
+        }
+        catch(const std::exception&)
+        {
+            SIGHT_ERROR("Bad value for '" + pool_size_key + "' : '" + pool_size + "'");
+        }
+    }
+
     auto worker = core::thread::get_default_worker();
     worker->post([this](auto&& ...){run();});
 }
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -55,23 +55,32 @@ void memory_info::updating()
     std::uint64_t used_process_memory = core::memory::tools::memory_monitor_tools::get_used_process_memory();
     std::uint64_t estimate_free_mem   = core::memory::tools::memory_monitor_tools::estimate_free_mem();
 
-    core::memory::buffer_manager::size_t managed_buffer_size = 0;
-    core::memory::buffer_manager::size_t dumped_buffer_size  = 0;
-    core::memory::buffer_manager::sptr manager               = core::memory::buffer_manager::get();
+    core::memory::buffer_manager::buffer_stats stats = {0, 0};
+    core::memory::buffer_manager::sptr manager       = core::memory::buffer_manager::get();
     if(manager)
     {
-        core::memory::buffer_manager::buffer_stats stats = manager->get_buffer_stats().get();
-        managed_buffer_size = stats.total_managed;
-        dumped_buffer_size  = stats.total_dumped;
+        stats = manager->get_buffer_stats().get();
     }
 
+    const std::uint64_t nb_restores = stats.restore_hits + stats.restore_misses;
+
     std::stringstream stream;
     stream << "Total system memory = " << total_system_memory / mo << " Mo" << std::endl;
     stream << "Free system memory  = " << free_system_memory / mo << " Mo" << std::endl;
     stream << "Used process memory = " << used_process_memory / mo << " Mo" << std::endl;
     stream << "Estimated Free memory = " << estimate_free_mem / mo << " Mo" << std::endl;
-    stream << "ManagedBuffer size  = " << managed_buffer_size / mo << " Mo" << std::endl;
-    stream << "DumpedBuffer size   = " << dumped_buffer_size / mo << " Mo" << std::endl;
+    stream << "ManagedBuffer size  = " << stats.total_managed / mo << " Mo" << std::endl;
+    stream << "DumpedBuffer size   = " << stats.total_dumped / mo << " Mo" << std::endl;
+    stream << "Dumped/restored     = " << stats.dumped_bytes / mo << " Mo / " << stats.restored_bytes / mo << " Mo"
+    << std::endl;
+    stream << "Restores            = " << nb_restores << " (" << stats.restore_hits << " prefetched)" << std::endl;
+
+    if(nb_restores > 0)
+    {
+        stream << "Mean restore time   = "
+        << std::chrono::duration_cast<std::chrono::microseconds>(stats.restore_time).count()
+        / static_cast<std::int64_t>(nb_restores) << " us" << std::endl;
+    }
 
     // Information message box
     sight::ui::dialog::message::show(
@@ -46,6 +46,22 @@ namespace sight::module::memory
        </config>
    </service>
  * @endcode
+ *
+ * The prefetch_dump policy also restores buffers ahead of their use, typically the next series when browsing a list:
+ *
+ * @code{.xml}
+   <service ...>
+       <config>
+           <policy>prefetch_dump</policy>
+           <params>
+               <barrier>2GB</barrier>
+               <depth>1</depth>
+           </params>
+       </config>
+   </service>
+ * @endcode
+ *
+ * The efficiency of the prefetch can be checked with core::memory::buffer_manager::get_buffer_stats().
  */
 class dump_policy : public service::controller
 {
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2015 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -23,6 +23,8 @@
 #include "plugin.hpp"
 
 #include <core/memory/buffer_manager.hpp>
+#include <core/memory/byte_size.hpp>
+#include <core/memory/exception/bad_cast.hpp>
 #include <core/spy_log.hpp>
 
 namespace sight::module::memory
@@ -64,6 +66,44 @@ void plugin::start()
             SIGHT_ERROR("Unknown loading mode : '" + mode + "'");
         }
     }
+
+    const std::string backend_key = "dump_backend";
+
+    if(this->get_module()->has_parameter(backend_key))
+    {
+        core::mt::write_lock lock(manager->get_mutex());
+        std::string backend = this->get_module()->get_parameter_value(backend_key);
+        if(backend == "mapped")
+        {
+            manager->set_dump_backend(core::memory::buffer_manager::mapped_backend);
+            SIGHT_INFO("Enabled mapped dump backend");
+        }
+        else if(backend == "stream")
+        {
+            manager->set_dump_backend(core::memory::buffer_manager::stream_backend);
+            SIGHT_INFO("Enabled stream dump backend");
+        }
+        else
+        {
+            SIGHT_ERROR("Unknown dump backend : '" + backend + "'");
+        }
+    }
+
+    const std::string compressed_tier_key = "compressed_tier";
+
+    if(this->get_module()->has_parameter(compressed_tier_key))
+    {
+        std::string capacity = this->get_module()->get_parameter_value(compressed_tier_key);
+        try
+        {
+            manager->set_compressed_tier_capacity(core::memory::byte_size(capacity).size());
+            SIGHT_INFO("Compressed tier capacity set to " << capacity);
+        }
+        catch(core::memory::exception::bad_cast const&)
+        {
+            SIGHT_ERROR("Bad compressed tier capacity : '" + capacity + "'");
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include "synchronizer.hpp"
 
 #include <core/com/signal.hxx>
+#include <core/com/slot.hxx>
 #include <core/com/slots.hxx>
 
 #include <data/image_series.hpp>
@@ -45,12 +46,22 @@ synchronizer::synchronizer()
     new_signal<signals::int_t>(signals::FRAME_UNSYNCHRONIZED);
     new_signal<signals::int_t>(signals::MATRIX_SYNCHRONIZED);
     new_signal<signals::int_t>(signals::MATRIX_UNSYNCHRONIZED);
+    new_signal<signals::double_t>(signals::SYNCHRONIZATION_LATENCY);
 }
 
 //-----------------------------------------------------------------------------
 
 service::connections_t synchronizer::auto_connections() const
 {
+    if(m_indexed)
+    {
+        // The index is updated before trying to synchronize, see start_index()
+        return {
+            {config_key::FRAMETL_INPUT, data::timeline::signals::CLEARED, slots::RESET_TIMELINE},
+            {config_key::MATRIXTL_INPUT, data::timeline::signals::CLEARED, slots::RESET_TIMELINE}
+        };
+    }
+
     return {
         {config_key::FRAMETL_INPUT, data::timeline::signals::CLEARED, slots::RESET_TIMELINE},
         {config_key::MATRIXTL_INPUT, data::timeline::signals::CLEARED, slots::RESET_TIMELINE},
@@ -68,6 +79,13 @@ void synchronizer::configuring()
     m_legacy_auto_sync = cfg.get<bool>(config_key::LEGACY_AUTO_SYNCH, m_legacy_auto_sync);
 
     m_tolerance = cfg.get<core::clock::type>(config_key::TOLERANCE, m_tolerance);
+
+    m_indexed = cfg.get<bool>(config_key::INDEXED, m_indexed);
+    if(m_indexed && m_legacy_auto_sync)
+    {
+        SIGHT_WARN("The indexed mode is not compatible with legacyAutoSync, it is disabled.");
+        m_indexed = false;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -147,6 +165,10 @@ void synchronizer::starting()
                     config_key::OUTVAR_SEND_STATUS,
                     false
                 );
+                const bool alias = frame_out_var_config->second.get<bool>(
+                    config_key::OUTVAR_ALIAS,
+                    false
+                );
 
                 m_frame_out_var_parameters.emplace_back(
                     out_var_parameter(
@@ -156,7 +178,8 @@ void synchronizer::starting()
                         element_index,
                         false,
                         send_status,
-                        0
+                        0,
+                        alias
                     })
                 );
             }
@@ -197,7 +220,14 @@ void synchronizer::starting()
         }
     }
 
+    m_frame_aliases.resize(m_frames.size());
+
     SIGHT_ASSERT("No valid worker for timer.", this->worker());
+    if(m_indexed)
+    {
+        this->start_index();
+    }
+
     if(m_legacy_auto_sync)
     {
         m_worker = sight::core::thread::worker::make();
@@ -226,11 +256,30 @@ void synchronizer::stopping()
         m_worker->stop();
         m_worker.reset();
     }
+
+    if(m_indexed)
+    {
+        this->stop_index();
+    }
+
+    for(std::size_t i = 0 ; i < m_frame_aliases.size() ; ++i)
+    {
+        if(m_frame_aliases[i].buffer)
+        {
+            const auto frame = m_frames[i].lock();
+            this->release_frame_alias(i, *frame);
+        }
+    }
+
+    m_frame_aliases.clear();
 }
 
 // ----------------------------------------------------------------------------
 
-void synchronizer::synchronize()
+core::clock::type synchronizer::scan_timelines(
+    std::vector<std::size_t>& _frame_tl_to_synch_index,
+    std::vector<std::size_t>& _matrix_tl_to_synch_index
+)
 {
     // do the synchronisation
     // step 1: get the TL implicated in the synchronization
@@ -307,33 +356,85 @@ void synchronizer::synchronize()
 
     if(max_synchronization_timestamp == 0)
     {
-        // there is nothing to synchronize
-        SIGHT_INFO("skip sync, because there is nothing to sync");
-        this->signal<signals::timestamp_t>(signals::SYNCHRONIZATION_DONE)->async_emit(max_synchronization_timestamp);
-        return;
+        return 0.;
     }
 
     core::clock::type synchronization_timestamp = max_synchronization_timestamp;
-    std::vector<std::size_t> frame_tl_to_synch_index;
     for(std::size_t i = 0 ; i < frame_tl_populated_timestamp.size() ; i++)
     {
         if(max_synchronization_timestamp - frame_tl_populated_timestamp[i] < m_tolerance)
         {
             synchronization_timestamp = std::min(synchronization_timestamp, frame_tl_populated_timestamp[i]);
-            frame_tl_to_synch_index.push_back(frame_tl_populated_index[i]);
+            _frame_tl_to_synch_index.push_back(frame_tl_populated_index[i]);
         }
     }
 
-    std::vector<std::size_t> matrix_tl_to_synch_index;
     for(std::size_t i = 0 ; i < matrix_tl_populated_timestamp.size() ; i++)
     {
         if(max_synchronization_timestamp - matrix_tl_populated_timestamp[i] < m_tolerance)
         {
             synchronization_timestamp = std::min(synchronization_timestamp, matrix_tl_populated_timestamp[i]);
-            matrix_tl_to_synch_index.push_back(matrix_tl_populated_index[i]);
+            _matrix_tl_to_synch_index.push_back(matrix_tl_populated_index[i]);
+        }
+    }
+
+    return synchronization_timestamp;
+}
+
+// ----------------------------------------------------------------------------
+
+core::clock::type synchronizer::query_index(
+    std::vector<std::size_t>& _frame_tl_to_synch_index,
+    std::vector<std::size_t>& _matrix_tl_to_synch_index
+)
+{
+    if(m_index.empty())
+    {
+        return 0.;
+    }
+
+    // Same rule as scan_timelines(): the timelines whose newest timestamp is in the tolerance range from the most
+    // recent one are synchronized, around the oldest of them. They are all at the end of the index.
+    const core::clock::type max_synchronization_timestamp = m_index.rbegin()->first;
+    const auto first                                      = m_index.upper_bound(
+        max_synchronization_timestamp - m_tolerance
+    );
+
+    const std::size_t nb_frame_tls = m_frame_tls.size();
+    for(auto it = first ; it != m_index.end() ; ++it)
+    {
+        if(it->second < nb_frame_tls)
+        {
+            _frame_tl_to_synch_index.push_back(it->second);
+        }
+        else
+        {
+            _matrix_tl_to_synch_index.push_back(it->second - nb_frame_tls);
         }
     }
 
+    return first == m_index.end() ? max_synchronization_timestamp : first->first;
+}
+
+// ----------------------------------------------------------------------------
+
+void synchronizer::synchronize()
+{
+    std::vector<std::size_t> frame_tl_to_synch_index;
+    std::vector<std::size_t> matrix_tl_to_synch_index;
+
+    const core::clock::type synchronization_timestamp =
+        m_indexed ? this->query_index(frame_tl_to_synch_index, matrix_tl_to_synch_index)
+                  : this->scan_timelines(frame_tl_to_synch_index, matrix_tl_to_synch_index);
+
+    if(synchronization_timestamp == 0)
+    {
+        // there is nothing to synchronize
+        SIGHT_INFO("skip sync, because there is nothing to sync");
+        this->signal<signals::timestamp_t>(signals::SYNCHRONIZATION_DONE)->async_emit(synchronization_timestamp);
+        return;
+    }
+
     //step 3: get the matrix + frame and populate the output
 
     if(m_last_time_stamp != synchronization_timestamp)
@@ -353,6 +454,24 @@ void synchronizer::synchronize()
         this->signal<signals::timestamp_t>(signals::SYNCHRONIZATION_DONE)->async_emit(synchronization_timestamp);
         send_frame_var_status(frame_tl_to_synch_index);
         send_matrix_var_status(matrix_tl_to_synch_index);
+
+        if(m_indexed)
+        {
+            core::clock::type received = 0.;
+            for(const std::size_t tl_index : frame_tl_to_synch_index)
+            {
+                received = std::max(received, m_cursors[tl_index].received);
+            }
+
+            for(const std::size_t tl_index : matrix_tl_to_synch_index)
+            {
+                received = std::max(received, m_cursors[m_frame_tls.size() + tl_index].received);
+            }
+
+            this->signal<signals::double_t>(signals::SYNCHRONIZATION_LATENCY)->async_emit(
+                core::clock::get_time_in_milli_sec() - received
+            );
+        }
     }
     else
     {
@@ -362,6 +481,125 @@ void synchronizer::synchronize()
 
 // ----------------------------------------------------------------------------
 
+void synchronizer::start_index()
+{
+    const std::size_t nb_frame_tls = m_frame_tls.size();
+    m_cursors.assign(nb_frame_tls + m_matrix_tl_s.size(), {});
+
+    const auto track =
+        [this](std::size_t _cursor_index, const auto& _tl)
+        {
+            if(!_tl)
+            {
+                return;
+            }
+
+            // Timestamps pushed before the service started
+            const core::clock::type newest = _tl->get_newer_timestamp();
+            if(newest > 0)
+            {
+                auto& cursor = m_cursors[_cursor_index];
+                cursor.newest   = newest;
+                cursor.received = _tl->get_newer_push_time();
+                cursor.entry    = m_index.emplace(newest, _cursor_index);
+            }
+
+            // The latency is measured from the push, not from this slot which may run later on the worker
+            auto pushed_slot = core::com::new_slot(
+                [this, _cursor_index, weak_tl = std::weak_ptr<const data::buffer_tl>(_tl.get_shared())](
+                    core::clock::type _timestamp)
+                {
+                    const auto tl = weak_tl.lock();
+                    this->update_index(
+                        _cursor_index,
+                        _timestamp,
+                        tl ? tl->get_newer_push_time() : core::clock::get_time_in_milli_sec()
+                    );
+                });
+            pushed_slot->set_worker(this->worker());
+            m_index_connections.push_back(
+                _tl->template signal<data::timeline::signals::pushed_t>(data::timeline::signals::PUSHED)->connect(
+                    pushed_slot
+                )
+            );
+            m_index_slots.push_back(pushed_slot);
+
+            auto cleared_slot = core::com::new_slot([this, _cursor_index]{this->clear_index(_cursor_index);});
+            cleared_slot->set_worker(this->worker());
+            m_index_connections.push_back(
+                _tl->template signal<data::timeline::signals::cleared_t>(data::timeline::signals::CLEARED)->connect(
+                    cleared_slot
+                )
+            );
+            m_index_slots.push_back(cleared_slot);
+        };
+
+    for(std::size_t i = 0 ; i != nb_frame_tls ; ++i)
+    {
+        track(i, m_frame_tls[i].lock());
+    }
+
+    for(std::size_t i = 0 ; i != m_matrix_tl_s.size() ; ++i)
+    {
+        track(nb_frame_tls + i, m_matrix_tl_s[i].lock());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void synchronizer::stop_index()
+{
+    for(auto& connection : m_index_connections)
+    {
+        connection.disconnect();
+    }
+
+    m_index_connections.clear();
+    m_index_slots.clear();
+    m_index.clear();
+    m_cursors.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void synchronizer::update_index(
+    std::size_t _cursor_index,
+    core::clock::type _timestamp,
+    core::clock::type _pushed
+)
+{
+    auto& cursor = m_cursors[_cursor_index];
+
+    // Like get_newer_timestamp(), only a more recent timestamp changes the newest one of the timeline
+    if(_timestamp > cursor.newest)
+    {
+        if(cursor.newest > 0)
+        {
+            m_index.erase(cursor.entry);
+        }
+
+        cursor.newest   = _timestamp;
+        cursor.received = _pushed;
+        cursor.entry    = m_index.emplace(_timestamp, _cursor_index);
+    }
+
+    this->try_sync();
+}
+
+// ----------------------------------------------------------------------------
+
+void synchronizer::clear_index(std::size_t _cursor_index)
+{
+    auto& cursor = m_cursors[_cursor_index];
+    if(cursor.newest > 0)
+    {
+        m_index.erase(cursor.entry);
+        cursor.newest = 0.;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 void synchronizer::try_sync()
 {
     if(m_locked)
@@ -375,6 +613,18 @@ void synchronizer::try_sync()
 
 //------------------------------------------------------------------------------
 
+void synchronizer::swapping(std::string_view /*_key*/)
+{
+    // The connections to the timelines are made by hand, since each timeline updates its own cursor
+    if(m_indexed)
+    {
+        this->stop_index();
+        this->start_index();
+    }
+}
+
+//------------------------------------------------------------------------------
+
 void synchronizer::request_sync()
 {
     m_locked = false;
@@ -403,17 +653,31 @@ void synchronizer::copy_frame_from_tl_to_output(
     core::clock::type _synchronization_timestamp
 )
 {
-    const auto frame_tl = m_frame_tls[_frame_tl_index].lock();
-    CSPTR(data::frame_tl::buffer_t) buffer =
-        frame_tl->get_closest_buffer(_synchronization_timestamp - m_frame_tl_delay[_frame_tl_index]);
+    const auto frame_tl                   = m_frame_tls[_frame_tl_index].lock();
+    const core::clock::type timestamp     = _synchronization_timestamp - m_frame_tl_delay[_frame_tl_index];
+    const data::timeline::ring::sptr ring = frame_tl->get_ring();
+
+    // The frames of a timeline with a ring are read in place, the slot stays borrowed until they are copied
+    CSPTR(data::frame_tl::buffer_t) buffer;
+    data::timeline::ring::view view;
+    if(ring)
+    {
+        view = ring->get_closest(timestamp);
+    }
+    else
+    {
+        buffer = frame_tl->get_closest_buffer(timestamp);
+    }
 
     data::image::size_t frame_tl_size = {frame_tl->get_width(), frame_tl->get_height(), 0};
 
     std::size_t frame_tl_num_components                     = frame_tl->num_components();
     core::type frame_tl_type                                = frame_tl->type();
     enum data::frame_tl::pixel_format frame_tl_pixel_format = frame_tl->pixel_format();
+    const std::size_t frame_tl_element_size                 = frame_tl->get_width() * frame_tl->get_height()
+                                                              * frame_tl_num_components * frame_tl_type.size();
 
-    if(buffer)
+    if(buffer || view)
     {
         for(const out_var_parameter output_var_param : get_frame_tl_output_var_index(_frame_tl_index))
         {
@@ -423,41 +687,46 @@ void synchronizer::copy_frame_from_tl_to_output(
             const auto frame = m_frames[frame_out_index].lock();
             SIGHT_ASSERT("image with index '" << frame_out_index << "' does not exist", frame);
 
-            // Check if frame dimensions have changed
-            if(frame_tl_size != frame->size() || frame_tl_num_components != frame->num_components())
-            {
-                enum data::image::pixel_format format
-                {
-                    data::image::undefined
-                };
-                switch(frame_tl_pixel_format)
-                {
-                    case data::frame_tl::pixel_format::gray_scale:
-                        format = data::image::gray_scale;
-                        break;
-
-                    case data::frame_tl::pixel_format::rgb:
-                        format = data::image::rgb;
-                        break;
+            const enum data::image::pixel_format format = data::frame_tl::to_image_format(frame_tl_pixel_format);
+            const std::uint8_t* frame_buff              = buffer
+                                                          ? &buffer->get_element(frame_tl_element_index)
+                                                          : view.data() + frame_tl_element_index
+                                                          * frame_tl_element_size;
+            const std::size_t frame_buff_size = buffer ? buffer->size() : ring->slot_size();
 
-                    case data::frame_tl::pixel_format::bgr:
-                        format = data::image::bgr;
-                        break;
+            // A slot of the ring can not be aliased, since it would stay borrowed
+            const bool aliased = output_var_param.alias && buffer;
 
-                    case data::frame_tl::pixel_format::rgba:
-                        format = data::image::rgba;
-                        break;
+            // Check if frame dimensions have changed
+            const bool resized = frame_tl_size != frame->size() || frame_tl_num_components != frame->num_components();
+            if((resized || aliased) && format == data::image::undefined)
+            {
+                SIGHT_ERROR("FrameTL pixel format undefined");
+                return;
+            }
 
-                    case data::frame_tl::pixel_format::bgra:
-                        format = data::image::bgra;
-                        break;
+            if(aliased)
+            {
+                // The image views the timeline buffer, see data::frame_tl::view()
+                auto& alias = m_frame_aliases[frame_out_index];
+                alias.locks.clear();
+                frame_tl->view(*frame, buffer, frame_tl_element_index);
+                alias.buffer = buffer;
+                alias.data   = frame_buff;
+                alias.locks  = frame->dump_lock();
+            }
+            else
+            {
+                this->release_frame_alias(frame_out_index, *frame);
 
-                    default:
-                        SIGHT_ERROR("FrameTL pixel format undefined");
-                        return;
+                if(resized)
+                {
+                    frame->resize(frame_tl_size, frame_tl_type, format);
                 }
+            }
 
-                frame->resize(frame_tl_size, frame_tl_type, format);
+            if(resized)
+            {
                 const data::image::origin_t origin = {0., 0., 0.};
                 frame->set_origin(origin);
                 const data::image::spacing_t spacing = {1., 1., 1.};
@@ -476,9 +745,11 @@ void synchronizer::copy_frame_from_tl_to_output(
                 image_series->set_frame_acquisition_time_point(_synchronization_timestamp, 0);
             }
 
-            const std::uint8_t* frame_buff = &buffer->get_element(frame_tl_element_index);
-            auto iter                      = frame->begin<std::uint8_t>();
-            std::memcpy(&*iter, frame_buff, buffer->size());
+            if(!aliased)
+            {
+                auto iter = frame->begin<std::uint8_t>();
+                std::memcpy(&*iter, frame_buff, frame_buff_size);
+            }
 
             // Notify
             auto sig = frame->signal<data::image::buffer_modified_signal_t>(data::image::BUFFER_MODIFIED_SIG);
@@ -496,6 +767,31 @@ void synchronizer::copy_frame_from_tl_to_output(
 
 // ----------------------------------------------------------------------------
 
+void synchronizer::release_frame_alias(std::size_t _frame_out_index, data::image& _frame)
+{
+    auto& alias = m_frame_aliases[_frame_out_index];
+    if(!alias.buffer)
+    {
+        return;
+    }
+
+    alias.locks.clear();
+
+    // Replace the timeline buffer by an owned one, holding a copy of the last frame
+    const auto size   = _frame.size();
+    const auto type   = _frame.type();
+    const auto format = _frame.pixel_format();
+    _frame.set_buffer(nullptr, true, type, size, format);
+    _frame.resize(size, type, format);
+
+    const auto dump_lock = _frame.dump_lock();
+    std::memcpy(_frame.buffer(), alias.data, _frame.size_in_bytes());
+
+    alias = {};
+}
+
+// ----------------------------------------------------------------------------
+
 std::vector<synchronizer::out_var_parameter> synchronizer::get_matrix_tl_output_var_index(
     std::size_t _matrix_tl_index
 )
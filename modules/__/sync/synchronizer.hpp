@@ -21,6 +21,9 @@
 
 #pragma once
 
+#include <core/com/connection.hpp>
+#include <core/com/slot_base.hpp>
+#include <core/memory/buffer_object.hpp>
 #include <core/thread/timer.hpp>
 
 #include <data/frame_tl.hpp>
@@ -30,6 +33,8 @@
 
 #include <service/synchronizer.hpp>
 
+#include <map>
+
 namespace sight::module::sync
 {
 
@@ -52,6 +57,8 @@ namespace sight::module::sync
  * previously.
  * - \b matrix_unsynchronized(int): Emitted when a matrix with sendStatus at true is unsynchronized while it wasn't
  * previously.
+ * - \b synchronization_latency(double): Emitted with the synchronization, in indexed mode only, with the time in
+ * milliseconds elapsed since the most recent data used for the synchronization was pushed in its timeline.
  *
  * @section Slots Slots
  * - \b try_sync() : synchronizes the timelines, if a request has been sent earlier. Normally you don't need to connect
@@ -96,6 +103,7 @@ namespace sight::module::sync
             <key uid="matrix4" tl="0" index2"/>
         </inout>
         <tolerance>500</tolerance>
+        <indexed>false</indexed>
     </service>
    @endcode
  *
@@ -104,6 +112,7 @@ namespace sight::module::sync
  * @subsection Input Input
  * - \b frameTL [sight::data::frame_tl]: defines the frameTL to synchronize.
  *  each frameTL can have an optional attribute, which is the delay to apply to the timeline.
+ *  If the ring of a frameTL is enabled, see data::buffer_tl::init_ring(), its frames are read from the ring.
  * - \b matrixTL [sight::data::matrix_tl]: defines the frameTL to synchronize.
  *  each matrixTL can have an optional attribute, which is the delay to apply to the timeline.
  *
@@ -114,6 +123,10 @@ namespace sight::module::sync
  *    - index: the element index, in the tl, from which the data are taken to populate the frame variable (default: 0).
  *    - sendStatus: a boolean to specify if a signal should be send when the variable synchronization state changes
  *(default: false).
+ *    - alias: a boolean to specify if the image should point to the buffer of the timeline instead of holding a copy
+ * (default: false). The image must then be considered as read-only. The buffer is kept alive until the next
+ * synchronization, and a copy of the last frame is given back to the image when the service stops. The frames of a
+ * ring are always copied.
  * - \b matrix [sight::data::matrix4]: defines the matrix where to extract the image.
  *  each frame can have an optional attribute:
  *    - tl : the index of the tl from which the data are taken to populate the frame variable (default: 0).
@@ -127,6 +140,9 @@ namespace sight::module::sync
  * should not be set to "true" in new configurations (default: false).
  * - \b tolerance : defines the maximum distance between two frames (default: 500).
  *      If a timeline exceeds this tolerance it will not be synchronized (default: true).
+ * - \b indexed : if true, the newest timestamp of each timeline is tracked when its data are pushed, in an index sorted
+ * by timestamp. The synchronization then only looks up the index instead of locking and scanning every timeline. This
+ * is not compatible with legacyAutoSync (default: false).
  */
 class synchronizer final : public service::synchronizer
 {
@@ -138,15 +154,17 @@ public:
     struct signals
     {
         using key_t = sight::core::com::signals::key_t;
-        static inline const key_t SYNCHRONIZATION_DONE  = "synchronization_done";
-        static inline const key_t FRAME_SYNCHRONIZED    = "frameSynchronized";
-        static inline const key_t FRAME_UNSYNCHRONIZED  = "frameUnsynchronized";
-        static inline const key_t MATRIX_SYNCHRONIZED   = "matrix_synchronized";
-        static inline const key_t MATRIX_UNSYNCHRONIZED = "matrix_unsynchronized";
+        static inline const key_t SYNCHRONIZATION_DONE    = "synchronization_done";
+        static inline const key_t FRAME_SYNCHRONIZED      = "frameSynchronized";
+        static inline const key_t FRAME_UNSYNCHRONIZED    = "frameUnsynchronized";
+        static inline const key_t MATRIX_SYNCHRONIZED     = "matrix_synchronized";
+        static inline const key_t MATRIX_UNSYNCHRONIZED   = "matrix_unsynchronized";
+        static inline const key_t SYNCHRONIZATION_LATENCY = "synchronization_latency";
 
         using timestamp_t = sight::core::com::signal<void (core::clock::type _timestamp)>;
         using void_t      = sight::core::com::signal<void ()>;
         using int_t       = sight::core::com::signal<void (int)>;
+        using double_t    = sight::core::com::signal<void (double)>;
     };
 
     /// Internal wrapper holding slots keys.
@@ -169,6 +187,7 @@ public:
         static inline const std::string OUTVAR_TL_INDEX      = "<xmlattr>.tl";
         static inline const std::string OUTVAR_ELEMENT_INDEX = "<xmlattr>.index";
         static inline const std::string OUTVAR_SEND_STATUS   = "<xmlattr>.sendStatus";
+        static inline const std::string OUTVAR_ALIAS         = "<xmlattr>.alias";
         static inline const std::string TL_DELAY             = "<xmlattr>.delay";
         static inline const std::string KEY                  = "key";
 
@@ -178,6 +197,7 @@ public:
         static inline const std::string MATRIX_INOUT      = "matrix";
         static inline const std::string TOLERANCE         = "tolerance";
         static inline const std::string LEGACY_AUTO_SYNCH = "legacyAutoSync";
+        static inline const std::string INDEXED           = "indexed";
     };
 
     /// Internal wrapper used for out variable association with TLs
@@ -189,6 +209,7 @@ public:
         bool is_synchronized {false};
         bool signal_synchronization {false};
         int delay {0};
+        bool alias {false};
     };
 
     /**
@@ -231,6 +252,11 @@ protected:
      */
     void updating() final;
 
+    /**
+     * @brief Rebuilds the index in indexed mode, since the connections to the swapped timelines are made by hand.
+     */
+    void swapping(std::string_view _key) final;
+
     /**
      * @brief SLOT: Synchronizes the TLs, fill the output variables, and send notifications
      */
@@ -294,6 +320,72 @@ protected:
 
 private:
 
+    /// Newest timestamp of a timeline, tracked in indexed mode
+    struct timeline_cursor
+    {
+        /// Newest timestamp pushed in the timeline, 0 if the timeline is empty
+        core::clock::type newest {0.};
+
+        /// Time when the newest timestamp was pushed in the timeline, see data::buffer_tl::get_newer_push_time()
+        core::clock::type received {0.};
+
+        /// Entry of the timeline in m_index, only valid if the timeline is not empty
+        std::multimap<core::clock::type, std::size_t>::iterator entry;
+    };
+
+    /// Image viewing the buffer of a timeline, the buffer is also held here to copy the last frame back at release
+    struct frame_alias
+    {
+        CSPTR(data::frame_tl::buffer_t) buffer;
+        const std::uint8_t* data {nullptr};
+        std::vector<core::memory::buffer_object::lock_t> locks;
+    };
+
+    /**
+     * @brief Finds the timelines to synchronize by locking and scanning every timeline.
+     *
+     * @param[out] _frame_tl_to_synch_index : indices of the frame timelines to synchronize
+     * @param[out] _matrix_tl_to_synch_index : indices of the matrix timelines to synchronize
+     * @return the synchronization timestamp, 0 if there is nothing to synchronize
+     */
+    core::clock::type scan_timelines(
+        std::vector<std::size_t>& _frame_tl_to_synch_index,
+        std::vector<std::size_t>& _matrix_tl_to_synch_index
+    );
+
+    /**
+     * @brief Finds the timelines to synchronize from the timestamps index.
+     *
+     * @param[out] _frame_tl_to_synch_index : indices of the frame timelines to synchronize
+     * @param[out] _matrix_tl_to_synch_index : indices of the matrix timelines to synchronize
+     * @return the synchronization timestamp, 0 if there is nothing to synchronize
+     */
+    core::clock::type query_index(
+        std::vector<std::size_t>& _frame_tl_to_synch_index,
+        std::vector<std::size_t>& _matrix_tl_to_synch_index
+    );
+
+    /// Initializes the cursors from the timelines and connects their signals to update them
+    void start_index();
+
+    /// Disconnects the timelines and clears the index
+    void stop_index();
+
+    /**
+     * @brief Updates the index when a timestamp is pushed in a timeline, then tries to synchronize.
+     *
+     * @param _cursor_index : index of the timeline cursor, frame timelines come first
+     * @param _timestamp : pushed timestamp
+     * @param _pushed : time when the timestamp was pushed, see data::buffer_tl::get_newer_push_time()
+     */
+    void update_index(std::size_t _cursor_index, core::clock::type _timestamp, core::clock::type _pushed);
+
+    /// Removes a timeline from the index when it is cleared
+    void clear_index(std::size_t _cursor_index);
+
+    /// Gives back a copy of the aliased buffer to an image, so that it does not point to the timeline anymore
+    void release_frame_alias(std::size_t _frame_out_index, data::image& _frame);
+
     /**
      * @brief Get the index of the frame output vars, associated to the given TL
      *
@@ -391,6 +483,22 @@ private:
 
     bool m_locked {false};
 
+    /// Defines if the timelines are tracked incrementally instead of being scanned at each synchronization
+    bool m_indexed {false};
+
+    /// Cursors of the frame timelines, followed by the ones of the matrix timelines
+    std::vector<timeline_cursor> m_cursors;
+
+    /// Newest timestamp of each non-empty timeline, associated to the index of its cursor
+    std::multimap<core::clock::type, std::size_t> m_index;
+
+    /// Slots and connections updating the index
+    std::vector<core::com::slot_base::sptr> m_index_slots;
+    std::vector<core::com::connection> m_index_connections;
+
+    /// Timeline buffers held by the aliased images, by output index
+    std::vector<frame_alias> m_frame_aliases;
+
     /// Contains the input video timelines.
     data::ptr_vector<data::frame_tl, data::access::in> m_frame_tls {this, config_key::FRAMETL_INPUT};
 
@@ -2116,4 +2116,180 @@ void synchronizer_test::single_image_series_tl_population()
 
 //------------------------------------------------------------------------------
 
+void synchronizer_test::indexed_synchronisation_test()
+{
+    std::stringstream config_string;
+    config_string
+    << "<in group=\"frameTL\">"
+       "    <key uid=\"frameTL1\" />"
+       "    <key uid=\"frameTL2\" />"
+       "</in>"
+       "<inout group=\"frames\">"
+       "    <key uid=\"frame1\" tl=\"0\" alias=\"true\"/>"
+       "    <key uid=\"frame2\" tl=\"1\" />"
+       "</inout>"
+       "<in group=\"matrixTL\">"
+       "    <key uid=\"matrixTL1\" />"
+       "</in>"
+       "<inout group=\"matrix\">"
+       "    <key uid=\"matrix1\" tl=\"0\"/>"
+       "</inout>"
+       "<tolerance>5</tolerance>"
+       "<indexed>true</indexed>";
+
+    synchronizer_tester tester(config_string);
+    tester.init_standard_in_out();
+    tester.srv->start().wait();
+
+    core::clock::type last_timestamp_synch = 0;
+    auto slot_synchronization_done         =
+        sight::core::com::new_slot(
+            [&last_timestamp_synch](core::clock::type _timestamp)
+        {
+            last_timestamp_synch = _timestamp;
+        });
+    slot_synchronization_done->set_worker(sight::core::thread::get_default_worker());
+    auto synch_done_connection = tester.srv->signal("synchronization_done")->connect(slot_synchronization_done);
+
+    // Assertions can not be made in the slot, it runs on another thread than the test
+    std::atomic_int latency_count          = 0;
+    std::atomic_int negative_latency_count = 0;
+    auto slot_latency                      =
+        sight::core::com::new_slot(
+            [&latency_count, &negative_latency_count](double _latency)
+        {
+            if(_latency < 0.)
+            {
+                ++negative_latency_count;
+            }
+
+            ++latency_count;
+        });
+    slot_latency->set_worker(sight::core::thread::get_default_worker());
+    auto latency_connection = tester.srv->signal("synchronization_latency")->connect(slot_latency);
+
+    const auto push =
+        [](const auto& _tl, core::clock::type _timestamp)
+        {
+            _tl->template signal<data::timeline::signals::pushed_t>(data::timeline::signals::PUSHED)->async_emit(
+                _timestamp
+            );
+        };
+
+    // Nothing was pushed yet, this only locks the synchronization until the next request
+    tester.srv->slot("try_sync")->async_run().wait();
+
+    // The index is only fed by the pushed signals
+    tester.add_frame_to_frame_tl(tester.frame_tl_1, 1);
+    tester.add_frame_to_frame_tl(tester.frame_tl_2, 1);
+    synchronizer_tester::add_matrix_to_matrix_tl(tester.matrix_tl_1, 1);
+    push(tester.frame_tl_1, 1);
+    push(tester.frame_tl_2, 1);
+    push(tester.matrix_tl_1, 1);
+    tester.srv->slot("request_sync")->async_run().wait();
+    tester.srv->slot("try_sync")->async_run().wait();
+    SIGHT_TEST_FAIL_WAIT(last_timestamp_synch == 1);
+    synchronizer_tester::check_frame(tester.frame1, 1);
+    synchronizer_tester::check_frame(tester.frame2, 1);
+    synchronizer_tester::check_matrix(tester.matrix1, 1);
+    SIGHT_TEST_FAIL_WAIT(latency_count == 1);
+
+    // frame1 points to the timeline buffer, frame2 holds a copy
+    {
+        const auto dump_lock_frame1 = tester.frame1->dump_lock();
+        const auto dump_lock_frame2 = tester.frame2->dump_lock();
+        CPPUNIT_ASSERT_EQUAL(
+            static_cast<const void*>(&tester.frame_tl_1->get_closest_buffer(1)->get_element(0)),
+            static_cast<const void*>(tester.frame1->buffer())
+        );
+        CPPUNIT_ASSERT(
+            static_cast<const void*>(&tester.frame_tl_2->get_closest_buffer(1)->get_element(0))
+            != static_cast<const void*>(tester.frame2->buffer())
+        );
+    }
+
+    // Only the first frame timeline is in the tolerance range
+    tester.add_frame_to_frame_tl(tester.frame_tl_1, 10);
+    push(tester.frame_tl_1, 10);
+    tester.srv->slot("request_sync")->async_run().wait();
+    tester.srv->slot("try_sync")->async_run().wait();
+    SIGHT_TEST_FAIL_WAIT(last_timestamp_synch == 10);
+    synchronizer_tester::check_frame(tester.frame1, 10);
+    synchronizer_tester::check_frame(tester.frame2, 1);
+    synchronizer_tester::check_matrix(tester.matrix1, 1);
+    SIGHT_TEST_FAIL_WAIT(latency_count == 2);
+    CPPUNIT_ASSERT_EQUAL(0, negative_latency_count.load());
+
+    // The index follows a swapped timeline
+    auto new_frame_tl = std::make_shared<data::frame_tl>();
+    new_frame_tl->init_pool_size(
+        tester.frame_size[0],
+        tester.frame_size[1],
+        core::type::UINT8,
+        sight::data::frame_tl::pixel_format::gray_scale
+    );
+    tester.srv->set_input(new_frame_tl, "frameTL", true, false, 0);
+    tester.srv->swap_key("frameTL", new_frame_tl).wait();
+    tester.add_frame_to_frame_tl(new_frame_tl, 11);
+    push(new_frame_tl, 11);
+    tester.srv->slot("request_sync")->async_run().wait();
+    tester.srv->slot("try_sync")->async_run().wait();
+    SIGHT_TEST_FAIL_WAIT(last_timestamp_synch == 11);
+    synchronizer_tester::check_frame(tester.frame1, 11);
+    SIGHT_TEST_FAIL_WAIT(latency_count == 3);
+    CPPUNIT_ASSERT_EQUAL(0, negative_latency_count.load());
+
+    // Once stopped, the aliased image owns a copy of its last frame
+    tester.srv->stop().wait();
+    new_frame_tl->clear_timeline();
+    synchronizer_tester::check_frame(tester.frame1, 11);
+}
+
+//------------------------------------------------------------------------------
+
+void synchronizer_test::ring_population_test()
+{
+    synchronizer_tester tester;
+    core::clock::type last_timestamp_synch = 0;
+    auto slot_synchronization_done         =
+        sight::core::com::new_slot(
+            [&last_timestamp_synch](core::clock::type _timestamp)
+        {
+            last_timestamp_synch = _timestamp;
+        });
+    slot_synchronization_done->set_worker(sight::core::thread::get_default_worker());
+    auto synch_done_connection = tester.srv->signal("synchronization_done")->connect(slot_synchronization_done);
+
+    // The producer writes in place in the ring, the map of the timeline stays empty
+    tester.frame_tl_1->init_ring(3);
+    const auto push =
+        [&tester](std::uint8_t _timestamp)
+        {
+            data::timeline::ring::writer writer = tester.frame_tl_1->begin_push();
+            CPPUNIT_ASSERT(writer);
+            std::memset(writer.data(), _timestamp, tester.frame_size[0] * tester.frame_size[1]);
+            tester.frame_tl_1->publish(writer, _timestamp);
+        };
+
+    push(1);
+    push(2);
+    tester.srv->slot("request_sync")->run();
+    tester.srv->slot("try_sync")->run();
+    synchronizer_tester::check_frame(tester.frame1, 2);
+    synchronizer_tester::check_frame(tester.frame2, 0);
+    CPPUNIT_ASSERT(!tester.frame_tl_1->get_newer_object());
+
+    // The synchronized slot is released, the producer can go round the ring
+    push(3);
+    push(4);
+    push(5);
+    tester.srv->slot("request_sync")->run();
+    tester.srv->slot("try_sync")->run();
+    SIGHT_TEST_FAIL_WAIT(last_timestamp_synch == 5);
+    synchronizer_tester::check_frame(tester.frame1, 5);
+    synchronizer_tester::check_frame(tester.frame2, 0);
+}
+
+//------------------------------------------------------------------------------
+
 } // namespace sight::module::sync::ut
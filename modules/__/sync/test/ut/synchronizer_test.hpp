@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2022-2023 IRCAD France
+ * Copyright (C) 2022-2024 IRCAD France
  *
  * This file is part of Sight.
  *
@@ -101,6 +101,8 @@ CPPUNIT_TEST(delay_test);
 CPPUNIT_TEST(tolerance_test);
 CPPUNIT_TEST(image_series_time_tagging_test);
 CPPUNIT_TEST(single_image_series_tl_population);
+CPPUNIT_TEST(indexed_synchronisation_test);
+CPPUNIT_TEST(ring_population_test);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -170,6 +172,13 @@ public:
     /// Test with an ImageSeries and matrices to ensure timestamp data is written in the ImageSeries
     /// assuming a more complex context
     static void single_image_series_tl_population();
+
+    /// Synchronisation driven by the pushed signals of the timelines, with an output image aliasing the timeline
+    /// buffer. Checks the latency signal and that the aliased image keeps a copy of its last frame once stopped.
+    static void indexed_synchronisation_test();
+
+    /// Give frames to a frameTL through its ring, without locking it, and check that the out frame is well filled
+    static void ring_population_test();
 };
 
 } // namespace sight::module::sync::ut
@@ -187,10 +187,12 @@ void propagator::propagate()
                         samples_out->resize(voxels_size, image_in->type(), image_in->pixel_format());
 
                         const auto lock = samples_out->dump_lock();
-                        for(std::size_t i = 0 ; i < propag_diff.num_elements() ; ++i)
-                        {
-                            samples_out->set_pixel(i, propag_diff.get_element(i).m_old_value);
-                        }
+                        std::size_t i   = 0;
+                        propag_diff.for_each_element(
+                            [&samples_out, &i](const sight::filter::image::image_diff::element_t& _elt)
+                            {
+                                samples_out->set_pixel(i++, _elt.m_old_value);
+                            });
 
                         samples_out->signal<data::image::modified_signal_t>(data::image::MODIFIED_SIG)->async_emit();
                     }
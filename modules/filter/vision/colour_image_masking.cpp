@@ -74,6 +74,7 @@ void colour_image_masking::configuring()
     m_noise                 = config.get<double>("noise", 0.0);
     m_foreground_components = config.get<int>("foregroundComponents", 5);
     m_background_components = config.get<int>("backgroundComponents", 5);
+    m_lookup_table          = config.get<bool>("lookupTable", true);
 
     SIGHT_ASSERT(
         "Scale factor must be between 0 and 1. Current value: " << m_scale_factor,
@@ -128,6 +129,7 @@ void colour_image_masking::starting()
     namespace vision = sight::filter::vision;
     m_masker         = std::make_unique<vision::masker>(vision::h_sv, vision::ll_ratio);
     m_masker->set_threshold(1.);
+    m_masker->set_lookup_table(m_lookup_table);
 
     m_last_video_timestamp = 0.;
 }
@@ -53,7 +53,7 @@ namespace sight::module::filter::vision
             <in key="videoTL" uid="..." auto_connect="true" />
             <inout key="mask" uid="..." />
             <inout key="videoMaskTL" uid="..." />
-            <config scaleFactor="0.5" noise="30" foregroundComponents="5" backgroundComponents="5"/>
+            <config scaleFactor="0.5" noise="30" foregroundComponents="5" backgroundComponents="5" lookupTable="true"/>
             <HSV>
                 <lower>35,0,0</lower>
                 <upper>360.5,255,255</upper>
@@ -78,6 +78,8 @@ namespace sight::module::filter::vision
  * learning step. For example, to avoid missing pixels when brightness or shadows is changing.
  * - \b foregroundComponents (optional)(default: 5) : number of components learned in the foreground color model
  * - \b backgroundComponents (optional)(default: 5) : number of components learned in the foreground color model
+ * - \b lookupTable (optional)(default: true) : classify the pixels with a lookup table computed from the color models
+ * after each learning step, instead of evaluating the models on each pixel. The mask is the same, only faster.
  * - \b HSV (optional) : values in HSV defined by <lower>(default: 0,0,0) and <upper> (default: 255,255,255) tags
  * allowing to compute automatically the mask during the foreground color model learning step
  */
@@ -161,6 +163,9 @@ private:
     /// Number of foreground components.
     int m_foreground_components {5};
 
+    /// Classify the pixels with a lookup table.
+    bool m_lookup_table {true};
+
     static constexpr std::string_view MASK_KEY          = "mask";
     static constexpr std::string_view VIDEO_TL_KEY      = "videoTL";
     static constexpr std::string_view VIDEO_MASK_TL_KEY = "videoMaskTL";
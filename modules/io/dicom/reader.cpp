@@ -165,6 +165,9 @@ public:
         // Set filters
         m_reader->set_filters(m_filters);
 
+        // Set the read mode
+        m_reader->set_parallel(m_parallel);
+
         // Scan the folder
         m_selection = m_reader->scan();
 
@@ -235,6 +238,9 @@ public:
     std::string m_displayed_columns =
         "PatientName/SeriesInstanceUID,PatientSex,PatientBirthDate/Icon,Modality,StudyDescription/SeriesDescription,StudyDate/SeriesDate,StudyTime/SeriesTime,PatientAge,BodyPartExamined,PatientPositionString,ContrastBolusAgent,AcquisitionTime,ContrastBolusStartTime";
 
+    /// If true, the instances of an image series are decoded concurrently.
+    bool m_parallel {false};
+
     /// Signal emitted when job created.
     job_created_signal_t::sptr m_job_created_signal;
 
@@ -330,6 +336,8 @@ void reader::configuring()
         {
             m_pimpl->m_displayed_columns = displayed_columns;
         }
+
+        m_pimpl->m_parallel = config->get<bool>("parallel", m_pimpl->m_parallel);
     }
 }
 
@@ -64,6 +64,9 @@ namespace sight::module::io::dicom
  *          - \b "never": never show the open dialog (DEFAULT)
  *          - \b "once": show only once, store the location as long as the service is started
  *          - \b "always": always show the location dialog
+ * - \b config(optional):
+ *      \b displayedColumns: The columns of the selection dialog.
+ *      \b parallel: If true, the slices of image series are decoded concurrently (false by default).
  *
  *
  * @see sight::io::service::reader
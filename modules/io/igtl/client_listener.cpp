@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -31,6 +31,8 @@
 #include <data/matrix_tl.hpp>
 #include <data/object.hpp>
 
+#include <io/igtl/detail/data_converter.hpp>
+
 #include <ui/__/dialog/message.hpp>
 #include <ui/__/preferences.hpp>
 
@@ -74,6 +76,8 @@ void client_listener::configuring()
 
     m_client.set_filtering_by_device_name(true);
 
+    m_compressed = config.get<bool>("compressed", false);
+
     const std::string server_info = config.get("server", "");
     if(!server_info.empty())
     {
@@ -101,6 +105,11 @@ void client_listener::run_client()
         const auto hostname = preferences.delimited_get<std::string>(m_hostname_config);
 
         m_client.connect(hostname, port);
+        if(m_compressed && !m_client.request_compressed_images())
+        {
+            SIGHT_WARN("Cannot ask the server to send compressed images");
+        }
+
         m_sig_connected->async_emit();
     }
     catch(core::exception& ex)
@@ -127,30 +136,54 @@ void client_listener::run_client()
     {
         while(m_client.is_connected())
         {
-            std::string device_name;
-            data::object::sptr receive_object = m_client.receive_object(device_name);
-            if(receive_object)
+            const ::igtl::MessageHeader::Pointer header = m_client.receive_header();
+            if(header.IsNull())
             {
-                const auto& iter = std::find(m_device_names.begin(), m_device_names.end(), device_name);
+                continue;
+            }
+
+            const std::string device_name = header->GetDeviceName();
+            const auto& iter              = std::find(m_device_names.begin(), m_device_names.end(), device_name);
+            const auto index              = static_cast<std::size_t>(std::distance(m_device_names.begin(), iter));
 
-                if(iter != m_device_names.end())
+            // Images are received directly in the frame timelines when possible
+            ::igtl::MessageBase::Pointer msg;
+            if(iter != m_device_names.end()
+               && header->GetDeviceType() == std::string(sight::io::igtl::detail::packed_message::IMAGE_TYPE))
+            {
+                msg = this->receive_image(header, index);
+                if(msg.IsNull())
                 {
-                    const auto index_receive_object = std::distance(m_device_names.begin(), iter);
-                    const auto obj                  = m_objects[static_cast<std::size_t>(index_receive_object)].lock();
+                    continue;
+                }
+            }
+            else
+            {
+                msg = m_client.receive_body(header);
+            }
 
-                    const bool is_a_timeline = obj->is_a("data::matrix_tl") || obj->is_a("data::frame_tl");
-                    if(is_a_timeline)
-                    {
-                        this->manage_timeline(receive_object, static_cast<std::size_t>(index_receive_object));
-                    }
-                    else
-                    {
-                        obj->shallow_copy(receive_object);
+            data::object::sptr receive_object;
+            if(msg.IsNotNull() && iter != m_device_names.end())
+            {
+                receive_object = sight::io::igtl::detail::data_converter::get_instance()->from_igtl_message(msg);
+            }
 
-                        data::object::modified_signal_t::sptr sig;
-                        sig = obj->signal<data::object::modified_signal_t>(data::object::MODIFIED_SIG);
-                        sig->async_emit();
-                    }
+            if(receive_object)
+            {
+                const auto obj = m_objects[index].lock();
+
+                const bool is_a_timeline = obj->is_a("data::matrix_tl") || obj->is_a("data::frame_tl");
+                if(is_a_timeline)
+                {
+                    this->manage_timeline(receive_object, index);
+                }
+                else
+                {
+                    obj->shallow_copy(receive_object);
+
+                    data::object::modified_signal_t::sptr sig;
+                    sig = obj->signal<data::object::modified_signal_t>(data::object::MODIFIED_SIG);
+                    sig->async_emit();
                 }
             }
         }
@@ -204,6 +237,80 @@ void client_listener::stopping()
 
 //-----------------------------------------------------------------------------
 
+::igtl::MessageBase::Pointer client_listener::receive_image(
+    const ::igtl::MessageHeader::Pointer& _header,
+    std::size_t _index
+)
+{
+    if(!std::dynamic_pointer_cast<data::frame_tl>(m_objects[_index].lock().get_shared()))
+    {
+        return m_client.receive_body(_header);
+    }
+
+    const core::clock::type timestamp = core::clock::get_time_in_milli_sec();
+
+    const auto frame_size =
+        [](const data::frame_tl& _tl)
+        {
+            return _tl.get_width() * _tl.get_height() * _tl.num_components() * _tl.type().size();
+        };
+
+    // The timeline is only locked to allocate the buffer, not while the image is received
+    std::size_t allocated_size = 0;
+    auto frame                 = m_client.receive_frame(
+        _header,
+        [this, _index, timestamp, &frame_size, &allocated_size](
+            std::size_t _width,
+            std::size_t _height,
+            core::type _type,
+            enum data::frame_tl::pixel_format _format) -> SPTR(data::frame_tl::buffer_t)
+        {
+            const auto data     = m_objects[_index].lock();
+            const auto frame_tl = std::dynamic_pointer_cast<data::frame_tl>(data.get_shared());
+            if(!frame_tl)
+            {
+                return nullptr;
+            }
+
+            if(frame_tl->get_width() != _width || frame_tl->get_height() != _height || frame_tl->type() != _type
+               || frame_tl->pixel_format() != _format)
+            {
+                frame_tl->init_pool_size(_width, _height, _type, _format);
+            }
+
+            allocated_size = frame_size(*frame_tl);
+            return frame_tl->create_buffer(timestamp);
+        });
+    if(auto* const msg = std::get_if< ::igtl::MessageBase::Pointer>(&frame))
+    {
+        return *msg;
+    }
+
+    const auto data     = m_objects[_index].lock();
+    const auto frame_tl = std::dynamic_pointer_cast<data::frame_tl>(data.get_shared());
+
+    // The image is dropped if the timeline was initialized again with another format during the transfer
+    if(!frame_tl || frame_size(*frame_tl) != allocated_size)
+    {
+        return {};
+    }
+
+    if(!m_tl_initialized)
+    {
+        frame_tl->set_maximum_size(10);
+        m_tl_initialized = true;
+    }
+
+    frame_tl->push_object(std::get<SPTR(data::frame_tl::buffer_t)>(frame));
+
+    auto sig = frame_tl->signal<data::timeline::signals::pushed_t>(data::timeline::signals::PUSHED);
+    sig->async_emit(timestamp);
+
+    return {};
+}
+
+//-----------------------------------------------------------------------------
+
 void client_listener::manage_timeline(data::object::sptr _obj, std::size_t _index)
 {
     core::clock::type timestamp = core::clock::get_time_in_milli_sec();
@@ -281,7 +388,7 @@ void client_listener::manage_timeline(data::object::sptr _obj, std::size_t _inde
 
         std::copy(itr, end, dest_buffer);
 
-        frame_tl->push_object(buffer);
+        frame_tl->push_object(std::get<SPTR(data::frame_tl::buffer_t)>(frame));
 
         data::timeline::signals::pushed_t::sptr sig;
         sig = frame_tl->signal<data::timeline::signals::pushed_t>
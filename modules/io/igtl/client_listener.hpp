@@ -41,6 +41,7 @@ namespace sight::module::io::igtl
  * @code{.xml}
  * <service uid="..." type="sight::module::io::igtl::client_listener" >
  *      <server>127.0.0.1:4242</server>
+ *      <compressed>false</compressed>
  *      <inout group="objects">
  *          <key uid="..." deviceName="device01" />
  *          <key uid="..." deviceName="device02" />
@@ -55,6 +56,8 @@ namespace sight::module::io::igtl
  * @subsection Configuration Configuration:
  * - \b deviceName: filter by device Name in Message
  * - \b server: server URL. Need hostname and port in this format addr:port (default value is 127.0.0.1:4242).
+ * - \b compressed: optional, ask the server to send 2D images compressed (default: false). Servers that do not support
+ *   it keep sending uncompressed images.
  * @note : hostname and port of this service can be a value or a nameKey from preference settings
  *  (for example <server>%HOSTNAME%:%PORT%</server>)
  */
@@ -95,6 +98,12 @@ private:
      */
     void manage_timeline(data::object::sptr _obj, std::size_t _index);
 
+    /**
+     * @brief receives the body of an IMAGE message, directly in a frame timeline when the image fits in a frame
+     * @return the received message if it still has to be converted, null if the frame was pushed in the timeline
+     */
+    ::igtl::MessageBase::Pointer receive_image(const ::igtl::MessageHeader::Pointer& _header, std::size_t _index);
+
     /// client socket
     sight::io::igtl::client m_client;
 
@@ -109,6 +118,9 @@ private:
 
     bool m_tl_initialized {false};
 
+    /// ask the server to send compressed images
+    bool m_compressed {false};
+
     /// Vector of device name used
     std::vector<std::string> m_device_names;
 
@@ -1,6 +1,6 @@
 /************************************************************************
  *
- * Copyright (C) 2009-2023 IRCAD France
+ * Copyright (C) 2009-2024 IRCAD France
  * Copyright (C) 2012-2020 IHU Strasbourg
  *
  * This file is part of Sight.
@@ -26,6 +26,8 @@
 #include <core/com/slots.hpp>
 #include <core/com/slots.hxx>
 
+#include <data/image.hpp>
+
 #include <service/macros.hpp>
 
 #include <ui/__/dialog/message.hpp>
@@ -56,6 +58,25 @@ void server_sender::configuring()
 
     m_port_config = config.get("port", "4242");
 
+    const std::string compression = config.get("compression", "none");
+    if(compression == "jpeg")
+    {
+        m_compression = sight::io::bitmap::backend::libjpeg;
+    }
+    else if(compression == "tiff")
+    {
+        m_compression = sight::io::bitmap::backend::libtiff;
+    }
+    else if(compression == "png")
+    {
+        m_compression = sight::io::bitmap::backend::libpng;
+    }
+    else
+    {
+        SIGHT_ASSERT("Unknown compression '" + compression + "'", compression == "none");
+        m_compression.reset();
+    }
+
     const config_t config_in = config.get_child("in");
 
     SIGHT_ASSERT(
@@ -81,6 +102,12 @@ void server_sender::starting()
         ui::preferences preferences;
         const auto port = preferences.delimited_get<std::uint16_t>(m_port_config);
 
+        if(m_compression.has_value())
+        {
+            m_server->set_image_compression(m_compression);
+            m_encoder = core::thread::worker::make();
+        }
+
         m_server->start(port);
 
         m_server_future = std::async(std::launch::async, [this](auto&& ...){m_server->run_server();});
@@ -104,6 +131,14 @@ void server_sender::starting()
 
 void server_sender::stopping()
 {
+    if(m_encoder)
+    {
+        // Waits for the objects already copied
+        m_encoder->stop();
+        m_encoder.reset();
+        m_pending_images = 0;
+    }
+
     try
     {
         if(m_server->started())
@@ -127,6 +162,57 @@ void server_sender::stopping()
 //-----------------------------------------------------------------------------
 
 void server_sender::send_object(const data::object::csptr& _obj, const std::size_t _index)
+{
+    if(!m_encoder)
+    {
+        this->broadcast(_obj, _index);
+        return;
+    }
+
+    if(!m_server->compresses_images())
+    {
+        // Nothing is encoded, so the object is sent without copy while the caller holds it. It is still sent from the
+        // encoder thread, after the objects that are already queued.
+        m_encoder->post_task<void>([this, &_obj, _index]{this->broadcast(_obj, _index);}).get();
+        return;
+    }
+
+    // The object is copied, since it may be modified while it is encoded
+    const bool is_image = std::dynamic_pointer_cast<const data::image>(_obj) != nullptr;
+    if(is_image)
+    {
+        if(m_pending_images >= MAX_PENDING_IMAGES)
+        {
+            SIGHT_DEBUG("Image dropped, the encoder is late");
+            return;
+        }
+
+        ++m_pending_images;
+    }
+
+    data::object::csptr copy = data::object::copy(_obj);
+    m_encoder->post(
+        [this, copy = std::move(copy), _index, is_image]
+        {
+            try
+            {
+                this->broadcast(copy, _index);
+            }
+            catch(const core::exception& e)
+            {
+                SIGHT_ERROR(e.what());
+            }
+
+            if(is_image)
+            {
+                --m_pending_images;
+            }
+        });
+}
+
+//-----------------------------------------------------------------------------
+
+void server_sender::broadcast(const data::object::csptr& _obj, const std::size_t _index)
 {
     if(!m_device_names[_index].empty())
     {
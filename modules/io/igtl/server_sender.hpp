@@ -24,11 +24,14 @@
 
 #include "modules/io/igtl/network_sender.hpp"
 
+#include <core/thread/worker.hpp>
+
 #include <data/object.hpp>
 
 #include <io/igtl/client.hpp>
 #include <io/igtl/server.hpp>
 
+#include <atomic>
 #include <cstdint>
 #include <future>
 #include <string>
@@ -43,6 +46,7 @@ namespace sight::module::io::igtl
  * @code{.xml}
  * <service uid="..." type="sight::module::io::igtl::server_sender" auto_connect="true" >
  *      <port>...</port>
+ *      <compression>none</compression>
  *      <in group="objects">
  *           <key uid="..." deviceName="device01" />
  *           <key uid="..." deviceName="device02" />
@@ -51,6 +55,10 @@ namespace sight::module::io::igtl
  * @endcode
  * @subsection Configuration Configuration:
  * - \b port : defines the port where the objects will be sent
+ * - \b compression : optional, codec used to compress 2D images for the clients that ask for it, \c none, \c jpeg
+ *   (lossy), \c tiff or \c png (lossless, \c png compresses more but slower) (default: none). Other clients receive
+ *   uncompressed images. When enabled, the objects are copied and sent by a dedicated thread, so that encoding does
+ *   not delay the service; images are dropped when the thread is late by more than two images.
  * @subsection Input Input:
  * - \b objects [sight::data::object]: specified objects to send.
  * They must have an attribute 'deviceName' to know the device-name used for this specific data.
@@ -89,9 +97,24 @@ private:
      */
     void send_object(const data::object::csptr& _obj, std::size_t _index) override;
 
+    /// Broadcasts an object, from the encoder thread when compression is enabled
+    void broadcast(const data::object::csptr& _obj, std::size_t _index);
+
     /// Server instance
     sight::io::igtl::server::sptr m_server;
 
+    /// Codec used to compress the images, if any
+    std::optional<sight::io::bitmap::backend> m_compression;
+
+    /// Thread encoding and sending the objects when compression is enabled
+    core::thread::worker::sptr m_encoder;
+
+    /// Number of images waiting to be encoded
+    std::atomic<std::size_t> m_pending_images {0};
+
+    /// Maximum number of images waiting to be encoded before images are dropped
+    static constexpr std::size_t MAX_PENDING_IMAGES = 2;
+
     /// Future used to wait for the server
     std::future<void> m_server_future;
 
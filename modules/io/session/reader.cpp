@@ -88,6 +88,9 @@ public:
     /// Archive format to use
     archive::archive_format m_archive_format {archive::archive_format::DEFAULT};
 
+    /// If true, images and arrays are loaded on demand
+    bool m_lazy_loading {false};
+
     /// Signal emitted when job created.
     signals::job_created_signal_t::sptr m_job_created_signal;
 
@@ -189,6 +192,8 @@ void reader::configuring()
         {
             SIGHT_THROW("Cannot read archive format '" + format + "'.");
         }
+
+        m_pimpl->m_lazy_loading = archive->get<bool>("lazy", false);
     }
 }
 
@@ -258,6 +263,7 @@ void reader::updating()
             reader->set_password(password);
             reader->set_encryption_policy(m_pimpl->m_encryption_policy);
             reader->set_archive_format(m_pimpl->m_archive_format);
+            reader->set_lazy_loading(m_pimpl->m_lazy_loading);
 
             // Set cursor to busy state. It will be reset to default even if exception occurs
             const sight::ui::busy_cursor busy_cursor;
@@ -55,7 +55,7 @@ namespace sight::module::io::session
         <inout key="data" uid="..." />
         <dialog extension=".sample" description="Sample Sight session file" policy="always"/>
         <password policy="once, encryption=salted"/>
-        <archive format="default"/>
+        <archive format="default" lazy="false"/>
     </service>
    @endcode
  *
@@ -91,6 +91,7 @@ namespace sight::module::io::session
  *          - \b "filesystem": Reads files from the filesystem.
  *          - \b "archive": Reads files from an session archive.
  *          - \b "default": uses the builtin default behavior which is "archive"
+ *      \b lazy: if true, images and arrays are read from the archive the first time they are used (false by default).
  *
  * @see sight::io::service::reader
  * @see sight::io::session::session_reader
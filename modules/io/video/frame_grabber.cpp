@@ -26,6 +26,7 @@
 #include <core/com/signal.hxx>
 #include <core/com/slot.hxx>
 #include <core/com/slots.hxx>
+#include <core/thread/pool.hxx>
 
 #include <data/camera.hpp>
 #include <data/frame_tl.hpp>
@@ -38,14 +39,56 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <regex>
+#include <thread>
 
 namespace sight::module::io::video
 {
 
 // -----------------------------------------------------------------------------
 
+/// Converts an image read by OpenCV to the channel order of the timeline
+static void convert_image(const cv::Mat& _image, cv::Mat& _out)
+{
+    if(_image.type() == CV_8UC3)
+    {
+        // convert the readded image from BGR to RGB
+        cv::cvtColor(_image, _out, cv::COLOR_BGR2RGB);
+    }
+    else if(_image.type() == CV_8UC4)
+    {
+        // convert the readded image from BGRA to RGBA
+        cv::cvtColor(_image, _out, cv::COLOR_BGRA2RGBA);
+    }
+    else
+    {
+        _image.copyTo(_out);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// Returns the size of the frames of a timeline
+static cv::Size frame_size(const data::frame_tl& _frame_tl)
+{
+    return {static_cast<int>(_frame_tl.get_width()), static_cast<int>(_frame_tl.get_height())};
+}
+
+// -----------------------------------------------------------------------------
+
+/// Returns the OpenCV type of the frames of a timeline
+static int frame_type(const data::frame_tl& _frame_tl)
+{
+    return CV_MAKETYPE(
+        _frame_tl.type() == core::type::UINT16 ? CV_16U : CV_8U,
+        static_cast<int>(_frame_tl.num_components())
+    );
+}
+
+// -----------------------------------------------------------------------------
+
 frame_grabber::frame_grabber() noexcept
 {
     new_slot(SET_STEP_SLOT, &frame_grabber::set_step, this);
@@ -94,6 +137,10 @@ void frame_grabber::configuring()
     m_step = config.get<std::uint64_t>("step", m_step);
     SIGHT_ASSERT("Step value is set to " << m_step << " but should be > 0.", m_step > 0);
     m_step_changed = m_step;
+
+    m_prefetch_depth = config.get<std::size_t>("prefetch", m_prefetch_depth);
+
+    m_ring_capacity = config.get<std::size_t>("ring", m_ring_capacity);
 }
 
 // -----------------------------------------------------------------------------
@@ -192,6 +239,9 @@ void frame_grabber::stop_camera()
         m_timer.reset();
     }
 
+    this->cancel_prefetch();
+    m_prefetch_pool.reset();
+
     if(m_video_capture.isOpened())
     {
         m_video_capture.release();
@@ -506,6 +556,16 @@ void frame_grabber::read_images(const std::filesystem::path& _folder, const std:
         m_is_initialized = true;
         this->set_start_state(true);
 
+        if(m_prefetch_depth > 0)
+        {
+            const std::size_t nb_threads =
+                std::min<std::size_t>(m_prefetch_depth, std::max(1U, std::thread::hardware_concurrency()));
+            m_prefetch_pool = std::make_unique<core::thread::pool>(nb_threads);
+
+            const auto frame_tl = m_frame.lock();
+            this->prefetch(*frame_tl);
+        }
+
         const auto sig_duration = this->signal<duration_modified_signal_t>(DURATION_MODIFIED_SIG);
 
         std::int64_t video_duration = 0;
@@ -578,77 +638,89 @@ void frame_grabber::grab_video()
 
         if(is_grabbed)
         {
-            auto frame_tl = m_frame.lock();
-
             cv::Mat image;
             m_video_capture.retrieve(image);
 
             this->update_zoom(image);
 
-            if(!m_is_initialized)
+            // The timeline is only locked to be initialized, the frames are then written in place in its ring if
+            // it is enabled, see data::buffer_tl::init_ring()
+            data::frame_tl::sptr timeline;
             {
-                const auto width  = static_cast<std::size_t>(m_video_capture.get(cv::CAP_PROP_FRAME_WIDTH));
-                const auto height = static_cast<std::size_t>(m_video_capture.get(cv::CAP_PROP_FRAME_HEIGHT));
-
-                const std::size_t w = static_cast<std::size_t>(image.size().width);
-                const std::size_t h = static_cast<std::size_t>(image.size().height);
+                auto frame_tl = m_frame.lock();
 
-                if(width != w || height != h)
+                if(!m_is_initialized)
                 {
-                    SIGHT_ERROR(
-                        "This video cannot be read, the frame size is not expected. expected: "
-                        << width << " x " << height << ", actual: " << w << " x " << h
-                    );
-                    return;
-                }
+                    const auto width  = static_cast<std::size_t>(m_video_capture.get(cv::CAP_PROP_FRAME_WIDTH));
+                    const auto height = static_cast<std::size_t>(m_video_capture.get(cv::CAP_PROP_FRAME_HEIGHT));
 
-                switch(image.type())
-                {
-                    case CV_8UC1:
-                        frame_tl->init_pool_size(
-                            width,
-                            height,
-                            core::type::UINT8,
-                            sight::data::frame_tl::pixel_format::gray_scale
-                        );
-                        break;
-
-                    case CV_8UC3:
-                        frame_tl->init_pool_size(
-                            width,
-                            height,
-                            core::type::UINT8,
-                            sight::data::frame_tl::pixel_format::rgb
-                        );
-                        break;
-
-                    case CV_8UC4:
-                        frame_tl->init_pool_size(
-                            width,
-                            height,
-                            core::type::UINT8,
-                            sight::data::frame_tl::pixel_format::rgba
-                        );
-                        break;
-
-                    case CV_16UC1:
-                        frame_tl->init_pool_size(
-                            width,
-                            height,
-                            core::type::UINT16,
-                            sight::data::frame_tl::pixel_format::gray_scale
-                        );
-                        break;
+                    const std::size_t w = static_cast<std::size_t>(image.size().width);
+                    const std::size_t h = static_cast<std::size_t>(image.size().height);
 
-                    default:
-                        sight::ui::dialog::message::show(
-                            "Grabber",
-                            "This video cannot be read, the video type is not managed."
+                    if(width != w || height != h)
+                    {
+                        SIGHT_ERROR(
+                            "This video cannot be read, the frame size is not expected. expected: "
+                            << width << " x " << height << ", actual: " << w << " x " << h
                         );
                         return;
+                    }
+
+                    switch(image.type())
+                    {
+                        case CV_8UC1:
+                            frame_tl->init_pool_size(
+                                width,
+                                height,
+                                core::type::UINT8,
+                                sight::data::frame_tl::pixel_format::gray_scale
+                            );
+                            break;
+
+                        case CV_8UC3:
+                            frame_tl->init_pool_size(
+                                width,
+                                height,
+                                core::type::UINT8,
+                                sight::data::frame_tl::pixel_format::rgb
+                            );
+                            break;
+
+                        case CV_8UC4:
+                            frame_tl->init_pool_size(
+                                width,
+                                height,
+                                core::type::UINT8,
+                                sight::data::frame_tl::pixel_format::rgba
+                            );
+                            break;
+
+                        case CV_16UC1:
+                            frame_tl->init_pool_size(
+                                width,
+                                height,
+                                core::type::UINT16,
+                                sight::data::frame_tl::pixel_format::gray_scale
+                            );
+                            break;
+
+                        default:
+                            sight::ui::dialog::message::show(
+                                "Grabber",
+                                "This video cannot be read, the video type is not managed."
+                            );
+                            return;
+                    }
+
+                    if(m_ring_capacity > 0)
+                    {
+                        frame_tl->init_ring(m_ring_capacity);
+                    }
+
+                    m_is_initialized = true;
                 }
 
-                m_is_initialized = true;
+                timeline = frame_tl.get_shared();
             }
 
             // Get time slider position.
@@ -656,33 +728,40 @@ void frame_grabber::grab_video()
             const auto sig_position = this->signal<position_modified_signal_t>(POSITION_MODIFIED_SIG);
             sig_position->async_emit(static_cast<std::int64_t>(ms));
 
-            // Get the buffer of the timeline to fill
-            SPTR(data::frame_tl::buffer_t) buffer_out = frame_tl->create_buffer(timestamp);
-            std::uint8_t* frame_buff_out = buffer_out->add_element(0);
-
-            // Create an OpenCV mat that aliases the buffer created from the output timeline.
-            cv::Mat img_out(image.size(), image.type(), (void*) frame_buff_out, cv::Mat::AUTO_STEP);
-
-            if(image.type() == CV_8UC3)
+            bool pushed = true;
+            if(timeline->get_ring())
             {
-                // Convert the read image from BGR to RGB.
-                cv::cvtColor(image, img_out, cv::COLOR_BGR2RGB);
-            }
-            else if(image.type() == CV_8UC4)
-            {
-                // Convert the read image from BGRA to RGBA.
-                cv::cvtColor(image, img_out, cv::COLOR_BGRA2RGBA);
+                // The frame is skipped if all the slots are borrowed by the consumers
+                data::timeline::ring::writer writer = timeline->begin_push();
+                pushed = static_cast<bool>(writer);
+                if(pushed)
+                {
+                    cv::Mat img_out(image.size(), image.type(), writer.data(), cv::Mat::AUTO_STEP);
+                    convert_image(image, img_out);
+                    timeline->publish(writer, timestamp);
+                }
             }
             else
             {
-                image.copyTo(img_out);
-            }
+                auto frame_tl = m_frame.lock();
 
-            frame_tl->push_object(buffer_out);
+                // Get the buffer of the timeline to fill
+                SPTR(data::frame_tl::buffer_t) buffer_out = frame_tl->create_buffer(timestamp);
+                std::uint8_t* frame_buff_out = buffer_out->add_element(0);
 
-            const auto sig =
-                frame_tl->signal<data::timeline::signals::pushed_t>(data::timeline::signals::PUSHED);
-            sig->async_emit(timestamp);
+                // Create an OpenCV mat that aliases the buffer created from the output timeline.
+                cv::Mat img_out(image.size(), image.type(), (void*) frame_buff_out, cv::Mat::AUTO_STEP);
+                convert_image(image, img_out);
+
+                frame_tl->push_object(buffer_out);
+            }
+
+            if(pushed)
+            {
+                const auto sig =
+                    timeline->signal<data::timeline::signals::pushed_t>(data::timeline::signals::PUSHED);
+                sig->async_emit(timestamp);
+            }
         }
 
         if(m_loop_video)
@@ -712,9 +791,6 @@ void frame_grabber::grab_image()
     {
         const auto frame_tl = m_frame.lock();
 
-        const std::filesystem::path image_path = m_image_to_read[m_image_count];
-
-        const cv::Mat image         = cv::imread(image_path.string(), cv::IMREAD_UNCHANGED);
         core::clock::type timestamp = NAN;
 
         //create a new timestamp
@@ -728,39 +804,56 @@ void frame_grabber::grab_image()
             timestamp = m_image_timestamps[m_image_count];
         }
 
-        this->update_zoom(image);
-
         SIGHT_DEBUG("Reading image index " << m_image_count << " with timestamp " << timestamp);
 
-        const std::size_t width  = static_cast<std::size_t>(image.size().width);
-        const std::size_t height = static_cast<std::size_t>(image.size().height);
+        SPTR(data::frame_tl::buffer_t) buffer_out = this->pop_prefetched();
 
-        if(width == frame_tl->get_width() && height == frame_tl->get_height())
+        if(buffer_out)
         {
-            const auto sig_position = this->signal<position_modified_signal_t>(POSITION_MODIFIED_SIG);
-            sig_position->async_emit(static_cast<std::int64_t>(m_image_count) * 30);
+            if(m_create_new_ts)
+            {
+                // The prefetched buffer holds the timestamp of the file
+                SPTR(data::frame_tl::buffer_t) stamped_buffer = frame_tl->create_buffer(timestamp);
+                std::memcpy(
+                    stamped_buffer->add_element(0),
+                    &buffer_out->get_element(0),
+                    buffer_out->get_element_size()
+                );
+                buffer_out = stamped_buffer;
+            }
 
-            // Get the buffer of the timeline to fill
-            SPTR(data::frame_tl::buffer_t) buffer_out = frame_tl->create_buffer(timestamp);
             std::uint8_t* frame_buff_out = buffer_out->add_element(0);
+            this->update_zoom(
+                cv::Mat(frame_size(*frame_tl), frame_type(*frame_tl), (void*) frame_buff_out, cv::Mat::AUTO_STEP)
+            );
+        }
+        else
+        {
+            const std::filesystem::path image_path = m_image_to_read[m_image_count];
 
-            // Create an openCV mat that aliases the buffer created from the output timeline
-            cv::Mat img_out(image.size(), image.type(), (void*) frame_buff_out, cv::Mat::AUTO_STEP);
+            const cv::Mat image = cv::imread(image_path.string(), cv::IMREAD_UNCHANGED);
 
-            if(image.type() == CV_8UC3)
-            {
-                // convert the readded image from BGR to RGB
-                cv::cvtColor(image, img_out, cv::COLOR_BGR2RGB);
-            }
-            else if(image.type() == CV_8UC4)
-            {
-                // convert the readded image from BGRA to RGBA
-                cv::cvtColor(image, img_out, cv::COLOR_BGRA2RGBA);
-            }
-            else
+            this->update_zoom(image);
+
+            const std::size_t width  = static_cast<std::size_t>(image.size().width);
+            const std::size_t height = static_cast<std::size_t>(image.size().height);
+
+            if(width == frame_tl->get_width() && height == frame_tl->get_height())
             {
-                image.copyTo(img_out);
+                // Get the buffer of the timeline to fill
+                buffer_out = frame_tl->create_buffer(timestamp);
+                std::uint8_t* frame_buff_out = buffer_out->add_element(0);
+
+                // Create an openCV mat that aliases the buffer created from the output timeline
+                cv::Mat img_out(image.size(), image.type(), (void*) frame_buff_out, cv::Mat::AUTO_STEP);
+                convert_image(image, img_out);
             }
+        }
+
+        if(buffer_out)
+        {
+            const auto sig_position = this->signal<position_modified_signal_t>(POSITION_MODIFIED_SIG);
+            sig_position->async_emit(static_cast<std::int64_t>(m_image_count) * 30);
 
             frame_tl->push_object(buffer_out);
 
@@ -811,6 +904,8 @@ void frame_grabber::grab_image()
             {
                 m_image_count += m_step;
             }
+
+            this->prefetch(*frame_tl);
         }
         else
         {
@@ -827,6 +922,135 @@ void frame_grabber::grab_image()
 
 //------------------------------------------------------------------------------
 
+void frame_grabber::prefetch(data::frame_tl& _frame_tl)
+{
+    // Release the buffers of the cancelled images once their decoding ended
+    std::erase_if(
+        m_discarded,
+        [](const prefetched_image& _image)
+        {
+            return _image.decoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+
+    if(!m_prefetch_pool || !_frame_tl.is_allocated())
+    {
+        return;
+    }
+
+    // Keep the images that will be read next, the others were skipped or the position changed
+    std::size_t next = m_image_count;
+    std::size_t kept = 0;
+    for(const auto& image : m_prefetched)
+    {
+        if(image.index != next)
+        {
+            break;
+        }
+
+        ++kept;
+        next += m_step;
+    }
+
+    while(m_prefetched.size() > kept)
+    {
+        this->discard_prefetched(std::move(m_prefetched.back()));
+        m_prefetched.pop_back();
+    }
+
+    const cv::Size size = frame_size(_frame_tl);
+    const int type      = frame_type(_frame_tl);
+
+    for( ; m_prefetched.size() < m_prefetch_depth && next < m_image_to_read.size() ; next += m_step)
+    {
+        prefetched_image image;
+        image.index     = next;
+        image.buffer    = _frame_tl.create_buffer(m_image_timestamps[next]);
+        image.cancelled = std::make_shared<std::atomic<bool> >(false);
+
+        auto promise = std::make_shared<std::promise<bool> >();
+        image.decoded = promise->get_future().share();
+
+        // The decoding thread writes directly in the buffer of the timeline
+        const cv::Mat img_out(size, type, (void*) image.buffer->add_element(0), cv::Mat::AUTO_STEP);
+
+        m_prefetch_pool->post(
+            [path = m_image_to_read[next], img_out, cancelled = image.cancelled, promise]
+            {
+                bool decoded = false;
+                if(!cancelled->load())
+                {
+                    try
+                    {
+                        const cv::Mat image = cv::imread(path.string(), cv::IMREAD_UNCHANGED);
+                        if(image.size() == img_out.size() && image.type() == img_out.type())
+                        {
+                            cv::Mat out = img_out;
+                            convert_image(image, out);
+                            decoded = true;
+                        }
+                    }
+                    catch(const std::exception& e)
+                    {
+                        SIGHT_ERROR("Unable to read the image '" + path.string() + "': " + e.what());
+                    }
+                }
+
+                promise->set_value(decoded);
+            });
+
+        m_prefetched.push_back(std::move(image));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+SPTR(data::frame_tl::buffer_t) frame_grabber::pop_prefetched()
+{
+    if(m_prefetched.empty() || m_prefetched.front().index != m_image_count)
+    {
+        return nullptr;
+    }
+
+    const prefetched_image image = std::move(m_prefetched.front());
+    m_prefetched.pop_front();
+
+    // Only blocks if the decoding is late, an image that failed is read again to report the error
+    return image.decoded.get() ? image.buffer : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+void frame_grabber::discard_prefetched(prefetched_image&& _image)
+{
+    _image.cancelled->store(true);
+
+    // The decoding thread may still be writing in the buffer
+    if(_image.decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        m_discarded.push_back(std::move(_image));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void frame_grabber::cancel_prefetch()
+{
+    while(!m_prefetched.empty())
+    {
+        this->discard_prefetched(std::move(m_prefetched.back()));
+        m_prefetched.pop_back();
+    }
+
+    for(const auto& image : m_discarded)
+    {
+        image.decoded.wait();
+    }
+
+    m_discarded.clear();
+}
+
+//------------------------------------------------------------------------------
+
 void frame_grabber::update_zoom(cv::Mat _image)
 {
     if(m_zoom_center.has_value())
@@ -881,6 +1105,14 @@ void frame_grabber::set_position(int64_t _position)
         if(new_pos < m_image_to_read.size())
         {
             m_image_count = new_pos;
+
+            if(m_prefetch_pool)
+            {
+                // Restart the prefetch window from the new position
+                this->cancel_prefetch();
+                const auto frame_tl = m_frame.lock();
+                this->prefetch(*frame_tl);
+            }
         }
     }
 }
@@ -25,14 +25,20 @@
 #include <core/com/slot.hpp>
 #include <core/com/slots.hpp>
 #include <core/mt/types.hpp>
+#include <core/thread/pool.hpp>
 #include <core/thread/timer.hpp>
 #include <core/tools/failed.hpp>
 
+#include <data/frame_tl.hpp>
+
 #include <io/__/service/grabber.hpp>
 
 #include <opencv2/videoio.hpp>
 
+#include <atomic>
+#include <deque>
 #include <filesystem>
+#include <future>
 
 namespace sight::data
 {
@@ -52,6 +58,8 @@ namespace sight::module::io::video
  * @note Only file source is currently managed.
  * @note You can load images in a folder like img_<timestamp>.<ext> (ex. img_642752427.jpg). The service uses
  * the timestamp to order the frames and to push them in the timeline.
+ * @note When playing images, the next images can be decoded ahead of time by background threads, into buffers of
+ * the timeline, so that the timer only has to push them. Seeking cancels and restarts this prefetch window.
  *
  * \b Tags: FILE,DEVICE,STREAM
  *
@@ -85,6 +93,8 @@ namespace sight::module::io::video
             <useTimelapse>true</useTimelapse>
             <defaultDuration>5000</defaultDuration>
             <step>5</step>
+            <prefetch>4</prefetch>
+            <ring>8</ring>
         </service>
    @endcode
  * @subsection Input Input
@@ -104,6 +114,12 @@ namespace sight::module::io::video
  * this value is used (default: 5000), this is a very advanced option.
  * It will have not effects if reading a video or if a timestamp can be deduced from images filenames
  * (ex. img_642752427.jpg).
+ * - \b prefetch (optional): number of images decoded ahead of time when reading a set of images, 0 disables the
+ * prefetching (default: 0).
+ * - \b ring (optional): number of slots of the lock-free ring of the timeline, where the frames of a video file are
+ * written in place without locking the timeline, see data::buffer_tl::init_ring(). The frames are then only visible to
+ * the consumers reading the ring, such as sight::module::sync::synchronizer. 0 pushes the frames in the timeline
+ * (default: 0).
  */
 class frame_grabber : public sight::io::service::grabber
 {
@@ -188,6 +204,34 @@ private:
     /// Reads the next image.
     void grab_image();
 
+    /// Image decoded ahead of time in a buffer of the timeline.
+    struct prefetched_image
+    {
+        /// Index of the image in m_image_to_read.
+        std::size_t index {0};
+
+        /// Buffer of the timeline receiving the image, it is never released by a decoding thread.
+        SPTR(data::frame_tl::buffer_t) buffer;
+
+        /// Set to true to skip the decoding if it has not started yet.
+        std::shared_ptr<std::atomic<bool> > cancelled;
+
+        /// Becomes true once the image is decoded, false if the image does not match the timeline format.
+        std::shared_future<bool> decoded;
+    };
+
+    /// Realigns the prefetch window on the next images to read and fills it, m_mutex must be locked.
+    void prefetch(data::frame_tl& _frame_tl);
+
+    /// Returns the buffer of the current image if it was prefetched, m_mutex must be locked.
+    SPTR(data::frame_tl::buffer_t) pop_prefetched();
+
+    /// Cancels a prefetched image, its buffer is kept until its decoding ends, m_mutex must be locked.
+    void discard_prefetched(prefetched_image&& _image);
+
+    /// Cancels all prefetched images and waits for the decodings in progress, m_mutex must be locked.
+    void cancel_prefetch();
+
     /// Updates the image if zoom is requested
     void update_zoom(cv::Mat _image);
 
@@ -250,6 +294,21 @@ private:
     /// Total number of frames in a video file.
     std::size_t m_video_frames_nb {0};
 
+    /// Number of images decoded ahead of time, 0 disables the prefetching.
+    std::size_t m_prefetch_depth {0};
+
+    /// Number of slots of the ring of the timeline where video frames are written, 0 disables the ring.
+    std::size_t m_ring_capacity {0};
+
+    /// Threads decoding the prefetched images.
+    std::unique_ptr<core::thread::pool> m_prefetch_pool;
+
+    /// Images being decoded or ready to be pushed, in reading order.
+    std::deque<prefetched_image> m_prefetched;
+
+    /// Cancelled images whose decoding has not ended yet.
+    std::vector<prefetched_image> m_discarded;
+
     data::ptr<data::camera, data::access::in> m_camera {this, CAMERA_INPUT};
 };
 
@@ -31,6 +31,8 @@
 #include <core/com/slots.hpp>
 #include <core/com/slots.hxx>
 #include <core/location/single_folder.hpp>
+#include <core/spy_log.hpp>
+#include <core/thread/pool.hxx>
 
 #include <data/map.hpp>
 
@@ -70,6 +72,10 @@ frame_writer::frame_writer() noexcept :
     new_slot(TOGGLE_RECORDING, &frame_writer::toggle_recording, this);
     new_slot(WRITE, &frame_writer::write, this);
     new_slot(SET_FORMAT_PARAMETER, &frame_writer::set_format_parameter, this);
+
+    new_signal<signals::int_t>(signals::QUEUED);
+    new_signal<signals::int_t>(signals::DROPPED);
+    new_signal<signals::double_t>(signals::ENCODE_LATENCY);
 }
 
 //------------------------------------------------------------------------------
@@ -92,13 +98,19 @@ void frame_writer::configuring()
 
     service::config_t config = this->get_config();
 
-    m_format = config.get<std::string>("format", ".tiff");
+    m_format      = config.get<std::string>("format", ".tiff");
+    m_nb_encoders = config.get<std::size_t>("encoders", 0);
+    m_queue_size  = config.get<std::size_t>("queue_size", 32);
+
+    SIGHT_ASSERT("The queue size must be greater than 0.", m_queue_size > 0);
 }
 
 //------------------------------------------------------------------------------
 
 void frame_writer::starting()
 {
+    m_encoders = std::make_unique<core::thread::pool>(m_nb_encoders);
+    m_pending  = std::make_unique<core::thread::task_group>(*m_encoders);
 }
 
 //------------------------------------------------------------------------------
@@ -130,6 +142,10 @@ void frame_writer::open_location_dialog()
 void frame_writer::stopping()
 {
     this->stop_record();
+
+    // The group refers to the pool, it must be destroyed first
+    m_pending.reset();
+    m_encoders.reset();
 }
 
 //------------------------------------------------------------------------------
@@ -159,55 +175,98 @@ void frame_writer::write(core::clock::type _timestamp)
         const auto locked   = m_data.lock();
         const auto frame_tl = std::dynamic_pointer_cast<const data::frame_tl>(locked.get_shared());
 
-        // The following lock causes the service to drop frames if under heavy load. This prevents desynchronization
-        // between frames and timestamps.
-        // TODO: experiment with queuing frames and writing them from a worker thread.
-        const auto sig = frame_tl->signal<data::timeline::signals::pushed_t>(
-            data::timeline::signals::PUSHED
-        );
-        core::com::connection::blocker write_blocker(sig->get_connection(m_slots[WRITE]));
-
-        // Get the buffer of the copied timeline
         const auto buffer = frame_tl->get_closest_buffer(_timestamp);
 
         if(buffer)
         {
-            _timestamp = buffer->get_timestamp();
-            const int width  = static_cast<int>(frame_tl->get_width());
-            const int height = static_cast<int>(frame_tl->get_height());
+            if(m_queued.load() >= m_queue_size)
+            {
+                this->signal<signals::int_t>(signals::DROPPED)->async_emit(static_cast<int>(++m_dropped));
+                return;
+            }
 
-            const std::uint8_t* image_buffer = &buffer->get_element(0);
+            // Frames pushed within the same millisecond are numbered, so that they do not overwrite each other
+            const auto time = static_cast<std::size_t>(buffer->get_timestamp());
+            m_same_time_count = (time == m_last_time) ? m_same_time_count + 1 : 0;
+            m_last_time       = time;
 
-            cv::Mat image(cv::Size(width, height), m_image_type, (void*) image_buffer, cv::Mat::AUTO_STEP);
+            const std::string suffix = m_same_time_count == 0 ? "" : "_" + std::to_string(m_same_time_count);
+            const std::string filename("img_" + std::to_string(time) + suffix + m_format);
 
-            const auto time = static_cast<std::size_t>(_timestamp);
-            const std::string filename("img_" + std::to_string(time) + m_format);
-            const std::filesystem::path path = this->get_folder() / filename;
+            const int queued = static_cast<int>(++m_queued);
+            this->signal<signals::int_t>(signals::QUEUED)->async_emit(queued);
 
-            if(image.type() == CV_8UC3)
-            {
-                // convert the read image from BGR to RGB
-                cv::Mat image_rgb;
-                cv::cvtColor(image, image_rgb, cv::COLOR_BGR2RGB);
-                cv::imwrite(path.string(), image_rgb);
-            }
-            else if(image.type() == CV_8UC4)
-            {
-                // convert the read image from BGRA to RGBA
-                cv::Mat image_rgb;
-                cv::cvtColor(image, image_rgb, cv::COLOR_BGRA2RGBA);
-                cv::imwrite(path.string(), image_rgb);
-            }
-            else
-            {
-                cv::imwrite(path.string(), image);
-            }
+            m_pending->run(
+                [this, buffer, width = static_cast<int>(frame_tl->get_width()),
+                 height = static_cast<int>(frame_tl->get_height()), image_type = m_image_type,
+                 path = this->get_folder() / filename, queued_time = core::clock::get_time_in_milli_sec()]
+                {
+                    this->encode(buffer, width, height, image_type, path, queued_time);
+                });
         }
     }
 }
 
 //------------------------------------------------------------------------------
 
+void frame_writer::encode(
+    CSPTR(data::frame_tl::buffer_t) _buffer,
+    int _width,
+    int _height,
+    int _image_type,
+    const std::filesystem::path& _path,
+    core::clock::type _queued_time
+)
+{
+    try
+    {
+        const std::uint8_t* image_buffer = &_buffer->get_element(0);
+
+        cv::Mat image(cv::Size(_width, _height), _image_type, (void*) image_buffer, cv::Mat::AUTO_STEP);
+
+        if(image.type() == CV_8UC3)
+        {
+            // convert the read image from BGR to RGB
+            cv::Mat image_rgb;
+            cv::cvtColor(image, image_rgb, cv::COLOR_BGR2RGB);
+            cv::imwrite(_path.string(), image_rgb);
+        }
+        else if(image.type() == CV_8UC4)
+        {
+            // convert the read image from BGRA to RGBA
+            cv::Mat image_rgb;
+            cv::cvtColor(image, image_rgb, cv::COLOR_BGRA2RGBA);
+            cv::imwrite(_path.string(), image_rgb);
+        }
+        else
+        {
+            cv::imwrite(_path.string(), image);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        SIGHT_ERROR("Unable to write the frame '" + _path.string() + "': " + e.what());
+    }
+
+    const int queued = static_cast<int>(--m_queued);
+    this->signal<signals::int_t>(signals::QUEUED)->async_emit(queued);
+    this->signal<signals::double_t>(signals::ENCODE_LATENCY)->async_emit(
+        core::clock::get_time_in_milli_sec() - _queued_time
+    );
+}
+
+//------------------------------------------------------------------------------
+
+void frame_writer::flush()
+{
+    if(m_pending)
+    {
+        m_pending->wait();
+    }
+}
+
+//------------------------------------------------------------------------------
+
 void frame_writer::start_record()
 {
     if(!this->has_location_defined())
@@ -262,6 +321,8 @@ void frame_writer::start_record()
             std::filesystem::create_directories(path);
         }
 
+        m_dropped      = 0;
+        m_last_time.reset();
         m_is_recording = true;
     }
 }
@@ -271,6 +332,7 @@ void frame_writer::start_record()
 void frame_writer::stop_record()
 {
     m_is_recording = false;
+    this->flush();
 }
 
 //------------------------------------------------------------------------------
@@ -22,10 +22,18 @@
 
 #pragma once
 
+#include <core/com/signal.hpp>
+#include <core/thread/pool.hpp>
+
 #include <data/frame_tl.hpp>
 
 #include <io/__/service/writer.hpp>
 
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
 namespace sight::module::io::video
 {
 
@@ -35,8 +43,22 @@ namespace sight::module::io::video
  * @note The method 'updating' allows to save the timeline frame with the current timestamp. If you want to save all the
  *       frame when they are pushed in the timeline, you must use the slots 'startRecord' and 'stopRecord'
  *
+ * Recorded frames are queued and encoded by a pool of threads, so that the service never blocks the timeline. The
+ * frames are not copied, the queue holds the timeline buffers until they are written. When the queue is full, the
+ * incoming frames are dropped. Stopping the recording waits until all queued frames are written.
+ *
+ * Frames are written in files named after their timestamp in milliseconds, 'img_<timestamp><format>'. Frames with the
+ * same timestamp in milliseconds are numbered, 'img_<timestamp>_<number><format>'.
+ *
  * @todo Only image of type 'uint8' (RGB and RGBA) and grayscale image of type 'uint8' and 'uint16' are managed.
  *
+ * @section Signals Signals
+ * - \b queued(int): Emitted when a frame is queued or written, with the number of frames waiting to be written.
+ * - \b dropped(int): Emitted when a frame is dropped because the queue is full, with the number of dropped frames
+ * since the recording started.
+ * - \b encode_latency(double): Emitted when a frame is written, with the time in milliseconds elapsed since it was
+ * queued.
+ *
  * @section Slots Slots
  * - \b save_frame(timestamp): adds the current frame in the video
  * - \b start_record(): starts recording
@@ -51,6 +73,8 @@ namespace sight::module::io::video
        <in key="data" uid="..." auto_connect="true" />
        <windowTitle>Select the image file to load</windowTitle>
        <format>.tiff</format>
+       <encoders>4</encoders>
+       <queue_size>64</queue_size>
    </service>
    @endcode
  * @subsection Input Input
@@ -59,6 +83,9 @@ namespace sight::module::io::video
  * @subsection Configuration Configuration
  * - \b windowTitle: allow overriding the default title of the modal file selection window. \see io::writer
  * - \b format: optional, file format used to store frames. Possible extensions (.jpeg ,.bmp, .tiff, .png, .jp2,... )
+ * - \b encoders: optional, number of threads writing the frames, 0 means one per core (default: 0).
+ * - \b queue_size: optional, maximum number of frames waiting to be written before frames are dropped
+ * (default: 32).
  */
 class frame_writer : public sight::io::service::writer
 {
@@ -66,6 +93,18 @@ public:
 
     SIGHT_DECLARE_SERVICE(frame_writer, sight::io::service::writer);
 
+    /// Internal wrapper holding signals keys.
+    struct signals
+    {
+        using key_t = sight::core::com::signals::key_t;
+        static inline const key_t QUEUED         = "queued";
+        static inline const key_t DROPPED        = "dropped";
+        static inline const key_t ENCODE_LATENCY = "encode_latency";
+
+        using int_t    = sight::core::com::signal<void (int)>;
+        using double_t = sight::core::com::signal<void (double)>;
+    };
+
     /// Constructor.
     frame_writer() noexcept;
 
@@ -86,10 +125,10 @@ protected:
     /// Does nothing
     void configuring() override;
 
-    /// Does nothing
+    /// Starts the encoder threads
     void starting() override;
 
-    /// Does nothing
+    /// Stops recording and the encoder threads
     void stopping() override;
 
     /// Does nothing
@@ -100,9 +139,22 @@ private:
     /// SLOT: Adds the current frame in the video
     void save_frame(core::clock::type _timestamp);
 
-    /// Writes frame on the disk
+    /// Queues the frame to be written on the disk
     void write(core::clock::type _timestamp);
 
+    /// Writes a queued frame on the disk, called from the encoder threads
+    void encode(
+        CSPTR(data::frame_tl::buffer_t) _buffer,
+        int _width,
+        int _height,
+        int _image_type,
+        const std::filesystem::path& _path,
+        core::clock::type _queued_time
+    );
+
+    /// Waits until all queued frames are written
+    void flush();
+
     /// SLOT: Starts recording
     void start_record();
 
@@ -123,6 +175,22 @@ private:
     bool m_is_recording {false}; ///< flag if the service is recording.
 
     std::string m_format; ///< file format (.tiff by default)
+
+    std::size_t m_nb_encoders {0}; ///< number of encoder threads, 0 means one per core
+
+    std::size_t m_queue_size {32}; ///< maximum number of frames waiting to be written
+
+    std::unique_ptr<core::thread::pool> m_encoders; ///< threads writing the frames
+
+    std::unique_ptr<core::thread::task_group> m_pending; ///< frames queued since the last flush
+
+    std::atomic<std::size_t> m_queued {0}; ///< number of frames waiting to be written
+
+    std::size_t m_dropped {0}; ///< number of frames dropped since the recording started
+
+    std::optional<std::size_t> m_last_time; ///< timestamp in milliseconds of the last queued frame
+
+    std::size_t m_same_time_count {0}; ///< number of frames queued before the last one with the same timestamp
 };
 
 } // namespace sight::module::io::video
@@ -0,0 +1,162 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "frame_writer_test.hpp"
+
+#include <core/os/temp_path.hpp>
+
+#include <data/frame_tl.hpp>
+
+#include <io/__/service/writer.hpp>
+
+#include <service/op.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(sight::module::io::video::ut::frame_writer_test);
+
+namespace sight::module::io::video::ut
+{
+
+//------------------------------------------------------------------------------
+
+static std::size_t count_files(const std::filesystem::path& _folder)
+{
+    const std::filesystem::directory_iterator files(_folder);
+    return static_cast<std::size_t>(std::distance(std::filesystem::begin(files), std::filesystem::end(files)));
+}
+
+//------------------------------------------------------------------------------
+
+static void push_frame(const data::frame_tl::sptr& _timeline, core::clock::type _timestamp)
+{
+    core::mt::write_lock lock(_timeline->get_mutex());
+    SPTR(data::frame_tl::buffer_t) buffer = _timeline->create_buffer(_timestamp);
+    std::uint8_t* frame                   = buffer->add_element(0);
+    std::fill_n(frame, _timeline->get_width() * _timeline->get_height() * 4, static_cast<std::uint8_t>(_timestamp));
+    _timeline->push_object(buffer);
+}
+
+//------------------------------------------------------------------------------
+
+static service::base::sptr start_writer(
+    const data::frame_tl::sptr& _timeline,
+    const std::filesystem::path& _folder,
+    std::size_t _queue_size
+)
+{
+    auto writer = service::add("sight::module::io::video::frame_writer");
+    CPPUNIT_ASSERT_MESSAGE("Failed to create service 'sight::module::io::video::frame_writer'", writer);
+    writer->set_input(_timeline, "data");
+
+    service::config_t config;
+    config.add("format", ".png");
+    config.add("encoders", 4);
+    config.add("queue_size", _queue_size);
+
+    CPPUNIT_ASSERT_NO_THROW(writer->set_config(config));
+    CPPUNIT_ASSERT_NO_THROW(writer->configure());
+    std::dynamic_pointer_cast<sight::io::service::writer>(writer)->set_folder(_folder);
+    CPPUNIT_ASSERT_NO_THROW(writer->start().wait());
+
+    return writer;
+}
+
+//------------------------------------------------------------------------------
+
+void frame_writer_test::setUp()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void frame_writer_test::tearDown()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void frame_writer_test::basic_test()
+{
+    core::os::temp_dir tmp_dir;
+
+    auto timeline = std::make_shared<data::frame_tl>();
+    timeline->init_pool_size(8, 4, core::type::UINT8, data::frame_tl::pixel_format::rgba);
+
+    push_frame(timeline, 1.);
+    push_frame(timeline, 1.5);
+    push_frame(timeline, 2.);
+
+    auto writer = start_writer(timeline, tmp_dir, 32);
+
+    writer->slot("start_record")->run();
+    writer->slot("write")->run(core::clock::type(1.));
+    writer->slot("write")->run(core::clock::type(1.5));
+    writer->slot("write")->run(core::clock::type(2.));
+    writer->slot("stop_record")->run();
+
+    CPPUNIT_ASSERT_NO_THROW(writer->stop().wait());
+    service::remove(writer);
+
+    // The frames of the same millisecond do not overwrite each other
+    CPPUNIT_ASSERT(std::filesystem::exists(tmp_dir / "img_1.png"));
+    CPPUNIT_ASSERT(std::filesystem::exists(tmp_dir / "img_1_1.png"));
+    CPPUNIT_ASSERT(std::filesystem::exists(tmp_dir / "img_2.png"));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), count_files(tmp_dir));
+}
+
+//------------------------------------------------------------------------------
+
+void frame_writer_test::concurrent_push_test()
+{
+    constexpr std::size_t nb_frames = 200;
+
+    core::os::temp_dir tmp_dir;
+
+    // The timeline only keeps a few frames, most buffers are released by the encoder threads while new ones are
+    // allocated
+    auto timeline = std::make_shared<data::frame_tl>();
+    timeline->init_pool_size(64, 48, core::type::UINT8, data::frame_tl::pixel_format::rgba);
+    timeline->set_maximum_size(2);
+
+    auto writer = start_writer(timeline, tmp_dir, nb_frames);
+
+    writer->slot("start_record")->run();
+    for(std::size_t i = 1 ; i <= nb_frames ; ++i)
+    {
+        const auto timestamp = static_cast<core::clock::type>(i);
+        push_frame(timeline, timestamp);
+        writer->slot("write")->run(timestamp);
+    }
+
+    writer->slot("stop_record")->run();
+
+    CPPUNIT_ASSERT_NO_THROW(writer->stop().wait());
+    service::remove(writer);
+
+    // The queue is large enough, no frame is dropped
+    CPPUNIT_ASSERT_EQUAL(nb_frames, count_files(tmp_dir));
+}
+
+} // namespace sight::module::io::video::ut
@@ -0,0 +1,49 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace sight::module::io::video::ut
+{
+
+/**
+ * @brief Test the frame writer.
+ */
+class frame_writer_test : public CPPUNIT_NS::TestFixture
+{
+CPPUNIT_TEST_SUITE(frame_writer_test);
+CPPUNIT_TEST(basic_test);
+CPPUNIT_TEST(concurrent_push_test);
+CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    // interface
+    void setUp() override;
+    void tearDown() override;
+
+    static void basic_test();
+    static void concurrent_push_test();
+};
+
+} // namespace sight::module::io::video::ut
@@ -0,0 +1,184 @@
+/************************************************************************
+ *
+ * Copyright (C) 2024 IRCAD France
+ *
+ * This file is part of Sight.
+ *
+ * Sight is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Sight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Sight. If not, see <https://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "video_writer_test.hpp"
+
+#include <core/os/temp_path.hpp>
+
+#include <data/frame_tl.hpp>
+
+#include <io/__/service/writer.hpp>
+
+#include <service/op.hpp>
+
+#include <ui/__/dialog/message_dummy.hpp>
+#include <ui/__/macros.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(sight::module::io::video::ut::video_writer_test);
+
+SIGHT_REGISTER_GUI(sight::ui::dialog::message_dummy, sight::ui::dialog::message_base::REGISTRY_KEY);
+
+namespace sight::module::io::video::ut
+{
+
+//------------------------------------------------------------------------------
+
+void video_writer_test::setUp()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void video_writer_test::tearDown()
+{
+}
+
+//------------------------------------------------------------------------------
+
+/// Records frames with a video_writer, and returns their timestamps
+inline static std::vector<core::clock::type> record(
+    const std::filesystem::path& _video_path,
+    std::size_t _nb_frames,
+    std::size_t _timeline_size
+)
+{
+    constexpr std::size_t width  = 64;
+    constexpr std::size_t height = 48;
+
+    auto timeline = std::make_shared<data::frame_tl>();
+    timeline->init_pool_size(width, height, core::type::UINT8, data::frame_tl::pixel_format::rgb);
+    timeline->set_maximum_size(_timeline_size);
+
+    auto writer = service::add("sight::module::io::video::video_writer");
+    CPPUNIT_ASSERT_MESSAGE("Failed to create service 'sight::module::io::video::video_writer'", writer);
+    writer->set_input(timeline, "data");
+
+    service::config_t config;
+    config.add("queue_size", _nb_frames);
+
+    CPPUNIT_ASSERT_NO_THROW(writer->set_config(config));
+    CPPUNIT_ASSERT_NO_THROW(writer->configure());
+    std::dynamic_pointer_cast<sight::io::service::writer>(writer)->set_file(_video_path);
+    CPPUNIT_ASSERT_NO_THROW(writer->start().wait());
+
+    std::vector<core::clock::type> timestamps;
+    writer->slot("start_record")->run();
+    for(std::size_t i = 0 ; i < _nb_frames ; ++i)
+    {
+        const auto timestamp = static_cast<core::clock::type>(1000 + i * 33);
+        {
+            core::mt::write_lock lock(timeline->get_mutex());
+            SPTR(data::frame_tl::buffer_t) buffer = timeline->create_buffer(timestamp);
+            std::fill_n(buffer->add_element(0), width * height * 3, static_cast<std::uint8_t>(i));
+            timeline->push_object(buffer);
+        }
+
+        writer->slot("save_frame")->run(timestamp);
+        timestamps.push_back(timestamp);
+    }
+
+    writer->slot("stop_record")->run();
+
+    CPPUNIT_ASSERT_NO_THROW(writer->stop().wait());
+    service::remove(writer);
+
+    return timestamps;
+}
+
+//------------------------------------------------------------------------------
+
+/// Checks that the timestamps sidecar of a video lists the given frames once, in order
+inline static void check_timestamps(
+    const std::filesystem::path& _path,
+    const std::vector<core::clock::type>& _timestamps
+)
+{
+    std::ifstream file(_path);
+    CPPUNIT_ASSERT(file.is_open());
+
+    std::string line;
+    std::getline(file, line);
+    CPPUNIT_ASSERT_EQUAL(std::string("frame,timestamp"), line);
+
+    std::size_t frame = 0;
+    while(std::getline(file, line))
+    {
+        CPPUNIT_ASSERT(frame < _timestamps.size());
+
+        const auto separator = line.find(',');
+        CPPUNIT_ASSERT(separator != std::string::npos);
+        CPPUNIT_ASSERT_EQUAL(std::to_string(frame), line.substr(0, separator));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(_timestamps[frame], std::stod(line.substr(separator + 1)), 1e-3);
+        ++frame;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(_timestamps.size(), frame);
+}
+
+//------------------------------------------------------------------------------
+
+void video_writer_test::timestamps_test()
+{
+    core::os::temp_dir tmp_dir;
+    const std::filesystem::path video_path = tmp_dir / "video.mp4";
+
+    // The timeline only keeps a few frames, most buffers are released by the encoder thread while new ones are
+    // allocated
+    const auto timestamps = record(video_path, 30, 8);
+
+    // The codec may not be available with this build of OpenCV
+    if(!std::filesystem::exists(video_path))
+    {
+        return;
+    }
+
+    // Every frame is encoded once, in order
+    check_timestamps(tmp_dir / "video_timestamps.csv", timestamps);
+}
+
+//------------------------------------------------------------------------------
+
+void video_writer_test::opening_frame_test()
+{
+    core::os::temp_dir tmp_dir;
+    const std::filesystem::path video_path = tmp_dir / "video.mp4";
+
+    // The first five frames give the frame rate, the sixth one opens the video
+    const auto timestamps = record(video_path, 6, 8);
+
+    // The codec may not be available with this build of OpenCV
+    if(!std::filesystem::exists(video_path))
+    {
+        return;
+    }
+
+    // The frame that opens the video is encoded after the first ones, and only once
+    check_timestamps(tmp_dir / "video_timestamps.csv", timestamps);
+}
+
+} // namespace sight::module::io::video::ut
@@ -30,6 +30,7 @@
 #include <core/com/slots.hxx>
 #include <core/location/single_file.hpp>
 #include <core/location/single_folder.hpp>
+#include <core/spy_log.hpp>
 
 #include <service/macros.hpp>
 
@@ -40,6 +41,8 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <iomanip>
+
 namespace sight::module::io::video
 {
 
@@ -61,6 +64,9 @@ video_writer::video_writer() noexcept
     new_slot(STOP_RECORD, &video_writer::stop_record, this);
     new_slot(RECORD, &video_writer::record, this);
     new_slot(TOGGLE_RECORDING, &video_writer::toggle_recording, this);
+
+    new_signal<signals::int_t>(signals::QUEUED);
+    new_signal<signals::int_t>(signals::DROPPED);
 }
 
 //------------------------------------------------------------------------------
@@ -80,12 +86,20 @@ sight::io::service::path_type_t video_writer::get_path_type() const
 void video_writer::configuring()
 {
     sight::io::service::writer::configuring();
+
+    const service::config_t config = this->get_config();
+
+    m_queue_size       = config.get<std::size_t>("queue_size", 16);
+    m_write_timestamps = config.get<bool>("timestamps", true);
+
+    SIGHT_ASSERT("The queue size must be greater than 0.", m_queue_size > 0);
 }
 
 //------------------------------------------------------------------------------
 
 void video_writer::starting()
 {
+    m_encoder = core::thread::worker::make();
 }
 
 //------------------------------------------------------------------------------
@@ -118,6 +132,9 @@ void video_writer::open_location_dialog()
 void video_writer::stopping()
 {
     this->stop_record();
+
+    m_encoder->stop();
+    m_encoder.reset();
 }
 
 //------------------------------------------------------------------------------
@@ -133,39 +150,83 @@ void video_writer::write_buffer(int _width, int _height, CSPTR(data::frame_tl::b
     SIGHT_ASSERT("OpenCV video writer not initialized", m_writer);
     const std::uint8_t* image_buffer = &_buffer->get_element(0);
 
-    const cv::Mat image(
-        cv::Size(_width, _height),
-        m_image_type, const_cast<std::uint8_t*>(image_buffer), // NOLINT(cppcoreguidelines-pro-type-const-cast)
-        cv::Mat::AUTO_STEP
-    );
-    if(m_image_type == CV_16UC1)
+    try
     {
-        // Convert the image to a RGB image
-        cv::Mat img8bit;
-        cv::Mat img_color;
-        image.convertTo(img8bit, CV_8UC1, 1 / 100.0);
-        cv::cvtColor(img8bit, img_color, cv::COLOR_GRAY2RGB);
+        const cv::Mat image(
+            cv::Size(_width, _height),
+            m_image_type, const_cast<std::uint8_t*>(image_buffer), // NOLINT(cppcoreguidelines-pro-type-const-cast)
+            cv::Mat::AUTO_STEP
+        );
+        if(m_image_type == CV_16UC1)
+        {
+            // Convert the image to a RGB image
+            cv::Mat img8bit;
+            cv::Mat img_color;
+            image.convertTo(img8bit, CV_8UC1, 1 / 100.0);
+            cv::cvtColor(img8bit, img_color, cv::COLOR_GRAY2RGB);
 
-        m_writer->write(img_color);
+            m_writer->write(img_color);
+        }
+        else if(m_image_type == CV_8UC3)
+        {
+            // convert the image from RGB to BGR
+            cv::Mat image_bgr;
+            cv::cvtColor(image, image_bgr, cv::COLOR_RGB2BGR);
+            m_writer->write(image_bgr);
+        }
+        else if(m_image_type == CV_8UC4)
+        {
+            // convert the image from RGBA to BGR
+            cv::Mat image_bgr;
+            cv::cvtColor(image, image_bgr, cv::COLOR_RGBA2BGR);
+            m_writer->write(image_bgr);
+        }
+        else
+        {
+            m_writer->write(image);
+        }
     }
-    else if(m_image_type == CV_8UC3)
+    catch(const std::exception& e)
     {
-        // convert the image from RGB to BGR
-        cv::Mat image_bgr;
-        cv::cvtColor(image, image_bgr, cv::COLOR_RGB2BGR);
-        m_writer->write(image_bgr);
+        SIGHT_ERROR("Unable to encode the frame " + std::to_string(_buffer->get_timestamp()) + ": " + e.what());
+        this->drop_frame();
+        return;
     }
-    else if(m_image_type == CV_8UC4)
+
+    if(m_timestamps_file.is_open())
     {
-        // convert the image from RGBA to BGR
-        cv::Mat image_bgr;
-        cv::cvtColor(image, image_bgr, cv::COLOR_RGBA2BGR);
-        m_writer->write(image_bgr);
+        m_timestamps_file << m_frame_index << "," << _buffer->get_timestamp() << "\n";
     }
-    else
+
+    ++m_frame_index;
+}
+
+//------------------------------------------------------------------------------
+
+void video_writer::queue_buffer(int _width, int _height, CSPTR(data::frame_tl::buffer_t) _buffer)
+{
+    if(m_queued.load() >= m_queue_size)
     {
-        m_writer->write(image);
+        this->drop_frame();
+        return;
     }
+
+    const auto sig = this->signal<signals::int_t>(signals::QUEUED);
+    sig->async_emit(static_cast<int>(++m_queued));
+
+    m_encoder->post(
+        [this, sig, _width, _height, buffer = std::move(_buffer)]
+        {
+            this->write_buffer(_width, _height, buffer);
+            sig->async_emit(static_cast<int>(--m_queued));
+        });
+}
+
+//------------------------------------------------------------------------------
+
+void video_writer::drop_frame()
+{
+    this->signal<signals::int_t>(signals::DROPPED)->async_emit(static_cast<int>(++m_dropped));
 }
 
 //------------------------------------------------------------------------------
@@ -195,7 +256,11 @@ void video_writer::save_frame(core::clock::type _timestamp)
             {
                 const int width  = static_cast<int>(frame_tl->get_width());
                 const int height = static_cast<int>(frame_tl->get_height());
-                this->write_buffer(width, height, buffer);
+                this->queue_buffer(width, height, buffer);
+            }
+            else
+            {
+                this->drop_frame();
             }
         }
         else
@@ -263,13 +328,36 @@ void video_writer::save_frame(core::clock::type _timestamp)
                 }
                 else
                 {
+                    // Nothing is queued yet, the encoder thread only accesses these members after the next post
+                    m_frame_index = 0;
+                    if(m_write_timestamps)
+                    {
+                        const std::filesystem::path timestamps_path =
+                            path.parent_path() / (path.stem().string() + "_timestamps.csv");
+                        m_timestamps_file.open(timestamps_path);
+                        if(m_timestamps_file)
+                        {
+                            m_timestamps_file << std::fixed << std::setprecision(3) << "frame,timestamp\n";
+                        }
+                        else
+                        {
+                            SIGHT_ERROR("Unable to write the timestamps in the file: " + timestamps_path.string());
+                        }
+                    }
+
+                    // The current frame is written after the ones used to compute the number of fps
+                    m_timestamps.push_back(_timestamp);
                     for(const auto& old_timestamp : m_timestamps)
                     {
                         // writes the old frames used to compute the number of fps
                         CSPTR(data::frame_tl::buffer_t) buffer = frame_tl->get_closest_buffer(old_timestamp);
                         if(buffer)
                         {
-                            this->write_buffer(width, height, buffer);
+                            this->queue_buffer(width, height, buffer);
+                        }
+                        else
+                        {
+                            this->drop_frame();
                         }
                     }
                 }
@@ -324,6 +412,7 @@ void video_writer::start_record()
             std::filesystem::create_directories(dirname);
         }
 
+        m_dropped      = 0;
         m_is_recording = true;
     }
 }
@@ -336,7 +425,13 @@ void video_writer::stop_record()
     m_timestamps.clear();
     if(m_writer)
     {
-        m_writer->release();
+        // Waits until the queued frames are encoded
+        m_encoder->post_task<void>(
+            [this]
+            {
+                m_writer->release();
+                m_timestamps_file.close();
+            }).wait();
         m_writer.reset();
         this->clear_locations();
     }
@@ -22,31 +22,56 @@
 
 #pragma once
 
+#include <core/com/signal.hpp>
+#include <core/thread/worker.hpp>
+
 #include <data/frame_tl.hpp>
 
 #include <io/__/service/writer.hpp>
 
 #include <opencv2/videoio.hpp>
 
+#include <atomic>
+#include <fstream>
+
 namespace sight::module::io::video
 {
 
 /**
  * @brief This service allows to save the timeline frames in a video file.
  *
+ * The frames are encoded by a dedicated thread, so that encoding never stalls the timeline. The service only queues
+ * references to the timeline buffers, without copying them. When the queue is full, the incoming frames are dropped.
+ * Stopping the recording waits until all queued frames are encoded.
+ *
+ * The timestamp of each encoded frame is written in a sidecar file, next to the video and named after it with a
+ * "_timestamps.csv" suffix, to allow synchronizing the video with other timelines afterwards.
+ *
+ * @section Slots Slots
  * - \b save_frame(timestamp) : add the current frame in the video
  * - \b start_record() : start recording
  * - \b stop_record() : stop recording
  *
+ * @section Signals Signals
+ * - \b queued(int): Emitted when a frame is queued or encoded, with the number of frames waiting to be encoded.
+ * - \b dropped(int): Emitted when a frame is not in the video, because it left the timeline before being queued,
+ * the queue was full or the encoding failed, with the number of dropped frames since the recording started.
+ *
  * @section XML XML Configuration
  *
  * @code{.xml}
    <service type="sight::module::io::video::video_writer">
        <in key="data" uid="..." />
+       <queue_size>16</queue_size>
+       <timestamps>true</timestamps>
    </service>
    @endcode
  * @subsection Input Input
  * - \b data [sight::data::frame_tl]: timeline containing the frame to save.
+ *
+ * @subsection Configuration Configuration
+ * - \b queue_size: optional, maximum number of frames waiting to be encoded before frames are dropped (default: 16).
+ * - \b timestamps: optional, write the timestamps sidecar file (default: true).
  */
 class video_writer : public sight::io::service::writer
 {
@@ -54,6 +79,16 @@ public:
 
     SIGHT_DECLARE_SERVICE(video_writer, sight::io::service::writer);
 
+    /// Internal wrapper holding signals keys.
+    struct signals
+    {
+        using key_t = sight::core::com::signals::key_t;
+        static inline const key_t QUEUED  = "queued";
+        static inline const key_t DROPPED = "dropped";
+
+        using int_t = sight::core::com::signal<void (int)>;
+    };
+
     /// Constructor.
     video_writer() noexcept;
 
@@ -71,13 +106,13 @@ public:
 
 protected:
 
-    /// Does nothing
+    /// Reads the queue size and the sidecar option
     void configuring() override;
 
-    /// Does nothing
+    /// Starts the encoder thread
     void starting() override;
 
-    /// Does nothing
+    /// Stops recording and the encoder thread
     void stopping() override;
 
     /// Does nothing
@@ -88,9 +123,15 @@ private:
     /// SLOT: adds the current frame in the video
     void save_frame(core::clock::type _timestamp);
 
-    /// saves current buffer with OpenCV video writer (m_writer must be initialized)
+    /// queues a buffer to be encoded, or drops it if the queue is full
+    void queue_buffer(int _width, int _height, CSPTR(data::frame_tl::buffer_t) _buffer);
+
+    /// saves current buffer with OpenCV video writer (m_writer must be initialized), called from the encoder thread
     void write_buffer(int _width, int _height, CSPTR(data::frame_tl::buffer_t) _buffer);
 
+    /// counts a dropped frame
+    void drop_frame();
+
     /// SLOT: Starts recording
     void start_record();
 
@@ -118,6 +159,27 @@ private:
     /// Extension selected in file dialog
     std::string m_selected_extension;
 
+    /// thread encoding the frames
+    core::thread::worker::sptr m_encoder;
+
+    /// maximum number of frames waiting to be encoded
+    std::size_t m_queue_size {16};
+
+    /// number of frames waiting to be encoded
+    std::atomic<std::size_t> m_queued {0};
+
+    /// number of frames dropped since the recording started
+    std::atomic<std::size_t> m_dropped {0};
+
+    /// flag to write the timestamps sidecar file
+    bool m_write_timestamps {true};
+
+    /// timestamps sidecar file, only accessed by the encoder thread once the recording started
+    std::ofstream m_timestamps_file;
+
+    /// index of the next encoded frame, only accessed by the encoder thread
+    std::size_t m_frame_index {0};
+
     ///  static string containing the file extension
     static const std::string P4_EXTENSION;
 